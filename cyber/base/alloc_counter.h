@@ -0,0 +1,38 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_BASE_ALLOC_COUNTER_H_
+#define CYBER_BASE_ALLOC_COUNTER_H_
+
+#include <cstdint>
+
+namespace apollo {
+namespace cyber {
+namespace base {
+
+/**
+ * @brief Number of calls to the global operator new so far.
+ *
+ * Test only: linking alloc_counter replaces the global operator new and
+ * delete of the whole binary, so tests can check a path does not allocate.
+ */
+uint64_t AllocCount();
+
+}  // namespace base
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_BASE_ALLOC_COUNTER_H_
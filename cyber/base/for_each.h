@@ -17,9 +17,11 @@
 #ifndef CYBER_BASE_FOR_EACH_H_
 #define CYBER_BASE_FOR_EACH_H_
 
+#include <cstddef>
 #include <type_traits>
 
 #include "cyber/base/macros.h"
+#include "cyber/base/work_stealing_executor.h"
 
 namespace apollo {
 namespace cyber {
@@ -45,6 +47,25 @@ LessThan(const Value& val, const End& end) {
   for (auto i = (true ? (begin) : (end)); \
        apollo::cyber::base::LessThan(i, (end)); ++i)
 
+/**
+ * @brief FOR_EACH over [begin, end) on the default work-stealing executor,
+ * func(i) runs concurrently for different i.
+ */
+template <typename F>
+void ParallelForEach(std::size_t begin, std::size_t end, const F& func,
+                     std::size_t grain = 0) {
+  WorkStealingExecutor::Default()->ParallelFor(begin, end, func, grain);
+}
+
+// map(chunk_begin, chunk_end, identity) per chunk, combined in index order
+template <typename T, typename Map, typename Reduce>
+T ParallelReduce(std::size_t begin, std::size_t end, const T& identity,
+                 const Map& map, const Reduce& reduce,
+                 std::size_t grain = 0) {
+  return WorkStealingExecutor::Default()->ParallelReduce(begin, end, identity,
+                                                         map, reduce, grain);
+}
+
 }  // namespace base
 }  // namespace cyber
 }  // namespace apollo
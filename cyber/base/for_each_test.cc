@@ -35,6 +35,21 @@ TEST(ForEachTest, base) {
   FOR_EACH(i, 0, 'a') { EXPECT_GT('a', i); }
 }
 
+TEST(ForEachTest, parallel) {
+  std::vector<int> vec(1000, 0);
+  ParallelForEach(0, vec.size(), [&vec](std::size_t i) { vec[i] = 2 * i; });
+  FOR_EACH(i, 0, vec.size()) { EXPECT_EQ(2 * i, vec[i]); }
+
+  auto sum = ParallelReduce(
+      0, vec.size(), 0L,
+      [&vec](std::size_t begin, std::size_t end, int64_t init) {
+        FOR_EACH(i, begin, end) { init += vec[i]; }
+        return init;
+      },
+      [](int64_t a, int64_t b) { return a + b; });
+  EXPECT_EQ(999 * 1000, sum);
+}
+
 }  // namespace base
 }  // namespace cyber
 }  // namespace apollo
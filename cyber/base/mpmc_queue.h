@@ -0,0 +1,184 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_BASE_MPMC_QUEUE_H_
+#define CYBER_BASE_MPMC_QUEUE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+#include "cyber/base/macros.h"
+
+namespace apollo {
+namespace cyber {
+namespace base {
+
+/**
+ * @class MpmcQueue
+ * @brief Bounded lock-free multi-producer multi-consumer queue.
+ *
+ * Unlike BoundedQueue, every slot carries its own sequence number, so an
+ * element is only touched by the thread that owns the slot. That makes it
+ * safe for non-trivial types such as std::shared_ptr.
+ */
+template <typename T>
+class MpmcQueue {
+ public:
+  using value_type = T;
+  using size_type = uint64_t;
+
+ public:
+  MpmcQueue() {}
+  MpmcQueue& operator=(const MpmcQueue& other) = delete;
+  MpmcQueue(const MpmcQueue& other) = delete;
+  ~MpmcQueue();
+  // capacity is rounded up to a power of two
+  bool Init(uint64_t size);
+  bool Enqueue(const T& element);
+  bool Enqueue(T&& element);
+  bool Dequeue(T* element);
+  uint64_t Size();
+  bool Empty();
+  uint64_t Capacity() { return mask_ + 1; }
+
+ private:
+  struct Cell {
+    std::atomic<uint64_t> seq;
+    T data;
+  };
+
+  template <typename U>
+  bool EnqueueImpl(U&& element);
+
+  alignas(CACHELINE_SIZE) std::atomic<uint64_t> head_ = {0};
+  alignas(CACHELINE_SIZE) std::atomic<uint64_t> tail_ = {0};
+  uint64_t mask_ = 0;
+  Cell* pool_ = nullptr;
+};
+
+template <typename T>
+MpmcQueue<T>::~MpmcQueue() {
+  if (pool_) {
+    for (uint64_t i = 0; i <= mask_; ++i) {
+      pool_[i].~Cell();
+    }
+    std::free(pool_);
+  }
+}
+
+template <typename T>
+bool MpmcQueue<T>::Init(uint64_t size) {
+  if (pool_ != nullptr || size == 0) {
+    return false;
+  }
+  uint64_t capacity = 1;
+  while (capacity < size) {
+    capacity <<= 1;
+  }
+  pool_ = reinterpret_cast<Cell*>(std::calloc(capacity, sizeof(Cell)));
+  if (pool_ == nullptr) {
+    return false;
+  }
+  for (uint64_t i = 0; i < capacity; ++i) {
+    new (&(pool_[i])) Cell();
+    pool_[i].seq.store(i, std::memory_order_relaxed);
+  }
+  mask_ = capacity - 1;
+  return true;
+}
+
+template <typename T>
+bool MpmcQueue<T>::Enqueue(const T& element) {
+  return EnqueueImpl(element);
+}
+
+template <typename T>
+bool MpmcQueue<T>::Enqueue(T&& element) {
+  return EnqueueImpl(std::move(element));
+}
+
+template <typename T>
+template <typename U>
+bool MpmcQueue<T>::EnqueueImpl(U&& element) {
+  Cell* cell = nullptr;
+  uint64_t pos = tail_.load(std::memory_order_relaxed);
+  while (true) {
+    cell = &pool_[pos & mask_];
+    uint64_t seq = cell->seq.load(std::memory_order_acquire);
+    int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+    if (diff == 0) {
+      if (tail_.compare_exchange_weak(pos, pos + 1,
+                                      std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // full
+      return false;
+    } else {
+      pos = tail_.load(std::memory_order_relaxed);
+    }
+  }
+  cell->data = std::forward<U>(element);
+  cell->seq.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+bool MpmcQueue<T>::Dequeue(T* element) {
+  Cell* cell = nullptr;
+  uint64_t pos = head_.load(std::memory_order_relaxed);
+  while (true) {
+    cell = &pool_[pos & mask_];
+    uint64_t seq = cell->seq.load(std::memory_order_acquire);
+    int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos + 1);
+    if (diff == 0) {
+      if (head_.compare_exchange_weak(pos, pos + 1,
+                                      std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // empty
+      return false;
+    } else {
+      pos = head_.load(std::memory_order_relaxed);
+    }
+  }
+  *element = std::move(cell->data);
+  cell->data = T();
+  cell->seq.store(pos + mask_ + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+inline uint64_t MpmcQueue<T>::Size() {
+  uint64_t head = head_.load(std::memory_order_acquire);
+  uint64_t tail = tail_.load(std::memory_order_acquire);
+  return tail > head ? tail - head : 0;
+}
+
+template <typename T>
+inline bool MpmcQueue<T>::Empty() {
+  return Size() == 0;
+}
+
+}  // namespace base
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_BASE_MPMC_QUEUE_H_
@@ -0,0 +1,98 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/base/mpmc_queue.h"
+
+#include <memory>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace base {
+
+TEST(MpmcQueueTest, Enqueue) {
+  MpmcQueue<int> queue;
+  EXPECT_FALSE(queue.Init(0));
+  EXPECT_TRUE(queue.Init(100));
+  EXPECT_FALSE(queue.Init(100));
+  EXPECT_EQ(128, queue.Capacity());
+  EXPECT_EQ(0, queue.Size());
+  EXPECT_TRUE(queue.Empty());
+  for (int i = 1; i <= 128; i++) {
+    EXPECT_TRUE(queue.Enqueue(i));
+    EXPECT_EQ(i, queue.Size());
+  }
+  EXPECT_FALSE(queue.Enqueue(129));
+}
+
+TEST(MpmcQueueTest, Dequeue) {
+  MpmcQueue<std::shared_ptr<int>> queue;
+  queue.Init(4);
+  std::shared_ptr<int> value;
+  for (int i = 0; i < 100; i++) {
+    auto element = std::make_shared<int>(i);
+    EXPECT_TRUE(queue.Enqueue(element));
+    EXPECT_EQ(2, element.use_count());
+    EXPECT_TRUE(queue.Dequeue(&value));
+    EXPECT_EQ(i, *value);
+    // the queue gives up its reference on dequeue
+    EXPECT_EQ(2, element.use_count());
+  }
+  EXPECT_FALSE(queue.Dequeue(&value));
+}
+
+TEST(MpmcQueueTest, concurrency) {
+  MpmcQueue<int> queue;
+  queue.Init(16);
+  std::atomic<int64_t> enqueued = {0};
+  std::atomic<int64_t> dequeued = {0};
+  std::thread threads[16];
+  for (int i = 0; i < 16; ++i) {
+    if (i % 2 == 0) {
+      threads[i] = std::thread([&]() {
+        for (int j = 1; j <= 10000; ++j) {
+          if (queue.Enqueue(j)) {
+            enqueued += j;
+          }
+        }
+      });
+    } else {
+      threads[i] = std::thread([&]() {
+        for (int j = 0; j < 10000; ++j) {
+          int value = 0;
+          if (queue.Dequeue(&value)) {
+            dequeued += value;
+          }
+        }
+      });
+    }
+  }
+  for (int i = 0; i < 16; ++i) {
+    threads[i].join();
+  }
+  int value = 0;
+  while (queue.Dequeue(&value)) {
+    dequeued += value;
+  }
+  EXPECT_EQ(enqueued.load(), dequeued.load());
+  EXPECT_TRUE(queue.Empty());
+}
+
+}  // namespace base
+}  // namespace cyber
+}  // namespace apollo
@@ -18,54 +18,41 @@
 #define CYBER_BASE_THREAD_POOL_H_
 
 #include <atomic>
-#include <functional>
 #include <future>
-#include <memory>
-#include <queue>
-#include <stdexcept>
-#include <thread>
 #include <utility>
-#include <vector>
 
-#include "cyber/base/bounded_queue.h"
+#include "cyber/base/work_stealing_executor.h"
 
 namespace apollo {
 namespace cyber {
 namespace base {
 
+/**
+ * @class ThreadPool
+ * @brief A future per task on top of a WorkStealingExecutor. Use the executor
+ * directly for fan-out work that needs no future per task.
+ */
 class ThreadPool {
  public:
+  // the queues grow as needed, max_task_num is no longer a limit
   explicit ThreadPool(std::size_t thread_num, std::size_t max_task_num = 1000);
 
   template <typename F, typename... Args>
   auto Enqueue(F&& f, Args&&... args)
       -> std::future<typename std::result_of<F(Args...)>::type>;
 
+  WorkStealingExecutor* executor() { return &executor_; }
+
   ~ThreadPool();
 
  private:
-  std::vector<std::thread> workers_;
-  BoundedQueue<std::function<void()>> task_queue_;
+  WorkStealingExecutor executor_;
   std::atomic_bool stop_;
 };
 
-inline ThreadPool::ThreadPool(std::size_t threads, std::size_t max_task_num)
-    : stop_(false) {
-  if (!task_queue_.Init(max_task_num, new BlockWaitStrategy())) {
-    throw std::runtime_error("Task queue init failed.");
-  }
-  workers_.reserve(threads);
-  for (size_t i = 0; i < threads; ++i) {
-    workers_.emplace_back([this] {
-      while (!stop_) {
-        std::function<void()> task;
-        if (task_queue_.WaitDequeue(&task)) {
-          task();
-        }
-      }
-    });
-  }
-}
+inline ThreadPool::ThreadPool(std::size_t threads,
+                              std::size_t /*max_task_num*/)
+    : executor_(threads), stop_(false) {}
 
 // before using the return value, you should check value.valid()
 template <typename F, typename... Args>
@@ -73,30 +60,16 @@ auto ThreadPool::Enqueue(F&& f, Args&&... args)
     -> std::future<typename std::result_of<F(Args...)>::type> {
   using return_type = typename std::result_of<F(Args...)>::type;
 
-  auto task = std::make_shared<std::packaged_task<return_type()>>(
-      std::bind(std::forward<F>(f), std::forward<Args>(args)...));
-
-  std::future<return_type> res = task->get_future();
-
   // don't allow enqueueing after stopping the pool
   if (stop_) {
     return std::future<return_type>();
   }
-  task_queue_.Enqueue([task]() { (*task)(); });
-  return res;
-};
-
-// the destructor joins all threads
-inline ThreadPool::~ThreadPool() {
-  if (stop_.exchange(true)) {
-    return;
-  }
-  task_queue_.BreakAllWait();
-  for (std::thread& worker : workers_) {
-    worker.join();
-  }
+  return executor_.Submit(std::forward<F>(f), std::forward<Args>(args)...);
 }
 
+// the destructor runs the tasks already queued and joins all threads
+inline ThreadPool::~ThreadPool() { stop_.store(true); }
+
 }  // namespace base
 }  // namespace cyber
 }  // namespace apollo
@@ -0,0 +1,752 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_BASE_WORK_STEALING_EXECUTOR_H_
+#define CYBER_BASE_WORK_STEALING_EXECUTOR_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "cyber/base/macros.h"
+
+namespace apollo {
+namespace cyber {
+namespace base {
+
+/**
+ * @class SmallTask
+ * @brief A move-only void() callable. Callables up to kInlineSize bytes, e.g.
+ * lambdas capturing a few pointers, are stored in place instead of on the
+ * heap.
+ */
+class SmallTask {
+ public:
+  static const std::size_t kInlineSize = 6 * sizeof(void*);
+
+  SmallTask() = default;
+
+  template <typename F, typename Fn = typename std::decay<F>::type,
+            typename = typename std::enable_if<
+                !std::is_same<Fn, SmallTask>::value>::type>
+  explicit SmallTask(F&& func) {
+    Init<Fn>(std::forward<F>(func),
+             std::integral_constant<bool, IsInline<Fn>()>());
+  }
+
+  SmallTask(SmallTask&& other) noexcept { MoveFrom(&other); }
+
+  SmallTask& operator=(SmallTask&& other) noexcept {
+    if (this != &other) {
+      Reset();
+      MoveFrom(&other);
+    }
+    return *this;
+  }
+
+  ~SmallTask() { Reset(); }
+
+  void operator()() { ops_->invoke(&storage_); }
+
+  explicit operator bool() const { return ops_ != nullptr; }
+
+  void Reset() {
+    if (ops_ != nullptr) {
+      ops_->destroy(&storage_);
+      ops_ = nullptr;
+    }
+  }
+
+ private:
+  struct Ops {
+    void (*invoke)(void*);
+    void (*move)(void*, void*);
+    void (*destroy)(void*);
+  };
+
+  template <typename Fn>
+  static constexpr bool IsInline() {
+    return sizeof(Fn) <= kInlineSize &&
+           alignof(Fn) <= alignof(std::max_align_t) &&
+           std::is_nothrow_move_constructible<Fn>::value;
+  }
+
+  template <typename Fn>
+  struct InlineOps {
+    static void Invoke(void* p) { (*static_cast<Fn*>(p))(); }
+    static void Move(void* dst, void* src) {
+      new (dst) Fn(std::move(*static_cast<Fn*>(src)));
+      static_cast<Fn*>(src)->~Fn();
+    }
+    static void Destroy(void* p) { static_cast<Fn*>(p)->~Fn(); }
+    static const Ops* Get() {
+      static const Ops ops = {&Invoke, &Move, &Destroy};
+      return &ops;
+    }
+  };
+
+  template <typename Fn>
+  struct HeapOps {
+    static void Invoke(void* p) { (**static_cast<Fn**>(p))(); }
+    static void Move(void* dst, void* src) {
+      *static_cast<Fn**>(dst) = *static_cast<Fn**>(src);
+    }
+    static void Destroy(void* p) { delete *static_cast<Fn**>(p); }
+    static const Ops* Get() {
+      static const Ops ops = {&Invoke, &Move, &Destroy};
+      return &ops;
+    }
+  };
+
+  template <typename Fn, typename F>
+  void Init(F&& func, std::true_type) {
+    new (&storage_) Fn(std::forward<F>(func));
+    ops_ = InlineOps<Fn>::Get();
+  }
+
+  template <typename Fn, typename F>
+  void Init(F&& func, std::false_type) {
+    *reinterpret_cast<Fn**>(&storage_) = new Fn(std::forward<F>(func));
+    ops_ = HeapOps<Fn>::Get();
+  }
+
+  void MoveFrom(SmallTask* other) {
+    if (other->ops_ != nullptr) {
+      other->ops_->move(&storage_, &other->storage_);
+      ops_ = other->ops_;
+      other->ops_ = nullptr;
+    }
+  }
+
+  typename std::aligned_storage<kInlineSize, alignof(std::max_align_t)>::type
+      storage_;
+  const Ops* ops_ = nullptr;
+};
+
+/**
+ * @class WorkStealingDeque
+ * @brief Bounded Chase-Lev deque. The owner thread pushes and pops at the
+ * bottom, any thread steals from the top.
+ */
+template <typename T>
+class WorkStealingDeque {
+ public:
+  explicit WorkStealingDeque(std::size_t capacity)
+      : mask_(capacity - 1), buffer_(capacity) {
+    for (auto& item : buffer_) {
+      item.store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  // owner only, false when the deque is full
+  bool Push(T* item) {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    int64_t top = top_.load(std::memory_order_acquire);
+    if (bottom - top > static_cast<int64_t>(mask_)) {
+      return false;
+    }
+    buffer_[bottom & mask_].store(item, std::memory_order_relaxed);
+    bottom_.store(bottom + 1, std::memory_order_release);
+    return true;
+  }
+
+  // owner only, the latest item pushed
+  T* Pop() {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(bottom, std::memory_order_seq_cst);
+    int64_t top = top_.load(std::memory_order_seq_cst);
+    if (top > bottom) {
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    T* item = buffer_[bottom & mask_].load(std::memory_order_relaxed);
+    if (top == bottom) {
+      // the last item, thieves may race for it
+      if (!top_.compare_exchange_strong(top, top + 1,
+                                        std::memory_order_seq_cst,
+                                        std::memory_order_relaxed)) {
+        item = nullptr;
+      }
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return item;
+  }
+
+  // any thread, the oldest item, nullptr when empty or lost a race
+  T* Steal() {
+    int64_t top = top_.load(std::memory_order_seq_cst);
+    int64_t bottom = bottom_.load(std::memory_order_seq_cst);
+    if (top >= bottom) {
+      return nullptr;
+    }
+    T* item = buffer_[top & mask_].load(std::memory_order_relaxed);
+    if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return item;
+  }
+
+  bool Empty() const {
+    return top_.load(std::memory_order_relaxed) >=
+           bottom_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  alignas(CACHELINE_SIZE) std::atomic<int64_t> top_ = {0};
+  alignas(CACHELINE_SIZE) std::atomic<int64_t> bottom_ = {0};
+  const std::size_t mask_;
+  std::vector<std::atomic<T*>> buffer_;
+};
+
+class TaskGroup;
+
+/**
+ * @brief How TaskGroup::Wait gives way when it is called from a coroutine,
+ * whose processor thread must not block. The croutine library fills them
+ * in, cyber/base can't depend on it.
+ */
+struct CoroutineHooks {
+  // whether the calling thread runs a coroutine right now
+  bool (*in_routine)() = nullptr;
+  // lets the scheduler run other coroutines before coming back
+  void (*yield)() = nullptr;
+};
+
+inline CoroutineHooks* GetCoroutineHooks() {
+  static CoroutineHooks hooks;
+  return &hooks;
+}
+
+/**
+ * @class WorkStealingExecutor
+ * @brief Thread pool where every worker keeps its own deque. Tasks submitted
+ * by a worker stay on its deque, idle workers steal from the others, tasks
+ * from other threads go through a shared injection queue. Threads waiting
+ * for a TaskGroup run the queued tasks of that group meanwhile, so nested
+ * parallelism doesn't deadlock, but never the tasks of others, which may
+ * run for long. Tasks must not throw, except those of Submit whose
+ * exceptions end up in the future.
+ */
+class WorkStealingExecutor {
+ public:
+  static const std::size_t kDequeCapacity = 4096;
+
+  explicit WorkStealingExecutor(std::size_t thread_num);
+  // runs the tasks still queued, then joins the workers
+  virtual ~WorkStealingExecutor();
+
+  // a process wide executor with a worker per cpu
+  static WorkStealingExecutor* Default();
+
+  std::size_t thread_num() const { return workers_.size(); }
+
+  // e.g. to set the affinity and priority of the workers
+  void ForEachThread(const std::function<void(std::thread*)>& func);
+
+  template <typename F>
+  void Execute(F&& func) {
+    Schedule(std::forward<F>(func), nullptr);
+  }
+
+  template <typename F, typename... Args>
+  auto Submit(F&& func, Args&&... args)
+      -> std::future<typename std::result_of<F(Args...)>::type>;
+
+  /**
+   * @brief Calls func(i) for every i in [begin, end), split into chunks of
+   * grain indexes. A grain of 0 makes about 4 chunks per thread.
+   */
+  template <typename F>
+  void ParallelFor(std::size_t begin, std::size_t end, const F& func,
+                   std::size_t grain = 0);
+
+  /**
+   * @brief Folds [begin, end) chunk by chunk with map(chunk_begin, chunk_end,
+   * identity) and combines the chunk results with reduce in index order, so
+   * the result doesn't depend on the scheduling.
+   */
+  template <typename T, typename Map, typename Reduce>
+  T ParallelReduce(std::size_t begin, std::size_t end, const T& identity,
+                   const Map& map, const Reduce& reduce,
+                   std::size_t grain = 0);
+
+ private:
+  friend class TaskGroup;
+
+  struct TaskCache;
+
+  struct Task {
+    SmallTask func;
+    TaskGroup* group = nullptr;
+    TaskCache* cache = nullptr;
+    Task* next = nullptr;
+  };
+
+  // recycled tasks, freed by other threads they go back to returned_tasks
+  struct TaskCache {
+    std::vector<Task*> free_tasks;
+    std::atomic<Task*> returned_tasks = {nullptr};
+  };
+
+  struct Worker {
+    explicit Worker(WorkStealingExecutor* owner)
+        : executor(owner), deque(kDequeCapacity) {}
+    WorkStealingExecutor* executor;
+    WorkStealingDeque<Task> deque;
+    TaskCache cache;
+    uint64_t seed = 0;
+    std::thread thread;
+  };
+
+  static Worker*& CurrentWorker() {
+    static thread_local Worker* worker = nullptr;
+    return worker;
+  }
+
+  template <typename F>
+  void Schedule(F&& func, TaskGroup* group);
+  std::size_t ChunkSize(std::size_t num, std::size_t grain) const;
+  void Push(Task* task);
+  void Inject(Task* task);
+  void WakeOne();
+  Task* FindTask(Worker* worker);
+  Task* StealTask(uint64_t* seed, const Worker* self);
+  /**
+   * @brief Runs a queued task of the group on the calling thread, false if
+   * none was found. A worker looks at the bottom of its own deque, where the
+   * tasks it just added to the group are, and moves the tasks of others it
+   * finds there to the injection queue. The injection queue is searched too.
+   */
+  bool RunOneOf(const TaskGroup* group);
+  void Run(Task* task);
+  void WorkerLoop(Worker* worker);
+  Task* AllocTask();
+  void FreeTask(Task* task);
+  static Task* AllocFrom(TaskCache* cache);
+  static void DeleteTasks(TaskCache* cache);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  std::mutex injection_mutex_;
+  std::deque<Task*> injection_;
+  std::atomic<std::size_t> injection_num_ = {0};
+
+  std::mutex external_mutex_;
+  TaskCache external_cache_;
+  uint64_t external_seed_ = 0x9E3779B97F4A7C15ULL;
+
+  std::atomic<bool> stop_ = {false};
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_cv_;
+  std::atomic<uint64_t> epoch_ = {0};
+  std::atomic<std::size_t> sleeping_ = {0};
+};
+
+/**
+ * @class TaskGroup
+ * @brief Tasks run on an executor and waited for together. Wait() runs the
+ * queued tasks of the group on the calling thread, and blocks while the
+ * rest runs elsewhere. In a coroutine it yields to the scheduler instead of
+ * blocking.
+ */
+class TaskGroup {
+ public:
+  explicit TaskGroup(
+      WorkStealingExecutor* executor = WorkStealingExecutor::Default())
+      : executor_(executor) {}
+  virtual ~TaskGroup() { Wait(); }
+
+  template <typename F>
+  void Run(F&& func) {
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    executor_->Schedule(std::forward<F>(func), this);
+  }
+
+  void Wait() {
+    auto hooks = GetCoroutineHooks();
+    bool in_routine = hooks->in_routine != nullptr && hooks->in_routine();
+    while (pending_.load(std::memory_order_acquire) > 0) {
+      if (executor_->RunOneOf(this)) {
+        continue;
+      }
+      if (in_routine) {
+        hooks->yield();
+        continue;
+      }
+      // wakes up now and then for tasks added to the group meanwhile
+      std::unique_lock<std::mutex> lock(mutex_);
+      done_cv_.wait_for(lock, std::chrono::milliseconds(1), [this]() {
+        return pending_.load(std::memory_order_acquire) == 0;
+      });
+    }
+    // Done() may still hold the lock, the group must outlive it
+    std::lock_guard<std::mutex> lock(mutex_);
+  }
+
+ private:
+  friend class WorkStealingExecutor;
+
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  void Done() {
+    // the count drops under the lock, see the end of Wait()
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending_.fetch_sub(1, std::memory_order_release) == 1) {
+      done_cv_.notify_all();
+    }
+  }
+
+  WorkStealingExecutor* executor_;
+  std::atomic<std::size_t> pending_ = {0};
+  std::mutex mutex_;
+  std::condition_variable done_cv_;
+};
+
+inline WorkStealingExecutor::WorkStealingExecutor(std::size_t thread_num) {
+  thread_num = std::max<std::size_t>(thread_num, 1);
+  workers_.reserve(thread_num);
+  for (std::size_t i = 0; i < thread_num; ++i) {
+    workers_.emplace_back(new Worker(this));
+    workers_.back()->seed = (i + 1) * 0x9E3779B97F4A7C15ULL;
+  }
+  for (auto& worker : workers_) {
+    Worker* self = worker.get();
+    worker->thread = std::thread([this, self]() { WorkerLoop(self); });
+  }
+}
+
+inline WorkStealingExecutor::~WorkStealingExecutor() {
+  stop_.store(true);
+  epoch_.fetch_add(1);
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    sleep_cv_.notify_all();
+  }
+  for (auto& worker : workers_) {
+    if (worker->thread.joinable()) {
+      worker->thread.join();
+    }
+  }
+  for (auto& worker : workers_) {
+    DeleteTasks(&worker->cache);
+  }
+  DeleteTasks(&external_cache_);
+}
+
+inline WorkStealingExecutor* WorkStealingExecutor::Default() {
+  // never destroyed, tasks may still run while statics go away
+  static WorkStealingExecutor* executor =
+      new WorkStealingExecutor(std::thread::hardware_concurrency());
+  return executor;
+}
+
+inline void WorkStealingExecutor::ForEachThread(
+    const std::function<void(std::thread*)>& func) {
+  for (auto& worker : workers_) {
+    func(&worker->thread);
+  }
+}
+
+template <typename F, typename... Args>
+auto WorkStealingExecutor::Submit(F&& func, Args&&... args)
+    -> std::future<typename std::result_of<F(Args...)>::type> {
+  using return_type = typename std::result_of<F(Args...)>::type;
+  std::packaged_task<return_type()> task(
+      std::bind(std::forward<F>(func), std::forward<Args>(args)...));
+  std::future<return_type> res = task.get_future();
+  Schedule(std::move(task), nullptr);
+  return res;
+}
+
+template <typename F>
+void WorkStealingExecutor::ParallelFor(std::size_t begin, std::size_t end,
+                                       const F& func, std::size_t grain) {
+  if (begin >= end) {
+    return;
+  }
+  std::size_t chunk = ChunkSize(end - begin, grain);
+  TaskGroup group(this);
+  for (std::size_t first = begin + chunk; first < end; first += chunk) {
+    std::size_t last = std::min(first + chunk, end);
+    group.Run([&func, first, last]() {
+      for (std::size_t i = first; i < last; ++i) {
+        func(i);
+      }
+    });
+  }
+  // the calling thread takes the first chunk
+  for (std::size_t i = begin; i < std::min(begin + chunk, end); ++i) {
+    func(i);
+  }
+  group.Wait();
+}
+
+template <typename T, typename Map, typename Reduce>
+T WorkStealingExecutor::ParallelReduce(std::size_t begin, std::size_t end,
+                                       const T& identity, const Map& map,
+                                       const Reduce& reduce,
+                                       std::size_t grain) {
+  if (begin >= end) {
+    return identity;
+  }
+  std::size_t chunk = ChunkSize(end - begin, grain);
+  std::size_t chunk_num = (end - begin + chunk - 1) / chunk;
+  std::vector<T> results(chunk_num, identity);
+  ParallelFor(
+      0, chunk_num,
+      [&](std::size_t index) {
+        std::size_t first = begin + index * chunk;
+        results[index] = map(first, std::min(first + chunk, end), identity);
+      },
+      1);
+  T result = identity;
+  for (auto& value : results) {
+    result = reduce(result, value);
+  }
+  return result;
+}
+
+template <typename F>
+void WorkStealingExecutor::Schedule(F&& func, TaskGroup* group) {
+  Task* task = AllocTask();
+  task->func = SmallTask(std::forward<F>(func));
+  task->group = group;
+  Push(task);
+}
+
+inline std::size_t WorkStealingExecutor::ChunkSize(std::size_t num,
+                                                   std::size_t grain) const {
+  if (grain > 0) {
+    return grain;
+  }
+  std::size_t chunk_num = (workers_.size() + 1) * 4;
+  return std::max<std::size_t>((num + chunk_num - 1) / chunk_num, 1);
+}
+
+inline void WorkStealingExecutor::Push(Task* task) {
+  Worker* worker = CurrentWorker();
+  if (worker == nullptr || worker->executor != this ||
+      !worker->deque.Push(task)) {
+    Inject(task);
+    return;
+  }
+  WakeOne();
+}
+
+inline void WorkStealingExecutor::Inject(Task* task) {
+  {
+    std::lock_guard<std::mutex> lock(injection_mutex_);
+    injection_.emplace_back(task);
+    injection_num_.fetch_add(1);
+  }
+  WakeOne();
+}
+
+inline void WorkStealingExecutor::WakeOne() {
+  // pairs with the epoch check of an idle worker before it sleeps
+  epoch_.fetch_add(1);
+  if (sleeping_.load() > 0) {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    sleep_cv_.notify_one();
+  }
+}
+
+inline WorkStealingExecutor::Task* WorkStealingExecutor::FindTask(
+    Worker* worker) {
+  Task* task = worker->deque.Pop();
+  if (task != nullptr) {
+    return task;
+  }
+  if (injection_num_.load() > 0) {
+    std::lock_guard<std::mutex> lock(injection_mutex_);
+    if (!injection_.empty()) {
+      task = injection_.front();
+      injection_.pop_front();
+      injection_num_.fetch_sub(1);
+      return task;
+    }
+  }
+  return StealTask(&worker->seed, worker);
+}
+
+inline WorkStealingExecutor::Task* WorkStealingExecutor::StealTask(
+    uint64_t* seed, const Worker* self) {
+  // xorshift, a random first victim spreads the thieves
+  *seed ^= *seed << 13;
+  *seed ^= *seed >> 7;
+  *seed ^= *seed << 17;
+  std::size_t num = workers_.size();
+  std::size_t first = static_cast<std::size_t>(*seed % num);
+  for (std::size_t i = 0; i < num; ++i) {
+    Worker* victim = workers_[(first + i) % num].get();
+    if (victim == self) {
+      continue;
+    }
+    Task* task = victim->deque.Steal();
+    if (task != nullptr) {
+      return task;
+    }
+  }
+  return nullptr;
+}
+
+inline bool WorkStealingExecutor::RunOneOf(const TaskGroup* group) {
+  Task* task = nullptr;
+  Worker* worker = CurrentWorker();
+  if (worker != nullptr && worker->executor == this) {
+    while ((task = worker->deque.Pop()) != nullptr && task->group != group) {
+      // queued on top of the group, others run it instead
+      Inject(task);
+    }
+  }
+  if (task == nullptr && injection_num_.load() > 0) {
+    std::lock_guard<std::mutex> lock(injection_mutex_);
+    auto it = std::find_if(
+        injection_.begin(), injection_.end(),
+        [group](const Task* queued) { return queued->group == group; });
+    if (it != injection_.end()) {
+      task = *it;
+      injection_.erase(it);
+      injection_num_.fetch_sub(1);
+    }
+  }
+  if (task == nullptr) {
+    return false;
+  }
+  Run(task);
+  return true;
+}
+
+inline void WorkStealingExecutor::Run(Task* task) {
+  task->func();
+  auto group = task->group;
+  FreeTask(task);
+  if (group != nullptr) {
+    group->Done();
+  }
+}
+
+inline void WorkStealingExecutor::WorkerLoop(Worker* worker) {
+  CurrentWorker() = worker;
+  while (true) {
+    Task* task = FindTask(worker);
+    for (int i = 0; task == nullptr && i < 64; ++i) {
+      cpu_relax();
+      task = FindTask(worker);
+    }
+    if (task != nullptr) {
+      Run(task);
+      continue;
+    }
+
+    uint64_t epoch = epoch_.load();
+    task = FindTask(worker);
+    if (task != nullptr) {
+      Run(task);
+      continue;
+    }
+    // the own deque and the injection queue are empty, all is done
+    if (stop_.load()) {
+      break;
+    }
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    sleeping_.fetch_add(1);
+    sleep_cv_.wait(lock, [this, epoch]() {
+      return epoch_.load() != epoch || stop_.load();
+    });
+    sleeping_.fetch_sub(1);
+  }
+  CurrentWorker() = nullptr;
+}
+
+inline WorkStealingExecutor::Task* WorkStealingExecutor::AllocTask() {
+  Worker* worker = CurrentWorker();
+  if (worker != nullptr && worker->executor == this) {
+    return AllocFrom(&worker->cache);
+  }
+  std::lock_guard<std::mutex> lock(external_mutex_);
+  return AllocFrom(&external_cache_);
+}
+
+inline void WorkStealingExecutor::FreeTask(Task* task) {
+  task->func.Reset();
+  task->group = nullptr;
+  Worker* worker = CurrentWorker();
+  if (worker != nullptr && &worker->cache == task->cache) {
+    worker->cache.free_tasks.emplace_back(task);
+    return;
+  }
+  TaskCache* cache = task->cache;
+  Task* head = cache->returned_tasks.load(std::memory_order_relaxed);
+  do {
+    task->next = head;
+  } while (!cache->returned_tasks.compare_exchange_weak(
+      head, task, std::memory_order_release, std::memory_order_relaxed));
+}
+
+inline WorkStealingExecutor::Task* WorkStealingExecutor::AllocFrom(
+    TaskCache* cache) {
+  if (cache->free_tasks.empty()) {
+    Task* task =
+        cache->returned_tasks.exchange(nullptr, std::memory_order_acquire);
+    while (task != nullptr) {
+      cache->free_tasks.emplace_back(task);
+      task = task->next;
+    }
+  }
+  if (!cache->free_tasks.empty()) {
+    Task* task = cache->free_tasks.back();
+    cache->free_tasks.pop_back();
+    return task;
+  }
+  Task* task = new Task();
+  task->cache = cache;
+  return task;
+}
+
+inline void WorkStealingExecutor::DeleteTasks(TaskCache* cache) {
+  Task* task = cache->returned_tasks.exchange(nullptr);
+  while (task != nullptr) {
+    Task* next = task->next;
+    delete task;
+    task = next;
+  }
+  for (auto free_task : cache->free_tasks) {
+    delete free_task;
+  }
+  cache->free_tasks.clear();
+}
+
+}  // namespace base
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_BASE_WORK_STEALING_EXECUTOR_H_
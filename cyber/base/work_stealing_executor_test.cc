@@ -0,0 +1,307 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/base/work_stealing_executor.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cyber/base/thread_pool.h"
+
+namespace apollo {
+namespace cyber {
+namespace base {
+
+TEST(SmallTaskTest, storage) {
+  int calls = 0;
+  SmallTask small([&calls]() { ++calls; });
+  EXPECT_TRUE(small);
+  small();
+  SmallTask moved(std::move(small));
+  EXPECT_FALSE(small);
+  moved();
+  EXPECT_EQ(calls, 2);
+
+  // too large to be inline, lives on the heap
+  std::string big(1024, 'a');
+  std::array<char, 128> payload{};
+  auto owner = std::make_shared<int>(0);
+  SmallTask large([big, payload, owner]() { ++*owner; });
+  large();
+  SmallTask other;
+  other = std::move(large);
+  other();
+  EXPECT_EQ(*owner, 2);
+  other.Reset();
+  EXPECT_EQ(owner.use_count(), 1);
+}
+
+TEST(WorkStealingDequeTest, owner_and_thief) {
+  WorkStealingDeque<int> deque(4);
+  int values[5] = {0, 1, 2, 3, 4};
+  EXPECT_EQ(deque.Pop(), nullptr);
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(deque.Push(&values[i]));
+  }
+  EXPECT_FALSE(deque.Push(&values[4]));
+  EXPECT_EQ(deque.Steal(), &values[0]);
+  EXPECT_EQ(deque.Pop(), &values[3]);
+  EXPECT_EQ(deque.Pop(), &values[2]);
+  EXPECT_EQ(deque.Steal(), &values[1]);
+  EXPECT_EQ(deque.Steal(), nullptr);
+  EXPECT_TRUE(deque.Empty());
+}
+
+TEST(WorkStealingDequeTest, concurrent_steal) {
+  const int num = 100000;
+  WorkStealingDeque<int> deque(1024);
+  std::vector<int> values(num);
+  std::vector<std::atomic<int>> taken(num);
+  for (auto& count : taken) {
+    count.store(0);
+  }
+  std::atomic<bool> done = {false};
+  std::vector<std::thread> thieves;
+  for (int i = 0; i < 3; ++i) {
+    thieves.emplace_back([&]() {
+      while (!done.load() || !deque.Empty()) {
+        int* value = deque.Steal();
+        if (value != nullptr) {
+          taken[value - values.data()].fetch_add(1);
+        }
+      }
+    });
+  }
+  for (int i = 0; i < num; ++i) {
+    while (!deque.Push(&values[i])) {
+      int* value = deque.Pop();
+      if (value != nullptr) {
+        taken[value - values.data()].fetch_add(1);
+      }
+    }
+  }
+  int* value = nullptr;
+  while ((value = deque.Pop()) != nullptr) {
+    taken[value - values.data()].fetch_add(1);
+  }
+  done.store(true);
+  for (auto& thief : thieves) {
+    thief.join();
+  }
+  for (auto& count : taken) {
+    EXPECT_EQ(count.load(), 1);
+  }
+}
+
+TEST(WorkStealingExecutorTest, submit) {
+  WorkStealingExecutor executor(4);
+  EXPECT_EQ(executor.thread_num(), 4);
+  auto sum = executor.Submit([](int a, int b) { return a + b; }, 1, 2);
+  EXPECT_EQ(sum.get(), 3);
+
+  auto error = executor.Submit([]() -> int { throw std::runtime_error("x"); });
+  EXPECT_THROW(error.get(), std::runtime_error);
+
+  std::atomic<int> count = {0};
+  for (int i = 0; i < 1000; ++i) {
+    executor.Execute([&count]() { count.fetch_add(1); });
+  }
+  TaskGroup group(&executor);
+  group.Wait();
+  while (count.load() < 1000) {
+    std::this_thread::yield();
+  }
+}
+
+TEST(WorkStealingExecutorTest, nested_groups) {
+  WorkStealingExecutor executor(2);
+  std::atomic<int> count = {0};
+  TaskGroup outer(&executor);
+  for (int i = 0; i < 16; ++i) {
+    outer.Run([&executor, &count]() {
+      // waiting on a worker runs the inner tasks instead of blocking it
+      TaskGroup inner(&executor);
+      for (int j = 0; j < 16; ++j) {
+        inner.Run([&count]() { count.fetch_add(1); });
+      }
+      inner.Wait();
+    });
+  }
+  outer.Wait();
+  EXPECT_EQ(count.load(), 256);
+}
+
+namespace {
+thread_local bool in_routine = false;
+std::atomic<int> yields = {0};
+std::atomic<bool> release = {false};
+}  // namespace
+
+TEST(WorkStealingExecutorTest, wait_in_coroutine) {
+  auto hooks = GetCoroutineHooks();
+  CoroutineHooks saved = *hooks;
+  hooks->in_routine = []() { return in_routine; };
+  hooks->yield = []() {
+    yields.fetch_add(1);
+    release.store(true);
+  };
+
+  WorkStealingExecutor executor(1);
+  TaskGroup group(&executor);
+  std::atomic<bool> blocked = {false};
+  std::thread::id worker_task_thread;
+  executor.Execute([&]() {
+    // queued on the worker's own deque, out of the waiting thread's reach
+    group.Run([&]() { worker_task_thread = std::this_thread::get_id(); });
+    blocked.store(true);
+    while (!release.load()) {
+      std::this_thread::yield();
+    }
+  });
+  while (!blocked.load()) {
+    std::this_thread::yield();
+  }
+  auto other = executor.Submit([]() { return std::this_thread::get_id(); });
+  std::thread::id own_task_thread;
+  group.Run([&]() { own_task_thread = std::this_thread::get_id(); });
+
+  in_routine = true;
+  group.Wait();
+  in_routine = false;
+  *hooks = saved;
+
+  // the own task ran here, the other group's was left to the worker
+  EXPECT_EQ(own_task_thread, std::this_thread::get_id());
+  EXPECT_NE(worker_task_thread, std::this_thread::get_id());
+  EXPECT_GE(yields.load(), 1);
+  EXPECT_NE(other.get(), std::this_thread::get_id());
+}
+
+TEST(WorkStealingExecutorTest, wait_runs_own_tasks_only) {
+  WorkStealingExecutor executor(2);
+  std::atomic<bool> release = {false};
+  std::atomic<int> blocked = {0};
+  auto block = [&]() {
+    blocked.fetch_add(1);
+    while (!release.load()) {
+      std::this_thread::yield();
+    }
+  };
+  executor.Execute(block);
+  while (blocked.load() < 1) {
+    std::this_thread::yield();
+  }
+
+  // a worker waiting for its group moves the task queued on top of the
+  // group's out of the way instead of running it
+  std::atomic<bool> foreign_ran = {false};
+  bool foreign_ran_in_wait = true;
+  std::thread::id waiter;
+  std::thread::id own_thread;
+  executor
+      .Submit([&]() {
+        waiter = std::this_thread::get_id();
+        TaskGroup group(&executor);
+        group.Run([&]() { own_thread = std::this_thread::get_id(); });
+        executor.Execute([&]() { foreign_ran.store(true); });
+        group.Wait();
+        foreign_ran_in_wait = foreign_ran.load();
+      })
+      .get();
+  EXPECT_EQ(own_thread, waiter);
+  EXPECT_FALSE(foreign_ran_in_wait);
+  while (!foreign_ran.load()) {
+    std::this_thread::yield();
+  }
+
+  // with every worker busy, an outside waiter runs its own task only and
+  // then blocks instead of picking up the long running ones
+  executor.Execute(block);
+  while (blocked.load() < 2) {
+    std::this_thread::yield();
+  }
+  auto other = executor.Submit([]() { return std::this_thread::get_id(); });
+  std::thread::id group_thread;
+  {
+    TaskGroup group(&executor);
+    group.Run([&]() { group_thread = std::this_thread::get_id(); });
+    group.Wait();
+  }
+  EXPECT_EQ(group_thread, std::this_thread::get_id());
+  release.store(true);
+  EXPECT_NE(other.get(), std::this_thread::get_id());
+}
+
+TEST(WorkStealingExecutorTest, parallel_for_and_reduce) {
+  WorkStealingExecutor executor(4);
+  std::vector<int> values(10000, 0);
+  executor.ParallelFor(0, values.size(),
+                       [&values](std::size_t i) { values[i] = 1; });
+  for (auto value : values) {
+    EXPECT_EQ(value, 1);
+  }
+  executor.ParallelFor(5, 5, [&values](std::size_t i) { values[i] = 2; });
+
+  auto sum = executor.ParallelReduce(
+      0, 10001, static_cast<uint64_t>(0),
+      [](std::size_t begin, std::size_t end, uint64_t init) {
+        for (auto i = begin; i < end; ++i) {
+          init += i;
+        }
+        return init;
+      },
+      [](uint64_t a, uint64_t b) { return a + b; }, 7);
+  EXPECT_EQ(sum, 10000ULL * 10001 / 2);
+}
+
+TEST(WorkStealingExecutorTest, drain_on_destruction) {
+  std::atomic<int> count = {0};
+  {
+    WorkStealingExecutor executor(2);
+    for (int i = 0; i < 100; ++i) {
+      executor.Execute([&count]() {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        count.fetch_add(1);
+      });
+    }
+  }
+  EXPECT_EQ(count.load(), 100);
+}
+
+TEST(ThreadPoolTest, enqueue) {
+  ThreadPool pool(2);
+  std::vector<std::future<int>> results;
+  for (int i = 0; i < 100; ++i) {
+    results.emplace_back(pool.Enqueue([](int value) { return value; }, i));
+  }
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_TRUE(results[i].valid());
+    EXPECT_EQ(results[i].get(), i);
+  }
+}
+
+}  // namespace base
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,199 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Deserializes the same benchmark message over and over, once into messages
+// on the heap the way readers did so far and once into the recycled arenas of
+// an ArenaPool, and prints the cost per message of both.
+
+#include <getopt.h>
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "cyber/benchmark/benchmark_msg.pb.h"
+#include "cyber/common/log.h"
+#include "cyber/message/arena_pool.h"
+
+using apollo::cyber::benchmark::BenchmarkMsg;
+using apollo::cyber::message::ArenaPool;
+
+std::string BINARY_NAME = "cyber_arena_benchmark";  // NOLINT
+
+int message_size = 64 * 1024;
+int data_type = 2;
+int iterations = 10000;
+int queue_size = 1;
+
+void DisplayUsage() {
+  AINFO << "Usage: \n    " << BINARY_NAME << " [OPTION]...\n"
+        << "Description: \n"
+        << "    -h, --help: help information \n"
+        << "    -s, --message_size=message_size: serialized message size, "
+           "default value is 64K\n"
+        << "    -d, --data_type=data_type: message data type, 0 is bytes, 1 "
+           "is repeated field, 2 is repeated sub-messages, default value is "
+           "2\n"
+        << "    -n, --iterations=iterations: messages parsed per mode, "
+           "default value is 10000\n"
+        << "    -q, --queue_size=queue_size: messages kept alive at once, "
+           "like a reader queue, default value is 1\n"
+        << "Example:\n"
+        << "    " << BINARY_NAME << " -s 1M -d 2 -q 4\n";
+}
+
+void GetOptions(const int argc, char* const argv[]) {
+  opterr = 0;  // extern int opterr
+  int long_index = 0;
+  const std::string short_opts = "hs:d:n:q:";
+  static const struct option long_opts[] = {
+      {"help", no_argument, nullptr, 'h'},
+      {"message_size", required_argument, nullptr, 's'},
+      {"data_type", required_argument, nullptr, 'd'},
+      {"iterations", required_argument, nullptr, 'n'},
+      {"queue_size", required_argument, nullptr, 'q'},
+      {NULL, no_argument, nullptr, 0}};
+
+  do {
+    int opt =
+        getopt_long(argc, argv, short_opts.c_str(), long_opts, &long_index);
+    if (opt == -1) {
+      break;
+    }
+    int base_size = 1;
+    std::string arg;
+    switch (opt) {
+      case 's':
+        arg = std::string(optarg);
+        switch (arg[arg.length() - 1]) {
+          case 'K':
+            base_size = 1024;
+            break;
+          case 'M':
+            base_size = 1024 * 1024;
+            break;
+          default:
+            AERROR << "Invalid identifier. It should be 'K' or 'M'";
+            exit(-1);
+        }
+        message_size =
+            std::stoi(arg.substr(0, arg.length() - 1)) * base_size;
+        if (message_size <= 0) {
+          AERROR << "Invalid message size.";
+          exit(-1);
+        }
+        break;
+      case 'd':
+        data_type = std::stoi(std::string(optarg));
+        if (data_type < 0 || data_type > 2) {
+          AERROR << "Invalid data_type. It should be 0, 1 or 2";
+          exit(-1);
+        }
+        break;
+      case 'n':
+        iterations = std::stoi(std::string(optarg));
+        if (iterations <= 0) {
+          AERROR << "Invalid iterations. It should greater than 0";
+          exit(-1);
+        }
+        break;
+      case 'q':
+        queue_size = std::stoi(std::string(optarg));
+        if (queue_size <= 0) {
+          AERROR << "Invalid queue_size. It should greater than 0";
+          exit(-1);
+        }
+        break;
+      case 'h':
+        DisplayUsage();
+        exit(0);
+      default:
+        break;
+    }
+  } while (true);
+}
+
+std::string CreateSerializedMessage() {
+  BenchmarkMsg msg;
+  if (data_type == 0) {
+    msg.set_data_bytes(std::string(message_size, 'a'));
+  } else if (data_type == 1) {
+    for (int i = 0; i < message_size / 4; ++i) {
+      msg.add_data(i);
+    }
+  } else {
+    // an id and 8 values, about 80 bytes each
+    for (int i = 0; i < message_size / 80; ++i) {
+      auto item = msg.add_items();
+      item->set_id(i);
+      for (int j = 0; j < 8; ++j) {
+        item->add_values(i + j * 0.5);
+      }
+    }
+  }
+  std::string serialized;
+  msg.SerializeToString(&serialized);
+  return serialized;
+}
+
+double Measure(const std::string& serialized,
+               const std::function<std::shared_ptr<BenchmarkMsg>()>& create) {
+  std::deque<std::shared_ptr<BenchmarkMsg>> queue;
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    auto msg = create();
+    if (!msg->ParseFromString(serialized)) {
+      AERROR << "parse benchmark message failed";
+      exit(-1);
+    }
+    queue.emplace_back(std::move(msg));
+    if (static_cast<int>(queue.size()) > queue_size) {
+      queue.pop_front();
+    }
+  }
+  queue.clear();
+  auto end = std::chrono::steady_clock::now();
+  return static_cast<double>(
+             std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin)
+                 .count()) /
+         iterations;
+}
+
+int main(int argc, char** argv) {
+  GetOptions(argc, argv);
+
+  std::string serialized = CreateSerializedMessage();
+  // the arenas of the pool outlive the queue, a spare one is parsed into
+  // while the oldest message is still queued
+  auto pool = ArenaPool::Create(queue_size + 1);
+
+  double heap_ns =
+      Measure(serialized, [] { return std::make_shared<BenchmarkMsg>(); });
+  double arena_ns = Measure(
+      serialized, [&pool] { return pool->CreateMessage<BenchmarkMsg>(); });
+
+  std::cout << "message size: " << serialized.size()
+            << " bytes, data type: " << data_type
+            << ", queue size: " << queue_size << std::endl;
+  std::cout << "heap:  " << heap_ns / 1000.0 << " us per message" << std::endl;
+  std::cout << "arena: " << arena_ns / 1000.0 << " us per message"
+            << std::endl;
+  std::cout << "speedup: " << heap_ns / arena_ns << std::endl;
+  return 0;
+}
@@ -0,0 +1,720 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Sweeps message size, publish rate, reader count and transport mode over
+// the transport layer on one host, and prints one machine-readable result
+// per case: end-to-end latency percentiles, throughput and cpu per message.
+//
+// With -p every reader lives in a process of its own, forked before cyber is
+// initialized, so SHM, RTPS and HYBRID are measured across processes the way
+// components use them. INTRA cases are skipped in that mode.
+
+#include <getopt.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cyber/common/global_data.h"
+#include "cyber/common/log.h"
+#include "cyber/common/util.h"
+#include "cyber/init.h"
+#include "cyber/message/raw_message.h"
+#include "cyber/transport/transport.h"
+
+using apollo::cyber::common::GlobalData;
+using apollo::cyber::message::RawMessage;
+using apollo::cyber::proto::OptionalMode;
+using apollo::cyber::proto::RoleAttributes;
+using apollo::cyber::transport::MessageInfo;
+using apollo::cyber::transport::Receiver;
+using apollo::cyber::transport::Transmitter;
+using apollo::cyber::transport::Transport;
+
+namespace {
+
+const char BINARY_NAME[] = "cyber_transport_benchmark";
+const char kChannelPrefix[] = "/apollo/cyber/benchmark/transport/";
+// send timestamp and sequence number lead every payload
+const size_t kPayloadHeaderSize = 2 * sizeof(uint64_t);
+const uint64_t kMaxSamplesPerReader = 1000000;
+const uint32_t kQuitCommand = 0xFFFFFFFF;
+
+struct Options {
+  std::vector<uint64_t> sizes = {1024, 64 * 1024, 1024 * 1024,
+                                 8 * 1024 * 1024, 32 * 1024 * 1024};
+  std::vector<uint64_t> rates = {100, 1000};
+  std::vector<uint64_t> readers = {1};
+  std::vector<OptionalMode> modes = {OptionalMode::INTRA, OptionalMode::SHM,
+                                     OptionalMode::RTPS, OptionalMode::HYBRID};
+  uint64_t duration_s = 5;
+  bool multi_process = false;
+  std::string format = "json";
+  std::string output;
+};
+
+struct Case {
+  OptionalMode mode;
+  uint64_t msg_size;
+  // messages per second, 0 to publish as fast as possible
+  uint64_t rate;
+  uint64_t readers;
+};
+
+struct ReaderResult {
+  uint64_t received = 0;
+  uint64_t cpu_ns = 0;
+  std::vector<uint64_t> latencies;
+};
+
+struct ReaderStats {
+  std::atomic<uint64_t> received = {0};
+  std::vector<uint64_t> latencies;
+
+  explicit ReaderStats(uint64_t samples) : latencies(samples, 0) {}
+
+  void OnMessage(const std::shared_ptr<RawMessage>& msg) {
+    uint64_t now = NowNs();
+    if (msg->message.size() < kPayloadHeaderSize) {
+      return;
+    }
+    uint64_t send_ts = 0;
+    memcpy(&send_ts, msg->message.data(), sizeof(send_ts));
+    uint64_t index = received.fetch_add(1);
+    if (index < latencies.size()) {
+      latencies[index] = now - send_ts;
+    }
+  }
+
+  ReaderResult Result(uint64_t cpu_ns) {
+    ReaderResult result;
+    result.received = received.load();
+    result.cpu_ns = cpu_ns;
+    result.latencies.assign(
+        latencies.begin(),
+        latencies.begin() + std::min<uint64_t>(result.received,
+                                               latencies.size()));
+    return result;
+  }
+
+  // CLOCK_MONOTONIC is shared by all processes of the host
+  static uint64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+};
+
+struct ReaderProcess {
+  pid_t pid = -1;
+  int command_fd = -1;
+  int result_fd = -1;
+};
+
+std::string ModeName(OptionalMode mode) {
+  switch (mode) {
+    case OptionalMode::INTRA:
+      return "intra";
+    case OptionalMode::SHM:
+      return "shm";
+    case OptionalMode::RTPS:
+      return "rtps";
+    default:
+      return "hybrid";
+  }
+}
+
+uint64_t CpuTimeNs() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  auto to_ns = [](const struct timeval& tv) {
+    return static_cast<uint64_t>(tv.tv_sec) * 1000000000ULL +
+           static_cast<uint64_t>(tv.tv_usec) * 1000ULL;
+  };
+  return to_ns(usage.ru_utime) + to_ns(usage.ru_stime);
+}
+
+bool WriteAll(int fd, const void* data, size_t size) {
+  const char* p = static_cast<const char*>(data);
+  while (size > 0) {
+    ssize_t n = write(fd, p, size);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    p += n;
+    size -= n;
+  }
+  return true;
+}
+
+bool ReadAll(int fd, void* data, size_t size) {
+  char* p = static_cast<char*>(data);
+  while (size > 0) {
+    ssize_t n = read(fd, p, size);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    p += n;
+    size -= n;
+  }
+  return true;
+}
+
+std::string ChannelName(uint32_t case_index) {
+  return kChannelPrefix + std::to_string(case_index);
+}
+
+RoleAttributes MakeAttr(const std::string& channel, const std::string& role,
+                        int process_id) {
+  RoleAttributes attr;
+  attr.set_channel_name(channel);
+  attr.set_channel_id(GlobalData::RegisterChannel(channel));
+  attr.set_host_name(GlobalData::Instance()->HostName());
+  attr.set_host_ip(GlobalData::Instance()->HostIp());
+  attr.set_process_id(process_id);
+  // ids are derived from names so forked processes agree on them
+  attr.set_id(apollo::cyber::common::Hash(channel + "/" + role));
+  return attr;
+}
+
+uint64_t ExpectedMessages(const Case& c, const Options& opts) {
+  if (c.rate == 0) {
+    return kMaxSamplesPerReader;
+  }
+  return std::min(c.rate * opts.duration_s, kMaxSamplesPerReader);
+}
+
+std::shared_ptr<Receiver<RawMessage>> CreateReceiver(
+    const Case& c, const RoleAttributes& attr, const RoleAttributes& writer,
+    ReaderStats* stats) {
+  auto receiver = Transport::Instance()->CreateReceiver<RawMessage>(
+      attr,
+      [stats](const std::shared_ptr<RawMessage>& msg, const MessageInfo&,
+              const RoleAttributes&) { stats->OnMessage(msg); },
+      c.mode);
+  if (receiver != nullptr && c.mode == OptionalMode::HYBRID) {
+    receiver->Enable(writer);
+  }
+  return receiver;
+}
+
+// publishes for the duration of the case and returns the messages sent
+uint64_t Publish(const Case& c, const Options& opts,
+                 const std::shared_ptr<Transmitter<RawMessage>>& transmitter) {
+  std::string payload(std::max<uint64_t>(c.msg_size, kPayloadHeaderSize), 'x');
+  uint64_t max_msgs = ExpectedMessages(c, opts);
+  uint64_t begin = ReaderStats::NowNs();
+  uint64_t end = begin + opts.duration_s * 1000000000ULL;
+  uint64_t interval = c.rate == 0 ? 0 : 1000000000ULL / c.rate;
+  uint64_t seq = 0;
+  while (seq < max_msgs) {
+    uint64_t now = ReaderStats::NowNs();
+    if (now >= end) {
+      break;
+    }
+    if (interval > 0) {
+      uint64_t due = begin + seq * interval;
+      if (due > now) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(due - now));
+      }
+    }
+    now = ReaderStats::NowNs();
+    memcpy(&payload[0], &now, sizeof(now));
+    memcpy(&payload[sizeof(now)], &seq, sizeof(seq));
+    auto msg = std::make_shared<RawMessage>(payload);
+    transmitter->Transmit(msg);
+    ++seq;
+  }
+  return seq;
+}
+
+// waits until every reader got all messages or stopped making progress
+void Drain(const std::vector<std::unique_ptr<ReaderStats>>& stats,
+           uint64_t sent) {
+  uint64_t last = 0;
+  for (int idle = 0; idle < 10;) {
+    uint64_t total = 0;
+    bool done = true;
+    for (auto& s : stats) {
+      total += s->received.load();
+      done = done && s->received.load() >= sent;
+    }
+    if (done) {
+      return;
+    }
+    idle = total == last ? idle + 1 : 0;
+    last = total;
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+}
+
+void Report(const Case& c, const Options& opts, uint64_t sent,
+            double elapsed_s, uint64_t writer_cpu_ns,
+            const std::vector<ReaderResult>& results, std::ostream* out) {
+  std::vector<uint64_t> latencies;
+  uint64_t received = 0;
+  uint64_t reader_cpu_ns = 0;
+  for (auto& r : results) {
+    received += r.received;
+    reader_cpu_ns += r.cpu_ns;
+    latencies.insert(latencies.end(), r.latencies.begin(), r.latencies.end());
+  }
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&latencies](double q) -> double {
+    if (latencies.empty()) {
+      return 0.0;
+    }
+    size_t i = std::min(latencies.size() - 1,
+                        static_cast<size_t>(q * latencies.size()));
+    return static_cast<double>(latencies[i]) / 1000.0;
+  };
+  uint64_t expected = sent * c.readers;
+  double msgs_per_s = elapsed_s > 0 ? received / elapsed_s : 0.0;
+  double mb_per_s = msgs_per_s * c.msg_size / (1024.0 * 1024.0);
+  // in one process the writer cpu already covers the readers
+  double writer_cpu_us = sent ? writer_cpu_ns / 1000.0 / sent : 0.0;
+  double reader_cpu_us = received ? reader_cpu_ns / 1000.0 / received : 0.0;
+
+  std::ostringstream line;
+  if (opts.format == "csv") {
+    line << ModeName(c.mode) << "," << (opts.multi_process ? 1 : 0) << ","
+         << c.msg_size << "," << c.rate << "," << c.readers << "," << sent
+         << "," << received << "," << (expected - std::min(expected, received))
+         << "," << msgs_per_s << "," << mb_per_s << "," << percentile(0.5)
+         << "," << percentile(0.99) << "," << percentile(0.999) << ","
+         << (latencies.empty() ? 0.0 : latencies.back() / 1000.0) << ","
+         << writer_cpu_us << "," << reader_cpu_us;
+  } else {
+    line << "{\"mode\":\"" << ModeName(c.mode) << "\""
+         << ",\"multi_process\":" << (opts.multi_process ? "true" : "false")
+         << ",\"msg_size\":" << c.msg_size << ",\"rate\":" << c.rate
+         << ",\"readers\":" << c.readers << ",\"sent\":" << sent
+         << ",\"received\":" << received
+         << ",\"lost\":" << expected - std::min(expected, received)
+         << ",\"throughput_msgs_per_s\":" << msgs_per_s
+         << ",\"throughput_mb_per_s\":" << mb_per_s
+         << ",\"latency_us\":{\"p50\":" << percentile(0.5)
+         << ",\"p99\":" << percentile(0.99)
+         << ",\"p999\":" << percentile(0.999) << ",\"max\":"
+         << (latencies.empty() ? 0.0 : latencies.back() / 1000.0) << "}"
+         << ",\"cpu_us_per_msg\":{\"writer\":" << writer_cpu_us
+         << ",\"reader\":" << reader_cpu_us << "}}";
+  }
+  *out << line.str() << std::endl;
+}
+
+void RunReaderProcess(const std::vector<Case>& cases, const Options& opts,
+                      uint32_t reader_index, int command_fd, int result_fd) {
+  apollo::cyber::Init(BINARY_NAME);
+  uint32_t case_index = 0;
+  while (ReadAll(command_fd, &case_index, sizeof(case_index)) &&
+         case_index != kQuitCommand) {
+    const Case& c = cases[case_index];
+    auto channel = ChannelName(case_index);
+    auto attr = MakeAttr(channel, "reader" + std::to_string(reader_index),
+                         GlobalData::Instance()->ProcessId());
+    auto writer = MakeAttr(channel, "writer", getppid());
+    ReaderStats stats(ExpectedMessages(c, opts));
+    auto receiver = CreateReceiver(c, attr, writer, &stats);
+    char ready = receiver != nullptr ? 1 : 0;
+    WriteAll(result_fd, &ready, sizeof(ready));
+
+    uint32_t stop = 0;
+    uint64_t cpu_begin = CpuTimeNs();
+    ReadAll(command_fd, &stop, sizeof(stop));
+    uint64_t cpu_ns = CpuTimeNs() - cpu_begin;
+    if (receiver != nullptr) {
+      receiver->Disable();
+    }
+    auto result = stats.Result(cpu_ns);
+    uint64_t samples = result.latencies.size();
+    WriteAll(result_fd, &result.received, sizeof(result.received));
+    WriteAll(result_fd, &result.cpu_ns, sizeof(result.cpu_ns));
+    WriteAll(result_fd, &samples, sizeof(samples));
+    WriteAll(result_fd, result.latencies.data(),
+             samples * sizeof(uint64_t));
+  }
+  Transport::Instance()->Shutdown();
+  apollo::cyber::Clear();
+}
+
+bool RunCase(uint32_t case_index, const Case& c, const Options& opts,
+             const std::vector<ReaderProcess>& procs, std::ostream* out) {
+  auto channel = ChannelName(case_index);
+  auto writer_attr =
+      MakeAttr(channel, "writer", GlobalData::Instance()->ProcessId());
+  auto transmitter = Transport::Instance()->CreateTransmitter<RawMessage>(
+      writer_attr, c.mode);
+  if (transmitter == nullptr) {
+    AERROR << "create transmitter failed, mode: " << ModeName(c.mode);
+    return false;
+  }
+
+  std::vector<std::unique_ptr<ReaderStats>> stats;
+  std::vector<std::shared_ptr<Receiver<RawMessage>>> receivers;
+  for (uint64_t i = 0; i < c.readers; ++i) {
+    int pid = opts.multi_process ? procs[i].pid
+                                 : GlobalData::Instance()->ProcessId();
+    auto reader_attr = MakeAttr(channel, "reader" + std::to_string(i), pid);
+    if (c.mode == OptionalMode::HYBRID) {
+      transmitter->Enable(reader_attr);
+    }
+    if (opts.multi_process) {
+      char ready = 0;
+      if (!WriteAll(procs[i].command_fd, &case_index, sizeof(case_index)) ||
+          !ReadAll(procs[i].result_fd, &ready, sizeof(ready)) || !ready) {
+        AERROR << "reader process #" << i << " is not ready.";
+        return false;
+      }
+      continue;
+    }
+    stats.emplace_back(new ReaderStats(ExpectedMessages(c, opts)));
+    receivers.emplace_back(
+        CreateReceiver(c, reader_attr, writer_attr, stats.back().get()));
+  }
+  // let discovery and the first mappings settle before timing anything
+  std::this_thread::sleep_for(std::chrono::seconds(1));
+
+  uint64_t cpu_begin = CpuTimeNs();
+  auto begin = std::chrono::steady_clock::now();
+  uint64_t sent = Publish(c, opts, transmitter);
+  double elapsed_s = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - begin)
+                         .count();
+  if (!opts.multi_process) {
+    Drain(stats, sent);
+  } else {
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+  }
+  uint64_t writer_cpu_ns = CpuTimeNs() - cpu_begin;
+
+  std::vector<ReaderResult> results;
+  if (opts.multi_process) {
+    for (uint64_t i = 0; i < c.readers; ++i) {
+      uint32_t stop = 0;
+      ReaderResult result;
+      uint64_t samples = 0;
+      if (!WriteAll(procs[i].command_fd, &stop, sizeof(stop)) ||
+          !ReadAll(procs[i].result_fd, &result.received,
+                   sizeof(result.received)) ||
+          !ReadAll(procs[i].result_fd, &result.cpu_ns,
+                   sizeof(result.cpu_ns)) ||
+          !ReadAll(procs[i].result_fd, &samples, sizeof(samples))) {
+        AERROR << "lost reader process #" << i;
+        return false;
+      }
+      result.latencies.resize(samples);
+      if (!ReadAll(procs[i].result_fd, result.latencies.data(),
+                   samples * sizeof(uint64_t))) {
+        AERROR << "lost reader process #" << i;
+        return false;
+      }
+      results.emplace_back(std::move(result));
+    }
+  } else {
+    for (auto& receiver : receivers) {
+      if (receiver != nullptr) {
+        receiver->Disable();
+      }
+    }
+    for (auto& s : stats) {
+      results.emplace_back(s->Result(0));
+    }
+  }
+  transmitter->Disable();
+
+  Report(c, opts, sent, elapsed_s, writer_cpu_ns, results, out);
+  return true;
+}
+
+bool ParseList(const std::string& arg, std::vector<std::string>* items) {
+  items->clear();
+  std::stringstream ss(arg);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (!item.empty()) {
+      items->emplace_back(item);
+    }
+  }
+  return !items->empty();
+}
+
+bool ParseSize(const std::string& arg, uint64_t* size) {
+  uint64_t base = 1;
+  std::string number = arg;
+  switch (arg.back()) {
+    case 'K':
+      base = 1024;
+      number.pop_back();
+      break;
+    case 'M':
+      base = 1024 * 1024;
+      number.pop_back();
+      break;
+    case 'B':
+      number.pop_back();
+      break;
+    default:
+      break;
+  }
+  try {
+    *size = std::stoull(number) * base;
+  } catch (const std::exception& e) {
+    return false;
+  }
+  return true;
+}
+
+bool ParseNumbers(const std::string& arg, bool with_unit,
+                  std::vector<uint64_t>* numbers) {
+  std::vector<std::string> items;
+  if (!ParseList(arg, &items)) {
+    return false;
+  }
+  numbers->clear();
+  for (auto& item : items) {
+    uint64_t value = 0;
+    if (with_unit) {
+      if (!ParseSize(item, &value)) {
+        return false;
+      }
+    } else {
+      try {
+        value = std::stoull(item);
+      } catch (const std::exception& e) {
+        return false;
+      }
+    }
+    numbers->emplace_back(value);
+  }
+  return true;
+}
+
+bool ParseModes(const std::string& arg, std::vector<OptionalMode>* modes) {
+  std::vector<std::string> items;
+  if (!ParseList(arg, &items)) {
+    return false;
+  }
+  modes->clear();
+  for (auto& item : items) {
+    if (item == "intra") {
+      modes->emplace_back(OptionalMode::INTRA);
+    } else if (item == "shm") {
+      modes->emplace_back(OptionalMode::SHM);
+    } else if (item == "rtps") {
+      modes->emplace_back(OptionalMode::RTPS);
+    } else if (item == "hybrid") {
+      modes->emplace_back(OptionalMode::HYBRID);
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+void DisplayUsage() {
+  std::cout
+      << "Usage: \n    " << BINARY_NAME << " [OPTION]...\n"
+      << "Description: \n"
+      << "    -h, --help: help information\n"
+      << "    -s, --sizes=1K,64K,1M,8M,32M: message sizes to sweep\n"
+      << "    -r, --rates=100,1000: publish rates in Hz to sweep, 0 "
+         "publishes as fast as possible\n"
+      << "    -n, --readers=1: reader counts to sweep\n"
+      << "    -m, --modes=intra,shm,rtps,hybrid: transport modes to sweep\n"
+      << "    -T, --time=5: seconds to publish per case\n"
+      << "    -p, --multi_process: run every reader in a process of its own\n"
+      << "    -f, --format=json: json (one object per line) or csv\n"
+      << "    -o, --output=file: write results to file instead of stdout\n"
+      << "Example:\n"
+      << "    " << BINARY_NAME << " -s 1K,1M -r 100 -n 1,4 -m shm,hybrid -p\n";
+}
+
+bool GetOptions(int argc, char* argv[], Options* opts) {
+  const std::string short_opts = "hs:r:n:m:T:pf:o:";
+  static const struct option long_opts[] = {
+      {"help", no_argument, nullptr, 'h'},
+      {"sizes", required_argument, nullptr, 's'},
+      {"rates", required_argument, nullptr, 'r'},
+      {"readers", required_argument, nullptr, 'n'},
+      {"modes", required_argument, nullptr, 'm'},
+      {"time", required_argument, nullptr, 'T'},
+      {"multi_process", no_argument, nullptr, 'p'},
+      {"format", required_argument, nullptr, 'f'},
+      {"output", required_argument, nullptr, 'o'},
+      {nullptr, no_argument, nullptr, 0}};
+  int long_index = 0;
+  while (true) {
+    int opt =
+        getopt_long(argc, argv, short_opts.c_str(), long_opts, &long_index);
+    if (opt == -1) {
+      break;
+    }
+    bool ok = true;
+    std::vector<uint64_t> durations;
+    switch (opt) {
+      case 's':
+        ok = ParseNumbers(optarg, true, &opts->sizes);
+        break;
+      case 'r':
+        ok = ParseNumbers(optarg, false, &opts->rates);
+        break;
+      case 'n':
+        ok = ParseNumbers(optarg, false, &opts->readers);
+        break;
+      case 'm':
+        ok = ParseModes(optarg, &opts->modes);
+        break;
+      case 'T':
+        ok = ParseNumbers(optarg, false, &durations) && durations[0] > 0;
+        if (ok) {
+          opts->duration_s = durations[0];
+        }
+        break;
+      case 'p':
+        opts->multi_process = true;
+        break;
+      case 'f':
+        opts->format = optarg;
+        ok = opts->format == "json" || opts->format == "csv";
+        break;
+      case 'o':
+        opts->output = optarg;
+        break;
+      case 'h':
+        DisplayUsage();
+        exit(0);
+      default:
+        ok = false;
+        break;
+    }
+    if (!ok) {
+      std::cerr << "Invalid argument for -" << static_cast<char>(opt)
+                << std::endl;
+      DisplayUsage();
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<Case> MakeCases(const Options& opts) {
+  std::vector<Case> cases;
+  for (auto mode : opts.modes) {
+    if (opts.multi_process && mode == OptionalMode::INTRA) {
+      std::cerr << "intra can not cross processes, skipped." << std::endl;
+      continue;
+    }
+    for (auto size : opts.sizes) {
+      for (auto rate : opts.rates) {
+        for (auto readers : opts.readers) {
+          if (readers == 0) {
+            continue;
+          }
+          cases.push_back({mode, size, rate, readers});
+        }
+      }
+    }
+  }
+  return cases;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  Options opts;
+  if (!GetOptions(argc, argv, &opts)) {
+    return -1;
+  }
+  auto cases = MakeCases(opts);
+
+  // readers are forked before cyber starts any thread
+  std::vector<ReaderProcess> procs;
+  if (opts.multi_process) {
+    uint64_t max_readers =
+        *std::max_element(opts.readers.begin(), opts.readers.end());
+    for (uint32_t i = 0; i < max_readers; ++i) {
+      int command_pipe[2];
+      int result_pipe[2];
+      if (pipe(command_pipe) != 0 || pipe(result_pipe) != 0) {
+        std::cerr << "pipe failed, errno: " << errno << std::endl;
+        return -1;
+      }
+      pid_t pid = fork();
+      if (pid == 0) {
+        close(command_pipe[1]);
+        close(result_pipe[0]);
+        RunReaderProcess(cases, opts, i, command_pipe[0], result_pipe[1]);
+        _exit(0);
+      }
+      close(command_pipe[0]);
+      close(result_pipe[1]);
+      procs.push_back({pid, command_pipe[1], result_pipe[0]});
+    }
+  }
+
+  apollo::cyber::Init(argv[0]);
+  std::ofstream file;
+  std::ostream* out = &std::cout;
+  if (!opts.output.empty()) {
+    file.open(opts.output);
+    out = &file;
+  }
+  if (opts.format == "csv") {
+    *out << "mode,multi_process,msg_size,rate,readers,sent,received,lost,"
+            "throughput_msgs_per_s,throughput_mb_per_s,latency_p50_us,"
+            "latency_p99_us,latency_p999_us,latency_max_us,"
+            "writer_cpu_us_per_msg,reader_cpu_us_per_msg"
+         << std::endl;
+  }
+
+  int ret = 0;
+  for (uint32_t i = 0; i < cases.size(); ++i) {
+    if (!RunCase(i, cases[i], opts, procs, out)) {
+      ret = -1;
+      break;
+    }
+  }
+
+  for (auto& proc : procs) {
+    WriteAll(proc.command_fd, &kQuitCommand, sizeof(kQuitCommand));
+    close(proc.command_fd);
+    close(proc.result_fd);
+    waitpid(proc.pid, nullptr, 0);
+  }
+  Transport::Instance()->Shutdown();
+  apollo::cyber::Clear();
+  return ret;
+}
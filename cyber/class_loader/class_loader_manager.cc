@@ -25,18 +25,24 @@ ClassLoaderManager::~ClassLoaderManager() {}
 
 ClassLoader* ClassLoaderManager::GetClassLoaderByLibPath(
     const std::string& library_path) {
-  return libpath_loader_map_[library_path];
+  std::lock_guard<std::mutex> lck(libpath_loader_map_mutex_);
+  auto it = libpath_loader_map_.find(library_path);
+  return it == libpath_loader_map_.end() ? nullptr : it->second;
 }
 
 std::vector<ClassLoader*> ClassLoaderManager::GetAllValidClassLoaders() {
+  std::lock_guard<std::mutex> lck(libpath_loader_map_mutex_);
   std::vector<ClassLoader*> class_loaders;
   for (auto& lib_class_loader : libpath_loader_map_) {
-    class_loaders.emplace_back(lib_class_loader.second);
+    if (lib_class_loader.second != nullptr) {
+      class_loaders.emplace_back(lib_class_loader.second);
+    }
   }
   return class_loaders;
 }
 
 std::vector<std::string> ClassLoaderManager::GetAllValidLibPath() {
+  std::lock_guard<std::mutex> lck(libpath_loader_map_mutex_);
   std::vector<std::string> libpath;
   for (auto& lib_class_loader : libpath_loader_map_) {
     if (lib_class_loader.second != nullptr) {
@@ -47,27 +53,28 @@ std::vector<std::string> ClassLoaderManager::GetAllValidLibPath() {
 }
 
 bool ClassLoaderManager::IsLibraryValid(const std::string& library_name) {
-  std::vector<std::string> valid_libraries = GetAllValidLibPath();
-  return (valid_libraries.end() != std::find(valid_libraries.begin(),
-                                             valid_libraries.end(),
-                                             library_name));
+  return GetClassLoaderByLibPath(library_name) != nullptr;
 }
 
 bool ClassLoaderManager::LoadLibrary(const std::string& library_path) {
+  // libraries may load while components of others are created, see the
+  // parallel init of the mainboard
   std::lock_guard<std::mutex> lck(libpath_loader_map_mutex_);
-  if (!IsLibraryValid(library_path)) {
-    libpath_loader_map_[library_path] =
-        new class_loader::ClassLoader(library_path);
+  auto& class_loader = libpath_loader_map_[library_path];
+  if (class_loader == nullptr) {
+    class_loader = new class_loader::ClassLoader(library_path);
   }
-  return IsLibraryValid(library_path);
+  return true;
 }
 
 int ClassLoaderManager::UnloadLibrary(const std::string& library_path) {
+  std::lock_guard<std::mutex> lck(libpath_loader_map_mutex_);
   int num_remain_unload = 0;
-  if (IsLibraryValid(library_path)) {
-    ClassLoader* class_loader = GetClassLoaderByLibPath(library_path);
+  auto it = libpath_loader_map_.find(library_path);
+  if (it != libpath_loader_map_.end() && it->second != nullptr) {
+    ClassLoader* class_loader = it->second;
     if ((num_remain_unload = class_loader->UnloadLibrary()) == 0) {
-      libpath_loader_map_[library_path] = nullptr;
+      it->second = nullptr;
       delete class_loader;
     }
   }
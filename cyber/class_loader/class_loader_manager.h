@@ -113,6 +113,7 @@ std::vector<std::string> ClassLoaderManager::GetValidClassNames() {
 template <typename Base>
 std::string ClassLoaderManager::GetClassValidLibrary(
     const std::string& class_name) {
+  std::lock_guard<std::mutex> lck(libpath_loader_map_mutex_);
   for (auto& lib_class_loader : libpath_loader_map_) {
     if (lib_class_loader.second != nullptr) {
       if (lib_class_loader.second->IsClassValid<Base>(class_name)) {
@@ -0,0 +1,166 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_COMPONENT_BATCH_COMPONENT_H_
+#define CYBER_COMPONENT_BATCH_COMPONENT_H_
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "cyber/base/macros.h"
+#include "cyber/common/global_data.h"
+#include "cyber/component/component_base.h"
+#include "cyber/croutine/routine_factory.h"
+#include "cyber/data/data_visitor.h"
+#include "cyber/scheduler/scheduler.h"
+#include "cyber/statistics/statistics.h"
+#include "cyber/time/time.h"
+
+namespace apollo {
+namespace cyber {
+
+/**
+ * @brief .
+ * BatchComponent processes the messages of one channel in batches. Every
+ * message queued since the last run, up to the pending queue size of the
+ * reader, is handed to Proc(...) at once, so a high rate channel costs one
+ * wakeup per batch instead of one per message. Your component can inherit
+ * from BatchComponent, and implement Init() & Proc(...), They are picked up
+ * by the CyberRT.
+ *
+ * @tparam M0 the message of the channel.
+ */
+template <typename M0>
+class BatchComponent : public ComponentBase {
+ public:
+  BatchComponent() {}
+  ~BatchComponent() override {}
+
+  /**
+   * @brief init the component by protobuf object.
+   *
+   * @param config which is defined in 'cyber/proto/component_conf.proto'
+   *
+   * @return returns true if successful, otherwise returns false
+   */
+  bool Initialize(const ComponentConfig& config) override;
+  bool Process(const std::vector<std::shared_ptr<M0>>& msgs);
+
+ private:
+  /**
+   * @brief The process logical of yours.
+   *
+   * @param msgs the messages received since the last call, oldest first.
+   *
+   * @return returns true if successful, otherwise returns false
+   */
+  virtual bool Proc(const std::vector<std::shared_ptr<M0>>& msgs) = 0;
+};
+
+template <typename M0>
+bool BatchComponent<M0>::Process(const std::vector<std::shared_ptr<M0>>& msgs) {
+  if (is_shutdown_.load()) {
+    return true;
+  }
+  return Proc(msgs);
+}
+
+template <typename M0>
+bool BatchComponent<M0>::Initialize(const ComponentConfig& config) {
+  node_.reset(new Node(config.name()));
+  LoadConfigFiles(config);
+
+  if (config.readers_size() != 1) {
+    AERROR << "Invalid config file: batch component reads one channel.";
+    return false;
+  }
+
+  if (!Init()) {
+    AERROR << "Component Init() failed.";
+    return false;
+  }
+
+  bool is_reality_mode = common::GlobalData::Instance()->IsRealityMode();
+
+  ReaderConfig reader_cfg;
+  reader_cfg.channel_name = config.readers(0).channel();
+  reader_cfg.qos_profile.CopyFrom(config.readers(0).qos_profile());
+  reader_cfg.pending_queue_size = config.readers(0).pending_queue_size();
+
+  auto role_attr = std::make_shared<proto::RoleAttributes>();
+  role_attr->set_node_name(config.name());
+  role_attr->set_channel_name(config.readers(0).channel());
+
+  std::weak_ptr<BatchComponent<M0>> self =
+      std::dynamic_pointer_cast<BatchComponent<M0>>(shared_from_this());
+  auto func = [self, role_attr](const std::vector<std::shared_ptr<M0>>& msgs) {
+    auto start_time = Time::Now().ToMicrosecond();
+    auto ptr = self.lock();
+    if (ptr) {
+      ptr->Process(msgs);
+    } else {
+      AERROR << "Component object has been destroyed.";
+    }
+    auto end_time = Time::Now().ToMicrosecond();
+    // sampling proc latency of the whole batch in microsecond
+    uint64_t process_start_time;
+    statistics::Statistics::Instance()->SamplingProcLatency<uint64_t>(
+        *role_attr, end_time - start_time);
+    if (statistics::Statistics::Instance()->GetProcStatus(
+            *role_attr, &process_start_time) &&
+        (start_time - process_start_time) > 0) {
+      statistics::Statistics::Instance()->SamplingCyberLatency(
+          *role_attr, start_time - process_start_time);
+    }
+  };
+
+  std::shared_ptr<Reader<M0>> reader = nullptr;
+
+  if (cyber_likely(is_reality_mode)) {
+    reader = node_->CreateReader<M0>(reader_cfg);
+  } else {
+    // messages are delivered one by one here, each is a batch of its own
+    reader = node_->CreateReader<M0>(
+        reader_cfg, [func](const std::shared_ptr<M0>& msg) {
+          func(std::vector<std::shared_ptr<M0>>{msg});
+        });
+  }
+
+  if (reader == nullptr) {
+    AERROR << "Component create reader failed.";
+    return false;
+  }
+  readers_.emplace_back(std::move(reader));
+
+  if (cyber_unlikely(!is_reality_mode)) {
+    return true;
+  }
+
+  data::VisitorConfig conf = {readers_[0]->ChannelId(),
+                              readers_[0]->PendingQueueSize(), true};
+  auto dv = std::make_shared<data::DataVisitor<M0>>(conf);
+  croutine::RoutineFactory factory =
+      croutine::CreateBatchRoutineFactory<M0>(func, dv);
+  ConfigureTask(config);
+  auto sched = scheduler::Instance();
+  return sched->CreateTask(factory, node_->Name());
+}
+
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_COMPONENT_BATCH_COMPONENT_H_
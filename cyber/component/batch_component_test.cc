@@ -0,0 +1,149 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/component/batch_component.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cyber/init.h"
+#include "cyber/message/raw_message.h"
+#include "cyber/node/node.h"
+
+namespace apollo {
+namespace cyber {
+
+using apollo::cyber::message::RawMessage;
+using apollo::cyber::proto::ComponentConfig;
+
+static bool ret_proc = true;
+static bool ret_init = true;
+
+class Component_Batch : public BatchComponent<RawMessage> {
+ public:
+  Component_Batch() {}
+  bool Init() { return ret_init; }
+  size_t received() const { return received_; }
+
+ private:
+  bool Proc(const std::vector<std::shared_ptr<RawMessage>>& msgs) {
+    received_ += msgs.size();
+    return ret_proc;
+  }
+
+  size_t received_ = 0;
+};
+
+class Component_BatchCount : public BatchComponent<RawMessage> {
+ public:
+  bool Init() { return true; }
+
+  std::atomic<size_t> received = {0};
+  std::atomic<size_t> proc_calls = {0};
+  std::atomic<size_t> max_batch = {0};
+  // the first Proc(...) waits for this, so the rest queue up behind it
+  std::atomic<bool> release = {false};
+
+ private:
+  bool Proc(const std::vector<std::shared_ptr<RawMessage>>& msgs) {
+    while (proc_calls.load() == 0 && !release.load()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ++proc_calls;
+    if (msgs.size() > max_batch.load()) {
+      max_batch.store(msgs.size());
+    }
+    received += msgs.size();
+    return true;
+  }
+};
+
+TEST(BatchComponent, init) {
+  ret_proc = true;
+  ret_init = true;
+  cyber::Init("batch component test");
+  ComponentConfig compcfg;
+  compcfg.set_name("imu_batch");
+  auto reader = compcfg.add_readers();
+  reader->set_channel("/imu");
+  reader->set_pending_queue_size(20);
+
+  auto com = std::make_shared<Component_Batch>();
+  EXPECT_TRUE(com->Initialize(compcfg));
+  std::vector<std::shared_ptr<RawMessage>> msgs = {
+      std::make_shared<RawMessage>(), std::make_shared<RawMessage>()};
+  EXPECT_TRUE(com->Process(msgs));
+  EXPECT_EQ(2, com->received());
+}
+
+TEST(BatchComponent, batches_from_writer) {
+  cyber::Init("batch component test");
+  ComponentConfig compcfg;
+  compcfg.set_name("imu_batch_count");
+  auto reader = compcfg.add_readers();
+  reader->set_channel("/imu_batch");
+  reader->set_pending_queue_size(20);
+
+  auto com = std::make_shared<Component_BatchCount>();
+  ASSERT_TRUE(com->Initialize(compcfg));
+  auto node = CreateNode("batch_component_writer");
+  ASSERT_TRUE(node);
+  auto writer = node->CreateWriter<RawMessage>("/imu_batch");
+  ASSERT_TRUE(writer);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  // the first message wakes the routine, which holds it in Proc(...)
+  const size_t msg_num = 10;
+  ASSERT_TRUE(writer->Write(std::make_shared<RawMessage>("0")));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  for (size_t i = 1; i < msg_num; ++i) {
+    ASSERT_TRUE(writer->Write(std::make_shared<RawMessage>("msg")));
+  }
+  com->release.store(true);
+
+  for (int i = 0; i < 100 && com->received.load() < msg_num; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(msg_num, com->received.load());
+  EXPECT_LT(com->proc_calls.load(), msg_num);
+  EXPECT_GT(com->max_batch.load(), 1);
+}
+
+TEST(BatchComponent, fail) {
+  ret_proc = false;
+  ret_init = false;
+  cyber::Init("batch component test");
+  ComponentConfig compcfg;
+  compcfg.set_name("imu_batch_fail");
+  auto com = std::make_shared<Component_Batch>();
+  // a batch component reads exactly one channel
+  EXPECT_FALSE(com->Initialize(compcfg));
+  compcfg.add_readers()->set_channel("/imu");
+  compcfg.add_readers()->set_channel("/chassis");
+  EXPECT_FALSE(com->Initialize(compcfg));
+
+  compcfg.mutable_readers()->RemoveLast();
+  EXPECT_FALSE(com->Initialize(compcfg));
+  EXPECT_FALSE(com->Process({std::make_shared<RawMessage>()}));
+}
+
+}  // namespace cyber
+}  // namespace apollo
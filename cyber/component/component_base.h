@@ -29,6 +29,7 @@
 #include "cyber/class_loader/class_loader.h"
 #include "cyber/common/environment.h"
 #include "cyber/common/file.h"
+#include "cyber/data/fusion/data_fusion.h"
 #include "cyber/node/node.h"
 #include "cyber/scheduler/scheduler.h"
 
@@ -115,9 +116,34 @@ class ComponentBase : public std::enable_shared_from_this<ComponentBase> {
     }
   }
 
+  // Components that need more or less than the default 2MB croutine stack
+  // call this from their constructor; see StackPool for the usage report.
+  void SetStackSize(size_t stack_size) { stack_size_ = stack_size; }
+
+  // How the readers of a multi-channel component are joined, also meant to
+  // be called from the constructor. Defaults to FusionPolicy::ALL_LATEST.
+  void SetFusionConfig(const data::fusion::FusionConfig& fusion_config) {
+    fusion_config_ = fusion_config;
+  }
+
+  // The qos mps of the trigger reader is the period the dag expects, so the
+  // component is due before its next message arrives.
+  void ConfigureTask(const ComponentConfig& config) {
+    if (config.readers_size() > 0 &&
+        config.readers(0).qos_profile().mps() > 0) {
+      scheduler::Instance()->SetTaskDeadline(
+          config.name(), 1000000 / config.readers(0).qos_profile().mps());
+    }
+    if (stack_size_ > 0) {
+      scheduler::Instance()->SetTaskStackSize(config.name(), stack_size_);
+    }
+  }
+
   std::atomic<bool> is_shutdown_ = {false};
   std::shared_ptr<Node> node_ = nullptr;
   std::string config_file_path_ = "";
+  size_t stack_size_ = 0;
+  data::fusion::FusionConfig fusion_config_;
   std::vector<std::shared_ptr<ReaderBase>> readers_;
 };
 
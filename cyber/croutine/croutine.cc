@@ -17,9 +17,11 @@
 #include "cyber/croutine/croutine.h"
 
 #include <algorithm>
+#include <new>
 #include <utility>
 
 #include "cyber/base/concurrent_object_pool.h"
+#include "cyber/base/work_stealing_executor.h"
 #include "cyber/common/global_data.h"
 #include "cyber/common/log.h"
 #include "cyber/croutine/detail/routine_context.h"
@@ -40,9 +42,22 @@ void CRoutineEntry(void *arg) {
   r->Run();
   CRoutine::Yield(RoutineState::FINISHED);
 }
+
+bool InRoutine() { return CRoutine::GetCurrentRoutine() != nullptr; }
+
+void YieldRoutine() { CRoutine::Yield(); }
+
+// TaskGroup::Wait in a coroutine yields through the scheduler
+const bool kCoroutineHooksSet = []() {
+  auto hooks = base::GetCoroutineHooks();
+  hooks->in_routine = &InRoutine;
+  hooks->yield = &YieldRoutine;
+  return true;
+}();
 }  // namespace
 
-CRoutine::CRoutine(const std::function<void()> &func) : func_(func) {
+CRoutine::CRoutine(const std::function<void()> &func, size_t stack_size)
+    : func_(func) {
   std::call_once(pool_init_flag, [&]() {
     uint32_t routine_num = common::GlobalData::Instance()->ComponentNums();
     auto &global_conf = common::GlobalData::Instance()->Config();
@@ -61,12 +76,22 @@ CRoutine::CRoutine(const std::function<void()> &func) : func_(func) {
     context_.reset(new RoutineContext());
   }
 
+  context_->stack_size = stack_size;
+  context_->stack = StackPool::Instance()->Acquire(&context_->stack_size);
+  if (context_->stack == nullptr) {
+    throw std::bad_alloc();
+  }
   MakeContext(CRoutineEntry, this, context_.get());
   state_ = RoutineState::READY;
   updated_.test_and_set(std::memory_order_release);
 }
 
-CRoutine::~CRoutine() { context_ = nullptr; }
+CRoutine::~CRoutine() {
+  // the context goes back to its pool, the stack to StackPool
+  StackPool::Instance()->Release(context_->stack, context_->stack_size);
+  context_->stack = nullptr;
+  context_ = nullptr;
+}
 
 RoutineState CRoutine::Resume() {
   if (cyber_unlikely(force_stop_)) {
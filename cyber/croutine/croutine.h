@@ -27,6 +27,7 @@
 
 #include "cyber/common/log.h"
 #include "cyber/croutine/detail/routine_context.h"
+#include "cyber/croutine/detail/stack_pool.h"
 
 namespace apollo {
 namespace cyber {
@@ -39,7 +40,7 @@ enum class RoutineState { READY, FINISHED, SLEEP, IO_WAIT, DATA_WAIT };
 
 class CRoutine {
  public:
-  explicit CRoutine(const RoutineFunc &func);
+  explicit CRoutine(const RoutineFunc &func, size_t stack_size = STACK_SIZE);
   virtual ~CRoutine();
 
   // static interfaces
@@ -57,6 +58,11 @@ class CRoutine {
   // SetUpdateFlag().
   void SetUpdateFlag();
 
+  // a croutine sits in the lock-free ready queues at most once. SetQueued()
+  // returns false if it is queued already, ClearQueued() when it is popped
+  bool SetQueued();
+  void ClearQueued();
+
   // acquire && release should be called before Resume
   // when work-steal like mechanism used
   RoutineState Resume();
@@ -66,10 +72,14 @@ class CRoutine {
 
   void Run();
   void Stop();
+  bool IsStopped() const;
   void Wake();
   void HangUp();
   void Sleep(const Duration &sleep_duration);
 
+  // deepest the stack has been used so far, in bytes
+  size_t StackHighWaterMark() const;
+
   // getter and setter
   RoutineState state() const;
   void set_state(const RoutineState &state);
@@ -88,6 +98,8 @@ class CRoutine {
 
   std::chrono::steady_clock::time_point wake_time() const;
 
+  size_t stack_size() const { return context_->stack_size; }
+
   void set_group_name(const std::string &group_name) {
     group_name_ = group_name;
   }
@@ -109,8 +121,9 @@ class CRoutine {
 
   std::atomic_flag lock_ = ATOMIC_FLAG_INIT;
   std::atomic_flag updated_ = ATOMIC_FLAG_INIT;
+  std::atomic<bool> queued_ = {false};
 
-  bool force_stop_ = false;
+  std::atomic<bool> force_stop_ = {false};
 
   int processor_id_ = -1;
   uint32_t priority_ = 0;
@@ -165,7 +178,15 @@ inline void CRoutine::set_id(uint64_t id) { id_ = id; }
 
 inline const std::string &CRoutine::name() const { return name_; }
 
-inline void CRoutine::set_name(const std::string &name) { name_ = name; }
+inline void CRoutine::set_name(const std::string &name) {
+  name_ = name;
+  StackPool::Instance()->SetOwner(context_->stack, name);
+}
+
+inline size_t CRoutine::StackHighWaterMark() const {
+  return StackPool::Instance()->HighWaterMark(context_->stack,
+                                              context_->stack_size);
+}
 
 inline int CRoutine::processor_id() const { return processor_id_; }
 
@@ -206,6 +227,16 @@ inline void CRoutine::SetUpdateFlag() {
   updated_.clear(std::memory_order_release);
 }
 
+inline bool CRoutine::SetQueued() {
+  return !queued_.exchange(true, std::memory_order_acq_rel);
+}
+
+inline void CRoutine::ClearQueued() {
+  queued_.exchange(false, std::memory_order_acq_rel);
+}
+
+inline bool CRoutine::IsStopped() const { return force_stop_.load(); }
+
 }  // namespace croutine
 }  // namespace cyber
 }  // namespace apollo
@@ -31,6 +31,7 @@ namespace apollo {
 namespace cyber {
 namespace croutine {
 
+// default size, a croutine may ask for another one, see StackPool
 constexpr size_t STACK_SIZE = 2 * 1024 * 1024;
 #if defined __aarch64__
 constexpr size_t REGISTERS_SIZE = 160;
@@ -40,7 +41,8 @@ constexpr size_t REGISTERS_SIZE = 56;
 
 typedef void (*func)(void*);
 struct RoutineContext {
-  char stack[STACK_SIZE];
+  char* stack = nullptr;
+  size_t stack_size = 0;
   char* sp = nullptr;
 #if defined __aarch64__
 } __attribute__((aligned(16)));
@@ -0,0 +1,173 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/croutine/detail/stack_pool.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace croutine {
+
+StackPool::StackPool() {}
+
+StackPool::~StackPool() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& ele : free_stacks_) {
+    for (auto stack : ele.second) {
+      munmap(stack - PageSize(), ele.first + PageSize());
+    }
+  }
+  free_stacks_.clear();
+}
+
+size_t StackPool::PageSize() {
+  static const size_t page_size = sysconf(_SC_PAGESIZE);
+  return page_size;
+}
+
+char* StackPool::Acquire(size_t* size) {
+  const size_t page_size = PageSize();
+  *size = std::max((*size + page_size - 1) / page_size, size_t(1)) * page_size;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = free_stacks_.find(*size);
+    if (it != free_stacks_.end() && !it->second.empty()) {
+      char* stack = it->second.back();
+      it->second.pop_back();
+      --free_stack_num_;
+      live_stacks_[stack].size = *size;
+      return stack;
+    }
+  }
+
+  // MAP_NORESERVE: nothing is committed until the coroutine touches it
+  void* addr = mmap(nullptr, *size + page_size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK,
+                    -1, 0);
+  if (addr == MAP_FAILED) {
+    AERROR << "mmap coroutine stack of " << *size
+           << " bytes failed: " << std::strerror(errno);
+    return nullptr;
+  }
+  // stacks grow down, the guard page sits at the lowest address
+  if (mprotect(addr, page_size, PROT_NONE) != 0) {
+    AERROR << "mprotect stack guard page failed: " << std::strerror(errno);
+    munmap(addr, *size + page_size);
+    return nullptr;
+  }
+
+  char* stack = static_cast<char*>(addr) + page_size;
+  std::lock_guard<std::mutex> lock(mutex_);
+  live_stacks_[stack].size = *size;
+  return stack;
+}
+
+void StackPool::Release(char* stack, size_t size) {
+  if (stack == nullptr) {
+    return;
+  }
+  size_t hwm = HighWaterMark(stack, size);
+  // the next owner starts from untouched, uncommitted pages
+  madvise(stack, size, MADV_DONTNEED);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = live_stacks_.find(stack);
+  if (it != live_stacks_.end()) {
+    RecordUsage(it->second.owner, size, hwm);
+    live_stacks_.erase(it);
+  }
+  if (free_stack_num_ >= kMaxFreeStackNum) {
+    munmap(stack - PageSize(), size + PageSize());
+    return;
+  }
+  free_stacks_[size].emplace_back(stack);
+  ++free_stack_num_;
+}
+
+void StackPool::SetOwner(char* stack, const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = live_stacks_.find(stack);
+  if (it != live_stacks_.end()) {
+    it->second.owner = name;
+  }
+}
+
+size_t StackPool::HighWaterMark(char* stack, size_t size) const {
+  const size_t page_size = PageSize();
+  const size_t page_num = size / page_size;
+  std::vector<unsigned char> resident(page_num);
+  if (mincore(stack, size, resident.data()) != 0) {
+    AWARN << "mincore failed: " << std::strerror(errno);
+    return 0;
+  }
+  for (size_t i = 0; i < page_num; ++i) {
+    if (resident[i] & 1) {
+      return size - i * page_size;
+    }
+  }
+  return 0;
+}
+
+std::vector<StackUsage> StackPool::Usage() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto usage = usage_;
+  for (auto& ele : live_stacks_) {
+    auto hwm = HighWaterMark(ele.first, ele.second.size);
+    auto& entry = usage[ele.second.owner];
+    entry.name = ele.second.owner;
+    entry.stack_size = ele.second.size;
+    entry.high_water_mark = std::max(entry.high_water_mark, hwm);
+  }
+
+  std::vector<StackUsage> result;
+  for (auto& ele : usage) {
+    result.emplace_back(ele.second);
+  }
+  return result;
+}
+
+void StackPool::LogUsage() {
+  for (auto& usage : Usage()) {
+    AINFO << "croutine stack " << (usage.name.empty() ? "-" : usage.name)
+          << ": " << usage.high_water_mark / 1024 << "KB of "
+          << usage.stack_size / 1024 << "KB used";
+  }
+}
+
+size_t StackPool::FreeStackNum() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return free_stack_num_;
+}
+
+void StackPool::RecordUsage(const std::string& owner, size_t size,
+                            size_t hwm) {
+  auto& entry = usage_[owner];
+  entry.name = owner;
+  entry.stack_size = size;
+  entry.high_water_mark = std::max(entry.high_water_mark, hwm);
+}
+
+}  // namespace croutine
+}  // namespace cyber
+}  // namespace apollo
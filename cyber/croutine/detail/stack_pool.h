@@ -0,0 +1,95 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_CROUTINE_DETAIL_STACK_POOL_H_
+#define CYBER_CROUTINE_DETAIL_STACK_POOL_H_
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cyber/common/macros.h"
+
+namespace apollo {
+namespace cyber {
+namespace croutine {
+
+struct StackUsage {
+  std::string name;
+  size_t stack_size = 0;
+  // deepest use seen so far, in bytes
+  size_t high_water_mark = 0;
+};
+
+/**
+ * Coroutine stacks mapped with mmap. Every stack has a PROT_NONE guard page
+ * below it, so an overflow faults instead of corrupting the neighbour, and
+ * pages are only committed once the coroutine touches them. Released stacks
+ * give their pages back to the kernel and are kept per size for reuse.
+ *
+ * The high water mark is the depth of the lowest resident page, so it needs
+ * no stack painting; it can overestimate by up to a page and misses pages
+ * that were swapped out.
+ */
+class StackPool {
+ public:
+  ~StackPool();
+
+  // size is rounded up to whole pages; nullptr if the mapping failed
+  char* Acquire(size_t* size);
+  void Release(char* stack, size_t size);
+
+  // name the stack is reported under
+  void SetOwner(char* stack, const std::string& name);
+
+  size_t HighWaterMark(char* stack, size_t size) const;
+
+  // peak usage per owner, live stacks included, sorted by name
+  std::vector<StackUsage> Usage();
+  void LogUsage();
+
+  size_t FreeStackNum();
+
+  static size_t PageSize();
+
+ private:
+  struct LiveStack {
+    size_t size = 0;
+    std::string owner;
+  };
+
+  void RecordUsage(const std::string& owner, size_t size, size_t hwm);
+
+  std::mutex mutex_;
+  // key: stack size, value: stacks ready for reuse
+  std::map<size_t, std::vector<char*>> free_stacks_;
+  size_t free_stack_num_ = 0;
+  std::unordered_map<char*, LiveStack> live_stacks_;
+  std::map<std::string, StackUsage> usage_;
+
+  const size_t kMaxFreeStackNum = 1024;
+
+  DECLARE_SINGLETON(StackPool)
+};
+
+}  // namespace croutine
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_CROUTINE_DETAIL_STACK_POOL_H_
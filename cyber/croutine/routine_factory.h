@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "cyber/common/global_data.h"
 #include "cyber/common/log.h"
@@ -69,6 +70,31 @@ RoutineFactory CreateRoutineFactory(
   return factory;
 }
 
+// runs f once per wakeup with every message queued since the last run, the
+// visitor must be created with batch enabled
+template <typename M0, typename F>
+RoutineFactory CreateBatchRoutineFactory(
+    F&& f, const std::shared_ptr<data::DataVisitor<M0>>& dv) {
+  RoutineFactory factory;
+  factory.SetDataVisitor(dv);
+  factory.create_routine = [=]() {
+    return [=]() {
+      std::vector<std::shared_ptr<M0>> msgs;
+      for (;;) {
+        CRoutine::GetCurrentRoutine()->set_state(RoutineState::DATA_WAIT);
+        if (dv->TryFetchAll(&msgs)) {
+          f(msgs);
+          msgs.clear();
+          CRoutine::Yield(RoutineState::READY);
+        } else {
+          CRoutine::Yield();
+        }
+      }
+    };
+  };
+  return factory;
+}
+
 template <typename M0, typename M1, typename F>
 RoutineFactory CreateRoutineFactory(
     F&& f, const std::shared_ptr<data::DataVisitor<M0, M1>>& dv) {
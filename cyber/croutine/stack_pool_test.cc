@@ -0,0 +1,123 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/croutine/detail/stack_pool.h"
+
+#include <cstring>
+#include <memory>
+
+#include "gtest/gtest.h"
+
+#include "cyber/croutine/croutine.h"
+#include "cyber/cyber.h"
+
+namespace apollo {
+namespace cyber {
+namespace croutine {
+
+namespace {
+
+void UseStack() {
+  volatile char buf[32 * 1024];
+  for (size_t i = 0; i < sizeof(buf); ++i) {
+    buf[i] = 1;
+  }
+  CRoutine::Yield(RoutineState::DATA_WAIT);
+}
+
+}  // namespace
+
+TEST(StackPoolTest, acquire_release) {
+  auto pool = StackPool::Instance();
+  const size_t page_size = StackPool::PageSize();
+
+  size_t size = 3 * page_size + 1;
+  char* stack = pool->Acquire(&size);
+  ASSERT_NE(nullptr, stack);
+  EXPECT_EQ(4 * page_size, size);
+
+  auto free_num = pool->FreeStackNum();
+  pool->Release(stack, size);
+  EXPECT_EQ(free_num + 1, pool->FreeStackNum());
+
+  // a stack of the same size is reused
+  size_t same = 4 * page_size;
+  EXPECT_EQ(stack, pool->Acquire(&same));
+  EXPECT_EQ(free_num, pool->FreeStackNum());
+  pool->Release(stack, same);
+}
+
+TEST(StackPoolTest, lazy_commit) {
+  auto pool = StackPool::Instance();
+  size_t size = 1024 * 1024;
+  char* stack = pool->Acquire(&size);
+  ASSERT_NE(nullptr, stack);
+  EXPECT_EQ(0, pool->HighWaterMark(stack, size));
+
+  // stacks grow down from the top
+  std::memset(stack + size - 64 * 1024, 1, 64 * 1024);
+  EXPECT_EQ(64 * 1024, pool->HighWaterMark(stack, size));
+
+  // released pages are given back, the next owner starts clean
+  pool->Release(stack, size);
+  char* reused = pool->Acquire(&size);
+  EXPECT_EQ(stack, reused);
+  EXPECT_EQ(0, pool->HighWaterMark(reused, size));
+  EXPECT_EQ(0, reused[size - 1]);
+  pool->Release(reused, size);
+}
+
+TEST(StackPoolTest, guard_page) {
+  auto pool = StackPool::Instance();
+  size_t size = 64 * 1024;
+  char* stack = pool->Acquire(&size);
+  ASSERT_NE(nullptr, stack);
+  EXPECT_DEATH(*(reinterpret_cast<volatile char*>(stack) - 1) = 1, "");
+  pool->Release(stack, size);
+}
+
+TEST(StackPoolTest, croutine_stack) {
+  apollo::cyber::Init("stack_pool_test");
+  auto pool = StackPool::Instance();
+
+  auto cr = std::make_shared<CRoutine>(UseStack, 128 * 1024);
+  cr->set_name("stack_pool_test");
+  EXPECT_EQ(128 * 1024, cr->stack_size());
+  EXPECT_LT(cr->StackHighWaterMark(), 32 * 1024);
+
+  cr->Resume();
+  EXPECT_EQ(RoutineState::DATA_WAIT, cr->state());
+  auto hwm = cr->StackHighWaterMark();
+  EXPECT_GE(hwm, 32 * 1024);
+  EXPECT_LE(hwm, 128 * 1024);
+
+  // the peak outlives the croutine
+  cr->Stop();
+  cr = nullptr;
+  bool found = false;
+  for (auto& usage : pool->Usage()) {
+    if (usage.name == "stack_pool_test") {
+      found = true;
+      EXPECT_EQ(128 * 1024, usage.stack_size);
+      EXPECT_EQ(hwm, usage.high_water_mark);
+    }
+  }
+  EXPECT_TRUE(found);
+}
+
+}  // namespace croutine
+}  // namespace cyber
+}  // namespace apollo
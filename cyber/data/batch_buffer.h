@@ -0,0 +1,119 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_DATA_BATCH_BUFFER_H_
+#define CYBER_DATA_BATCH_BUFFER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "cyber/base/macros.h"
+
+namespace apollo {
+namespace cyber {
+namespace data {
+
+/**
+ * @brief A ring keeping the latest `size` values for one consumer, which
+ * takes everything filled since its last fetch without a lock.
+ *
+ * Fill must not run concurrently with itself, the dispatcher already fills
+ * under the mutex of the CacheBuffer. When the ring is full the oldest value
+ * is dropped, like the CacheBuffer does.
+ */
+template <typename T>
+class BatchBuffer {
+ public:
+  explicit BatchBuffer(uint64_t size)
+      : capacity_(size > 0 ? size : 1), slots_(new Slot[capacity_]) {
+    for (uint64_t i = 0; i < capacity_; ++i) {
+      slots_[i].free_at.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  // returns true if the oldest value was dropped to make room
+  bool Fill(const T& value) {
+    bool dropped = false;
+    uint64_t pos = tail_.load(std::memory_order_relaxed);
+    Slot& slot = slots_[pos % capacity_];
+    if (slot.free_at.load(std::memory_order_acquire) != pos) {
+      uint64_t oldest = pos - capacity_;
+      if (head_.compare_exchange_strong(oldest, oldest + 1,
+                                        std::memory_order_acq_rel)) {
+        dropped = true;
+      } else {
+        // the consumer took the oldest value and is moving it out
+        while (slot.free_at.load(std::memory_order_acquire) != pos) {
+          cpu_relax();
+        }
+      }
+    }
+    slot.value = value;
+    tail_.store(pos + 1, std::memory_order_release);
+    return dropped;
+  }
+
+  // appends the values filled since the last call, oldest first
+  bool FetchAll(std::vector<T>* values) {
+    bool fetched = false;
+    uint64_t head = head_.load(std::memory_order_acquire);
+    while (head < tail_.load(std::memory_order_acquire)) {
+      // Fill may drop the value under us, claim it before reading
+      if (!head_.compare_exchange_weak(head, head + 1,
+                                       std::memory_order_acq_rel)) {
+        continue;
+      }
+      Slot& slot = slots_[head % capacity_];
+      values->emplace_back(std::move(slot.value));
+      slot.value = T();
+      slot.free_at.store(head + capacity_, std::memory_order_release);
+      fetched = true;
+      ++head;
+    }
+    return fetched;
+  }
+
+  uint64_t Size() const {
+    return tail_.load(std::memory_order_acquire) -
+           head_.load(std::memory_order_acquire);
+  }
+  bool Empty() const { return Size() == 0; }
+  uint64_t Capacity() const { return capacity_; }
+
+ private:
+  struct Slot {
+    // the position whose value may be written here next
+    std::atomic<uint64_t> free_at = {0};
+    T value;
+  };
+
+  BatchBuffer(const BatchBuffer&) = delete;
+  BatchBuffer& operator=(const BatchBuffer&) = delete;
+
+  const uint64_t capacity_;
+  std::unique_ptr<Slot[]> slots_;
+  alignas(CACHELINE_SIZE) std::atomic<uint64_t> head_ = {0};
+  alignas(CACHELINE_SIZE) std::atomic<uint64_t> tail_ = {0};
+};
+
+}  // namespace data
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_DATA_BATCH_BUFFER_H_
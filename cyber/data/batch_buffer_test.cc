@@ -0,0 +1,95 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/data/batch_buffer.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace data {
+
+TEST(BatchBufferTest, fill_and_fetch) {
+  BatchBuffer<int> buffer(4);
+  std::vector<int> values;
+  EXPECT_TRUE(buffer.Empty());
+  EXPECT_FALSE(buffer.FetchAll(&values));
+
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_FALSE(buffer.Fill(i));
+  }
+  EXPECT_EQ(3, buffer.Size());
+  EXPECT_TRUE(buffer.FetchAll(&values));
+  EXPECT_EQ(std::vector<int>({0, 1, 2}), values);
+  EXPECT_TRUE(buffer.Empty());
+
+  // the oldest values are dropped once full
+  values.clear();
+  for (int i = 3; i < 7; ++i) {
+    EXPECT_FALSE(buffer.Fill(i));
+  }
+  EXPECT_TRUE(buffer.Fill(7));
+  EXPECT_TRUE(buffer.Fill(8));
+  EXPECT_EQ(4, buffer.Size());
+  EXPECT_TRUE(buffer.FetchAll(&values));
+  EXPECT_EQ(std::vector<int>({5, 6, 7, 8}), values);
+}
+
+TEST(BatchBufferTest, releases_fetched_values) {
+  BatchBuffer<std::shared_ptr<int>> buffer(2);
+  auto msg = std::make_shared<int>(1);
+  buffer.Fill(msg);
+  EXPECT_EQ(2, msg.use_count());
+  std::vector<std::shared_ptr<int>> msgs;
+  EXPECT_TRUE(buffer.FetchAll(&msgs));
+  msgs.clear();
+  EXPECT_EQ(1, msg.use_count());
+}
+
+TEST(BatchBufferTest, concurrent_fill_and_fetch) {
+  const int num = 200000;
+  BatchBuffer<int> buffer(16);
+  std::atomic<bool> done = {false};
+  std::thread producer([&]() {
+    for (int i = 1; i <= num; ++i) {
+      buffer.Fill(i);
+    }
+    done.store(true);
+  });
+
+  // whatever is dropped, the rest arrives in order and ends with the last
+  int last = 0;
+  std::vector<int> values;
+  while (!done.load() || !buffer.Empty()) {
+    values.clear();
+    buffer.FetchAll(&values);
+    for (auto value : values) {
+      EXPECT_GT(value, last);
+      last = value;
+    }
+  }
+  producer.join();
+  EXPECT_EQ(num, last);
+}
+
+}  // namespace data
+}  // namespace cyber
+}  // namespace apollo
@@ -22,6 +22,8 @@
 #include <mutex>
 #include <vector>
 
+#include "cyber/data/batch_buffer.h"
+
 namespace apollo {
 namespace cyber {
 namespace data {
@@ -65,19 +67,32 @@ class CacheBuffer {
     fusion_callback_ = callback;
   }
 
-  void Fill(const T& value) {
+  // values filled from now on are also kept for a batch consumer, call it
+  // before the buffer is handed to the dispatcher
+  void EnableBatch() {
+    batch_buffer_ = std::make_shared<BatchBuffer<T>>(capacity_ - 1);
+  }
+  BatchBuffer<T>* Batch() const { return batch_buffer_.get(); }
+
+  // returns true if the oldest value was dropped to make room
+  bool Fill(const T& value) {
     if (fusion_callback_) {
       fusion_callback_(value);
     } else {
+      if (batch_buffer_) {
+        batch_buffer_->Fill(value);
+      }
       if (Full()) {
         buffer_[GetIndex(head_)] = value;
         ++head_;
         ++tail_;
+        return true;
       } else {
         buffer_[GetIndex(tail_ + 1)] = value;
         ++tail_;
       }
     }
+    return false;
   }
 
   std::mutex& Mutex() { return mutex_; }
@@ -92,6 +107,7 @@ class CacheBuffer {
   std::vector<T> buffer_;
   mutable std::mutex mutex_;
   FusionCallback fusion_callback_;
+  std::shared_ptr<BatchBuffer<T>> batch_buffer_;
 };
 
 }  // namespace data
@@ -45,6 +45,10 @@ class ChannelBuffer {
 
   bool FetchMulti(uint64_t fetch_size, std::vector<std::shared_ptr<T>>* vec);
 
+  // takes every message filled since the last call without locking, the
+  // buffer must have batch enabled
+  bool FetchAll(std::vector<std::shared_ptr<T>>* vec);
+
   uint64_t channel_id() const { return channel_id_; }
   std::shared_ptr<BufferType> Buffer() const { return buffer_; }
 
@@ -104,6 +108,17 @@ bool ChannelBuffer<T>::FetchMulti(uint64_t fetch_size,
   return true;
 }
 
+template <typename T>
+bool ChannelBuffer<T>::FetchAll(std::vector<std::shared_ptr<T>>* vec) {
+  auto batch = buffer_->Batch();
+  if (batch == nullptr) {
+    AERROR << "channel[" << GlobalData::GetChannelById(channel_id_) << "] "
+           << "buffer is not enabled for batch fetch";
+    return false;
+  }
+  return batch->FetchAll(vec);
+}
+
 }  // namespace data
 }  // namespace cyber
 }  // namespace apollo
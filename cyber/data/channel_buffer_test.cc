@@ -98,6 +98,35 @@ TEST(ChannelBufferTest, FetchMulti) {
   EXPECT_EQ(2, *vector[1]);
 }
 
+TEST(ChannelBufferTest, FetchAll) {
+  auto cache_buffer = new CacheBuffer<std::shared_ptr<int>>(2);
+  auto buffer = std::make_shared<ChannelBuffer<int>>(channel0, cache_buffer);
+  std::vector<std::shared_ptr<int>> vector;
+  EXPECT_FALSE(buffer->FetchAll(&vector));
+
+  buffer->Buffer()->EnableBatch();
+  EXPECT_FALSE(buffer->FetchAll(&vector));
+  buffer->Buffer()->Fill(std::make_shared<int>(1));
+  EXPECT_TRUE(buffer->FetchAll(&vector));
+  EXPECT_EQ(1, vector.size());
+  EXPECT_EQ(1, *vector[0]);
+  EXPECT_FALSE(buffer->FetchAll(&vector));
+
+  vector.clear();
+  buffer->Buffer()->Fill(std::make_shared<int>(2));
+  buffer->Buffer()->Fill(std::make_shared<int>(3));
+  buffer->Buffer()->Fill(std::make_shared<int>(4));
+  EXPECT_TRUE(buffer->FetchAll(&vector));
+  EXPECT_EQ(2, vector.size());
+  EXPECT_EQ(3, *vector[0]);
+  EXPECT_EQ(4, *vector[1]);
+
+  // the single message path is not affected
+  std::shared_ptr<int> msg;
+  EXPECT_TRUE(buffer->Latest(msg));
+  EXPECT_EQ(4, *msg);
+}
+
 }  // namespace data
 }  // namespace cyber
 }  // namespace apollo
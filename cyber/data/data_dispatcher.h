@@ -25,6 +25,7 @@
 #include "cyber/common/macros.h"
 #include "cyber/data/channel_buffer.h"
 #include "cyber/state.h"
+#include "cyber/statistics/channel_stats.h"
 #include "cyber/time/time.h"
 
 namespace apollo {
@@ -80,7 +81,9 @@ bool DataDispatcher<T>::Dispatch(const uint64_t channel_id,
     for (auto& buffer_wptr : *buffers) {
       if (auto buffer = buffer_wptr.lock()) {
         std::lock_guard<std::mutex> lock(buffer->Mutex());
-        buffer->Fill(msg);
+        bool overwritten = buffer->Fill(msg);
+        statistics::ChannelStats::Instance()->OnCacheFill(
+            channel_id, overwritten, buffer->Size());
       }
     }
   } else {
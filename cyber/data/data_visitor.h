@@ -28,16 +28,21 @@
 #include "cyber/data/data_visitor_base.h"
 #include "cyber/data/fusion/all_latest.h"
 #include "cyber/data/fusion/data_fusion.h"
+#include "cyber/data/fusion/time_sync.h"
 
 namespace apollo {
 namespace cyber {
 namespace data {
 
 struct VisitorConfig {
-  VisitorConfig(uint64_t id, uint32_t size)
-      : channel_id(id), queue_size(size) {}
+  VisitorConfig(uint64_t id, uint32_t size, bool batch = false)
+      : channel_id(id), queue_size(size), batch(batch) {}
   uint64_t channel_id;
   uint32_t queue_size;
+  // fetch everything queued since the last run at once, single channel only
+  bool batch;
+  // sample the latency of the first channel's messages when they are fetched
+  bool sample_latency = true;
 };
 
 template <typename T>
@@ -47,7 +52,9 @@ template <typename M0, typename M1 = NullType, typename M2 = NullType,
           typename M3 = NullType>
 class DataVisitor : public DataVisitorBase {
  public:
-  explicit DataVisitor(const std::vector<VisitorConfig>& configs)
+  explicit DataVisitor(
+      const std::vector<VisitorConfig>& configs,
+      const fusion::FusionConfig& fusion_config = fusion::FusionConfig())
       : buffer_m0_(configs[0].channel_id,
                    new BufferType<M0>(configs[0].queue_size)),
         buffer_m1_(configs[1].channel_id,
@@ -61,8 +68,18 @@ class DataVisitor : public DataVisitorBase {
     DataDispatcher<M2>::Instance()->AddBuffer(buffer_m2_);
     DataDispatcher<M3>::Instance()->AddBuffer(buffer_m3_);
     data_notifier_->AddNotifier(buffer_m0_.channel_id(), notifier_);
-    data_fusion_ = new fusion::AllLatest<M0, M1, M2, M3>(
-        buffer_m0_, buffer_m1_, buffer_m2_, buffer_m3_);
+    sample_latency_ = configs[0].sample_latency;
+    if (fusion_config.policy == fusion::FusionPolicy::ALL_LATEST) {
+      data_fusion_ = new fusion::AllLatest<M0, M1, M2, M3>(
+          buffer_m0_, buffer_m1_, buffer_m2_, buffer_m3_);
+    } else {
+      // any of the channels may complete a join
+      data_notifier_->AddNotifier(buffer_m1_.channel_id(), notifier_);
+      data_notifier_->AddNotifier(buffer_m2_.channel_id(), notifier_);
+      data_notifier_->AddNotifier(buffer_m3_.channel_id(), notifier_);
+      data_fusion_ = new fusion::TimeSync<M0, M1, M2, M3>(
+          fusion_config, buffer_m0_, buffer_m1_, buffer_m2_, buffer_m3_);
+    }
   }
 
   ~DataVisitor() {
@@ -76,6 +93,7 @@ class DataVisitor : public DataVisitorBase {
                 std::shared_ptr<M2>& m2, std::shared_ptr<M3>& m3) {  // NOLINT
     if (data_fusion_->Fusion(&next_msg_index_, m0, m1, m2, m3)) {
       next_msg_index_++;
+      OnFetch(buffer_m0_.channel_id(), m0);
       return true;
     }
     return false;
@@ -92,7 +110,9 @@ class DataVisitor : public DataVisitorBase {
 template <typename M0, typename M1, typename M2>
 class DataVisitor<M0, M1, M2, NullType> : public DataVisitorBase {
  public:
-  explicit DataVisitor(const std::vector<VisitorConfig>& configs)
+  explicit DataVisitor(
+      const std::vector<VisitorConfig>& configs,
+      const fusion::FusionConfig& fusion_config = fusion::FusionConfig())
       : buffer_m0_(configs[0].channel_id,
                    new BufferType<M0>(configs[0].queue_size)),
         buffer_m1_(configs[1].channel_id,
@@ -103,8 +123,17 @@ class DataVisitor<M0, M1, M2, NullType> : public DataVisitorBase {
     DataDispatcher<M1>::Instance()->AddBuffer(buffer_m1_);
     DataDispatcher<M2>::Instance()->AddBuffer(buffer_m2_);
     data_notifier_->AddNotifier(buffer_m0_.channel_id(), notifier_);
-    data_fusion_ =
-        new fusion::AllLatest<M0, M1, M2>(buffer_m0_, buffer_m1_, buffer_m2_);
+    sample_latency_ = configs[0].sample_latency;
+    if (fusion_config.policy == fusion::FusionPolicy::ALL_LATEST) {
+      data_fusion_ = new fusion::AllLatest<M0, M1, M2>(buffer_m0_, buffer_m1_,
+                                                       buffer_m2_);
+    } else {
+      // any of the channels may complete a join
+      data_notifier_->AddNotifier(buffer_m1_.channel_id(), notifier_);
+      data_notifier_->AddNotifier(buffer_m2_.channel_id(), notifier_);
+      data_fusion_ = new fusion::TimeSync<M0, M1, M2>(
+          fusion_config, buffer_m0_, buffer_m1_, buffer_m2_);
+    }
   }
 
   ~DataVisitor() {
@@ -118,6 +147,7 @@ class DataVisitor<M0, M1, M2, NullType> : public DataVisitorBase {
                 std::shared_ptr<M2>& m2) {                         // NOLINT
     if (data_fusion_->Fusion(&next_msg_index_, m0, m1, m2)) {
       next_msg_index_++;
+      OnFetch(buffer_m0_.channel_id(), m0);
       return true;
     }
     return false;
@@ -133,7 +163,9 @@ class DataVisitor<M0, M1, M2, NullType> : public DataVisitorBase {
 template <typename M0, typename M1>
 class DataVisitor<M0, M1, NullType, NullType> : public DataVisitorBase {
  public:
-  explicit DataVisitor(const std::vector<VisitorConfig>& configs)
+  explicit DataVisitor(
+      const std::vector<VisitorConfig>& configs,
+      const fusion::FusionConfig& fusion_config = fusion::FusionConfig())
       : buffer_m0_(configs[0].channel_id,
                    new BufferType<M0>(configs[0].queue_size)),
         buffer_m1_(configs[1].channel_id,
@@ -141,7 +173,15 @@ class DataVisitor<M0, M1, NullType, NullType> : public DataVisitorBase {
     DataDispatcher<M0>::Instance()->AddBuffer(buffer_m0_);
     DataDispatcher<M1>::Instance()->AddBuffer(buffer_m1_);
     data_notifier_->AddNotifier(buffer_m0_.channel_id(), notifier_);
-    data_fusion_ = new fusion::AllLatest<M0, M1>(buffer_m0_, buffer_m1_);
+    sample_latency_ = configs[0].sample_latency;
+    if (fusion_config.policy == fusion::FusionPolicy::ALL_LATEST) {
+      data_fusion_ = new fusion::AllLatest<M0, M1>(buffer_m0_, buffer_m1_);
+    } else {
+      // any of the channels may complete a join
+      data_notifier_->AddNotifier(buffer_m1_.channel_id(), notifier_);
+      data_fusion_ = new fusion::TimeSync<M0, M1>(fusion_config, buffer_m0_,
+                                                  buffer_m1_);
+    }
   }
 
   ~DataVisitor() {
@@ -154,6 +194,7 @@ class DataVisitor<M0, M1, NullType, NullType> : public DataVisitorBase {
   bool TryFetch(std::shared_ptr<M0>& m0, std::shared_ptr<M1>& m1) {  // NOLINT
     if (data_fusion_->Fusion(&next_msg_index_, m0, m1)) {
       next_msg_index_++;
+      OnFetch(buffer_m0_.channel_id(), m0);
       return true;
     }
     return false;
@@ -170,6 +211,10 @@ class DataVisitor<M0, NullType, NullType, NullType> : public DataVisitorBase {
  public:
   explicit DataVisitor(const VisitorConfig& configs)
       : buffer_(configs.channel_id, new BufferType<M0>(configs.queue_size)) {
+    if (configs.batch) {
+      buffer_.Buffer()->EnableBatch();
+    }
+    sample_latency_ = configs.sample_latency;
     DataDispatcher<M0>::Instance()->AddBuffer(buffer_);
     data_notifier_->AddNotifier(buffer_.channel_id(), notifier_);
   }
@@ -183,11 +228,23 @@ class DataVisitor<M0, NullType, NullType, NullType> : public DataVisitorBase {
   bool TryFetch(std::shared_ptr<M0>& m0) {  // NOLINT
     if (buffer_.Fetch(&next_msg_index_, m0)) {
       next_msg_index_++;
+      OnFetch(buffer_.channel_id(), m0);
       return true;
     }
     return false;
   }
 
+  bool TryFetchAll(std::vector<std::shared_ptr<M0>>* msgs) {
+    msgs->clear();
+    if (!buffer_.FetchAll(msgs)) {
+      return false;
+    }
+    for (const auto& msg : *msgs) {
+      OnFetch(buffer_.channel_id(), msg);
+    }
+    return true;
+  }
+
  private:
   ChannelBuffer<M0> buffer_;
 };
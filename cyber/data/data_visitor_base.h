@@ -25,6 +25,8 @@
 #include "cyber/common/global_data.h"
 #include "cyber/common/log.h"
 #include "cyber/data/data_notifier.h"
+#include "cyber/profiler/block_manager.h"
+#include "cyber/statistics/channel_stats.h"
 
 namespace apollo {
 namespace cyber {
@@ -42,6 +44,21 @@ class DataVisitorBase {
   DataVisitorBase(const DataVisitorBase&) = delete;
   DataVisitorBase& operator=(const DataVisitorBase&) = delete;
 
+  // a message is handed out: samples its publish to fetch latency, see
+  // ChannelStats, and links the profiler spans of the routine to its trace
+  template <typename T>
+  void OnFetch(uint64_t channel_id, const std::shared_ptr<T>& msg) {
+    auto stats = statistics::ChannelStats::Instance();
+    if (sample_latency_) {
+      stats->OnCallback(channel_id, msg.get());
+    }
+    auto block_manager = profiler::BlockManager::Instance();
+    if (block_manager->span_enabled()) {
+      block_manager->OnFetch(stats->TraceId(channel_id, msg.get()));
+    }
+  }
+
+  bool sample_latency_ = false;
   uint64_t next_msg_index_ = 0;
   DataNotifier* data_notifier_ = DataNotifier::Instance();
   std::shared_ptr<Notifier> notifier_;
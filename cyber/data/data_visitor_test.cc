@@ -16,6 +16,7 @@
 
 #include "cyber/data/data_visitor.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -139,6 +140,54 @@ TEST(DataVisitorTest, four_channel) {
   EXPECT_FALSE(dv->TryFetch(msg0, msg1, msg2, msg3));
 }
 
+TEST(DataVisitorTest, sample_latency) {
+  auto channel_id = str_hash("/sample_latency");
+  auto dv = std::make_shared<DataVisitor<RawMessage>>(
+      VisitorConfig(channel_id, 10));
+  // readers sample in their callback, the visitor stays out of it
+  auto reader_dv = std::make_shared<DataVisitor<RawMessage>>(channel_id, 10);
+
+  auto stats = statistics::ChannelStats::Instance();
+  std::shared_ptr<RawMessage> msg;
+  for (int round = 0; round < 2; ++round) {
+    // the first fetch starts from the latest message, later ones go on
+    for (int i = 0; i <= round * 2; ++i) {
+      auto raw_msg = std::make_shared<RawMessage>();
+      stats->OnDispatch(channel_id, raw_msg.get(), Time::Now().ToNanosecond());
+      DataDispatcher<RawMessage>::Instance()->Dispatch(channel_id, raw_msg);
+    }
+    while (dv->TryFetch(msg)) {
+    }
+    while (reader_dv->TryFetch(msg)) {
+    }
+  }
+
+  std::vector<statistics::ChannelStatsSnapshot> snapshots;
+  ASSERT_TRUE(statistics::ChannelStats::ReadAll(&snapshots));
+  auto it = std::find_if(snapshots.begin(), snapshots.end(),
+                         [channel_id](const auto& snapshot) {
+                           return snapshot.channel_id == channel_id;
+                         });
+  ASSERT_NE(it, snapshots.end());
+  EXPECT_EQ(4, it->delivered);
+}
+
+TEST(DataVisitorTest, trace_id_of_fetched_message) {
+  auto channel_id = str_hash("/trace_id");
+  auto dv = std::make_shared<DataVisitor<RawMessage>>(channel_id, 10);
+  auto block_manager = profiler::BlockManager::Instance();
+  block_manager->SetSpanEnabled(true);
+
+  auto raw_msg = std::make_shared<RawMessage>();
+  statistics::ChannelStats::Instance()->OnDispatch(
+      channel_id, raw_msg.get(), Time::Now().ToNanosecond(), 42);
+  DataDispatcher<RawMessage>::Instance()->Dispatch(channel_id, raw_msg);
+  std::shared_ptr<RawMessage> msg;
+  EXPECT_TRUE(dv->TryFetch(msg));
+  EXPECT_EQ(42, block_manager->TraceId());
+  block_manager->SetSpanEnabled(false);
+}
+
 }  // namespace data
 }  // namespace cyber
 }  // namespace apollo
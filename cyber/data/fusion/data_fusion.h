@@ -31,6 +31,25 @@ namespace cyber {
 namespace data {
 namespace fusion {
 
+enum class FusionPolicy {
+  // channel 0 joined with the latest message of the other channels
+  ALL_LATEST,
+  // channel 0 joined with the closest stamp of every other channel, if all
+  // of them are within max_skew_ns
+  APPROXIMATE_TIME,
+  // messages that carry exactly the same stamp on every channel
+  EXACT_STAMP,
+  // channel 0 waits until every other channel delivered a newer message,
+  // or joins with what is there once deadline_ns passed
+  WAIT_FOR_ALL,
+};
+
+struct FusionConfig {
+  FusionPolicy policy = FusionPolicy::ALL_LATEST;
+  uint64_t max_skew_ns = 10000000;
+  uint64_t deadline_ns = 50000000;
+};
+
 template <typename M0, typename M1 = NullType, typename M2 = NullType,
           typename M3 = NullType>
 class DataFusion {
@@ -0,0 +1,486 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_DATA_FUSION_TIME_SYNC_H_
+#define CYBER_DATA_FUSION_TIME_SYNC_H_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "cyber/common/types.h"
+#include "cyber/data/cache_buffer.h"
+#include "cyber/data/channel_buffer.h"
+#include "cyber/data/fusion/data_fusion.h"
+#include "cyber/time/time.h"
+
+namespace apollo {
+namespace cyber {
+namespace data {
+namespace fusion {
+
+template <typename T, typename = void>
+struct HasHeaderStamp : std::false_type {};
+
+template <typename T>
+struct HasHeaderStamp<
+    T, decltype(void(std::declval<const T&>().header().timestamp_sec()))>
+    : std::true_type {};
+
+// The stamp a message is synchronized on: header().timestamp_sec() for
+// messages that carry one, the arrival time otherwise.
+template <typename T>
+typename std::enable_if<HasHeaderStamp<T>::value, uint64_t>::type
+MessageStamp(const T& msg, uint64_t arrival_ns) {
+  double stamp_sec = msg.header().timestamp_sec();
+  if (stamp_sec <= 0) {
+    return arrival_ns;
+  }
+  return static_cast<uint64_t>(std::llround(stamp_sec * 1e9));
+}
+
+template <typename T>
+typename std::enable_if<!HasHeaderStamp<T>::value, uint64_t>::type
+MessageStamp(const T& msg, uint64_t arrival_ns) {
+  return arrival_ns;
+}
+
+/**
+ * Joins messages of up to four channels according to a FusionPolicy. The
+ * messages are type erased, so one implementation serves every arity, and
+ * all queues are allocated up front: finding and emitting a join only
+ * moves shared_ptrs around. Not thread safe, TimeSync locks around it.
+ *
+ * The deadline of WAIT_FOR_ALL is checked whenever a message arrives on
+ * any of the channels, there is no timer behind it.
+ */
+class TimeSyncMatcher {
+ public:
+  static const uint32_t kMaxChannelNum = 4;
+  using Messages = std::array<std::shared_ptr<void>, kMaxChannelNum>;
+
+  TimeSyncMatcher(const FusionConfig& config, uint32_t channel_num)
+      : config_(config), channel_num_(channel_num) {}
+
+  void SetQueueSize(uint32_t channel, uint64_t size) {
+    // waiting for all only ever joins the latest messages
+    if (config_.policy == FusionPolicy::WAIT_FOR_ALL) {
+      size = 1;
+    }
+    queues_[channel].entries.resize(std::max(size, uint64_t(1)));
+  }
+
+  // emit is called with one message per channel for every join found
+  template <typename F>
+  void Add(uint32_t channel, const std::shared_ptr<void>& msg,
+           uint64_t stamp, uint64_t now_ns, F&& emit) {
+    if (config_.policy == FusionPolicy::WAIT_FOR_ALL && channel == 0 &&
+        waiting_) {
+      // superseded before the others caught up
+      JoinLatest(emit);
+      waiting_ = false;
+    }
+    bool count_dropped =
+        channel == 0 && config_.policy != FusionPolicy::WAIT_FOR_ALL;
+    queues_[channel].Push(msg, stamp, count_dropped ? &dropped_ : nullptr);
+
+    switch (config_.policy) {
+      case FusionPolicy::APPROXIMATE_TIME:
+        MatchApproximate(emit);
+        break;
+      case FusionPolicy::EXACT_STAMP:
+        MatchExact(stamp, emit);
+        break;
+      case FusionPolicy::WAIT_FOR_ALL:
+        MatchWaitForAll(channel, now_ns, emit);
+        break;
+      default:
+        break;
+    }
+  }
+
+  // channel 0 messages that never made it into a join
+  uint64_t dropped() const { return dropped_; }
+
+ private:
+  struct Entry {
+    std::shared_ptr<void> msg;
+    uint64_t stamp = 0;
+  };
+
+  // oldest first, the oldest is overwritten once full
+  struct Queue {
+    std::vector<Entry> entries = std::vector<Entry>(1);
+    uint64_t head = 0;
+    uint64_t size = 0;
+
+    bool Empty() const { return size == 0; }
+    Entry& At(uint64_t i) { return entries[(head + i) % entries.size()]; }
+    Entry& Front() { return At(0); }
+    Entry& Back() { return At(size - 1); }
+
+    void Push(const std::shared_ptr<void>& msg, uint64_t stamp,
+              uint64_t* dropped) {
+      if (size == entries.size()) {
+        Pop(1);
+        if (dropped != nullptr) {
+          ++*dropped;
+        }
+      }
+      Entry& entry = At(size++);
+      entry.msg = msg;
+      entry.stamp = stamp;
+    }
+
+    void Pop(uint64_t num) {
+      for (uint64_t i = 0; i < num && size > 0; ++i) {
+        entries[head].msg.reset();
+        head = (head + 1) % entries.size();
+        --size;
+      }
+    }
+  };
+
+  static uint64_t Distance(uint64_t lhs, uint64_t rhs) {
+    return lhs > rhs ? lhs - rhs : rhs - lhs;
+  }
+
+  template <typename F>
+  void Emit(F&& emit) {
+    emit(messages_);
+    for (auto& msg : messages_) {
+      msg.reset();
+    }
+  }
+
+  template <typename F>
+  void MatchApproximate(F&& emit) {
+    auto& pivots = queues_[0];
+    while (!pivots.Empty()) {
+      const uint64_t pivot_stamp = pivots.Front().stamp;
+      bool matched = true;
+      for (uint32_t c = 1; c < channel_num_; ++c) {
+        auto& queue = queues_[c];
+        // a closer message may still arrive
+        if (queue.Empty() || queue.Back().stamp < pivot_stamp) {
+          return;
+        }
+        uint64_t best = 0;
+        for (uint64_t i = 1; i < queue.size; ++i) {
+          if (Distance(queue.At(i).stamp, pivot_stamp) <
+              Distance(queue.At(best).stamp, pivot_stamp)) {
+            best = i;
+          }
+        }
+        best_[c] = best;
+        if (Distance(queue.At(best).stamp, pivot_stamp) >
+            config_.max_skew_ns) {
+          matched = false;
+        }
+      }
+
+      if (matched) {
+        messages_[0] = pivots.Front().msg;
+        for (uint32_t c = 1; c < channel_num_; ++c) {
+          messages_[c] = queues_[c].At(best_[c]).msg;
+          queues_[c].Pop(best_[c] + 1);
+        }
+        Emit(emit);
+      } else {
+        ++dropped_;
+      }
+      pivots.Pop(1);
+    }
+  }
+
+  template <typename F>
+  void MatchExact(uint64_t stamp, F&& emit) {
+    for (uint32_t c = 0; c < channel_num_; ++c) {
+      auto& queue = queues_[c];
+      uint64_t i = 0;
+      while (i < queue.size && queue.At(i).stamp != stamp) {
+        ++i;
+      }
+      if (i == queue.size) {
+        return;
+      }
+      best_[c] = i;
+    }
+
+    // stamps grow, older ones will never be joined any more
+    dropped_ += best_[0];
+    for (uint32_t c = 0; c < channel_num_; ++c) {
+      messages_[c] = queues_[c].At(best_[c]).msg;
+      queues_[c].Pop(best_[c] + 1);
+    }
+    Emit(emit);
+  }
+
+  template <typename F>
+  void MatchWaitForAll(uint32_t channel, uint64_t now_ns, F&& emit) {
+    if (channel == 0) {
+      waiting_ = true;
+      deadline_ns_ = now_ns + config_.deadline_ns;
+      fresh_.fill(false);
+    } else {
+      fresh_[channel] = true;
+    }
+    if (!waiting_) {
+      return;
+    }
+
+    bool all_fresh = true;
+    for (uint32_t c = 1; c < channel_num_; ++c) {
+      all_fresh = all_fresh && fresh_[c];
+    }
+    if (all_fresh || now_ns >= deadline_ns_) {
+      JoinLatest(emit);
+      waiting_ = false;
+    }
+  }
+
+  template <typename F>
+  void JoinLatest(F&& emit) {
+    for (uint32_t c = 0; c < channel_num_; ++c) {
+      if (queues_[c].Empty()) {
+        ++dropped_;
+        return;
+      }
+      messages_[c] = queues_[c].Back().msg;
+    }
+    Emit(emit);
+  }
+
+  FusionConfig config_;
+  uint32_t channel_num_ = 0;
+  std::array<Queue, kMaxChannelNum> queues_;
+  std::array<uint64_t, kMaxChannelNum> best_ = {};
+  Messages messages_;
+  uint64_t dropped_ = 0;
+
+  // WAIT_FOR_ALL: the latest channel 0 message waits for the others
+  bool waiting_ = false;
+  uint64_t deadline_ns_ = 0;
+  std::array<bool, kMaxChannelNum> fresh_ = {};
+};
+
+template <typename FusionDataType>
+class TimeSyncBase {
+ public:
+  // channel 0 messages that never made it into a join
+  uint64_t Dropped() {
+    std::lock_guard<std::mutex> lg(mutex_);
+    return matcher_.dropped();
+  }
+
+ protected:
+  TimeSyncBase(const FusionConfig& config, uint32_t channel_num,
+               uint64_t capacity)
+      : matcher_(config, channel_num), buffer_fusion_(capacity) {}
+
+  template <typename T>
+  void SetQueueSize(uint32_t channel, const ChannelBuffer<T>& buffer) {
+    matcher_.SetQueueSize(channel, buffer.Buffer()->Capacity() - 1);
+  }
+
+  template <typename T>
+  void Add(uint32_t channel, const std::shared_ptr<T>& msg) {
+    uint64_t now_ns = Time::Now().ToNanosecond();
+    uint64_t stamp = MessageStamp(*msg, now_ns);
+    std::lock_guard<std::mutex> lg(mutex_);
+    matcher_.Add(channel, msg, stamp, now_ns,
+                 [this](const TimeSyncMatcher::Messages& msgs) {
+                   Fill(msgs, std::make_index_sequence<
+                                  std::tuple_size<FusionDataType>::value>());
+                 });
+  }
+
+  // read hands out the join at *index while the buffer is locked
+  template <typename F>
+  bool Fetch(uint64_t* index, F&& read) {
+    std::lock_guard<std::mutex> lg(buffer_fusion_.Mutex());
+    if (buffer_fusion_.Empty()) {
+      return false;
+    }
+
+    if (*index == 0) {
+      *index = buffer_fusion_.Tail();
+    } else if (*index == buffer_fusion_.Tail() + 1) {
+      return false;
+    } else if (*index < buffer_fusion_.Head()) {
+      *index = buffer_fusion_.Tail();
+    }
+    read(buffer_fusion_.at(*index));
+    return true;
+  }
+
+ private:
+  template <size_t... I>
+  void Fill(const TimeSyncMatcher::Messages& msgs,
+            std::index_sequence<I...>) {
+    std::lock_guard<std::mutex> lg(buffer_fusion_.Mutex());
+    buffer_fusion_.Fill(FusionDataType(std::static_pointer_cast<
+        typename std::tuple_element<I, FusionDataType>::type::element_type>(
+        msgs[I])...));
+  }
+
+  std::mutex mutex_;
+  TimeSyncMatcher matcher_;
+  CacheBuffer<FusionDataType> buffer_fusion_;
+};
+
+template <typename M0, typename M1 = NullType, typename M2 = NullType,
+          typename M3 = NullType>
+class TimeSync
+    : public DataFusion<M0, M1, M2, M3>,
+      public TimeSyncBase<
+          std::tuple<std::shared_ptr<M0>, std::shared_ptr<M1>,
+                     std::shared_ptr<M2>, std::shared_ptr<M3>>> {
+  using FusionDataType = std::tuple<std::shared_ptr<M0>, std::shared_ptr<M1>,
+                                    std::shared_ptr<M2>, std::shared_ptr<M3>>;
+
+ public:
+  TimeSync(const FusionConfig& config, const ChannelBuffer<M0>& buffer_0,
+           const ChannelBuffer<M1>& buffer_1,
+           const ChannelBuffer<M2>& buffer_2,
+           const ChannelBuffer<M3>& buffer_3)
+      : TimeSyncBase<FusionDataType>(
+            config, 4, buffer_0.Buffer()->Capacity() - uint64_t(1)),
+        buffer_m0_(buffer_0),
+        buffer_m1_(buffer_1),
+        buffer_m2_(buffer_2),
+        buffer_m3_(buffer_3) {
+    this->SetQueueSize(0, buffer_m0_);
+    this->SetQueueSize(1, buffer_m1_);
+    this->SetQueueSize(2, buffer_m2_);
+    this->SetQueueSize(3, buffer_m3_);
+    buffer_m0_.Buffer()->SetFusionCallback(
+        [this](const std::shared_ptr<M0>& m0) { this->Add(0, m0); });
+    buffer_m1_.Buffer()->SetFusionCallback(
+        [this](const std::shared_ptr<M1>& m1) { this->Add(1, m1); });
+    buffer_m2_.Buffer()->SetFusionCallback(
+        [this](const std::shared_ptr<M2>& m2) { this->Add(2, m2); });
+    buffer_m3_.Buffer()->SetFusionCallback(
+        [this](const std::shared_ptr<M3>& m3) { this->Add(3, m3); });
+  }
+
+  bool Fusion(uint64_t* index, std::shared_ptr<M0>& m0, std::shared_ptr<M1>& m1,
+              std::shared_ptr<M2>& m2, std::shared_ptr<M3>& m3) override {
+    return this->Fetch(index, [&](const FusionDataType& data) {
+      m0 = std::get<0>(data);
+      m1 = std::get<1>(data);
+      m2 = std::get<2>(data);
+      m3 = std::get<3>(data);
+    });
+  }
+
+ private:
+  ChannelBuffer<M0> buffer_m0_;
+  ChannelBuffer<M1> buffer_m1_;
+  ChannelBuffer<M2> buffer_m2_;
+  ChannelBuffer<M3> buffer_m3_;
+};
+
+template <typename M0, typename M1, typename M2>
+class TimeSync<M0, M1, M2, NullType>
+    : public DataFusion<M0, M1, M2>,
+      public TimeSyncBase<std::tuple<std::shared_ptr<M0>, std::shared_ptr<M1>,
+                                     std::shared_ptr<M2>>> {
+  using FusionDataType =
+      std::tuple<std::shared_ptr<M0>, std::shared_ptr<M1>, std::shared_ptr<M2>>;
+
+ public:
+  TimeSync(const FusionConfig& config, const ChannelBuffer<M0>& buffer_0,
+           const ChannelBuffer<M1>& buffer_1,
+           const ChannelBuffer<M2>& buffer_2)
+      : TimeSyncBase<FusionDataType>(
+            config, 3, buffer_0.Buffer()->Capacity() - uint64_t(1)),
+        buffer_m0_(buffer_0),
+        buffer_m1_(buffer_1),
+        buffer_m2_(buffer_2) {
+    this->SetQueueSize(0, buffer_m0_);
+    this->SetQueueSize(1, buffer_m1_);
+    this->SetQueueSize(2, buffer_m2_);
+    buffer_m0_.Buffer()->SetFusionCallback(
+        [this](const std::shared_ptr<M0>& m0) { this->Add(0, m0); });
+    buffer_m1_.Buffer()->SetFusionCallback(
+        [this](const std::shared_ptr<M1>& m1) { this->Add(1, m1); });
+    buffer_m2_.Buffer()->SetFusionCallback(
+        [this](const std::shared_ptr<M2>& m2) { this->Add(2, m2); });
+  }
+
+  bool Fusion(uint64_t* index, std::shared_ptr<M0>& m0, std::shared_ptr<M1>& m1,
+              std::shared_ptr<M2>& m2) override {
+    return this->Fetch(index, [&](const FusionDataType& data) {
+      m0 = std::get<0>(data);
+      m1 = std::get<1>(data);
+      m2 = std::get<2>(data);
+    });
+  }
+
+ private:
+  ChannelBuffer<M0> buffer_m0_;
+  ChannelBuffer<M1> buffer_m1_;
+  ChannelBuffer<M2> buffer_m2_;
+};
+
+template <typename M0, typename M1>
+class TimeSync<M0, M1, NullType, NullType>
+    : public DataFusion<M0, M1>,
+      public TimeSyncBase<
+          std::tuple<std::shared_ptr<M0>, std::shared_ptr<M1>>> {
+  using FusionDataType = std::tuple<std::shared_ptr<M0>, std::shared_ptr<M1>>;
+
+ public:
+  TimeSync(const FusionConfig& config, const ChannelBuffer<M0>& buffer_0,
+           const ChannelBuffer<M1>& buffer_1)
+      : TimeSyncBase<FusionDataType>(
+            config, 2, buffer_0.Buffer()->Capacity() - uint64_t(1)),
+        buffer_m0_(buffer_0),
+        buffer_m1_(buffer_1) {
+    this->SetQueueSize(0, buffer_m0_);
+    this->SetQueueSize(1, buffer_m1_);
+    buffer_m0_.Buffer()->SetFusionCallback(
+        [this](const std::shared_ptr<M0>& m0) { this->Add(0, m0); });
+    buffer_m1_.Buffer()->SetFusionCallback(
+        [this](const std::shared_ptr<M1>& m1) { this->Add(1, m1); });
+  }
+
+  bool Fusion(uint64_t* index, std::shared_ptr<M0>& m0,
+              std::shared_ptr<M1>& m1) override {
+    return this->Fetch(index, [&](const FusionDataType& data) {
+      m0 = std::get<0>(data);
+      m1 = std::get<1>(data);
+    });
+  }
+
+ private:
+  ChannelBuffer<M0> buffer_m0_;
+  ChannelBuffer<M1> buffer_m1_;
+};
+
+}  // namespace fusion
+}  // namespace data
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_DATA_FUSION_TIME_SYNC_H_
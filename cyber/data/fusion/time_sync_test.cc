@@ -0,0 +1,254 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/data/fusion/time_sync.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cyber/base/alloc_counter.h"
+#include "cyber/cyber.h"
+#include "cyber/data/data_visitor.h"
+
+namespace apollo {
+namespace cyber {
+namespace data {
+
+namespace {
+
+struct StampHeader {
+  double timestamp_sec() const { return stamp; }
+  double stamp = 0;
+};
+
+struct StampedMessage {
+  StampedMessage(const std::string& msg_name, double stamp)
+      : name(msg_name) {
+    header_.stamp = stamp;
+  }
+  const StampHeader& header() const { return header_; }
+
+  std::string name;
+  StampHeader header_;
+};
+
+using MsgPtr = std::shared_ptr<StampedMessage>;
+using MsgCache = CacheBuffer<MsgPtr>;
+
+MsgPtr Msg(const std::string& name, double stamp) {
+  return std::make_shared<StampedMessage>(name, stamp);
+}
+
+fusion::FusionConfig Config(fusion::FusionPolicy policy) {
+  fusion::FusionConfig config;
+  config.policy = policy;
+  config.max_skew_ns = 10000000;
+  config.deadline_ns = 20000000;
+  return config;
+}
+
+}  // namespace
+
+TEST(TimeSyncTest, message_stamp) {
+  EXPECT_EQ(1500000000, fusion::MessageStamp(*Msg("m", 1.5), 7));
+  // no stamp in the header, use the arrival
+  EXPECT_EQ(7, fusion::MessageStamp(*Msg("m", 0), 7));
+  EXPECT_EQ(7, fusion::MessageStamp(std::string("m"), 7));
+}
+
+TEST(TimeSyncTest, approximate_time) {
+  auto cache0 = new MsgCache(10);
+  auto cache1 = new MsgCache(10);
+  ChannelBuffer<StampedMessage> buffer0(0, cache0);
+  ChannelBuffer<StampedMessage> buffer1(1, cache1);
+  fusion::TimeSync<StampedMessage, StampedMessage> fusion(
+      Config(fusion::FusionPolicy::APPROXIMATE_TIME), buffer0, buffer1);
+  MsgPtr m0;
+  MsgPtr m1;
+  uint64_t index = 0;
+
+  cache0->Fill(Msg("0-0", 1.000));
+  cache1->Fill(Msg("1-0", 0.995));
+  // a closer message on channel 1 may still come
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1));
+  cache1->Fill(Msg("1-1", 1.004));
+  EXPECT_TRUE(fusion.Fusion(&index, m0, m1));
+  index++;
+  EXPECT_EQ("0-0", m0->name);
+  EXPECT_EQ("1-1", m1->name);
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1));
+
+  // both sides of the pivot are known, 1.097 is the closer one
+  cache1->Fill(Msg("1-2", 1.097));
+  cache0->Fill(Msg("0-1", 1.100));
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1));
+  cache1->Fill(Msg("1-3", 1.120));
+  EXPECT_TRUE(fusion.Fusion(&index, m0, m1));
+  index++;
+  EXPECT_EQ("0-1", m0->name);
+  EXPECT_EQ("1-2", m1->name);
+
+  // out of the skew window
+  cache0->Fill(Msg("0-2", 1.200));
+  cache1->Fill(Msg("1-4", 1.250));
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1));
+  EXPECT_EQ(1, fusion.Dropped());
+}
+
+TEST(TimeSyncTest, exact_stamp) {
+  auto cache0 = new MsgCache(10);
+  auto cache1 = new MsgCache(10);
+  auto cache2 = new MsgCache(10);
+  ChannelBuffer<StampedMessage> buffer0(0, cache0);
+  ChannelBuffer<StampedMessage> buffer1(1, cache1);
+  ChannelBuffer<StampedMessage> buffer2(2, cache2);
+  fusion::TimeSync<StampedMessage, StampedMessage, StampedMessage> fusion(
+      Config(fusion::FusionPolicy::EXACT_STAMP), buffer0, buffer1, buffer2);
+  MsgPtr m0;
+  MsgPtr m1;
+  MsgPtr m2;
+  uint64_t index = 0;
+
+  cache0->Fill(Msg("0-0", 1.0));
+  cache1->Fill(Msg("1-0", 1.0));
+  cache0->Fill(Msg("0-1", 1.1));
+  cache1->Fill(Msg("1-1", 1.1));
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1, m2));
+  // channel 2 skipped 1.0, any channel may complete the join
+  cache2->Fill(Msg("2-1", 1.1));
+  EXPECT_TRUE(fusion.Fusion(&index, m0, m1, m2));
+  index++;
+  EXPECT_EQ("0-1", m0->name);
+  EXPECT_EQ("1-1", m1->name);
+  EXPECT_EQ("2-1", m2->name);
+  EXPECT_EQ(1, fusion.Dropped());
+
+  cache2->Fill(Msg("2-2", 1.2));
+  cache1->Fill(Msg("1-2", 1.2));
+  cache0->Fill(Msg("0-2", 1.2001));
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1, m2));
+  // no 1.2001 on the others, a late 1.2 still joins
+  cache0->Fill(Msg("0-3", 1.2));
+  EXPECT_TRUE(fusion.Fusion(&index, m0, m1, m2));
+  EXPECT_EQ("0-3", m0->name);
+  EXPECT_EQ("1-2", m1->name);
+  EXPECT_EQ("2-2", m2->name);
+  EXPECT_EQ(2, fusion.Dropped());
+}
+
+TEST(TimeSyncTest, wait_for_all) {
+  auto cache0 = new MsgCache(10);
+  auto cache1 = new MsgCache(10);
+  auto cache2 = new MsgCache(10);
+  ChannelBuffer<StampedMessage> buffer0(0, cache0);
+  ChannelBuffer<StampedMessage> buffer1(1, cache1);
+  ChannelBuffer<StampedMessage> buffer2(2, cache2);
+  fusion::TimeSync<StampedMessage, StampedMessage, StampedMessage> fusion(
+      Config(fusion::FusionPolicy::WAIT_FOR_ALL), buffer0, buffer1, buffer2);
+  MsgPtr m0;
+  MsgPtr m1;
+  MsgPtr m2;
+  uint64_t index = 0;
+
+  cache1->Fill(Msg("1-0", 0));
+  cache2->Fill(Msg("2-0", 0));
+  cache0->Fill(Msg("0-0", 0));
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1, m2));
+  cache1->Fill(Msg("1-1", 0));
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1, m2));
+  cache2->Fill(Msg("2-1", 0));
+  EXPECT_TRUE(fusion.Fusion(&index, m0, m1, m2));
+  index++;
+  EXPECT_EQ("0-0", m0->name);
+  EXPECT_EQ("1-1", m1->name);
+  EXPECT_EQ("2-1", m2->name);
+
+  // channel 2 does not make it before the deadline
+  cache0->Fill(Msg("0-1", 0));
+  cache1->Fill(Msg("1-2", 0));
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1, m2));
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  cache1->Fill(Msg("1-3", 0));
+  EXPECT_TRUE(fusion.Fusion(&index, m0, m1, m2));
+  index++;
+  EXPECT_EQ("0-1", m0->name);
+  EXPECT_EQ("1-3", m1->name);
+  EXPECT_EQ("2-1", m2->name);
+}
+
+TEST(TimeSyncTest, no_allocation) {
+  auto cache0 = new MsgCache(10);
+  auto cache1 = new MsgCache(10);
+  ChannelBuffer<StampedMessage> buffer0(0, cache0);
+  ChannelBuffer<StampedMessage> buffer1(1, cache1);
+  fusion::TimeSync<StampedMessage, StampedMessage> fusion(
+      Config(fusion::FusionPolicy::APPROXIMATE_TIME), buffer0, buffer1);
+
+  std::vector<MsgPtr> msgs0;
+  std::vector<MsgPtr> msgs1;
+  for (int i = 0; i < 100; ++i) {
+    msgs0.emplace_back(Msg("0", 1.0 + 0.01 * i));
+    msgs1.emplace_back(Msg("1", 1.001 + 0.01 * i));
+  }
+
+  MsgPtr m0;
+  MsgPtr m1;
+  uint64_t index = 0;
+  uint64_t fused = 0;
+  uint64_t allocs = base::AllocCount();
+  for (int i = 0; i < 100; ++i) {
+    cache0->Fill(msgs0[i]);
+    cache1->Fill(msgs1[i]);
+    if (fusion.Fusion(&index, m0, m1)) {
+      index++;
+      fused++;
+    }
+  }
+  EXPECT_EQ(allocs, base::AllocCount());
+  EXPECT_EQ(100, fused);
+}
+
+TEST(TimeSyncTest, data_visitor) {
+  std::vector<VisitorConfig> configs = {VisitorConfig(101, 10),
+                                        VisitorConfig(102, 10)};
+  auto dv = std::make_shared<DataVisitor<StampedMessage, StampedMessage>>(
+      configs, Config(fusion::FusionPolicy::EXACT_STAMP));
+  std::atomic<int> notified = {0};
+  dv->RegisterNotifyCallback([&notified]() { notified++; });
+
+  auto dispatcher = DataDispatcher<StampedMessage>::Instance();
+  MsgPtr m0;
+  MsgPtr m1;
+  dispatcher->Dispatch(101, Msg("0-0", 2.0));
+  EXPECT_FALSE(dv->TryFetch(m0, m1));
+  dispatcher->Dispatch(102, Msg("1-0", 2.0));
+  // the second channel wakes the visitor up as well
+  EXPECT_EQ(2, notified.load());
+  EXPECT_TRUE(dv->TryFetch(m0, m1));
+  EXPECT_EQ("0-0", m0->name);
+  EXPECT_EQ("1-0", m1->name);
+  EXPECT_FALSE(dv->TryFetch(m0, m1));
+}
+
+}  // namespace data
+}  // namespace cyber
+}  // namespace apollo
@@ -22,6 +22,8 @@
 
 #include <csignal>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <memory>
 #include <string>
@@ -29,18 +31,23 @@
 #include "cyber/proto/clock.pb.h"
 
 #include "cyber/binary.h"
+#include "cyber/common/environment.h"
 #include "cyber/common/file.h"
 #include "cyber/common/global_data.h"
 #include "cyber/data/data_dispatcher.h"
 #include "cyber/logger/async_logger.h"
+#include "cyber/message/raw_message.h"
 #include "cyber/node/node.h"
+#include "cyber/profiler/trace_exporter.h"
 #include "cyber/scheduler/scheduler.h"
 #include "cyber/service_discovery/topology_manager.h"
 #include "cyber/sysmo/sysmo.h"
 #include "cyber/task/task.h"
 #include "cyber/time/clock.h"
+#include "cyber/timer/precise_timing_wheel.h"
 #include "cyber/timer/timing_wheel.h"
 #include "cyber/transport/transport.h"
+#include "cyber/statistics/channel_stats.h"
 #include "cyber/statistics/statistics.h"
 
 #include "gflags/gflags.h"
@@ -55,10 +62,12 @@ namespace {
 
 const std::string& kClockChannel = "/clock";
 const std::string& kClockNode = "clock";
+const std::string& kTraceNode = "profiler_trace";
 
 bool g_atexit_registered = false;
 std::mutex g_mutex;
 std::unique_ptr<Node> clock_node;
+std::unique_ptr<Node> trace_node;
 
 logger::AsyncLogger* async_logger = nullptr;
 
@@ -77,14 +86,51 @@ void InitLogger(const char* binary_name) {
   google::SetLogDestination(google::FATAL, "");
 
   // Init async logger
+  size_t ring_size = logger::AsyncLogger::kDefaultRingSize;
+  const char* ring_size_env = std::getenv("CYBER_LOG_RING_SIZE_MB");
+  if (ring_size_env != nullptr && std::atoi(ring_size_env) > 0) {
+    ring_size = static_cast<size_t>(std::atoi(ring_size_env)) * 1024 * 1024;
+  }
+  auto policy = logger::AsyncLogger::FullPolicy::DROP;
+  const char* policy_env = std::getenv("CYBER_LOG_FULL_POLICY");
+  if (policy_env != nullptr && std::strcmp(policy_env, "block") == 0) {
+    policy = logger::AsyncLogger::FullPolicy::BLOCK;
+  }
   async_logger = new ::apollo::cyber::logger::AsyncLogger(
-      google::base::GetLogger(FLAGS_minloglevel));
+      google::base::GetLogger(FLAGS_minloglevel), ring_size, policy);
   google::base::SetLogger(FLAGS_minloglevel, async_logger);
   async_logger->Start();
 }
 
 void StopLogger() { delete async_logger; }
 
+// CYBER_PROFILER_TRACE_DIR writes the profiler spans to a Chrome trace file,
+// CYBER_PROFILER_TRACE_CHANNEL publishes them as RawMessage on a channel
+void InitTraceExporter() {
+  auto trace_dir = common::GetEnv("CYBER_PROFILER_TRACE_DIR");
+  auto trace_channel = common::GetEnv("CYBER_PROFILER_TRACE_CHANNEL");
+  if (trace_dir.empty() && trace_channel.empty()) {
+    return;
+  }
+
+  auto exporter = profiler::TraceExporter::Instance();
+  if (!trace_channel.empty()) {
+    trace_node.reset(new Node(kTraceNode + std::to_string(getpid())));
+    auto writer = trace_node->CreateWriter<message::RawMessage>(trace_channel);
+    if (writer != nullptr) {
+      exporter->AddSink([writer](const std::string& events) {
+        writer->Write(std::make_shared<message::RawMessage>(events));
+      });
+    }
+  }
+  std::string trace_file;
+  if (!trace_dir.empty()) {
+    trace_file = trace_dir + "/" + GlobalData::Instance()->ProcessGroup() +
+                 "." + std::to_string(getpid()) + ".trace.json";
+  }
+  exporter->Start(trace_file);
+}
+
 }  // namespace
 
 void OnShutdown(int sig) {
@@ -148,6 +194,8 @@ bool Init(const char* binary_name, const std::string& dag_info) {
   google::SetCommandLineOption("bvar_dump_exclude", "*qps");
   google::SetCommandLineOption("bvar_dump", "true");
 
+  InitTraceExporter();
+
   return true;
 }
 
@@ -156,12 +204,16 @@ void Clear() {
   if (GetState() == STATE_SHUTDOWN || GetState() == STATE_UNINITIALIZED) {
     return;
   }
+  profiler::TraceExporter::CleanUp();
+  trace_node.reset();
   SysMo::CleanUp();
   TaskManager::CleanUp();
   TimingWheel::CleanUp();
+  PreciseTimingWheel::CleanUp();
   scheduler::CleanUp();
   service_discovery::TopologyManager::CleanUp();
   transport::Transport::CleanUp();
+  statistics::ChannelStats::CleanUp();
   StopLogger();
   SetState(STATE_SHUTDOWN);
 }
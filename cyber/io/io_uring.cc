@@ -0,0 +1,314 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/io/io_uring.h"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <memory>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace io {
+
+#if CYBER_IO_URING_SUPPORTED
+
+namespace {
+
+int SysSetup(unsigned entries, io_uring_params* params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int SysEnter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags,
+             const void* arg, size_t arg_size) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit,
+                                  min_complete, flags, arg, arg_size));
+}
+
+int SysRegister(int fd, unsigned opcode, const void* arg, unsigned nr_args) {
+  return static_cast<int>(
+      syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+void* MapRing(int fd, size_t size, off_t offset) {
+  void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, fd, offset);
+  return ptr == MAP_FAILED ? nullptr : ptr;
+}
+
+}  // namespace
+
+IoUring::~IoUring() { Close(); }
+
+bool IoUring::Init(unsigned entries) {
+  io_uring_params params;
+  std::memset(&params, 0, sizeof(params));
+  ring_fd_ = SysSetup(entries, &params);
+  if (ring_fd_ < 0) {
+    AINFO << "io_uring setup failed, " << strerror(errno);
+    ring_fd_ = -1;
+    return false;
+  }
+  // the wait timeout goes through IORING_ENTER_EXT_ARG
+  const unsigned required = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP |
+                            IORING_FEAT_EXT_ARG;
+  if ((params.features & required) != required) {
+    AINFO << "io_uring lacks required features: " << params.features;
+    Close();
+    return false;
+  }
+
+  sq_entries_ = params.sq_entries;
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ =
+      params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  sq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  sq_ring_ = MapRing(ring_fd_, sq_ring_size_, IORING_OFF_SQ_RING);
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  sqes_ = static_cast<io_uring_sqe*>(
+      MapRing(ring_fd_, sqes_size_, IORING_OFF_SQES));
+  if (sq_ring_ == nullptr || sqes_ == nullptr) {
+    AERROR << "io_uring mmap failed, " << strerror(errno);
+    Close();
+    return false;
+  }
+  // single mmap, the completion queue shares the submission queue mapping
+  cq_ring_ = sq_ring_;
+
+  auto sq = static_cast<char*>(sq_ring_);
+  sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+  sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+  sqe_head_ = sqe_tail_ = *sq_tail_;
+
+  auto cq = static_cast<char*>(cq_ring_);
+  cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+  cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+  const size_t probe_size =
+      sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op);
+  std::unique_ptr<char[]> probe_buf(new char[probe_size]());
+  auto probe = reinterpret_cast<io_uring_probe*>(probe_buf.get());
+  if (SysRegister(ring_fd_, IORING_REGISTER_PROBE, probe, 256) == 0) {
+    for (unsigned i = 0; i < probe->ops_len && i < 256; ++i) {
+      if (probe->ops[i].flags & IO_URING_OP_SUPPORTED) {
+        supported_ops_[probe->ops[i].op] = true;
+      }
+    }
+  }
+  return true;
+}
+
+void IoUring::Close() {
+  if (sqes_ != nullptr) {
+    munmap(sqes_, sqes_size_);
+    sqes_ = nullptr;
+  }
+  if (sq_ring_ != nullptr) {
+    munmap(sq_ring_, sq_ring_size_);
+    sq_ring_ = nullptr;
+    cq_ring_ = nullptr;
+  }
+  if (ring_fd_ >= 0) {
+    close(ring_fd_);
+    ring_fd_ = -1;
+  }
+}
+
+bool IoUring::IsOpCodeSupported(uint8_t op) const {
+  return supported_ops_[op];
+}
+
+io_uring_sqe* IoUring::GetSqe() {
+  unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+  if (sqe_tail_ - head >= sq_entries_) {
+    return nullptr;
+  }
+  io_uring_sqe* sqe = &sqes_[sqe_tail_ & sq_mask_];
+  ++sqe_tail_;
+  std::memset(sqe, 0, sizeof(*sqe));
+  return sqe;
+}
+
+int IoUring::Submit(unsigned wait_nr, int timeout_ms) {
+  unsigned to_submit = sqe_tail_ - sqe_head_;
+  unsigned tail = *sq_tail_;
+  for (; sqe_head_ != sqe_tail_; ++sqe_head_, ++tail) {
+    sq_array_[tail & sq_mask_] = sqe_head_ & sq_mask_;
+  }
+  __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+  if (to_submit == 0 && wait_nr == 0) {
+    return 0;
+  }
+  return Enter(to_submit, wait_nr, timeout_ms);
+}
+
+int IoUring::Enter(unsigned to_submit, unsigned min_complete, int timeout_ms) {
+  unsigned flags = 0;
+  if (min_complete > 0) {
+    flags |= IORING_ENTER_GETEVENTS;
+  }
+  __kernel_timespec ts;
+  io_uring_getevents_arg arg;
+  std::memset(&arg, 0, sizeof(arg));
+  if (timeout_ms >= 0) {
+    ts.tv_sec = timeout_ms / 1000;
+    ts.tv_nsec = static_cast<int64_t>(timeout_ms % 1000) * 1000000;
+    arg.ts = reinterpret_cast<uint64_t>(&ts);
+  }
+  arg.sigmask_sz = _NSIG / 8;
+  flags |= IORING_ENTER_EXT_ARG;
+
+  int ret = SysEnter(ring_fd_, to_submit, min_complete, flags, &arg,
+                     sizeof(arg));
+  if (ret < 0) {
+    // ETIME and EINTR only mean nothing completed in time
+    return -errno;
+  }
+  return ret;
+}
+
+BufferRing::~BufferRing() { Release(); }
+
+bool BufferRing::Init(IoUring* ring, uint16_t group_id, uint16_t buffer_num,
+                      uint32_t buffer_size) {
+  if (buffer_num == 0 || (buffer_num & (buffer_num - 1)) != 0) {
+    AERROR << "buffer num must be a power of 2: " << buffer_num;
+    return false;
+  }
+  ring_ = ring;
+  group_id_ = group_id;
+  buffer_num_ = buffer_num;
+  buffer_size_ = buffer_size;
+
+  buf_ring_size_ = buffer_num * sizeof(io_uring_buf);
+  void* ptr = mmap(nullptr, buf_ring_size_, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ptr == MAP_FAILED) {
+    AERROR << "mmap buffer ring failed, " << strerror(errno);
+    return false;
+  }
+  buf_ring_ = static_cast<io_uring_buf_ring*>(ptr);
+
+  buffers_size_ = static_cast<size_t>(buffer_num) * buffer_size;
+  ptr = mmap(nullptr, buffers_size_, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ptr == MAP_FAILED) {
+    AERROR << "mmap buffers failed, " << strerror(errno);
+    Release();
+    return false;
+  }
+  buffers_ = static_cast<char*>(ptr);
+
+  io_uring_buf_reg reg;
+  std::memset(&reg, 0, sizeof(reg));
+  reg.ring_addr = reinterpret_cast<uint64_t>(buf_ring_);
+  reg.ring_entries = buffer_num;
+  reg.bgid = group_id;
+  if (SysRegister(ring_->fd(), IORING_REGISTER_PBUF_RING, &reg, 1) != 0) {
+    AINFO << "register buffer ring failed, " << strerror(errno);
+    ring_ = nullptr;
+    Release();
+    return false;
+  }
+
+  tail_ = 0;
+  for (uint16_t i = 0; i < buffer_num; ++i) {
+    Recycle(i);
+  }
+  return true;
+}
+
+void BufferRing::Release() {
+  if (ring_ != nullptr && ring_->fd() >= 0) {
+    io_uring_buf_reg reg;
+    std::memset(&reg, 0, sizeof(reg));
+    reg.bgid = group_id_;
+    SysRegister(ring_->fd(), IORING_UNREGISTER_PBUF_RING, &reg, 1);
+  }
+  ring_ = nullptr;
+  if (buf_ring_ != nullptr) {
+    munmap(buf_ring_, buf_ring_size_);
+    buf_ring_ = nullptr;
+  }
+  if (buffers_ != nullptr) {
+    munmap(buffers_, buffers_size_);
+    buffers_ = nullptr;
+  }
+}
+
+void BufferRing::Recycle(uint16_t buffer_id) {
+  io_uring_buf* buf = &buf_ring_->bufs[tail_ & (buffer_num_ - 1)];
+  buf->addr = reinterpret_cast<uint64_t>(Buffer(buffer_id));
+  buf->len = buffer_size_;
+  buf->bid = buffer_id;
+  ++tail_;
+  __atomic_store_n(&buf_ring_->tail, tail_, __ATOMIC_RELEASE);
+}
+
+#else  // !CYBER_IO_URING_SUPPORTED
+
+IoUring::~IoUring() { Close(); }
+
+bool IoUring::Init(unsigned /*entries*/) {
+  AINFO << "io_uring is not built in, kernel headers older than 6.0";
+  return false;
+}
+
+void IoUring::Close() {}
+
+bool IoUring::IsOpCodeSupported(uint8_t op) const {
+  return supported_ops_[op];
+}
+
+io_uring_sqe* IoUring::GetSqe() { return nullptr; }
+
+int IoUring::Submit(unsigned /*wait_nr*/, int /*timeout_ms*/) {
+  return -ENOSYS;
+}
+
+int IoUring::Enter(unsigned /*to_submit*/, unsigned /*min_complete*/,
+                   int /*timeout_ms*/) {
+  return -ENOSYS;
+}
+
+BufferRing::~BufferRing() { Release(); }
+
+bool BufferRing::Init(IoUring* /*ring*/, uint16_t /*group_id*/,
+                      uint16_t /*buffer_num*/, uint32_t /*buffer_size*/) {
+  return false;
+}
+
+void BufferRing::Release() {}
+
+void BufferRing::Recycle(uint16_t /*buffer_id*/) {}
+
+#endif  // CYBER_IO_URING_SUPPORTED
+
+}  // namespace io
+}  // namespace cyber
+}  // namespace apollo
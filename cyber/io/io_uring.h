@@ -0,0 +1,175 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_IO_IO_URING_H_
+#define CYBER_IO_IO_URING_H_
+
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+#endif
+
+#include <cstddef>
+#include <cstdint>
+
+#include "cyber/common/macros.h"
+
+// Multishot recvmsg, io_uring_recvmsg_out and provided buffer rings came with
+// the Linux 6.0 uapi headers. Built against older ones, IoUring::Init always
+// fails and the poller runs on epoll.
+#if defined(IORING_RECV_MULTISHOT)
+#define CYBER_IO_URING_SUPPORTED 1
+#else
+#define CYBER_IO_URING_SUPPORTED 0
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct io_uring_buf_ring;
+#endif
+
+namespace apollo {
+namespace cyber {
+namespace io {
+
+/**
+ * @class IoUring
+ * @brief Minimal io_uring wrapper on the raw system calls.
+ *
+ * Sqes handed out by GetSqe are only made visible to the kernel by Submit, so
+ * everything prepared in between goes out in a single io_uring_enter. Not
+ * thread safe: one thread owns the submission and completion queues.
+ */
+class IoUring {
+ public:
+  IoUring() = default;
+  ~IoUring();
+
+  // false when io_uring is unavailable or lacks the features we rely on
+  bool Init(unsigned entries);
+  void Close();
+
+  bool IsOpCodeSupported(uint8_t op) const;
+
+  // zeroed sqe, nullptr if the submission queue is full
+  io_uring_sqe* GetSqe();
+
+  /**
+   * @brief Submit the prepared sqes and wait for at least wait_nr
+   * completions, or timeout_ms when it is not negative.
+   *
+   * @return the number of sqes submitted, or -errno
+   */
+  int Submit(unsigned wait_nr = 0, int timeout_ms = -1);
+
+  // calls func(const io_uring_cqe&) for every completion, then releases them
+  template <typename Func>
+  unsigned ForEachCqe(Func&& func);
+
+  int fd() const { return ring_fd_; }
+
+ private:
+  int Enter(unsigned to_submit, unsigned min_complete, int timeout_ms);
+
+  int ring_fd_ = -1;
+  unsigned sq_entries_ = 0;
+
+  void* sq_ring_ = nullptr;
+  size_t sq_ring_size_ = 0;
+  void* cq_ring_ = nullptr;
+  size_t cq_ring_size_ = 0;
+  io_uring_sqe* sqes_ = nullptr;
+  size_t sqes_size_ = 0;
+
+  unsigned* sq_head_ = nullptr;
+  unsigned* sq_tail_ = nullptr;
+  unsigned sq_mask_ = 0;
+  unsigned* sq_array_ = nullptr;
+  // sqes handed out but not submitted yet live in [sqe_head_, sqe_tail_)
+  unsigned sqe_head_ = 0;
+  unsigned sqe_tail_ = 0;
+
+  unsigned* cq_head_ = nullptr;
+  unsigned* cq_tail_ = nullptr;
+  unsigned cq_mask_ = 0;
+  io_uring_cqe* cqes_ = nullptr;
+
+  bool supported_ops_[256] = {};
+
+  DISALLOW_COPY_AND_ASSIGN(IoUring);
+};
+
+/**
+ * @class BufferRing
+ * @brief Ring of provided buffers registered with an IoUring, the kernel picks
+ * one of them for every completion of a buffer select request.
+ *
+ * Recycle may be called from any thread as long as calls are serialized, the
+ * kernel is the only consumer.
+ */
+class BufferRing {
+ public:
+  BufferRing() = default;
+  ~BufferRing();
+
+  bool Init(IoUring* ring, uint16_t group_id, uint16_t buffer_num,
+            uint32_t buffer_size);
+  void Release();
+
+  char* Buffer(uint16_t buffer_id) const {
+    return buffers_ + static_cast<size_t>(buffer_id) * buffer_size_;
+  }
+  // hands buffer_id back to the kernel
+  void Recycle(uint16_t buffer_id);
+
+  uint16_t group_id() const { return group_id_; }
+  uint32_t buffer_size() const { return buffer_size_; }
+
+ private:
+  IoUring* ring_ = nullptr;
+  io_uring_buf_ring* buf_ring_ = nullptr;
+  size_t buf_ring_size_ = 0;
+  char* buffers_ = nullptr;
+  size_t buffers_size_ = 0;
+  uint16_t group_id_ = 0;
+  uint16_t buffer_num_ = 0;
+  uint32_t buffer_size_ = 0;
+  uint16_t tail_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(BufferRing);
+};
+
+template <typename Func>
+unsigned IoUring::ForEachCqe(Func&& func) {
+#if CYBER_IO_URING_SUPPORTED
+  unsigned head = *cq_head_;
+  unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+  unsigned count = 0;
+  for (; head != tail; ++head, ++count) {
+    func(cqes_[head & cq_mask_]);
+  }
+  __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+  return count;
+#else
+  (void)func;
+  return 0;
+#endif
+}
+
+}  // namespace io
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_IO_IO_URING_H_
@@ -21,6 +21,7 @@
 #include <unistd.h>
 
 #include <csignal>
+#include <cstdlib>
 #include <cstring>
 
 #include "cyber/common/log.h"
@@ -111,10 +112,19 @@ bool Poller::Unregister(const PollRequest& req) {
 }
 
 bool Poller::Init() {
-  epoll_fd_ = epoll_create(kPollSize);
-  if (epoll_fd_ < 0) {
-    AERROR << "epoll create failed, " << strerror(errno);
-    return false;
+  const char* backend = std::getenv("CYBER_IO_BACKEND");
+  if (backend != nullptr && std::strcmp(backend, "io_uring") == 0) {
+    use_io_uring_ = InitIoUring();
+    if (!use_io_uring_) {
+      AWARN << "io_uring is not available, fall back to epoll";
+    }
+  }
+  if (!use_io_uring_) {
+    epoll_fd_ = epoll_create(kPollSize);
+    if (epoll_fd_ < 0) {
+      AERROR << "epoll create failed, " << strerror(errno);
+      return false;
+    }
   }
 
   // create pipe, and set nonblock
@@ -156,6 +166,65 @@ bool Poller::Init() {
   return true;
 }
 
+auto Poller::OpenRecvChannel(int fd) -> RecvChannelPtr {
+  if (!use_io_uring_ || !recv_multishot_.load() || is_shutdown_.load()) {
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(recv_mutex_);
+  auto it = recv_channels_.find(fd);
+  if (it != recv_channels_.end()) {
+    return it->second;
+  }
+  uint16_t group_id = 0;
+  while (group_id < kRecvGroupNum && recv_group_ids_[group_id]) {
+    ++group_id;
+  }
+  if (group_id == kRecvGroupNum) {
+    AWARN << "too many receive channels, fd[" << fd << "] uses recv";
+    return nullptr;
+  }
+
+  auto channel = std::make_shared<RecvChannel>(fd, group_id);
+  if (!channel->Init(&ring_, kRecvBufferNum, kRecvBufferSize)) {
+    // the kernel has io_uring but no provided buffer rings
+    recv_multishot_.store(false);
+    return nullptr;
+  }
+  std::weak_ptr<RecvChannel> weak_channel = channel;
+  channel->rearm_callback_ = [this, weak_channel]() {
+    auto channel = weak_channel.lock();
+    if (channel == nullptr) {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(recv_mutex_);
+      recv_to_arm_.emplace_back(channel);
+    }
+    Notify();
+  };
+  recv_group_ids_[group_id] = true;
+  recv_channels_[fd] = channel;
+  recv_to_arm_.emplace_back(channel);
+  Notify();
+  return channel;
+}
+
+void Poller::CloseRecvChannel(const RecvChannelPtr& channel) {
+  if (channel == nullptr) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(recv_mutex_);
+    auto it = recv_channels_.find(channel->fd());
+    if (it != recv_channels_.end() && it->second == channel) {
+      recv_channels_.erase(it);
+    }
+    recv_to_close_.emplace_back(channel);
+  }
+  Notify();
+}
+
 void Poller::Clear() {
   if (thread_.joinable()) {
     thread_.join();
@@ -166,6 +235,27 @@ void Poller::Clear() {
     epoll_fd_ = -1;
   }
 
+  if (use_io_uring_) {
+    // closing the ring cancels everything in flight before buffers go away
+    ring_.Close();
+    std::lock_guard<std::mutex> lock(recv_mutex_);
+    for (auto& item : recv_channels_) {
+      item.second->Release();
+    }
+    for (auto& item : armed_recvs_) {
+      item.second->Release();
+    }
+    for (auto& channel : recv_to_close_) {
+      channel->Release();
+    }
+    recv_channels_.clear();
+    armed_recvs_.clear();
+    recv_to_arm_.clear();
+    recv_to_close_.clear();
+    poll_user_data_.clear();
+    ready_fds_.clear();
+  }
+
   if (pipe_fd_[0] >= 0) {
     close(pipe_fd_[0]);
     pipe_fd_[0] = -1;
@@ -184,9 +274,10 @@ void Poller::Clear() {
 }
 
 void Poller::Poll(int timeout_ms) {
-  epoll_event evt[kPollSize];
+  ResponseMap responses;
   auto before_time_ns = Time::Now().ToNanosecond();
-  int ready_num = epoll_wait(epoll_fd_, evt, kPollSize, timeout_ms);
+  int ready_num = use_io_uring_ ? UringWait(timeout_ms, &responses)
+                                : EpollWait(timeout_ms, &responses);
   auto after_time_ns = Time::Now().ToNanosecond();
   int interval_ms =
       static_cast<int>((after_time_ns - before_time_ns) / 1000000);
@@ -194,7 +285,6 @@ void Poller::Poll(int timeout_ms) {
     interval_ms = 1;
   }
 
-  std::unordered_map<int, PollResponse> responses;
   {
     ReadLockGuard<AtomicRWLock> lck(poll_data_lock_);
     for (auto& item : requests_) {
@@ -211,20 +301,13 @@ void Poller::Poll(int timeout_ms) {
       }
 
       if (request->timeout_ms == 0) {
-        responses[item.first] = PollResponse();
+        // a ready fd reports its events rather than the timeout
+        responses.emplace(item.first, PollResponse());
         request->timeout_ms = -1;
       }
     }
   }
 
-  if (ready_num > 0) {
-    for (int i = 0; i < ready_num; ++i) {
-      int fd = evt[i].data.fd;
-      uint32_t events = evt[i].events;
-      responses[fd] = PollResponse(events);
-    }
-  }
-
   for (auto& item : responses) {
     int fd = item.first;
     auto& response = item.second;
@@ -239,11 +322,20 @@ void Poller::Poll(int timeout_ms) {
 
   if (ready_num < 0) {
     if (errno != EINTR) {
-      AERROR << "epoll wait failed, " << strerror(errno);
+      AERROR << "poll wait failed, " << strerror(errno);
     }
   }
 }
 
+int Poller::EpollWait(int timeout_ms, ResponseMap* responses) {
+  epoll_event evt[kPollSize];
+  int ready_num = epoll_wait(epoll_fd_, evt, kPollSize, timeout_ms);
+  for (int i = 0; i < ready_num; ++i) {
+    (*responses)[evt[i].data.fd] = PollResponse(evt[i].events);
+  }
+  return ready_num;
+}
+
 void Poller::ThreadFunc() {
   // block all signals in this thread
   sigset_t signal_set;
@@ -259,6 +351,10 @@ void Poller::ThreadFunc() {
 }
 
 void Poller::HandleChanges() {
+  if (use_io_uring_) {
+    HandleRecvChanges();
+  }
+
   CtrlParamMap local_params;
   {
     ReadLockGuard<AtomicRWLock> lck(poll_data_lock_);
@@ -268,6 +364,11 @@ void Poller::HandleChanges() {
     local_params.swap(ctrl_params_);
   }
 
+  if (use_io_uring_) {
+    HandleUringChanges(local_params);
+    return;
+  }
+
   for (auto& pair : local_params) {
     auto& item = pair.second;
     ADEBUG << "epoll ctl, op[" << item.operation << "] fd[" << item.fd
@@ -279,6 +380,19 @@ void Poller::HandleChanges() {
   }
 }
 
+uint64_t Poller::NextUserData(UserDataType type, int fd) {
+  ++user_data_seq_;
+  return (static_cast<uint64_t>(type) << 56) |
+         (static_cast<uint64_t>(user_data_seq_ & 0xffffff) << 32) |
+         static_cast<uint32_t>(fd);
+}
+
+auto Poller::FindRecvChannel(int fd) -> RecvChannelPtr {
+  std::lock_guard<std::mutex> lock(recv_mutex_);
+  auto it = recv_channels_.find(fd);
+  return it == recv_channels_.end() ? nullptr : it->second;
+}
+
 // min heap can be used to optimize
 int Poller::GetTimeoutMs() {
   int timeout_ms = kPollTimeoutMs;
@@ -304,6 +418,224 @@ void Poller::Notify() {
   }
 }
 
+#if CYBER_IO_URING_SUPPORTED
+
+bool Poller::InitIoUring() {
+  if (!ring_.Init(kUringEntries)) {
+    return false;
+  }
+  if (!ring_.IsOpCodeSupported(IORING_OP_POLL_ADD) ||
+      !ring_.IsOpCodeSupported(IORING_OP_POLL_REMOVE)) {
+    ring_.Close();
+    return false;
+  }
+  // whether multishot is supported shows on the first receive
+  recv_multishot_.store(ring_.IsOpCodeSupported(IORING_OP_RECVMSG) &&
+                        ring_.IsOpCodeSupported(IORING_OP_ASYNC_CANCEL));
+  recv_group_ids_.assign(kRecvGroupNum, false);
+  AINFO << "io poller runs on io_uring, multishot receive: "
+        << recv_multishot_.load();
+  return true;
+}
+
+int Poller::UringWait(int timeout_ms, ResponseMap* responses) {
+  if (!ready_fds_.empty()) {
+    timeout_ms = 0;
+  }
+  // the sqes prepared by HandleChanges go out with the wait
+  int ret = ring_.Submit(1, timeout_ms);
+  if (ret < 0 && ret != -ETIME && ret != -EINTR && ret != -EBUSY) {
+    errno = -ret;
+    return -1;
+  }
+  int ready_num = static_cast<int>(ring_.ForEachCqe(
+      [this, responses](const io_uring_cqe& cqe) {
+        HandleCqe(cqe, responses);
+      }));
+  for (int fd : ready_fds_) {
+    (*responses)[fd] = PollResponse(EPOLLIN);
+  }
+  ready_fds_.clear();
+  return ready_num;
+}
+
+void Poller::HandleCqe(const io_uring_cqe& cqe, ResponseMap* responses) {
+  auto type = static_cast<UserDataType>(cqe.user_data >> 56);
+  int fd = static_cast<int>(cqe.user_data & 0xffffffff);
+  const bool more = (cqe.flags & IORING_CQE_F_MORE) != 0;
+
+  if (type == POLL) {
+    auto it = poll_user_data_.find(fd);
+    if (it == poll_user_data_.end() || it->second != cqe.user_data) {
+      // removed or replaced in the meantime
+      return;
+    }
+    if (!more) {
+      poll_user_data_.erase(it);
+    }
+    if (cqe.res >= 0) {
+      (*responses)[fd] = PollResponse(static_cast<uint32_t>(cqe.res));
+    }
+    if (!more && fd == pipe_fd_[0]) {
+      ArmPoll(fd, EPOLLIN);
+    }
+    return;
+  }
+
+  if (type == RECV) {
+    auto it = armed_recvs_.find(cqe.user_data);
+    if (it == armed_recvs_.end()) {
+      return;
+    }
+    auto channel = it->second;
+    bool readable = channel->OnCompletion(cqe);
+    if (!channel->armed_) {
+      armed_recvs_.erase(it);
+      if (channel->closing_) {
+        channel->Release();
+        std::lock_guard<std::mutex> lock(recv_mutex_);
+        recv_group_ids_[channel->group_id()] = false;
+      } else if (!channel->usable()) {
+        recv_multishot_.store(false);
+        AWARN << "multishot receive does not work, fall back to recv";
+      } else if (!channel->eof_ && !channel->starved_.load()) {
+        // an error ended it, e.g. an ICMP error on a datagram socket
+        ArmRecv(channel);
+      }
+    }
+    if (readable && channel->waiting_) {
+      channel->waiting_ = false;
+      (*responses)[channel->fd()] = PollResponse(EPOLLIN);
+    }
+  }
+}
+
+void Poller::HandleUringChanges(const CtrlParamMap& params) {
+  for (auto& pair : params) {
+    auto& item = pair.second;
+    ADEBUG << "uring ctl, op[" << item.operation << "] fd[" << item.fd
+           << "] events[" << item.event.events << "]";
+    RemovePoll(item.fd);
+    auto channel = FindRecvChannel(item.fd);
+    if (item.operation == EPOLL_CTL_DEL) {
+      if (channel != nullptr) {
+        channel->waiting_ = false;
+      }
+      continue;
+    }
+
+    if (channel != nullptr && channel->usable() &&
+        (item.event.events & EPOLLIN)) {
+      channel->waiting_ = true;
+      if (channel->Readable()) {
+        channel->waiting_ = false;
+        ready_fds_.emplace_back(item.fd);
+      }
+      continue;
+    }
+    ArmPoll(item.fd, item.event.events);
+  }
+}
+
+void Poller::HandleRecvChanges() {
+  std::vector<RecvChannelPtr> to_arm;
+  std::vector<RecvChannelPtr> to_close;
+  {
+    std::lock_guard<std::mutex> lock(recv_mutex_);
+    to_arm.swap(recv_to_arm_);
+    to_close.swap(recv_to_close_);
+  }
+
+  for (auto& channel : to_arm) {
+    ArmRecv(channel);
+  }
+  for (auto& channel : to_close) {
+    channel->closing_ = true;
+    channel->waiting_ = false;
+    if (!channel->armed_) {
+      channel->Release();
+      std::lock_guard<std::mutex> lock(recv_mutex_);
+      recv_group_ids_[channel->group_id()] = false;
+      continue;
+    }
+    auto sqe = GetSqe();
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = channel->user_data_;
+    sqe->user_data = NextUserData(CTRL, channel->fd());
+  }
+}
+
+io_uring_sqe* Poller::GetSqe() {
+  auto sqe = ring_.GetSqe();
+  while (sqe == nullptr) {
+    // submission queue full, flush what is prepared so far
+    ring_.Submit();
+    sqe = ring_.GetSqe();
+  }
+  return sqe;
+}
+
+void Poller::ArmPoll(int fd, uint32_t events) {
+  auto sqe = GetSqe();
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = fd;
+  sqe->poll32_events = events & ~(EPOLLET | EPOLLONESHOT);
+  if (!(events & EPOLLONESHOT)) {
+    sqe->len = IORING_POLL_ADD_MULTI;
+  }
+  sqe->user_data = NextUserData(POLL, fd);
+  poll_user_data_[fd] = sqe->user_data;
+}
+
+void Poller::RemovePoll(int fd) {
+  auto it = poll_user_data_.find(fd);
+  if (it == poll_user_data_.end()) {
+    return;
+  }
+  auto sqe = GetSqe();
+  sqe->opcode = IORING_OP_POLL_REMOVE;
+  sqe->fd = -1;
+  sqe->addr = it->second;
+  sqe->user_data = NextUserData(CTRL, fd);
+  poll_user_data_.erase(it);
+}
+
+void Poller::ArmRecv(const RecvChannelPtr& channel) {
+  if (channel->armed_ || channel->closing_ || !channel->usable()) {
+    return;
+  }
+  auto user_data = NextUserData(RECV, channel->fd());
+  channel->PrepareRecv(GetSqe(), user_data);
+  armed_recvs_[user_data] = channel;
+}
+
+#else  // !CYBER_IO_URING_SUPPORTED
+
+// built against kernel headers without multishot receive, epoll only
+bool Poller::InitIoUring() { return false; }
+
+int Poller::UringWait(int /*timeout_ms*/, ResponseMap* /*responses*/) {
+  return 0;
+}
+
+void Poller::HandleCqe(const io_uring_cqe& /*cqe*/,
+                       ResponseMap* /*responses*/) {}
+
+void Poller::HandleUringChanges(const CtrlParamMap& /*params*/) {}
+
+void Poller::HandleRecvChanges() {}
+
+io_uring_sqe* Poller::GetSqe() { return nullptr; }
+
+void Poller::ArmPoll(int /*fd*/, uint32_t /*events*/) {}
+
+void Poller::RemovePoll(int /*fd*/) {}
+
+void Poller::ArmRecv(const RecvChannelPtr& /*channel*/) {}
+
+#endif  // CYBER_IO_URING_SUPPORTED
+
 }  // namespace io
 }  // namespace cyber
 }  // namespace apollo
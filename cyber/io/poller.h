@@ -27,17 +27,30 @@
 
 #include "cyber/base/atomic_rw_lock.h"
 #include "cyber/common/macros.h"
+#include "cyber/io/io_uring.h"
 #include "cyber/io/poll_data.h"
+#include "cyber/io/recv_channel.h"
 
 namespace apollo {
 namespace cyber {
 namespace io {
 
+/**
+ * @class Poller
+ * @brief Waits for the PollRequests of all sessions on one thread.
+ *
+ * With CYBER_IO_BACKEND=io_uring the requests become poll sqes of an
+ * io_uring, submitted together with the wait in one system call, and
+ * datagram sockets can hand their receive path to a RecvChannel fed by a
+ * multishot recvmsg. Without io_uring support the poller falls back to epoll.
+ */
 class Poller {
  public:
   using RequestPtr = std::shared_ptr<PollRequest>;
   using RequestMap = std::unordered_map<int, RequestPtr>;
   using CtrlParamMap = std::unordered_map<int, PollCtrlParam>;
+  using ResponseMap = std::unordered_map<int, PollResponse>;
+  using RecvChannelPtr = std::shared_ptr<RecvChannel>;
 
   virtual ~Poller();
 
@@ -46,15 +59,43 @@ class Poller {
   bool Register(const PollRequest& req);
   bool Unregister(const PollRequest& req);
 
+  bool UseIoUring() const { return use_io_uring_; }
+
+  /**
+   * @brief Start a multishot receive on a datagram socket. While the
+   * channel is open, read requests of fd wait for the channel instead of
+   * polling the socket.
+   *
+   * @return nullptr if the poller does not run on io_uring or the kernel
+   * lacks multishot receive
+   */
+  RecvChannelPtr OpenRecvChannel(int fd);
+  void CloseRecvChannel(const RecvChannelPtr& channel);
+
  private:
+  enum UserDataType : uint64_t { POLL = 1, RECV = 2, CTRL = 3 };
+
   bool Init();
+  bool InitIoUring();
   void Clear();
   void Poll(int timeout_ms);
+  int EpollWait(int timeout_ms, ResponseMap* responses);
+  int UringWait(int timeout_ms, ResponseMap* responses);
   void ThreadFunc();
   void HandleChanges();
+  void HandleUringChanges(const CtrlParamMap& params);
+  void HandleRecvChanges();
+  void HandleCqe(const io_uring_cqe& cqe, ResponseMap* responses);
   int GetTimeoutMs();
   void Notify();
 
+  io_uring_sqe* GetSqe();
+  uint64_t NextUserData(UserDataType type, int fd);
+  void ArmPoll(int fd, uint32_t events);
+  void RemovePoll(int fd);
+  void ArmRecv(const RecvChannelPtr& channel);
+  RecvChannelPtr FindRecvChannel(int fd);
+
   int epoll_fd_ = -1;
   std::thread thread_;
   std::atomic<bool> is_shutdown_ = {true};
@@ -66,8 +107,28 @@ class Poller {
   CtrlParamMap ctrl_params_;
   base::AtomicRWLock poll_data_lock_;
 
+  // io_uring backend, the ring and the maps below belong to the poll thread
+  bool use_io_uring_ = false;
+  IoUring ring_;
+  uint32_t user_data_seq_ = 0;
+  std::unordered_map<int, uint64_t> poll_user_data_;
+  std::unordered_map<uint64_t, RecvChannelPtr> armed_recvs_;
+  // fds whose RecvChannel has data for a waiting read request
+  std::vector<int> ready_fds_;
+
+  std::atomic<bool> recv_multishot_ = {false};
+  std::mutex recv_mutex_;
+  std::unordered_map<int, RecvChannelPtr> recv_channels_;
+  std::vector<RecvChannelPtr> recv_to_arm_;
+  std::vector<RecvChannelPtr> recv_to_close_;
+  std::vector<bool> recv_group_ids_;
+
   const int kPollSize = 32;
   const int kPollTimeoutMs = 100;
+  const unsigned kUringEntries = 256;
+  const uint16_t kRecvBufferNum = 256;
+  const uint32_t kRecvBufferSize = 2048;
+  const uint16_t kRecvGroupNum = 1024;
 
   DECLARE_SINGLETON(Poller)
 };
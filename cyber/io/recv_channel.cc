@@ -0,0 +1,189 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/io/recv_channel.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace apollo {
+namespace cyber {
+namespace io {
+
+RecvChannel::RecvChannel(int fd, uint16_t group_id)
+    : fd_(fd), group_id_(group_id) {}
+
+#if CYBER_IO_URING_SUPPORTED
+bool RecvChannel::Init(IoUring* ring, uint16_t buffer_num,
+                       uint32_t buffer_size) {
+  // every buffer starts with the recvmsg header and the source address
+  msg_.msg_namelen = sizeof(struct sockaddr_storage);
+  msg_.msg_controllen = 0;
+  return buffer_ring_.Init(
+      ring, group_id_, buffer_num,
+      buffer_size + sizeof(io_uring_recvmsg_out) + msg_.msg_namelen);
+}
+#else
+bool RecvChannel::Init(IoUring* /*ring*/, uint16_t /*buffer_num*/,
+                       uint32_t /*buffer_size*/) {
+  usable_.store(false);
+  return false;
+}
+#endif  // CYBER_IO_URING_SUPPORTED
+
+ssize_t RecvChannel::Recv(void* buf, size_t len, int flags,
+                          struct sockaddr* src_addr, socklen_t* addrlen) {
+  bool rearm = false;
+  ssize_t nbytes = -1;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (packets_.empty()) {
+      if (error_ != 0) {
+        errno = error_;
+        error_ = 0;
+      } else if (eof_) {
+        return 0;
+      } else {
+        errno = EAGAIN;
+      }
+      return -1;
+    }
+
+    const Packet& packet = packets_.front();
+    size_t copied = std::min(len, static_cast<size_t>(packet.len));
+    std::memcpy(buf, packet.data, copied);
+    if (src_addr != nullptr && addrlen != nullptr) {
+      std::memcpy(src_addr, packet.name,
+                  std::min(*addrlen, packet.name_len));
+      *addrlen = packet.name_len;
+    }
+    nbytes = (flags & MSG_TRUNC) ? packet.len : copied;
+
+    if (!(flags & MSG_PEEK)) {
+      if (!released_) {
+        buffer_ring_.Recycle(packet.buffer_id);
+      }
+      packets_.pop_front();
+      rearm = starved_.exchange(false);
+    }
+  }
+  if (rearm && rearm_callback_) {
+    rearm_callback_();
+  }
+  return nbytes;
+}
+
+bool RecvChannel::Readable() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return !packets_.empty() || error_ != 0 || eof_ || !usable_.load();
+}
+
+#if CYBER_IO_URING_SUPPORTED
+void RecvChannel::PrepareRecv(io_uring_sqe* sqe, uint64_t user_data) {
+  sqe->opcode = IORING_OP_RECVMSG;
+  sqe->fd = fd_;
+  sqe->addr = reinterpret_cast<uint64_t>(&msg_);
+  sqe->len = 1;
+  sqe->ioprio |= IORING_RECV_MULTISHOT;
+  sqe->flags |= IOSQE_BUFFER_SELECT;
+  sqe->buf_group = group_id_;
+  sqe->user_data = user_data;
+  user_data_ = user_data;
+  armed_ = true;
+}
+
+bool RecvChannel::OnCompletion(const io_uring_cqe& cqe) {
+  if (!(cqe.flags & IORING_CQE_F_MORE)) {
+    armed_ = false;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (released_) {
+    return false;
+  }
+  if (cqe.res < 0) {
+    switch (-cqe.res) {
+      case ECANCELED:
+        return false;
+      case ENOBUFS:
+        if (received_) {
+          starved_.store(true);
+          return false;
+        }
+        // no buffer was ever taken, the kernel can't use the buffer ring
+        usable_.store(false);
+        return true;
+      case EINVAL:
+      case EOPNOTSUPP:
+        if (!received_) {
+          usable_.store(false);
+          return true;
+        }
+        break;
+      default:
+        break;
+    }
+    error_ = -cqe.res;
+    return true;
+  }
+  if (!(cqe.flags & IORING_CQE_F_BUFFER)) {
+    eof_ = cqe.res == 0;
+    return eof_;
+  }
+
+  uint16_t buffer_id =
+      static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+  const char* buf = buffer_ring_.Buffer(buffer_id);
+  if (static_cast<size_t>(cqe.res) < sizeof(io_uring_recvmsg_out)) {
+    buffer_ring_.Recycle(buffer_id);
+    return false;
+  }
+  auto out = reinterpret_cast<const io_uring_recvmsg_out*>(buf);
+  Packet packet;
+  packet.buffer_id = buffer_id;
+  packet.name = buf + sizeof(io_uring_recvmsg_out);
+  packet.name_len = std::min(out->namelen, msg_.msg_namelen);
+  packet.data = packet.name + msg_.msg_namelen + msg_.msg_controllen;
+  // never past the buffer, even if the kernel reports a truncated payload
+  size_t room = buffer_ring_.buffer_size() - (packet.data - buf);
+  packet.len = static_cast<uint32_t>(
+      std::min(static_cast<size_t>(out->payloadlen), room));
+  packets_.emplace_back(packet);
+  received_ = true;
+  return true;
+}
+#else
+// never armed, Init refuses every channel
+void RecvChannel::PrepareRecv(io_uring_sqe* /*sqe*/,
+                              uint64_t /*user_data*/) {}
+
+bool RecvChannel::OnCompletion(const io_uring_cqe& /*cqe*/) {
+  return false;
+}
+#endif  // CYBER_IO_URING_SUPPORTED
+
+void RecvChannel::Release() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  released_ = true;
+  usable_.store(false);
+  packets_.clear();
+  buffer_ring_.Release();
+}
+
+}  // namespace io
+}  // namespace cyber
+}  // namespace apollo
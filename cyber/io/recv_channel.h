@@ -0,0 +1,114 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_IO_RECV_CHANNEL_H_
+#define CYBER_IO_RECV_CHANNEL_H_
+
+#include <sys/socket.h>
+#include <sys/types.h>
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+#include "cyber/io/io_uring.h"
+
+namespace apollo {
+namespace cyber {
+namespace io {
+
+/**
+ * @class RecvChannel
+ * @brief Datagrams of one socket received by a multishot recvmsg of the
+ * Poller's io_uring.
+ *
+ * The kernel writes every datagram into a buffer of the channel's BufferRing
+ * and the poller thread queues it; Recv copies the oldest one out and hands
+ * the buffer back, so a busy socket costs no system call per datagram.
+ */
+class RecvChannel {
+ public:
+  RecvChannel(int fd, uint16_t group_id);
+  ~RecvChannel() = default;
+
+  bool Init(IoUring* ring, uint16_t buffer_num, uint32_t buffer_size);
+
+  /**
+   * @brief Same contract as recvfrom on a non-blocking datagram socket:
+   * -1 with EAGAIN when nothing is queued. MSG_PEEK and MSG_TRUNC are
+   * honored, other flags are ignored.
+   */
+  ssize_t Recv(void* buf, size_t len, int flags, struct sockaddr* src_addr,
+               socklen_t* addrlen);
+
+  // a datagram, an error or the end of stream is waiting for Recv
+  bool Readable();
+
+  // false once the kernel rejected multishot recvmsg, use plain recv instead
+  bool usable() const { return usable_.load(); }
+
+  int fd() const { return fd_; }
+  uint16_t group_id() const { return group_id_; }
+
+ private:
+  friend class Poller;
+
+  struct Packet {
+    uint16_t buffer_id;
+    const char* data;
+    uint32_t len;
+    const char* name;
+    socklen_t name_len;
+  };
+
+  // poller thread only
+  void PrepareRecv(io_uring_sqe* sqe, uint64_t user_data);
+  // returns whether a datagram, an error or the end of stream was queued
+  bool OnCompletion(const io_uring_cqe& cqe);
+  void Release();
+
+  int fd_;
+  uint16_t group_id_;
+  BufferRing buffer_ring_;
+  struct msghdr msg_ = {};
+
+  std::mutex mutex_;
+  std::deque<Packet> packets_;
+  int error_ = 0;
+  bool eof_ = false;
+  bool released_ = false;
+
+  std::atomic<bool> usable_ = {true};
+  // set by the poller when the kernel ran out of buffers, rearm_callback is
+  // called once Recv hands one back
+  std::atomic<bool> starved_ = {false};
+  std::function<void()> rearm_callback_;
+
+  // poller thread only
+  uint64_t user_data_ = 0;
+  bool armed_ = false;
+  bool closing_ = false;
+  bool waiting_ = false;
+  bool received_ = false;
+};
+
+}  // namespace io
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_IO_RECV_CHANNEL_H_
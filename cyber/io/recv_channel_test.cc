@@ -0,0 +1,221 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/io/recv_channel.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "cyber/init.h"
+#include "cyber/io/poller.h"
+
+namespace apollo {
+namespace cyber {
+namespace io {
+
+class RecvChannelTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    poller_ = Poller::Instance();
+    if (!poller_->UseIoUring()) {
+      GTEST_SKIP() << "io_uring is not available";
+    }
+
+    fd_ = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+    ASSERT_GE(fd_, 0);
+    addr_.sin_family = AF_INET;
+    addr_.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr_.sin_port = 0;
+    ASSERT_EQ(bind(fd_, reinterpret_cast<sockaddr*>(&addr_), sizeof(addr_)),
+              0);
+    socklen_t len = sizeof(addr_);
+    ASSERT_EQ(getsockname(fd_, reinterpret_cast<sockaddr*>(&addr_), &len), 0);
+
+    sender_ = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(sender_, 0);
+    sockaddr_in sender_addr = addr_;
+    sender_addr.sin_port = 0;
+    ASSERT_EQ(bind(sender_, reinterpret_cast<sockaddr*>(&sender_addr),
+                   sizeof(sender_addr)),
+              0);
+  }
+
+  void TearDown() override {
+    if (sender_ >= 0) {
+      close(sender_);
+    }
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  void Send(const std::string& msg) {
+    ASSERT_EQ(sendto(sender_, msg.data(), msg.size(), 0,
+                     reinterpret_cast<sockaddr*>(&addr_), sizeof(addr_)),
+              static_cast<ssize_t>(msg.size()));
+  }
+
+  Poller* poller_ = nullptr;
+  int fd_ = -1;
+  int sender_ = -1;
+  sockaddr_in addr_ = {};
+};
+
+TEST_F(RecvChannelTest, recv) {
+  auto channel = poller_->OpenRecvChannel(fd_);
+  if (channel == nullptr) {
+    GTEST_SKIP() << "multishot receive is not available";
+  }
+
+  // a read request of the fd waits for the channel
+  std::atomic<uint32_t> events = {0};
+  PollRequest request;
+  request.fd = fd_;
+  request.events = EPOLLIN | EPOLLET | EPOLLONESHOT;
+  request.timeout_ms = 1000;
+  request.callback = [&events](const PollResponse& rsp) {
+    events = rsp.events;
+  };
+  EXPECT_TRUE(poller_->Register(request));
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  // a channel the kernel refused wakes the request to fall back to recv
+  EXPECT_EQ(events.load() == 0, channel->usable());
+
+  Send("hello");
+  Send("cyber");
+  Send("io_uring");
+  for (int i = 0; i < 100 && events.load() == 0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_NE(events.load() & EPOLLIN, 0);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_TRUE(channel->Readable());
+
+  char buf[64] = {0};
+  if (!channel->usable()) {
+    // the kernel refused the receive, nothing was taken off the socket
+    EXPECT_EQ(recv(fd_, buf, sizeof(buf), 0), 5);
+    EXPECT_EQ(std::string(buf, 5), "hello");
+    EXPECT_TRUE(poller_->Unregister(request));
+    poller_->CloseRecvChannel(channel);
+    EXPECT_EQ(poller_->OpenRecvChannel(fd_), nullptr);
+    GTEST_SKIP() << "multishot receive does not work";
+  }
+
+  // peek leaves the datagram queued
+  EXPECT_EQ(channel->Recv(buf, 3, MSG_PEEK, nullptr, nullptr), 3);
+  EXPECT_EQ(std::string(buf, 3), "hel");
+
+  sockaddr_in src = {};
+  socklen_t src_len = sizeof(src);
+  EXPECT_EQ(channel->Recv(buf, sizeof(buf), 0,
+                          reinterpret_cast<sockaddr*>(&src), &src_len),
+            5);
+  EXPECT_EQ(std::string(buf, 5), "hello");
+  EXPECT_EQ(src_len, sizeof(src));
+  sockaddr_in sender_addr = {};
+  socklen_t sender_len = sizeof(sender_addr);
+  getsockname(sender_, reinterpret_cast<sockaddr*>(&sender_addr),
+              &sender_len);
+  EXPECT_EQ(src.sin_port, sender_addr.sin_port);
+
+  EXPECT_EQ(channel->Recv(buf, sizeof(buf), 0, nullptr, nullptr), 5);
+  EXPECT_EQ(std::string(buf, 5), "cyber");
+
+  // truncated, MSG_TRUNC reports the real length
+  EXPECT_EQ(channel->Recv(buf, 2, MSG_TRUNC, nullptr, nullptr), 8);
+  EXPECT_EQ(std::string(buf, 2), "io");
+
+  EXPECT_EQ(channel->Recv(buf, sizeof(buf), 0, nullptr, nullptr), -1);
+  EXPECT_EQ(errno, EAGAIN);
+  EXPECT_FALSE(channel->Readable());
+
+  // more datagrams than buffers, the channel rearms once Recv frees one
+  const int num = 600;
+  int received = 0;
+  for (int i = 0; i < num; ++i) {
+    Send(std::to_string(i));
+    if (i % 300 == 299) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      while (channel->Recv(buf, sizeof(buf), 0, nullptr, nullptr) > 0) {
+        EXPECT_EQ(std::string(buf, std::to_string(received).size()),
+                  std::to_string(received));
+        ++received;
+      }
+    }
+  }
+  EXPECT_EQ(received, num);
+
+  EXPECT_TRUE(poller_->Unregister(request));
+  poller_->CloseRecvChannel(channel);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_FALSE(channel->usable());
+}
+
+TEST_F(RecvChannelTest, poll) {
+  int pipe_fd[2] = {-1, -1};
+  ASSERT_EQ(pipe(pipe_fd), 0);
+  ASSERT_EQ(fcntl(pipe_fd[0], F_SETFL, O_NONBLOCK), 0);
+
+  // fds without a channel are polled by the ring
+  std::atomic<uint32_t> events = {0};
+  PollRequest request;
+  request.fd = pipe_fd[0];
+  request.events = EPOLLIN | EPOLLET | EPOLLONESHOT;
+  request.timeout_ms = 50;
+  request.callback = [&events](const PollResponse& rsp) {
+    events = rsp.events | 0x80000000;
+  };
+  EXPECT_TRUE(poller_->Register(request));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  // timed out
+  EXPECT_EQ(events.load(), 0x80000000);
+
+  events = 0;
+  request.timeout_ms = 1000;
+  EXPECT_TRUE(poller_->Register(request));
+  char msg = 'C';
+  ASSERT_EQ(write(pipe_fd[1], &msg, 1), 1);
+  for (int i = 0; i < 100 && events.load() == 0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_NE(events.load() & EPOLLIN, 0);
+
+  EXPECT_TRUE(poller_->Unregister(request));
+  close(pipe_fd[0]);
+  close(pipe_fd[1]);
+}
+
+}  // namespace io
+}  // namespace cyber
+}  // namespace apollo
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  setenv("CYBER_IO_BACKEND", "io_uring", 1);
+  apollo::cyber::Init(argv[0]);
+  return RUN_ALL_TESTS();
+}
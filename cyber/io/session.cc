@@ -17,6 +17,7 @@
 #include "cyber/io/session.h"
 
 #include "cyber/common/log.h"
+#include "cyber/io/poller.h"
 
 namespace apollo {
 namespace cyber {
@@ -90,23 +91,64 @@ int Session::Close() {
   ACHECK(fd_ != -1);
 
   poll_handler_->Unblock();
+  if (recv_channel_ != nullptr) {
+    Poller::Instance()->CloseRecvChannel(recv_channel_);
+    recv_channel_.reset();
+  }
+  recv_channel_checked_ = false;
   int res = close(fd_);
   fd_ = -1;
   return res;
 }
 
+RecvChannel *Session::GetRecvChannel() {
+  if (!recv_channel_checked_) {
+    recv_channel_checked_ = true;
+    int type = 0;
+    socklen_t optlen = sizeof(type);
+    if (Poller::Instance()->UseIoUring() &&
+        getsockopt(fd_, SOL_SOCKET, SO_TYPE, &type, &optlen) == 0 &&
+        type == SOCK_DGRAM) {
+      recv_channel_ = Poller::Instance()->OpenRecvChannel(fd_);
+    }
+  }
+  if (recv_channel_ != nullptr && !recv_channel_->usable()) {
+    // nothing queued any more, plain recv takes over
+    Poller::Instance()->CloseRecvChannel(recv_channel_);
+    recv_channel_.reset();
+  }
+  return recv_channel_.get();
+}
+
+ssize_t Session::DoRecv(void *buf, size_t len, int flags,
+                        struct sockaddr *src_addr, socklen_t *addrlen) {
+  auto channel = GetRecvChannel();
+  if (channel != nullptr) {
+    return channel->Recv(buf, len, flags, src_addr, addrlen);
+  }
+  return recvfrom(fd_, buf, len, flags, src_addr, addrlen);
+}
+
+ssize_t Session::DoRead(void *buf, size_t count) {
+  auto channel = GetRecvChannel();
+  if (channel != nullptr) {
+    return channel->Recv(buf, count, 0, nullptr, nullptr);
+  }
+  return read(fd_, buf, count);
+}
+
 ssize_t Session::Recv(void *buf, size_t len, int flags, int timeout_ms) {
   ACHECK(buf != nullptr);
   ACHECK(fd_ != -1);
 
-  ssize_t nbytes = recv(fd_, buf, len, flags);
+  ssize_t nbytes = DoRecv(buf, len, flags, nullptr, nullptr);
   if (timeout_ms == 0) {
     return nbytes;
   }
 
   while (nbytes == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
     if (poll_handler_->Block(timeout_ms, true)) {
-      nbytes = recv(fd_, buf, len, flags);
+      nbytes = DoRecv(buf, len, flags, nullptr, nullptr);
     }
     if (timeout_ms > 0) {
       break;
@@ -121,14 +163,14 @@ ssize_t Session::RecvFrom(void *buf, size_t len, int flags,
   ACHECK(buf != nullptr);
   ACHECK(fd_ != -1);
 
-  ssize_t nbytes = recvfrom(fd_, buf, len, flags, src_addr, addrlen);
+  ssize_t nbytes = DoRecv(buf, len, flags, src_addr, addrlen);
   if (timeout_ms == 0) {
     return nbytes;
   }
 
   while (nbytes == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
     if (poll_handler_->Block(timeout_ms, true)) {
-      nbytes = recvfrom(fd_, buf, len, flags, src_addr, addrlen);
+      nbytes = DoRecv(buf, len, flags, src_addr, addrlen);
     }
     if (timeout_ms > 0) {
       break;
@@ -184,14 +226,14 @@ ssize_t Session::Read(void *buf, size_t count, int timeout_ms) {
   ACHECK(buf != nullptr);
   ACHECK(fd_ != -1);
 
-  ssize_t nbytes = read(fd_, buf, count);
+  ssize_t nbytes = DoRead(buf, count);
   if (timeout_ms == 0) {
     return nbytes;
   }
 
   while ((nbytes == -1) && (errno == EAGAIN || errno == EWOULDBLOCK)) {
     if (poll_handler_->Block(timeout_ms, true)) {
-      nbytes = read(fd_, buf, count);
+      nbytes = DoRead(buf, count);
     }
     if (timeout_ms > 0) {
       break;
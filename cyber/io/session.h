@@ -25,6 +25,7 @@
 #include <memory>
 
 #include "cyber/io/poll_handler.h"
+#include "cyber/io/recv_channel.h"
 
 namespace apollo {
 namespace cyber {
@@ -34,6 +35,7 @@ class Session {
  public:
   using SessionPtr = std::shared_ptr<Session>;
   using PollHandlerPtr = std::unique_ptr<PollHandler>;
+  using RecvChannelPtr = std::shared_ptr<RecvChannel>;
 
   Session();
   explicit Session(int fd);
@@ -69,8 +71,16 @@ class Session {
     poll_handler_->set_fd(fd);
   }
 
+  // datagram sockets receive through the io_uring poller when it runs one
+  RecvChannel *GetRecvChannel();
+  ssize_t DoRecv(void *buf, size_t len, int flags, struct sockaddr *src_addr,
+                 socklen_t *addrlen);
+  ssize_t DoRead(void *buf, size_t count);
+
   int fd_;
   PollHandlerPtr poll_handler_;
+  RecvChannelPtr recv_channel_;
+  bool recv_channel_checked_ = false;
 };
 
 }  // namespace io
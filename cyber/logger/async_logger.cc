@@ -16,6 +16,7 @@
 
 #include "cyber/logger/async_logger.h"
 
+#include <chrono>
 #include <cstdlib>
 #include <string>
 #include <thread>
@@ -31,10 +32,9 @@ namespace logger {
 static const std::unordered_map<char, int> log_level_map = {
     {'F', 3}, {'E', 2}, {'W', 1}, {'I', 0}};
 
-AsyncLogger::AsyncLogger(google::base::Logger* wrapped) : wrapped_(wrapped) {
-  active_buf_.reset(new std::deque<Msg>());
-  flushing_buf_.reset(new std::deque<Msg>());
-}
+AsyncLogger::AsyncLogger(google::base::Logger* wrapped, size_t ring_size,
+                         FullPolicy policy)
+    : wrapped_(wrapped), policy_(policy), ring_(ring_size) {}
 
 AsyncLogger::~AsyncLogger() { Stop(); }
 
@@ -51,9 +51,7 @@ void AsyncLogger::Stop() {
     log_thread_.join();
   }
 
-  FlushBuffer(active_buf_);
-  ACHECK(active_buf_->empty());
-  ACHECK(flushing_buf_->empty());
+  FlushRing();
   // std::cout << "Async Logger Stop!" << std::endl;
 }
 
@@ -64,13 +62,23 @@ void AsyncLogger::Write(bool force_flush, time_t timestamp, const char* message,
     return;
   }
   if (message_len > 0) {
-    auto msg_str = std::string(message, message_len);
-    while (flag_.test_and_set(std::memory_order_acquire)) {
-      cpu_relax();
+    auto len = static_cast<size_t>(message_len);
+    if (cyber_unlikely(len > ring_.MaxMessageSize())) {
+      drop_count_.fetch_add(1, std::memory_order_relaxed);
+    } else if (cyber_unlikely(!ring_.TryPush(timestamp, message, len))) {
+      if (policy_ == FullPolicy::DROP) {
+        drop_count_.fetch_add(1, std::memory_order_relaxed);
+      } else {
+        block_count_.fetch_add(1, std::memory_order_relaxed);
+        while (!ring_.TryPush(timestamp, message, len)) {
+          if (state_.load(std::memory_order_acquire) != RUNNING) {
+            drop_count_.fetch_add(1, std::memory_order_relaxed);
+            break;
+          }
+          std::this_thread::yield();
+        }
+      }
     }
-    active_buf_->emplace_back(timestamp, std::move(msg_str),
-                              log_level_map.at(message[0]));
-    flag_.clear(std::memory_order_release);
   }
 
   if (force_flush && timestamp == 0 && message && message_len == 0) {
@@ -88,40 +96,48 @@ uint32_t AsyncLogger::LogSize() { return wrapped_->LogSize(); }
 
 void AsyncLogger::RunThread() {
   while (state_ == RUNNING) {
-    while (flag_.test_and_set(std::memory_order_acquire)) {
-      cpu_relax();
-    }
-    active_buf_.swap(flushing_buf_);
-    flag_.clear(std::memory_order_release);
-    FlushBuffer(flushing_buf_);
-    if (active_buf_->size() < 800) {
+    if (FlushRing() < 800) {
       std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
   }
 }
 
-void AsyncLogger::FlushBuffer(const std::unique_ptr<std::deque<Msg>>& buffer) {
-  std::string module_name = "";
-  while (!buffer->empty()) {
-    auto& msg = buffer->front();
-    FindModuleName(&(msg.message), &module_name);
+size_t AsyncLogger::FlushRing() {
+  auto count = ring_.Consume(
+      [this](time_t timestamp, const char* message, size_t message_len) {
+        WriteRecord(timestamp, message, message_len);
+      });
+  if (count > 0) {
+    flush_count_.fetch_add(1, std::memory_order_relaxed);
+    Flush();
+  }
+  return count;
+}
 
-    if (module_logger_map_.find(module_name) == module_logger_map_.end()) {
-      std::string file_name = module_name + ".log.INFO.";
-      if (!FLAGS_log_dir.empty()) {
-        file_name = FLAGS_log_dir + "/" + file_name;
-      }
-      module_logger_map_[module_name].reset(
-          new LogFileObject(google::INFO, file_name.c_str()));
-      module_logger_map_[module_name]->SetSymlinkBasename(module_name.c_str());
+void AsyncLogger::WriteRecord(time_t timestamp, const char* message,
+                              size_t message_len) {
+  message_.assign(message, message_len);
+  module_name_.clear();
+  FindModuleName(&message_, &module_name_);
+
+  auto it = module_logger_map_.find(module_name_);
+  if (it == module_logger_map_.end()) {
+    std::string file_name = module_name_ + ".log.INFO.";
+    if (!FLAGS_log_dir.empty()) {
+      file_name = FLAGS_log_dir + "/" + file_name;
     }
-    const bool force_flush = msg.level > 0;
-    module_logger_map_.find(module_name)
-        ->second->Write(force_flush, msg.ts, msg.message.data(),
-                        static_cast<int>(msg.message.size()));
-    buffer->pop_front();
+    it = module_logger_map_
+             .emplace(module_name_, std::unique_ptr<LogFileObject>(
+                                        new LogFileObject(google::INFO,
+                                                          file_name.c_str())))
+             .first;
+    it->second->SetSymlinkBasename(module_name_.c_str());
   }
-  Flush();
+
+  auto level = log_level_map.find(message[0]);
+  const bool force_flush = level != log_level_map.end() && level->second > 0;
+  it->second->Write(force_flush, timestamp, message_.data(),
+                    static_cast<int>(message_.size()));
 }
 
 }  // namespace logger
@@ -54,6 +54,32 @@ TEST(AsyncLoggerTest, WriteAndFlush) {
   logger.Stop();
 }
 
+TEST(AsyncLoggerTest, DropWhenFull) {
+  AsyncLogger logger(google::base::GetLogger(google::INFO), 256,
+                     AsyncLogger::FullPolicy::DROP);
+  logger.Start();
+
+  time_t timep;
+  time(&timep);
+  std::string message = "I0909 99:99:99.999999 99999 logger_test.cc:999] ";
+  message.append(LEFT_BRACKET);
+  message.append("AsyncLoggerTest");
+  message.append(RIGHT_BRACKET);
+  message.append("async logger test message\n");
+  logger.Write(false, timep, message.c_str(),
+               static_cast<int>(message.length()));
+  EXPECT_EQ(0, logger.DropCount());
+
+  // larger than the whole ring
+  message.append(std::string(256, 'x'));
+  logger.Write(false, timep, message.c_str(),
+               static_cast<int>(message.length()));
+  EXPECT_EQ(1, logger.DropCount());
+  EXPECT_EQ(0, logger.BlockCount());
+
+  logger.Stop();
+}
+
 TEST(AsyncLoggerTest, SetLoggerToGlog) {
   google::InitGoogleLogging("AsyncLoggerTest2");
   google::SetLogDestination(google::ERROR, "");
@@ -0,0 +1,89 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/logger/log_ring.h"
+
+#include <cstring>
+
+namespace apollo {
+namespace cyber {
+namespace logger {
+
+LogRing::LogRing(size_t capacity_bytes) {
+  uint64_t block_num = (capacity_bytes + kBlockSize - 1) / kBlockSize;
+  block_num_ = 1;
+  while (block_num_ < block_num) {
+    block_num_ <<= 1;
+  }
+  mask_ = block_num_ - 1;
+  headers_.reset(new Header[block_num_]);
+  data_.reset(new char[block_num_ * kBlockSize]);
+}
+
+LogRing::~LogRing() {}
+
+bool LogRing::TryPush(time_t timestamp, const char* message,
+                      size_t message_len) {
+  uint64_t need = (message_len + kBlockSize - 1) / kBlockSize;
+  if (need == 0) {
+    need = 1;
+  }
+  if (need > block_num_) {
+    return false;
+  }
+
+  uint64_t pos = write_pos_.load(std::memory_order_relaxed);
+  uint64_t pad = 0;
+  for (;;) {
+    uint64_t offset = pos & mask_;
+    pad = offset + need > block_num_ ? block_num_ - offset : 0;
+    if (pos + pad + need - read_pos_.load(std::memory_order_acquire) >
+        block_num_) {
+      return false;
+    }
+    if (write_pos_.compare_exchange_weak(pos, pos + pad + need,
+                                         std::memory_order_relaxed,
+                                         std::memory_order_relaxed)) {
+      break;
+    }
+  }
+
+  if (pad > 0) {
+    auto& header = headers_[pos & mask_];
+    header.padding = true;
+    header.block_num = static_cast<uint32_t>(pad);
+    header.seq.store(pos + 1, std::memory_order_release);
+    pos += pad;
+  }
+
+  auto& header = headers_[pos & mask_];
+  std::memcpy(data_.get() + (pos & mask_) * kBlockSize, message, message_len);
+  header.padding = false;
+  header.timestamp = timestamp;
+  header.message_len = static_cast<uint32_t>(message_len);
+  header.block_num = static_cast<uint32_t>(need);
+  header.seq.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+bool LogRing::Empty() const {
+  return read_pos_.load(std::memory_order_acquire) ==
+         write_pos_.load(std::memory_order_acquire);
+}
+
+}  // namespace logger
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,124 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_LOGGER_LOG_RING_H_
+#define CYBER_LOGGER_LOG_RING_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+
+#include "cyber/base/macros.h"
+#include "cyber/common/macros.h"
+
+namespace apollo {
+namespace cyber {
+namespace logger {
+
+/**
+ * @class LogRing
+ * @brief Preallocated lock-free multi-producer single-consumer ring of log
+ * records.
+ *
+ * The ring is an array of fixed size blocks, a record takes as many
+ * consecutive blocks as its message needs. Producers reserve blocks with a
+ * single CAS on the write position, copy the message in and publish the
+ * record through the sequence number of its first block, so nothing is
+ * allocated and no lock is taken on the logging thread. A record never wraps:
+ * when it does not fit before the end of the array, the remaining blocks are
+ * reserved as padding the consumer skips.
+ */
+class LogRing {
+ public:
+  static const size_t kBlockSize = 64;
+
+  // capacity is rounded up to a power of two number of blocks
+  explicit LogRing(size_t capacity_bytes);
+  ~LogRing();
+
+  /**
+   * @brief Copy a message into the ring.
+   *
+   * @return false if there is no room for it, the message is not queued
+   */
+  bool TryPush(time_t timestamp, const char* message, size_t message_len);
+
+  /**
+   * @brief Hand every published record over to func(timestamp, message,
+   * message_len) in order, the blocks are released once func returns. Must
+   * only be called from one thread.
+   *
+   * @return the number of records consumed
+   */
+  template <typename Func>
+  size_t Consume(Func&& func);
+
+  bool Empty() const;
+
+  size_t Capacity() const { return block_num_ * kBlockSize; }
+
+  // the largest message TryPush can ever accept
+  size_t MaxMessageSize() const { return Capacity(); }
+
+ private:
+  struct Header {
+    // write position of the record + 1 once it is published
+    std::atomic<uint64_t> seq = {0};
+    time_t timestamp = 0;
+    uint32_t message_len = 0;
+    // blocks taken by the record, or by the padding
+    uint32_t block_num = 0;
+    bool padding = false;
+  };
+
+  uint64_t block_num_ = 0;
+  uint64_t mask_ = 0;
+  std::unique_ptr<Header[]> headers_;
+  std::unique_ptr<char[]> data_;
+
+  alignas(CACHELINE_SIZE) std::atomic<uint64_t> write_pos_ = {0};
+  alignas(CACHELINE_SIZE) std::atomic<uint64_t> read_pos_ = {0};
+
+  DISALLOW_COPY_AND_ASSIGN(LogRing);
+};
+
+template <typename Func>
+size_t LogRing::Consume(Func&& func) {
+  size_t count = 0;
+  uint64_t pos = read_pos_.load(std::memory_order_relaxed);
+  for (;;) {
+    auto& header = headers_[pos & mask_];
+    if (header.seq.load(std::memory_order_acquire) != pos + 1) {
+      break;
+    }
+    if (!header.padding) {
+      func(header.timestamp, data_.get() + (pos & mask_) * kBlockSize,
+           static_cast<size_t>(header.message_len));
+      ++count;
+    }
+    pos += header.block_num;
+    read_pos_.store(pos, std::memory_order_release);
+  }
+  return count;
+}
+
+}  // namespace logger
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_LOGGER_LOG_RING_H_
@@ -0,0 +1,133 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/logger/log_ring.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace logger {
+
+TEST(LogRingTest, PushAndConsume) {
+  LogRing ring(1000);
+  EXPECT_EQ(1024, ring.Capacity());
+  EXPECT_TRUE(ring.Empty());
+
+  std::string short_msg = "I short message\n";
+  std::string long_msg(3 * LogRing::kBlockSize + 1, 'W');
+  EXPECT_TRUE(ring.TryPush(1, short_msg.data(), short_msg.size()));
+  EXPECT_TRUE(ring.TryPush(2, long_msg.data(), long_msg.size()));
+  EXPECT_FALSE(ring.Empty());
+
+  std::vector<std::string> messages;
+  std::vector<time_t> stamps;
+  auto count = ring.Consume([&](time_t ts, const char* msg, size_t len) {
+    stamps.emplace_back(ts);
+    messages.emplace_back(msg, len);
+  });
+  EXPECT_EQ(2, count);
+  ASSERT_EQ(2, messages.size());
+  EXPECT_EQ(short_msg, messages[0]);
+  EXPECT_EQ(long_msg, messages[1]);
+  EXPECT_EQ(1, stamps[0]);
+  EXPECT_EQ(2, stamps[1]);
+  EXPECT_TRUE(ring.Empty());
+  EXPECT_EQ(0, ring.Consume([](time_t, const char*, size_t) {}));
+}
+
+TEST(LogRingTest, FullAndWrap) {
+  LogRing ring(4 * LogRing::kBlockSize);
+  std::string msg(LogRing::kBlockSize, 'I');
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(ring.TryPush(i, msg.data(), msg.size()));
+  }
+  EXPECT_FALSE(ring.TryPush(4, msg.data(), msg.size()));
+  std::string too_long(ring.MaxMessageSize() + 1, 'I');
+  EXPECT_FALSE(ring.TryPush(4, too_long.data(), too_long.size()));
+
+  EXPECT_EQ(4, ring.Consume([](time_t, const char*, size_t) {}));
+
+  // one block left before the end of the ring, a two block record must not
+  // be split across it
+  EXPECT_TRUE(ring.TryPush(0, msg.data(), msg.size()));
+  EXPECT_TRUE(ring.TryPush(1, msg.data(), msg.size()));
+  EXPECT_TRUE(ring.TryPush(2, msg.data(), msg.size()));
+  EXPECT_EQ(3, ring.Consume([](time_t, const char*, size_t) {}));
+  std::string two_blocks(2 * LogRing::kBlockSize, 'E');
+  EXPECT_TRUE(ring.TryPush(3, two_blocks.data(), two_blocks.size()));
+
+  std::string consumed;
+  EXPECT_EQ(1, ring.Consume([&](time_t, const char* m, size_t len) {
+              consumed.assign(m, len);
+            }));
+  EXPECT_EQ(two_blocks, consumed);
+  EXPECT_TRUE(ring.Empty());
+}
+
+TEST(LogRingTest, MultiProducer) {
+  const int kThreadNum = 4;
+  const int kMessageNum = 20000;
+  LogRing ring(64 * 1024);
+  std::atomic<int> done = {0};
+
+  std::vector<std::thread> producers;
+  for (int t = 0; t < kThreadNum; ++t) {
+    producers.emplace_back([&ring, &done, t]() {
+      for (int i = 0; i < kMessageNum; ++i) {
+        std::string msg = std::to_string(t) + ":" + std::to_string(i);
+        msg.resize(msg.size() + i % 150, '.');
+        while (!ring.TryPush(t, msg.data(), msg.size())) {
+          std::this_thread::yield();
+        }
+      }
+      done++;
+    });
+  }
+
+  std::vector<int> next(kThreadNum, 0);
+  int total = 0;
+  bool in_order = true;
+  auto check = [&](time_t ts, const char* msg, size_t len) {
+    std::string expect = std::to_string(ts) + ":" + std::to_string(next[ts]);
+    expect.resize(expect.size() + next[ts] % 150, '.');
+    if (std::string(msg, len) != expect) {
+      in_order = false;
+    }
+    next[ts]++;
+    total++;
+  };
+  while (done.load() < kThreadNum) {
+    ring.Consume(check);
+  }
+  ring.Consume(check);
+  for (auto& producer : producers) {
+    producer.join();
+  }
+
+  EXPECT_TRUE(in_order);
+  EXPECT_EQ(kThreadNum * kMessageNum, total);
+  EXPECT_TRUE(ring.Empty());
+}
+
+}  // namespace logger
+}  // namespace cyber
+}  // namespace apollo
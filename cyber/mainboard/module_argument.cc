@@ -19,6 +19,9 @@
 #include <getopt.h>
 #include <libgen.h>
 
+#include <cstdlib>
+#include <thread>
+
 #if __has_include("gperftools/profiler.h")
 #include "gperftools/profiler.h"
 #endif
@@ -42,6 +45,10 @@ void ModuleArgument::DisplayUsage() {
            "plugin\n"
         << "    --disable_plugin_autoload : default enable autoload "
            "mode of plugins, use disable_plugin_autoload to ingore autoload\n"
+        << "    --parallel_init[=thread_num]: load the module libraries and "
+           "initialize the components concurrently, default thread_num is "
+           "the number of cpus. Init dependencies are declared in the dag "
+           "by comment lines like '# init_depends: planning: prediction'\n"
         << "    -c, --cpuprofile: enable gperftools cpu profile\n"
         << "    -o, --profile_filename=filename: the filename to dump the "
            "profile to, default value is ${process_group}_cpu.prof. Only work "
@@ -98,6 +105,8 @@ void ModuleArgument::GetOptions(const int argc, char* const argv[]) {
       {"plugin", required_argument, nullptr, ARGS_OPT_CODE_PLUGIN},
       {"disable_plugin_autoload", no_argument, nullptr,
        ARGS_OPT_CODE_DISABLE_PLUGIN_AUTOLOAD},
+      {"parallel_init", optional_argument, nullptr,
+       ARGS_OPT_CODE_PARALLEL_INIT},
       {"cpuprofile", no_argument, nullptr, 'c'},
       {"profile_filename", required_argument, nullptr, 'o'},
       {"heapprofile", no_argument, nullptr, 'H'},
@@ -146,6 +155,16 @@ void ModuleArgument::GetOptions(const int argc, char* const argv[]) {
       case ARGS_OPT_CODE_DISABLE_PLUGIN_AUTOLOAD:
         disable_plugin_autoload_ = true;
         break;
+      case ARGS_OPT_CODE_PARALLEL_INIT:
+        parallel_init_num_ = std::thread::hardware_concurrency();
+        if (optarg != nullptr) {
+          parallel_init_num_ =
+              static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+        }
+        if (parallel_init_num_ == 0) {
+          parallel_init_num_ = 1;
+        }
+        break;
       case 'c':
 #ifndef BASE_PROFILER_H_
         AWARN << "gperftools not installed, ignore perf parameters";
@@ -34,6 +34,7 @@ static const char DEFAULT_sched_name_[] = "CYBER_DEFAULT";
 // code for command line arguments without short parameters
 static const int ARGS_OPT_CODE_PLUGIN = 1001;
 static const int ARGS_OPT_CODE_DISABLE_PLUGIN_AUTOLOAD = 1002;
+static const int ARGS_OPT_CODE_PARALLEL_INIT = 1003;
 
 class ModuleArgument {
  public:
@@ -54,6 +55,8 @@ class ModuleArgument {
     return heapprofile_filename_;
   }
   const bool& GetDisablePluginsAutoLoad() const;
+  // threads loading and initializing the components, 0 for one by one
+  uint32_t GetParallelInitNum() const { return parallel_init_num_; }
 
  private:
   std::list<std::string> dag_conf_list_;
@@ -66,6 +69,7 @@ class ModuleArgument {
   bool enable_heapprofile_ = false;
   std::string heapprofile_filename_;
   bool disable_plugin_autoload_ = false;
+  uint32_t parallel_init_num_ = 0;
 };
 
 inline const std::string& ModuleArgument::GetBinaryName() const {
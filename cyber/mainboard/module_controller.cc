@@ -16,12 +16,20 @@
 
 #include "cyber/mainboard/module_controller.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <sstream>
 #include <utility>
 
+#include "cyber/base/thread_pool.h"
+
 #include "cyber/common/environment.h"
 #include "cyber/common/file.h"
 #include "cyber/component/component_base.h"
 #include "cyber/plugin_manager/plugin_manager.h"
+#include "cyber/time/time.h"
 
 namespace apollo {
 namespace cyber {
@@ -63,17 +71,32 @@ bool ModuleController::LoadAll() {
     total_component_nums += scheduler::Instance()->TaskPoolSize();
   }
   common::GlobalData::Instance()->SetComponentNums(total_component_nums);
-  for (auto module_path : paths) {
+
+  std::map<std::string, std::vector<std::string>> depends;
+  for (auto& module_path : paths) {
     AINFO << "Start initialize dag: " << module_path;
-    if (!LoadModule(module_path)) {
+    if (!AddInitTasks(module_path)) {
       AERROR << "Failed to load module: " << module_path;
       return false;
     }
+    GetInitDepends(module_path, &depends);
   }
-  return true;
+  if (!LinkInitTasks(depends)) {
+    return false;
+  }
+  uint64_t begin_ns = Time::MonoTime().ToNanosecond();
+  bool success = args_.GetParallelInitNum() > 0 ? RunInitTasksParallel()
+                                                : RunInitTasks();
+  for (auto& task : init_tasks_) {
+    if (task.success && task.component != nullptr) {
+      component_list_.emplace_back(std::move(task.component));
+    }
+  }
+  ReportInitTiming(begin_ns);
+  return success;
 }
 
-bool ModuleController::LoadModule(const DagConfig& dag_config) {
+bool ModuleController::AddInitTasks(const DagConfig& dag_config) {
   for (auto module_config : dag_config.module_config()) {
     std::string load_path;
     if (!common::GetFilePathWithEnv(module_config.module_library(),
@@ -84,38 +107,235 @@ bool ModuleController::LoadModule(const DagConfig& dag_config) {
     }
     AINFO << "mainboard: use module library " << load_path;
 
-    class_loader_manager_.LoadLibrary(load_path);
+    std::size_t library_index = init_tasks_.size();
+    InitTask library_task;
+    library_task.name = load_path;
+    library_task.is_library = true;
+    library_task.func = [this, load_path](InitTask*) {
+      class_loader_manager_.LoadLibrary(load_path);
+      return true;
+    };
+    init_tasks_.emplace_back(std::move(library_task));
 
     for (auto& component : module_config.components()) {
-      const std::string& class_name = component.class_name();
-      std::shared_ptr<ComponentBase> base =
-          class_loader_manager_.CreateClassObj<ComponentBase>(class_name);
-      if (base == nullptr || !base->Initialize(component.config())) {
-        return false;
-      }
-      component_list_.emplace_back(std::move(base));
+      InitTask task;
+      task.name = component.config().name().empty()
+                      ? component.class_name()
+                      : component.config().name();
+      task.depends.emplace_back(library_index);
+      task.func = [this, component](InitTask* task) {
+        task->component = class_loader_manager_.CreateClassObj<ComponentBase>(
+            component.class_name());
+        return task->component != nullptr &&
+               task->component->Initialize(component.config());
+      };
+      init_tasks_.emplace_back(std::move(task));
     }
 
     for (auto& component : module_config.timer_components()) {
-      const std::string& class_name = component.class_name();
-      std::shared_ptr<ComponentBase> base =
-          class_loader_manager_.CreateClassObj<ComponentBase>(class_name);
-      if (base == nullptr || !base->Initialize(component.config())) {
-        return false;
-      }
-      component_list_.emplace_back(std::move(base));
+      InitTask task;
+      task.name = component.config().name().empty()
+                      ? component.class_name()
+                      : component.config().name();
+      task.depends.emplace_back(library_index);
+      task.func = [this, component](InitTask* task) {
+        task->component = class_loader_manager_.CreateClassObj<ComponentBase>(
+            component.class_name());
+        return task->component != nullptr &&
+               task->component->Initialize(component.config());
+      };
+      init_tasks_.emplace_back(std::move(task));
     }
   }
   return true;
 }
 
-bool ModuleController::LoadModule(const std::string& path) {
+bool ModuleController::AddInitTasks(const std::string& path) {
   DagConfig dag_config;
   if (!common::GetProtoFromFile(path, &dag_config)) {
     AERROR << "Get proto failed, file: " << path;
     return false;
   }
-  return LoadModule(dag_config);
+  return AddInitTasks(dag_config);
+}
+
+void ModuleController::GetInitDepends(
+    const std::string& path,
+    std::map<std::string, std::vector<std::string>>* depends) {
+  static const std::string kPrefix = "init_depends:";
+  std::string content;
+  if (!common::GetContent(path, &content)) {
+    return;
+  }
+  std::istringstream lines(content);
+  std::string line;
+  while (std::getline(lines, line)) {
+    auto pos = line.find_first_not_of(" \t");
+    if (pos == std::string::npos || line[pos] != '#') {
+      continue;
+    }
+    pos = line.find_first_not_of(" \t", pos + 1);
+    if (pos == std::string::npos ||
+        line.compare(pos, kPrefix.size(), kPrefix) != 0) {
+      continue;
+    }
+    line = line.substr(pos + kPrefix.size());
+    auto colon = line.find(':');
+    if (colon == std::string::npos) {
+      AWARN << "ignore init dependency without ':' in " << path << ": "
+            << line;
+      continue;
+    }
+    std::replace(line.begin(), line.end(), ',', ' ');
+    std::istringstream component_names(line.substr(0, colon));
+    std::istringstream depend_names(line.substr(colon + 1));
+    std::string component_name;
+    if (!(component_names >> component_name)) {
+      continue;
+    }
+    std::string depend_name;
+    while (depend_names >> depend_name) {
+      (*depends)[component_name].emplace_back(depend_name);
+    }
+  }
+}
+
+bool ModuleController::LinkInitTasks(
+    const std::map<std::string, std::vector<std::string>>& depends) {
+  std::map<std::string, std::vector<std::size_t>> component_index;
+  for (std::size_t i = 0; i < init_tasks_.size(); ++i) {
+    if (!init_tasks_[i].is_library) {
+      component_index[init_tasks_[i].name].emplace_back(i);
+    }
+  }
+  for (auto& item : depends) {
+    auto components = component_index.find(item.first);
+    if (components == component_index.end()) {
+      AERROR << "init dependency of unknown component " << item.first;
+      return false;
+    }
+    for (auto& depend_name : item.second) {
+      auto depend_components = component_index.find(depend_name);
+      if (depend_components == component_index.end()) {
+        AERROR << "component " << item.first
+               << " depends on unknown component " << depend_name;
+        return false;
+      }
+      for (auto index : components->second) {
+        auto& task = init_tasks_[index];
+        task.depends.insert(task.depends.end(),
+                            depend_components->second.begin(),
+                            depend_components->second.end());
+      }
+    }
+  }
+  for (std::size_t i = 0; i < init_tasks_.size(); ++i) {
+    for (auto depend : init_tasks_[i].depends) {
+      init_tasks_[depend].next.emplace_back(i);
+      ++init_tasks_[i].wait_num;
+    }
+  }
+  return true;
+}
+
+void ModuleController::RunInitTask(InitTask* task) {
+  task->start_ns = Time::MonoTime().ToNanosecond();
+  task->success = task->func(task);
+  task->end_ns = Time::MonoTime().ToNanosecond();
+}
+
+bool ModuleController::RunInitTasks() {
+  // the dag order, as the components always started
+  for (auto& task : init_tasks_) {
+    RunInitTask(&task);
+    if (!task.success) {
+      AERROR << "Failed to initialize " << task.name;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ModuleController::RunInitTasksParallel() {
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::queue<std::size_t> finished;
+  base::ThreadPool pool(args_.GetParallelInitNum(), init_tasks_.size() + 1);
+  AINFO << "mainboard: initialize " << init_tasks_.size() << " tasks with "
+        << args_.GetParallelInitNum() << " threads";
+
+  std::size_t running = 0;
+  std::size_t remaining = init_tasks_.size();
+  auto submit = [&](std::size_t index) {
+    ++running;
+    pool.Enqueue([&, index]() {
+      RunInitTask(&init_tasks_[index]);
+      std::lock_guard<std::mutex> lock(mutex);
+      finished.push(index);
+      cv.notify_one();
+    });
+  };
+  for (std::size_t i = 0; i < init_tasks_.size(); ++i) {
+    if (init_tasks_[i].wait_num == 0) {
+      submit(i);
+    }
+  }
+
+  bool success = true;
+  while (running > 0) {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&finished] { return !finished.empty(); });
+    std::size_t index = finished.front();
+    finished.pop();
+    lock.unlock();
+    --running;
+    --remaining;
+
+    auto& task = init_tasks_[index];
+    if (!task.success) {
+      AERROR << "Failed to initialize " << task.name;
+      success = false;
+    }
+    // let the running tasks finish, but start no more after a failure
+    if (!success) {
+      continue;
+    }
+    for (auto next : task.next) {
+      if (--init_tasks_[next].wait_num == 0) {
+        submit(next);
+      }
+    }
+  }
+  if (success && remaining > 0) {
+    for (auto& task : init_tasks_) {
+      if (task.wait_num > 0) {
+        AERROR << "init dependency cycle through " << task.name;
+      }
+    }
+    return false;
+  }
+  return success;
+}
+
+void ModuleController::ReportInitTiming(uint64_t begin_ns) const {
+  uint64_t end_ns = begin_ns;
+  for (auto& task : init_tasks_) {
+    end_ns = std::max(end_ns, task.end_ns);
+  }
+  AINFO << "mainboard: init took " << (end_ns - begin_ns) / 1000000
+        << " ms, per library and component:";
+  for (auto& task : init_tasks_) {
+    if (task.start_ns == 0) {
+      AINFO << "  " << (task.is_library ? "library " : "component ")
+            << task.name << " not run";
+      continue;
+    }
+    AINFO << "  " << (task.is_library ? "library " : "component ")
+          << task.name << " started at "
+          << (task.start_ns - begin_ns) / 1000000 << " ms, took "
+          << (task.end_ns - task.start_ns) / 1000000 << " ms"
+          << (task.success ? "" : ", failed");
+  }
 }
 
 int ModuleController::GetComponentNum(const std::string& path) {
@@ -16,6 +16,9 @@
 #ifndef CYBER_MAINBOARD_MODULE_CONTROLLER_H_
 #define CYBER_MAINBOARD_MODULE_CONTROLLER_H_
 
+#include <cstdint>
+#include <functional>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -42,15 +45,42 @@ class ModuleController {
   void Clear();
 
  private:
-  bool LoadModule(const std::string& path);
-  bool LoadModule(const DagConfig& dag_config);
+  // a library load or a component initialization, timed for the report
+  struct InitTask {
+    std::string name;
+    bool is_library = false;
+    std::function<bool(InitTask*)> func;
+    std::shared_ptr<ComponentBase> component;
+    // the library of a component and the components declared in the dag
+    std::vector<std::size_t> depends;
+    // tasks waiting for this one and the number this one still waits for
+    std::vector<std::size_t> next;
+    std::size_t wait_num = 0;
+    uint64_t start_ns = 0;
+    uint64_t end_ns = 0;
+    bool success = false;
+  };
+
+  bool AddInitTasks(const std::string& path);
+  bool AddInitTasks(const DagConfig& dag_config);
+  bool LinkInitTasks(
+      const std::map<std::string, std::vector<std::string>>& depends);
+  bool RunInitTasks();
+  bool RunInitTasksParallel();
+  static void RunInitTask(InitTask* task);
+  void ReportInitTiming(uint64_t begin_ns) const;
   int GetComponentNum(const std::string& path);
+  // reads the '# init_depends: component: dependency...' lines of a dag
+  static void GetInitDepends(
+      const std::string& path,
+      std::map<std::string, std::vector<std::string>>* depends);
   int total_component_nums = 0;
   bool has_timer_component = false;
 
   ModuleArgument args_;
   class_loader::ClassLoaderManager class_loader_manager_;
   std::vector<std::shared_ptr<ComponentBase>> component_list_;
+  std::vector<InitTask> init_tasks_;
 };
 
 inline ModuleController::ModuleController(const ModuleArgument& args)
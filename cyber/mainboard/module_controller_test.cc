@@ -0,0 +1,50 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/mainboard/module_controller.h"
+
+#include "gtest/gtest.h"
+
+#include "cyber/init.h"
+#include "cyber/mainboard/module_argument.h"
+
+namespace apollo {
+namespace cyber {
+namespace mainboard {
+
+TEST(ModuleControllerTest, parallel_init_of_two_dags) {
+  // the library of one dag loads while components of the other are created
+  char* argv[] = {const_cast<char*>("mainboard"),
+                  const_cast<char*>("-d"),
+                  const_cast<char*>("cyber/mainboard/test/a.dag"),
+                  const_cast<char*>("-d"),
+                  const_cast<char*>("cyber/mainboard/test/b.dag"),
+                  const_cast<char*>("--parallel_init=4"),
+                  const_cast<char*>("--disable_plugin_autoload")};
+  ModuleArgument args;
+  args.ParseArgument(sizeof(argv) / sizeof(argv[0]), argv);
+  EXPECT_EQ(4, args.GetParallelInitNum());
+  EXPECT_EQ(2, args.GetDAGConfList().size());
+
+  cyber::Init(argv[0]);
+  ModuleController controller(args);
+  EXPECT_TRUE(controller.Init());
+  controller.Clear();
+}
+
+}  // namespace mainboard
+}  // namespace cyber
+}  // namespace apollo
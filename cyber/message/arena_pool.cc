@@ -0,0 +1,132 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/message/arena_pool.h"
+
+#include <algorithm>
+
+#include "cyber/common/global_data.h"
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace message {
+
+const std::size_t ArenaPool::kDefaultMaxIdleNum;
+const std::size_t ArenaPool::kMinBlockSize;
+const std::size_t ArenaPool::kMaxBlockSize;
+
+std::shared_ptr<ArenaPool> ArenaPool::Create(std::size_t max_idle_num) {
+  return std::shared_ptr<ArenaPool>(new ArenaPool(max_idle_num));
+}
+
+ArenaPool::ArenaPool(std::size_t max_idle_num)
+    : max_idle_num_(max_idle_num) {}
+
+ArenaPool::~ArenaPool() {
+  for (auto block : idle_blocks_) {
+    delete block;
+  }
+}
+
+std::size_t ArenaPool::IdleNum() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return idle_blocks_.size();
+}
+
+std::shared_ptr<google::protobuf::Arena> ArenaPool::Acquire() {
+  Block* block = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!idle_blocks_.empty()) {
+      block = idle_blocks_.back();
+      idle_blocks_.pop_back();
+    }
+  }
+  if (block == nullptr) {
+    block = new Block();
+    ResetBlock(block, kMinBlockSize);
+  }
+  auto self = shared_from_this();
+  return std::shared_ptr<google::protobuf::Arena>(
+      block->arena.get(),
+      [self, block](google::protobuf::Arena*) { self->Release(block); });
+}
+
+void ArenaPool::Release(Block* block) {
+  // runs the destructors of the message, the initial block stays
+  std::size_t used = static_cast<std::size_t>(block->arena->Reset());
+  if (used > block->size && block->size < kMaxBlockSize) {
+    std::size_t size = block->size;
+    while (size < used && size < kMaxBlockSize) {
+      size *= 2;
+    }
+    ResetBlock(block, std::min(size, kMaxBlockSize));
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (idle_blocks_.size() < max_idle_num_) {
+      idle_blocks_.emplace_back(block);
+      return;
+    }
+  }
+  delete block;
+}
+
+void ArenaPool::ResetBlock(Block* block, std::size_t size) {
+  // the arena refers to the old data, it goes first
+  block->arena.reset();
+  block->data.reset(new char[size]);
+  block->size = size;
+  google::protobuf::ArenaOptions options;
+  options.initial_block = block->data.get();
+  options.initial_block_size = size;
+  block->arena.reset(new google::protobuf::Arena(options));
+}
+
+ArenaPoolManager::ArenaPoolManager() {}
+
+void ArenaPoolManager::Enable(const std::string& channel_name) {
+  Enable(common::GlobalData::RegisterChannel(channel_name));
+}
+
+void ArenaPoolManager::Enable(uint64_t channel_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (pools_.Has(channel_id)) {
+    return;
+  }
+  auto pool = ArenaPool::Create();
+  pools_.Set(channel_id, pool.get());
+  owned_pools_.emplace_back(std::move(pool));
+  ADEBUG << "arena allocation enabled, channel id: " << channel_id;
+}
+
+bool ArenaPoolManager::IsEnabled(uint64_t channel_id) {
+  return pools_.Has(channel_id);
+}
+
+ArenaPool* ArenaPoolManager::GetPool(uint64_t channel_id) {
+  ArenaPool* pool = nullptr;
+  if (pools_.Get(channel_id, &pool)) {
+    return pool;
+  }
+  return nullptr;
+}
+
+}  // namespace message
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,181 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_MESSAGE_ARENA_POOL_H_
+#define CYBER_MESSAGE_ARENA_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "google/protobuf/arena.h"
+#include "google/protobuf/message.h"
+
+#include "cyber/base/atomic_hash_map.h"
+#include "cyber/common/macros.h"
+
+namespace apollo {
+namespace cyber {
+namespace message {
+
+template <typename MessageT>
+struct IsArenaMessage
+    : std::integral_constant<
+          bool,
+          std::is_base_of<google::protobuf::Message, MessageT>::value &&
+              google::protobuf::Arena::is_arena_constructable<
+                  MessageT>::value> {};
+
+/**
+ * @class ArenaPool
+ * @brief Recycles protobuf arenas, every message created by the pool lives on
+ * an arena of its own which returns to the pool once the last shared_ptr of
+ * the message goes away. The initial block of an arena grows to the largest
+ * message it held, so a steady stream of messages allocates nothing.
+ */
+class ArenaPool : public std::enable_shared_from_this<ArenaPool> {
+ public:
+  static const std::size_t kDefaultMaxIdleNum = 16;
+  static const std::size_t kMinBlockSize = 4 * 1024;
+  static const std::size_t kMaxBlockSize = 64 * 1024 * 1024;
+
+  static std::shared_ptr<ArenaPool> Create(
+      std::size_t max_idle_num = kDefaultMaxIdleNum);
+  virtual ~ArenaPool();
+
+  template <typename MessageT>
+  typename std::enable_if<IsArenaMessage<MessageT>::value,
+                          std::shared_ptr<MessageT>>::type
+  CreateMessage();
+
+  template <typename MessageT>
+  typename std::enable_if<!IsArenaMessage<MessageT>::value,
+                          std::shared_ptr<MessageT>>::type
+  CreateMessage() {
+    return std::make_shared<MessageT>();
+  }
+
+  // a copy of msg on an arena of the pool
+  template <typename MessageT>
+  typename std::enable_if<IsArenaMessage<MessageT>::value,
+                          std::shared_ptr<MessageT>>::type
+  CreateMessage(const MessageT& msg) {
+    auto copy = CreateMessage<MessageT>();
+    *copy = msg;
+    return copy;
+  }
+
+  template <typename MessageT>
+  typename std::enable_if<!IsArenaMessage<MessageT>::value,
+                          std::shared_ptr<MessageT>>::type
+  CreateMessage(const MessageT& msg) {
+    return std::make_shared<MessageT>(msg);
+  }
+
+  std::size_t IdleNum();
+
+ private:
+  struct Block {
+    std::unique_ptr<char[]> data;
+    std::size_t size = 0;
+    std::unique_ptr<google::protobuf::Arena> arena;
+  };
+
+  explicit ArenaPool(std::size_t max_idle_num);
+
+  std::shared_ptr<google::protobuf::Arena> Acquire();
+  void Release(Block* block);
+  static void ResetBlock(Block* block, std::size_t size);
+
+  std::size_t max_idle_num_;
+  std::mutex mutex_;
+  std::vector<Block*> idle_blocks_;
+};
+
+template <typename MessageT>
+typename std::enable_if<IsArenaMessage<MessageT>::value,
+                        std::shared_ptr<MessageT>>::type
+ArenaPool::CreateMessage() {
+  auto arena = Acquire();
+  auto msg = google::protobuf::Arena::CreateMessage<MessageT>(arena.get());
+  // shares the ownership of the arena, the message is freed along with it
+  return std::shared_ptr<MessageT>(std::move(arena), msg);
+}
+
+/**
+ * @class ArenaPoolManager
+ * @brief The arena pools of the channels that opted in, e.g. with
+ * ReaderConfig::arena_allocation. Readers of such a channel deserialize into
+ * recycled arenas and writers copy the messages they send into them.
+ */
+class ArenaPoolManager {
+ public:
+  virtual ~ArenaPoolManager() = default;
+
+  void Enable(const std::string& channel_name);
+  void Enable(uint64_t channel_id);
+  bool IsEnabled(uint64_t channel_id);
+
+  template <typename MessageT>
+  std::shared_ptr<MessageT> CreateMessage(uint64_t channel_id);
+
+  template <typename MessageT>
+  std::shared_ptr<MessageT> CreateMessage(uint64_t channel_id,
+                                          const MessageT& msg);
+
+ private:
+  ArenaPool* GetPool(uint64_t channel_id);
+
+  std::mutex mutex_;
+  base::AtomicHashMap<uint64_t, ArenaPool*, 256> pools_;
+  std::vector<std::shared_ptr<ArenaPool>> owned_pools_;
+
+  DECLARE_SINGLETON(ArenaPoolManager)
+};
+
+template <typename MessageT>
+std::shared_ptr<MessageT> ArenaPoolManager::CreateMessage(
+    uint64_t channel_id) {
+  if (IsArenaMessage<MessageT>::value) {
+    auto pool = GetPool(channel_id);
+    if (pool != nullptr) {
+      return pool->CreateMessage<MessageT>();
+    }
+  }
+  return std::make_shared<MessageT>();
+}
+
+template <typename MessageT>
+std::shared_ptr<MessageT> ArenaPoolManager::CreateMessage(
+    uint64_t channel_id, const MessageT& msg) {
+  if (IsArenaMessage<MessageT>::value) {
+    auto pool = GetPool(channel_id);
+    if (pool != nullptr) {
+      return pool->CreateMessage<MessageT>(msg);
+    }
+  }
+  return std::make_shared<MessageT>(msg);
+}
+
+}  // namespace message
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_MESSAGE_ARENA_POOL_H_
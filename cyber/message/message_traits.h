@@ -22,6 +22,7 @@
 #include "cyber/base/macros.h"
 #include "cyber/common/log.h"
 #include "cyber/message/message_header.h"
+#include "cyber/message/message_view_traits.h"
 #include "cyber/message/protobuf_traits.h"
 #include "cyber/message/py_message_traits.h"
 #include "cyber/message/raw_message_traits.h"
@@ -0,0 +1,180 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_MESSAGE_MESSAGE_VIEW_H_
+#define CYBER_MESSAGE_MESSAGE_VIEW_H_
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#include "cyber/message/protobuf_factory.h"
+
+namespace apollo {
+namespace cyber {
+namespace message {
+
+/**
+ * @class MessageView
+ * @brief Read-only view over the serialized bytes of a message.
+ *
+ * When delivered by the shared memory transport the view points straight into
+ * the segment block, and `holder` keeps that block read-locked until the last
+ * copy of the view is gone. On other transports the bytes are owned by the
+ * view itself, so readers can use MessageView regardless of where the writer
+ * lives.
+ */
+class MessageView {
+ public:
+  MessageView() : data_(nullptr), size_(0) {}
+
+  MessageView(const MessageView &other) { CopyFrom(other); }
+
+  MessageView &operator=(const MessageView &other) {
+    if (this != &other) {
+      CopyFrom(other);
+    }
+    return *this;
+  }
+
+  ~MessageView() {}
+
+  class Descriptor {
+   public:
+    std::string full_name() const {
+      return "apollo.cyber.message.MessageView";
+    }
+    std::string name() const { return "apollo.cyber.message.MessageView"; }
+  };
+
+  static const Descriptor *descriptor() {
+    static Descriptor desc;
+    return &desc;
+  }
+
+  static void GetDescriptorString(const std::string &type,
+                                  std::string *desc_str) {
+    ProtobufFactory::Instance()->GetDescriptorString(type, desc_str);
+  }
+
+  static std::string TypeName() { return "apollo.cyber.message.MessageView"; }
+
+  /**
+   * @brief Point the view at externally owned bytes without copying them.
+   *
+   * @param data start of the serialized message
+   * @param size length of the serialized message
+   * @param holder keeps `data` valid for as long as the view lives
+   */
+  void Attach(const void *data, std::size_t size,
+              const std::shared_ptr<const void> &holder) {
+    storage_.clear();
+    data_ = static_cast<const uint8_t *>(data);
+    size_ = size;
+    holder_ = holder;
+  }
+
+  bool IsZeroCopy() const { return holder_ != nullptr; }
+
+  const uint8_t *data() const { return data_; }
+  std::size_t size() const { return size_; }
+
+  /**
+   * @brief Interpret the bytes as a fixed-layout message.
+   *
+   * @return nullptr if the payload size does not match sizeof(T)
+   */
+  template <typename T>
+  const T *As() const {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "only fixed-layout messages can be viewed in place");
+    if (data_ == nullptr || size_ != sizeof(T)) {
+      return nullptr;
+    }
+    return reinterpret_cast<const T *>(data_);
+  }
+
+  /**
+   * @brief Deserialize the viewed bytes into a concrete message type.
+   */
+  template <typename T>
+  bool ParseTo(T *message) const {
+    if (message == nullptr || data_ == nullptr) {
+      return false;
+    }
+    return message->ParseFromArray(data_, static_cast<int>(size_));
+  }
+
+  bool SerializeToArray(void *data, int size) const {
+    if (data == nullptr || size < ByteSize()) {
+      return false;
+    }
+    if (size_ > 0) {
+      memcpy(data, data_, size_);
+    }
+    return true;
+  }
+
+  bool SerializeToString(std::string *str) const {
+    if (str == nullptr) {
+      return false;
+    }
+    str->assign(reinterpret_cast<const char *>(data_), size_);
+    return true;
+  }
+
+  bool ParseFromArray(const void *data, int size) {
+    if (data == nullptr || size <= 0) {
+      return false;
+    }
+    holder_.reset();
+    storage_.assign(reinterpret_cast<const char *>(data), size);
+    data_ = reinterpret_cast<const uint8_t *>(storage_.data());
+    size_ = storage_.size();
+    return true;
+  }
+
+  bool ParseFromString(const std::string &str) {
+    return ParseFromArray(str.data(), static_cast<int>(str.size()));
+  }
+
+  int ByteSize() const { return static_cast<int>(size_); }
+
+ private:
+  void CopyFrom(const MessageView &other) {
+    storage_ = other.storage_;
+    holder_ = other.holder_;
+    size_ = other.size_;
+    if (holder_ != nullptr || other.data_ == nullptr) {
+      data_ = other.data_;
+    } else {
+      data_ = reinterpret_cast<const uint8_t *>(storage_.data());
+    }
+  }
+
+  std::string storage_;
+  const uint8_t *data_;
+  std::size_t size_;
+  std::shared_ptr<const void> holder_;
+};
+
+}  // namespace message
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_MESSAGE_MESSAGE_VIEW_H_
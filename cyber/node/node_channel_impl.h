@@ -25,9 +25,11 @@
 #include "cyber/blocker/intra_reader.h"
 #include "cyber/blocker/intra_writer.h"
 #include "cyber/common/global_data.h"
+#include "cyber/message/arena_pool.h"
 #include "cyber/message/message_traits.h"
 #include "cyber/node/reader.h"
 #include "cyber/node/writer.h"
+#include "cyber/transport/message/content_filter.h"
 
 namespace apollo {
 namespace cyber {
@@ -48,7 +50,9 @@ struct ReaderConfig {  ///< configurations for a Reader
   ReaderConfig(const ReaderConfig& other)
       : channel_name(other.channel_name),
         qos_profile(other.qos_profile),
-        pending_queue_size(other.pending_queue_size) {}
+        pending_queue_size(other.pending_queue_size),
+        content_filter(other.content_filter),
+        arena_allocation(other.arena_allocation) {}
 
   std::string channel_name;       //< channel reads
   proto::QosProfile qos_profile;  //< the qos configuration
@@ -57,6 +61,18 @@ struct ReaderConfig {  ///< configurations for a Reader
    * Older messages will dropped if you have no time to handle
    */
   uint32_t pending_queue_size;
+  /**
+   * @brief messages the reader wants, e.g. at most 1 Hz of the channel.
+   * Writers on this host skip the rest, the others are dropped before they
+   * are parsed
+   */
+  transport::ContentFilter content_filter;
+  /**
+   * @brief deserialize the messages of the channel into recycled protobuf
+   * arenas instead of the heap, for every reader of the channel in this
+   * process and the copies its writers make
+   */
+  bool arena_allocation = false;
 };
 
 /**
@@ -132,7 +148,9 @@ class NodeChannelImpl {
   template <typename MessageT>
   auto CreateReader(const proto::RoleAttributes& role_attr,
                     const CallbackFunc<MessageT>& reader_func,
-                    uint32_t pending_queue_size = DEFAULT_PENDING_QUEUE_SIZE)
+                    uint32_t pending_queue_size = DEFAULT_PENDING_QUEUE_SIZE,
+                    const transport::ContentFilter& content_filter =
+                        transport::ContentFilter())
       -> std::shared_ptr<Reader<MessageT>>;
 
   template <typename MessageT>
@@ -194,14 +212,20 @@ auto NodeChannelImpl::CreateReader(const ReaderConfig& config,
   proto::RoleAttributes role_attr;
   role_attr.set_channel_name(config.channel_name);
   role_attr.mutable_qos_profile()->CopyFrom(config.qos_profile);
+  if (config.arena_allocation) {
+    // before the receiver of the channel is created
+    message::ArenaPoolManager::Instance()->Enable(config.channel_name);
+  }
   return this->template CreateReader<MessageT>(role_attr, reader_func,
-                                               config.pending_queue_size);
+                                               config.pending_queue_size,
+                                               config.content_filter);
 }
 
 template <typename MessageT>
-auto NodeChannelImpl::CreateReader(const proto::RoleAttributes& role_attr,
-                                   const CallbackFunc<MessageT>& reader_func,
-                                   uint32_t pending_queue_size)
+auto NodeChannelImpl::CreateReader(
+    const proto::RoleAttributes& role_attr,
+    const CallbackFunc<MessageT>& reader_func, uint32_t pending_queue_size,
+    const transport::ContentFilter& content_filter)
     -> std::shared_ptr<Reader<MessageT>> {
   if (!role_attr.has_channel_name() || role_attr.channel_name().empty()) {
     AERROR << "Can't create a reader with empty channel name!";
@@ -216,8 +240,8 @@ auto NodeChannelImpl::CreateReader(const proto::RoleAttributes& role_attr,
     reader_ptr =
         std::make_shared<blocker::IntraReader<MessageT>>(new_attr, reader_func);
   } else {
-    reader_ptr = std::make_shared<Reader<MessageT>>(new_attr, reader_func,
-                                                    pending_queue_size);
+    reader_ptr = std::make_shared<Reader<MessageT>>(
+        new_attr, reader_func, pending_queue_size, content_filter);
   }
 
   RETURN_VAL_IF_NULL(reader_ptr, nullptr);
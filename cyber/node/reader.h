@@ -36,6 +36,7 @@
 #include "cyber/scheduler/scheduler_factory.h"
 #include "cyber/service_discovery/topology_manager.h"
 #include "cyber/time/time.h"
+#include "cyber/transport/message/content_filter_registry.h"
 #include "cyber/transport/transport.h"
 #include "cyber/statistics/statistics.h"
 
@@ -81,12 +82,18 @@ class Reader : public ReaderBase {
    * channel name and other info.
    * @param reader_func is the callback function, when the message is received.
    * @param pending_queue_size is the max depth of message cache queue.
+   * @param content_filter the messages wanted, writers skip the others.
+   * Readers of a channel in one process share what they receive, so each of
+   * them gets what any of their filters passes.
    * @warning the received messages is enqueue a queue,the queue's depth is
    * pending_queue_size
    */
-  explicit Reader(const proto::RoleAttributes& role_attr,
-                  const CallbackFunc<MessageT>& reader_func = nullptr,
-                  uint32_t pending_queue_size = DEFAULT_PENDING_QUEUE_SIZE);
+  explicit Reader(
+      const proto::RoleAttributes& role_attr,
+      const CallbackFunc<MessageT>& reader_func = nullptr,
+      uint32_t pending_queue_size = DEFAULT_PENDING_QUEUE_SIZE,
+      const transport::ContentFilter& content_filter =
+          transport::ContentFilter());
   virtual ~Reader();
 
   /**
@@ -218,6 +225,7 @@ class Reader : public ReaderBase {
   void OnChannelChange(const proto::ChangeMsg& change_msg);
 
   CallbackFunc<MessageT> reader_func_;
+  transport::ContentFilter content_filter_;
   ReceiverPtr receiver_ = nullptr;
   std::string croutine_name_;
 
@@ -230,10 +238,12 @@ class Reader : public ReaderBase {
 template <typename MessageT>
 Reader<MessageT>::Reader(const proto::RoleAttributes& role_attr,
                          const CallbackFunc<MessageT>& reader_func,
-                         uint32_t pending_queue_size)
+                         uint32_t pending_queue_size,
+                         const transport::ContentFilter& content_filter)
     : ReaderBase(role_attr),
       pending_queue_size_(pending_queue_size),
-      reader_func_(reader_func) {
+      reader_func_(reader_func),
+      content_filter_(content_filter) {
   blocker_.reset(new blocker::Blocker<MessageT>(blocker::BlockerAttr(
       role_attr.qos_profile().depth(), role_attr.channel_name())));
 }
@@ -293,8 +303,10 @@ bool Reader<MessageT>::Init() {
   }
   auto sched = scheduler::Instance();
   croutine_name_ = role_attr_.node_name() + "_" + role_attr_.channel_name();
-  auto dv = std::make_shared<data::DataVisitor<MessageT>>(
-      role_attr_.channel_id(), pending_queue_size_);
+  // only callback readers consume the messages here, the others just queue
+  data::VisitorConfig conf(role_attr_.channel_id(), pending_queue_size_);
+  conf.sample_latency = reader_func_ != nullptr;
+  auto dv = std::make_shared<data::DataVisitor<MessageT>>(conf);
   // Using factory to wrap templates.
   croutine::RoutineFactory factory =
       croutine::CreateRoutineFactory<MessageT>(std::move(func), dv);
@@ -306,6 +318,9 @@ bool Reader<MessageT>::Init() {
 
   receiver_ = ReceiverManager<MessageT>::Instance()->GetReceiver(role_attr_);
   this->role_attr_.set_id(receiver_->id().HashValue());
+  // before joining, writers look the filter up when they see the reader
+  transport::ContentFilterRegistry::Instance()->Add(
+      role_attr_.channel_id(), role_attr_.id(), content_filter_);
   channel_manager_ =
       service_discovery::TopologyManager::Instance()->channel_manager();
   JoinTheTopology();
@@ -319,6 +334,8 @@ void Reader<MessageT>::Shutdown() {
     return;
   }
   LeaveTheTopology();
+  transport::ContentFilterRegistry::Instance()->Remove(
+      role_attr_.channel_id(), role_attr_.id(), content_filter_);
   receiver_ = nullptr;
   channel_manager_ = nullptr;
 
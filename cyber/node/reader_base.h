@@ -26,6 +26,7 @@
 #include "cyber/common/macros.h"
 #include "cyber/common/util.h"
 #include "cyber/event/perf_event_cache.h"
+#include "cyber/statistics/channel_stats.h"
 #include "cyber/transport/transport.h"
 
 namespace apollo {
@@ -214,6 +215,9 @@ auto ReceiverManager<MessageT>::GetReceiver(
               PerfEventCache::Instance()->AddTransportEvent(
                   TransPerf::DISPATCH, reader_attr.channel_id(),
                   msg_info.seq_num());
+              statistics::ChannelStats::Instance()->OnDispatch(
+                  reader_attr.channel_id(), msg.get(), msg_info.send_time(),
+                  msg_info.TraceId());
               data::DataDispatcher<MessageT>::Instance()->Dispatch(
                   reader_attr.channel_id(), msg);
               PerfEventCache::Instance()->AddTransportEvent(
@@ -24,6 +24,7 @@
 #include "cyber/proto/topology_change.pb.h"
 
 #include "cyber/common/log.h"
+#include "cyber/message/arena_pool.h"
 #include "cyber/node/writer_base.h"
 #include "cyber/service_discovery/topology_manager.h"
 #include "cyber/transport/transport.h"
@@ -84,6 +85,28 @@ class Writer : public WriterBase {
    */
   virtual bool Write(const std::shared_ptr<MessageT>& msg_ptr);
 
+  /**
+   * @brief Borrow a shared memory block to build a message in place
+   *
+   * The returned loan is invalid when the channel is not carried over shared
+   * memory, callers should then fall back to Write(msg).
+   *
+   * @param size number of bytes the serialized message will occupy
+   * @return transport::LoanedMessage the loan, check IsValid() before use
+   */
+  transport::LoanedMessage Loan(std::size_t size);
+
+  /**
+   * @brief Publish a loaned message without copying it again
+   *
+   * The loan is consumed whether or not the write succeeds.
+   *
+   * @param loaned_msg loan obtained from Loan()
+   * @return true if write successfully
+   * @return false if write failed
+   */
+  bool Write(transport::LoanedMessage* loaned_msg);
+
   /**
    * @brief Is there any Reader that subscribes our Channel?
    * You can publish message when this return true
@@ -159,7 +182,8 @@ void Writer<MessageT>::Shutdown() {
 template <typename MessageT>
 bool Writer<MessageT>::Write(const MessageT& msg) {
   RETURN_VAL_IF(!WriterBase::IsInit(), false);
-  auto msg_ptr = std::make_shared<MessageT>(msg);
+  auto msg_ptr = message::ArenaPoolManager::Instance()->CreateMessage(
+      role_attr_.channel_id(), msg);
   return Write(msg_ptr);
 }
 
@@ -169,6 +193,27 @@ bool Writer<MessageT>::Write(const std::shared_ptr<MessageT>& msg_ptr) {
   return transmitter_->Transmit(msg_ptr);
 }
 
+template <typename MessageT>
+transport::LoanedMessage Writer<MessageT>::Loan(std::size_t size) {
+  transport::LoanedMessage loaned_msg;
+  RETURN_VAL_IF(!WriterBase::IsInit(), loaned_msg);
+  if (!transmitter_->Loan(size, &loaned_msg)) {
+    ADEBUG << "channel[" << role_attr_.channel_name()
+           << "] can not loan shared memory.";
+  }
+  return loaned_msg;
+}
+
+template <typename MessageT>
+bool Writer<MessageT>::Write(transport::LoanedMessage* loaned_msg) {
+  RETURN_VAL_IF_NULL(loaned_msg, false);
+  if (!WriterBase::IsInit()) {
+    loaned_msg->Release();
+    return false;
+  }
+  return transmitter_->Transmit(loaned_msg);
+}
+
 template <typename MessageT>
 void Writer<MessageT>::JoinTheTopology() {
   // add listener
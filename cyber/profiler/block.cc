@@ -27,6 +27,9 @@ Block::Block() : depth_(0), begin_time_(), end_time_() {}
 Block::Block(const std::string& name)
     : name_(name), depth_(0), begin_time_(), end_time_() {}
 
+Block::Block(const std::string& name, std::uint64_t seq)
+    : name_(name), depth_(0), seq_(seq), begin_time_(), end_time_() {}
+
 Block::~Block() {
   if (!finished())
     BlockManager::Instance()->EndBlock();
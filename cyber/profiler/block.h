@@ -18,6 +18,7 @@
 #define CYBER_PROFILER_BLOCK_H_
 
 #include <chrono>
+#include <cstdint>
 #include <string>
 
 namespace apollo {
@@ -31,6 +32,8 @@ class Block {
  public:
   Block();
   explicit Block(const std::string& name);
+  // seq links the span to the processing of one message across components
+  Block(const std::string& name, std::uint64_t seq);
   virtual ~Block();
 
   void Start();
@@ -39,6 +42,8 @@ class Block {
   const std::string& name() const { return name_; }
   std::uint32_t depth() const { return depth_; }
   void set_depth(std::uint32_t depth) { depth_ = depth; }
+  std::uint64_t seq() const { return seq_; }
+  void set_seq(std::uint64_t seq) { seq_ = seq; }
 
   const time_point& begin_time() const { return begin_time_; }
   const time_point& end_time() const { return end_time_; }
@@ -52,6 +57,7 @@ class Block {
  private:
   std::string name_;
   std::uint32_t depth_;
+  std::uint64_t seq_ = 0;
   time_point begin_time_;
   time_point end_time_;
 };
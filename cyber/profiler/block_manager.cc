@@ -16,14 +16,38 @@
 
 #include "cyber/profiler/block_manager.h"
 
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+
 #include "cyber/croutine/croutine.h"
 
 namespace apollo {
 namespace cyber {
 namespace profiler {
 
-thread_local std::unordered_map<std::string, Frame>
-    BlockManager::routine_frame_map_{};
+namespace {
+
+// marks the buffer of an exiting thread, so that it is dropped once drained
+struct ThreadSpanBuffer {
+  ~ThreadSpanBuffer() {
+    if (buffer) {
+      buffer->set_orphaned();
+    }
+  }
+  std::shared_ptr<SpanBuffer> buffer;
+  int32_t tid = 0;
+};
+
+thread_local ThreadSpanBuffer thread_span_buffer;
+
+}  // namespace
+
+const uint64_t BlockManager::kSpanBufferSize;
+
+thread_local BlockManager::RoutineFrameMap BlockManager::routine_frame_map_{};
 
 BlockManager::BlockManager() {}
 
@@ -31,6 +55,10 @@ void BlockManager::StartBlock(Block* block) {
   Frame* frame_ptr = GetRoutineFrame();
   if (frame_ptr == nullptr || block == nullptr)
     return;
+  Block* parent = frame_ptr->Top();
+  if (block->seq() == 0) {
+    block->set_seq(parent != nullptr ? parent->seq() : frame_ptr->trace_id());
+  }
   frame_ptr->Push(block);
   block->set_depth(frame_ptr->size());
   block->Start();
@@ -43,6 +71,11 @@ void BlockManager::EndBlock() {
 
   Block* block = frame_ptr->Top();
   block->End();
+  if (span_enabled_.load(std::memory_order_relaxed)) {
+    RecordSpan(*block);
+    frame_ptr->Discard();
+    return;
+  }
   frame_ptr->Pop();
 
   if (frame_ptr->finished()) {
@@ -52,6 +85,47 @@ void BlockManager::EndBlock() {
   }
 }
 
+size_t BlockManager::CollectSpans(std::vector<Span>* spans) {
+  size_t count = 0;
+  std::lock_guard<std::mutex> lock(span_buffers_mutex_);
+  for (auto it = span_buffers_.begin(); it != span_buffers_.end();) {
+    // check first, the last spans of an exiting thread land before the mark
+    bool orphaned = (*it)->orphaned();
+    count += (*it)->Drain(spans);
+    if (orphaned) {
+      orphaned_drop_count_ += (*it)->DropCount();
+      it = span_buffers_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  return count;
+}
+
+uint64_t BlockManager::SpanDropCount() {
+  std::lock_guard<std::mutex> lock(span_buffers_mutex_);
+  uint64_t count = orphaned_drop_count_;
+  for (auto& buffer : span_buffers_) {
+    count += buffer->DropCount();
+  }
+  return count;
+}
+
+void BlockManager::OnFetch(std::uint64_t trace_id) {
+  if (!span_enabled_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  GetRoutineFrame()->set_trace_id(trace_id);
+}
+
+std::uint64_t BlockManager::TraceId() {
+  if (!span_enabled_.load(std::memory_order_relaxed)) {
+    return 0;
+  }
+  auto it = routine_frame_map_.find(GetRoutineId());
+  return it == routine_frame_map_.end() ? 0 : it->second.trace_id();
+}
+
 std::string BlockManager::GetRoutineName() {
   std::string routine_name("default_croutine");
   if (croutine::CRoutine::GetCurrentRoutine() != nullptr) {
@@ -60,9 +134,38 @@ std::string BlockManager::GetRoutineName() {
   return routine_name;
 }
 
+BlockManager::RoutineId BlockManager::GetRoutineId() {
+  auto routine = croutine::CRoutine::GetCurrentRoutine();
+  return routine == nullptr ? 0 : routine->id();
+}
+
 Frame* BlockManager::GetRoutineFrame() {
-  const std::string& routine_name = GetRoutineName();
-  return &routine_frame_map_[routine_name];
+  return &routine_frame_map_[GetRoutineId()];
+}
+
+void BlockManager::RecordSpan(const Block& block) {
+  SpanBuffer* buffer = GetThreadSpanBuffer();
+  Span span;
+  span.begin_ns = block.begin_time_since_epoch();
+  span.end_ns = block.end_time_since_epoch();
+  span.seq = block.seq();
+  span.routine_id = GetRoutineId();
+  span.depth = block.depth();
+  span.tid = thread_span_buffer.tid;
+  auto len = std::min(block.name().size(), kSpanNameSize - 1);
+  std::memcpy(span.name, block.name().data(), len);
+  span.name[len] = '\0';
+  buffer->Push(span);
+}
+
+SpanBuffer* BlockManager::GetThreadSpanBuffer() {
+  if (cyber_unlikely(thread_span_buffer.buffer == nullptr)) {
+    thread_span_buffer.buffer = std::make_shared<SpanBuffer>(kSpanBufferSize);
+    thread_span_buffer.tid = static_cast<int32_t>(syscall(SYS_gettid));
+    std::lock_guard<std::mutex> lock(span_buffers_mutex_);
+    span_buffers_.emplace_back(thread_span_buffer.buffer);
+  }
+  return thread_span_buffer.buffer.get();
 }
 
 }  // namespace profiler
@@ -17,34 +17,78 @@
 #ifndef CYBER_PROFILER_BLOCK_MANAGER_H_
 #define CYBER_PROFILER_BLOCK_MANAGER_H_
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "cyber/common/macros.h"
 #include "cyber/profiler/block.h"
 #include "cyber/profiler/frame.h"
+#include "cyber/profiler/span_buffer.h"
 
 namespace apollo {
 namespace cyber {
 namespace profiler {
 
+/**
+ * @class BlockManager
+ * @brief Keeps the stack of open blocks of every croutine.
+ *
+ * By default each finished frame is dumped to the perf log. Once span
+ * recording is enabled, every finished block is instead copied as a Span into
+ * a buffer of the calling thread, which CollectSpans drains; see
+ * TraceExporter. A block without a seq inherits the one of its parent, a
+ * top level block the trace id of the message its routine fetched last.
+ */
 class BlockManager {
  public:
-  using RoutineName = std::string;
-  using RoutineFrameMap = std::unordered_map<RoutineName, Frame>;
+  using RoutineId = std::uint64_t;
+  using RoutineFrameMap = std::unordered_map<RoutineId, Frame>;
+
+  static const uint64_t kSpanBufferSize = 4096;
 
  public:
   void StartBlock(Block* block);
 
   void EndBlock();
 
+  void SetSpanEnabled(bool enabled) { span_enabled_.store(enabled); }
+  bool span_enabled() const { return span_enabled_.load(); }
+
+  // appends the spans recorded by all threads since the last call
+  size_t CollectSpans(std::vector<Span>* spans);
+  // spans lost because a thread's buffer was full
+  uint64_t SpanDropCount();
+
+  /**
+   * @brief The calling routine fetched a message with the trace id, see
+   * MessageInfo::TraceId. Its next top level blocks take it as seq, and the
+   * messages it publishes carry it on. Both do nothing unless span recording
+   * is enabled.
+   */
+  void OnFetch(std::uint64_t trace_id);
+  // the trace id of the calling routine, 0 if none
+  std::uint64_t TraceId();
+
  private:
   std::string GetRoutineName();
+  RoutineId GetRoutineId();
   Frame* GetRoutineFrame();
+  void RecordSpan(const Block& block);
+  SpanBuffer* GetThreadSpanBuffer();
 
  private:
   static thread_local RoutineFrameMap routine_frame_map_;
 
+  std::atomic<bool> span_enabled_ = {false};
+  std::mutex span_buffers_mutex_;
+  std::vector<std::shared_ptr<SpanBuffer>> span_buffers_;
+  uint64_t orphaned_drop_count_ = 0;
+
   DECLARE_SINGLETON(BlockManager)
 };
 
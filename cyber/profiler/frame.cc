@@ -46,6 +46,11 @@ void Frame::Pop() {
   storage_.push_back(std::move(*block_ptr));
 }
 
+void Frame::Discard() {
+  if (!stack_.empty())
+    stack_.pop();
+}
+
 bool Frame::DumpToFile(const std::string& routine_name) {
   // Use 'ALOG_MODULE' instead of 'AINFO' to specify the log file
   ALOG_MODULE(kModuleName, INFO) << "Frame : " << routine_name;
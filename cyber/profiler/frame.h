@@ -32,6 +32,8 @@ class Frame {
   void Push(Block* block);
   Block* Top();
   void Pop();
+  // pops the top block without keeping it for DumpToFile
+  void Discard();
 
   bool DumpToFile(const std::string& coroutine_name);
   void Clear();
@@ -39,7 +41,13 @@ class Frame {
   std::uint32_t size() const { return stack_.size(); }
   bool finished() const { return stack_.empty(); }
 
+  // trace id of the message the routine processes, the seq of top level
+  // blocks without one
+  std::uint64_t trace_id() const { return trace_id_; }
+  void set_trace_id(std::uint64_t trace_id) { trace_id_ = trace_id; }
+
  private:
+  std::uint64_t trace_id_ = 0;
   std::stack<Block*> stack_;
   std::list<Block> storage_;
 };
@@ -42,6 +42,12 @@ namespace profiler {
   apollo::cyber::profiler::BlockManager::Instance()->StartBlock( \
       &UNIQUE_NAME(__LINE__));
 
+// seq links the block, and the blocks nested in it, to one message
+#define PERF_BLOCK_SEQ(name, seq)                                  \
+  apollo::cyber::profiler::Block UNIQUE_NAME(__LINE__)(name, seq); \
+  apollo::cyber::profiler::BlockManager::Instance()->StartBlock(   \
+      &UNIQUE_NAME(__LINE__));
+
 #define PERF_BLOCK_END \
   apollo::cyber::profiler::BlockManager::Instance()->EndBlock();
 
@@ -50,6 +56,7 @@ namespace profiler {
 #else
 
 #define PERF_BLOCK(...)
+#define PERF_BLOCK_SEQ(...)
 #define PERF_BLOCK_END
 #define PERF_FUNCTION(...)
 
@@ -14,9 +14,18 @@
  * limitations under the License.
  *****************************************************************************/
 
+#include <string>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "cyber/profiler/profiler.h"
+#include "cyber/profiler/trace_exporter.h"
+
+using apollo::cyber::profiler::Block;
+using apollo::cyber::profiler::BlockManager;
+using apollo::cyber::profiler::Span;
+using apollo::cyber::profiler::TraceExporter;
 
 TEST(ProfilerTest, single_block) {
   PERF_BLOCK("block")
@@ -60,3 +69,84 @@ TEST(ProfilerTest, function) {
   for (int i = 0; i < 1000; ++i) {
   }
 }
+
+TEST(ProfilerTest, span) {
+  auto manager = BlockManager::Instance();
+  manager->SetSpanEnabled(true);
+  {
+    Block outer("outer", 42);
+    manager->StartBlock(&outer);
+    Block inner("inner");
+    manager->StartBlock(&inner);
+    manager->EndBlock();
+    manager->EndBlock();
+  }
+  manager->SetSpanEnabled(false);
+
+  std::vector<Span> spans;
+  EXPECT_EQ(2, manager->CollectSpans(&spans));
+  ASSERT_EQ(2, spans.size());
+  EXPECT_STREQ("inner", spans[0].name);
+  EXPECT_EQ(2, spans[0].depth);
+  EXPECT_EQ(42, spans[0].seq);
+  EXPECT_STREQ("outer", spans[1].name);
+  EXPECT_EQ(1, spans[1].depth);
+  EXPECT_EQ(42, spans[1].seq);
+  EXPECT_LE(spans[1].begin_ns, spans[0].begin_ns);
+  EXPECT_GE(spans[1].end_ns, spans[0].end_ns);
+  EXPECT_EQ(0, manager->CollectSpans(&spans));
+
+  std::string events;
+  TraceExporter::Instance()->AppendEvents(spans, &events);
+  EXPECT_NE(std::string::npos, events.find("\"name\":\"outer\""));
+  EXPECT_NE(std::string::npos, events.find("\"ph\":\"X\""));
+  // only the top level span joins the flow
+  EXPECT_EQ(events.find("\"bind_id\":42"), events.rfind("\"bind_id\":42"));
+  EXPECT_NE(std::string::npos, events.find("\"bind_id\":42"));
+}
+
+TEST(ProfilerTest, span_seq_of_fetched_message) {
+  auto manager = BlockManager::Instance();
+  // nothing is linked while span recording is off
+  manager->OnFetch(7);
+  EXPECT_EQ(0, manager->TraceId());
+  manager->SetSpanEnabled(true);
+  {
+    Block block("unlinked");
+    manager->StartBlock(&block);
+    manager->EndBlock();
+  }
+
+  manager->OnFetch(7);
+  {
+    Block outer("outer");
+    manager->StartBlock(&outer);
+    Block inner("inner");
+    manager->StartBlock(&inner);
+    manager->EndBlock();
+    manager->EndBlock();
+  }
+  // what the messages the routine publishes carry on
+  EXPECT_EQ(7, manager->TraceId());
+  // a message without a trace id unlinks the next blocks
+  manager->OnFetch(0);
+  {
+    Block block("other");
+    manager->StartBlock(&block);
+    manager->EndBlock();
+  }
+  manager->SetSpanEnabled(false);
+  EXPECT_EQ(0, manager->TraceId());
+
+  std::vector<Span> spans;
+  EXPECT_EQ(4, manager->CollectSpans(&spans));
+  ASSERT_EQ(4, spans.size());
+  EXPECT_STREQ("unlinked", spans[0].name);
+  EXPECT_EQ(0, spans[0].seq);
+  EXPECT_STREQ("inner", spans[1].name);
+  EXPECT_EQ(7, spans[1].seq);
+  EXPECT_STREQ("outer", spans[2].name);
+  EXPECT_EQ(7, spans[2].seq);
+  EXPECT_STREQ("other", spans[3].name);
+  EXPECT_EQ(0, spans[3].seq);
+}
@@ -0,0 +1,55 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/profiler/span_buffer.h"
+
+namespace apollo {
+namespace cyber {
+namespace profiler {
+
+SpanBuffer::SpanBuffer(uint64_t capacity) {
+  uint64_t size = 1;
+  while (size < capacity) {
+    size <<= 1;
+  }
+  mask_ = size - 1;
+  spans_.reset(new Span[size]);
+}
+
+bool SpanBuffer::Push(const Span& span) {
+  uint64_t tail = tail_.load(std::memory_order_relaxed);
+  if (tail - head_.load(std::memory_order_acquire) > mask_) {
+    drop_count_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  spans_[tail & mask_] = span;
+  tail_.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+size_t SpanBuffer::Drain(std::vector<Span>* spans) {
+  uint64_t head = head_.load(std::memory_order_relaxed);
+  uint64_t tail = tail_.load(std::memory_order_acquire);
+  for (uint64_t i = head; i < tail; ++i) {
+    spans->emplace_back(spans_[i & mask_]);
+  }
+  head_.store(tail, std::memory_order_release);
+  return static_cast<size_t>(tail - head);
+}
+
+}  // namespace profiler
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,77 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_PROFILER_SPAN_BUFFER_H_
+#define CYBER_PROFILER_SPAN_BUFFER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "cyber/base/macros.h"
+
+namespace apollo {
+namespace cyber {
+namespace profiler {
+
+static const size_t kSpanNameSize = 48;
+
+// A finished Block, plain data so that recording it is a copy.
+struct Span {
+  uint64_t begin_ns = 0;  // steady clock, shared by all processes on a host
+  uint64_t end_ns = 0;
+  uint64_t seq = 0;  // message seq or trace id, 0 if not linked
+  uint64_t routine_id = 0;  // 0 outside of a croutine
+  uint32_t depth = 0;
+  int32_t tid = 0;
+  char name[kSpanNameSize] = {0};
+};
+
+/**
+ * @class SpanBuffer
+ * @brief Single-producer single-consumer ring of spans. Each thread records
+ * into its own buffer, which the exporter thread drains; a full buffer drops
+ * the span rather than stall the thread being measured.
+ */
+class SpanBuffer {
+ public:
+  explicit SpanBuffer(uint64_t capacity);
+
+  bool Push(const Span& span);
+  // appends everything recorded so far to spans
+  size_t Drain(std::vector<Span>* spans);
+
+  uint64_t DropCount() const { return drop_count_.load(); }
+
+  // set once the owning thread exited, the buffer goes away when drained
+  void set_orphaned() { orphaned_.store(true, std::memory_order_release); }
+  bool orphaned() const { return orphaned_.load(std::memory_order_acquire); }
+
+ private:
+  uint64_t mask_ = 0;
+  std::unique_ptr<Span[]> spans_;
+  alignas(CACHELINE_SIZE) std::atomic<uint64_t> head_ = {0};
+  alignas(CACHELINE_SIZE) std::atomic<uint64_t> tail_ = {0};
+  std::atomic<uint64_t> drop_count_ = {0};
+  std::atomic<bool> orphaned_ = {false};
+};
+
+}  // namespace profiler
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_PROFILER_SPAN_BUFFER_H_
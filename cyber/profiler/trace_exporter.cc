@@ -0,0 +1,205 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/profiler/trace_exporter.h"
+
+#include <unistd.h>
+
+#include <chrono>
+
+#include "cyber/common/global_data.h"
+#include "cyber/common/log.h"
+#include "cyber/profiler/block_manager.h"
+
+namespace apollo {
+namespace cyber {
+namespace profiler {
+
+namespace {
+
+void AppendEscaped(const char* str, std::string* out) {
+  for (; *str != '\0'; ++str) {
+    char c = *str;
+    if (c == '"' || c == '\\') {
+      out->push_back('\\');
+      out->push_back(c);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      out->push_back(' ');
+    } else {
+      out->push_back(c);
+    }
+  }
+}
+
+// chrome trace timestamps are in microseconds
+void AppendMicros(uint64_t ns, std::string* out) {
+  out->append(std::to_string(ns / 1000));
+  out->push_back('.');
+  auto frac = std::to_string(ns % 1000);
+  out->append(3 - frac.size(), '0');
+  out->append(frac);
+}
+
+}  // namespace
+
+TraceExporter::TraceExporter() : pid_(static_cast<int>(getpid())) {}
+
+TraceExporter::~TraceExporter() { Shutdown(); }
+
+bool TraceExporter::Start(const std::string& file_path, uint64_t interval_ms) {
+  std::lock_guard<std::mutex> lock(running_mutex_);
+  if (running_) {
+    return true;
+  }
+
+  if (!file_path.empty()) {
+    file_ = fopen(file_path.c_str(), "w");
+    if (file_ == nullptr) {
+      AERROR << "open trace file " << file_path << " failed";
+      return false;
+    }
+    fputs("[\n]\n", file_);
+    fflush(file_);
+    file_empty_ = true;
+  }
+  file_path_ = file_path;
+  interval_ms_ = interval_ms;
+
+  BlockManager::Instance()->SetSpanEnabled(true);
+  running_ = true;
+  export_thread_ = std::thread([this]() { this->ExportFunc(); });
+  AINFO << "trace exporter start, file: " << file_path_
+        << ", interval: " << interval_ms_ << "ms";
+  return true;
+}
+
+void TraceExporter::Shutdown() {
+  {
+    std::lock_guard<std::mutex> lock(running_mutex_);
+    if (!running_.exchange(false)) {
+      return;
+    }
+    cv_.notify_all();
+  }
+  if (export_thread_.joinable()) {
+    export_thread_.join();
+  }
+  BlockManager::Instance()->SetSpanEnabled(false);
+  Export();
+
+  std::lock_guard<std::mutex> lock(export_mutex_);
+  if (file_ != nullptr) {
+    fclose(file_);
+    file_ = nullptr;
+  }
+  auto dropped = BlockManager::Instance()->SpanDropCount();
+  if (dropped > 0) {
+    AWARN << dropped << " spans dropped by full span buffers";
+  }
+}
+
+void TraceExporter::AddSink(const Sink& sink) {
+  std::lock_guard<std::mutex> lock(export_mutex_);
+  sinks_.emplace_back(sink);
+}
+
+void TraceExporter::ExportFunc() {
+  while (running_) {
+    {
+      std::unique_lock<std::mutex> lock(running_mutex_);
+      cv_.wait_for(lock, std::chrono::milliseconds(interval_ms_),
+                   [this]() { return !running_; });
+    }
+    Export();
+  }
+}
+
+void TraceExporter::Export() {
+  std::lock_guard<std::mutex> lock(export_mutex_);
+  spans_.clear();
+  if (BlockManager::Instance()->CollectSpans(&spans_) == 0) {
+    return;
+  }
+  std::string events;
+  AppendEvents(spans_, &events);
+  WriteFile(events);
+  for (auto& sink : sinks_) {
+    sink(events);
+  }
+}
+
+void TraceExporter::AppendEvents(const std::vector<Span>& spans,
+                                 std::string* events) {
+  events->reserve(events->size() + spans.size() * 200);
+  for (auto& span : spans) {
+    if (!events->empty()) {
+      events->append(",\n");
+    }
+    events->append("{\"name\":\"");
+    AppendEscaped(span.name, events);
+    events->append("\",\"cat\":\"cyber\",\"ph\":\"X\",\"ts\":");
+    AppendMicros(span.begin_ns, events);
+    events->append(",\"dur\":");
+    AppendMicros(span.end_ns > span.begin_ns ? span.end_ns - span.begin_ns : 0,
+                 events);
+    events->append(",\"pid\":");
+    events->append(std::to_string(pid_));
+    events->append(",\"tid\":");
+    events->append(std::to_string(span.tid));
+    if (span.seq != 0 && span.depth == 1) {
+      events->append(",\"bind_id\":");
+      events->append(std::to_string(span.seq));
+      events->append(",\"flow_in\":true,\"flow_out\":true");
+    }
+    events->append(",\"args\":{\"seq\":");
+    events->append(std::to_string(span.seq));
+    events->append(",\"depth\":");
+    events->append(std::to_string(span.depth));
+    events->append(",\"routine\":\"");
+    AppendEscaped(RoutineName(span.routine_id).c_str(), events);
+    events->append("\"}}");
+  }
+}
+
+void TraceExporter::WriteFile(const std::string& events) {
+  if (file_ == nullptr) {
+    return;
+  }
+  // overwrite the closing "]\n"
+  fseek(file_, -2, SEEK_END);
+  if (!file_empty_) {
+    fputs(",\n", file_);
+  }
+  fputs(events.c_str(), file_);
+  fputs("\n]\n", file_);
+  fflush(file_);
+  file_empty_ = false;
+}
+
+const std::string& TraceExporter::RoutineName(uint64_t routine_id) {
+  auto it = routine_names_.find(routine_id);
+  if (it == routine_names_.end()) {
+    std::string name = routine_id == 0
+                           ? common::GlobalData::Instance()->ProcessGroup()
+                           : common::GlobalData::GetTaskNameById(routine_id);
+    it = routine_names_.emplace(routine_id, name).first;
+  }
+  return it->second;
+}
+
+}  // namespace profiler
+}  // namespace cyber
+}  // namespace apollo
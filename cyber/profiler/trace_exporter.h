@@ -0,0 +1,103 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_PROFILER_TRACE_EXPORTER_H_
+#define CYBER_PROFILER_TRACE_EXPORTER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "cyber/common/macros.h"
+#include "cyber/profiler/span_buffer.h"
+
+namespace apollo {
+namespace cyber {
+namespace profiler {
+
+/**
+ * @class TraceExporter
+ * @brief Periodically collects the spans of BlockManager and exports them as
+ * Chrome trace events, which chrome://tracing and Perfetto both load.
+ *
+ * Every top level span carrying a seq is bound to a flow with that seq as id,
+ * so the spans of one message line up across components, and across
+ * processes once their files are merged (e.g. `jq -s add *.trace.json`):
+ * timestamps come from the steady clock, which all processes of a host share.
+ *
+ * The file is rewritten to stay a valid JSON array after every export. Sinks
+ * get the events of each export as comma separated JSON objects.
+ */
+class TraceExporter {
+ public:
+  using Sink = std::function<void(const std::string& events)>;
+
+  ~TraceExporter();
+
+  /**
+   * @brief Enable span recording and start exporting every interval_ms.
+   *
+   * @param file_path the trace file, no file is written when empty
+   */
+  bool Start(const std::string& file_path, uint64_t interval_ms = 1000);
+  void Shutdown();
+
+  void AddSink(const Sink& sink);
+
+  // collect and export the spans recorded so far
+  void Export();
+
+  /**
+   * @brief Append spans as Chrome trace events to events, comma separated.
+   */
+  void AppendEvents(const std::vector<Span>& spans, std::string* events);
+
+ private:
+  void ExportFunc();
+  void WriteFile(const std::string& events);
+  const std::string& RoutineName(uint64_t routine_id);
+
+  int pid_ = 0;
+  uint64_t interval_ms_ = 1000;
+  std::string file_path_;
+  FILE* file_ = nullptr;
+  bool file_empty_ = true;
+
+  std::mutex export_mutex_;
+  std::vector<Span> spans_;
+  std::vector<Sink> sinks_;
+  std::unordered_map<uint64_t, std::string> routine_names_;
+
+  std::atomic<bool> running_ = {false};
+  std::mutex running_mutex_;
+  std::condition_variable cv_;
+  std::thread export_thread_;
+
+  DECLARE_SINGLETON(TraceExporter)
+};
+
+}  // namespace profiler
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_PROFILER_TRACE_EXPORTER_H_
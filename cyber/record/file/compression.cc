@@ -0,0 +1,206 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/record/file/compression.h"
+
+#include <cstring>
+#include <limits>
+
+#include "bzlib.h"
+#include "lz4.h"
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+using apollo::cyber::proto::CompressType;
+
+namespace {
+
+const int kBz2BlockSize100k = 9;
+const int kBz2WorkFactor = 30;
+
+bool Lz4Compress(const std::string& raw, std::string* frame) {
+  if (raw.size() > static_cast<size_t>(LZ4_MAX_INPUT_SIZE)) {
+    AERROR << "Chunk of " << raw.size() << " bytes is too large for lz4.";
+    return false;
+  }
+  int src_size = static_cast<int>(raw.size());
+  int bound = LZ4_compressBound(src_size);
+  frame->resize(kCompressFrameHeaderSize + bound);
+  int size = LZ4_compress_default(raw.data(),
+                                  &(*frame)[kCompressFrameHeaderSize],
+                                  src_size, bound);
+  if (size <= 0) {
+    AERROR << "lz4 compress failed, src size: " << src_size;
+    return false;
+  }
+  frame->resize(kCompressFrameHeaderSize + size);
+  return true;
+}
+
+bool Lz4Decompress(const char* data, size_t size, std::string* raw) {
+  if (size > static_cast<size_t>(std::numeric_limits<int>::max()) ||
+      raw->size() > static_cast<size_t>(std::numeric_limits<int>::max())) {
+    AERROR << "Frame of " << size << " bytes is too large for lz4.";
+    return false;
+  }
+  int dst_size = static_cast<int>(raw->size());
+  int count = LZ4_decompress_safe(data, &(*raw)[0], static_cast<int>(size),
+                                  dst_size);
+  if (count != dst_size) {
+    AERROR << "lz4 decompress failed, expect: " << dst_size
+           << ", actual: " << count;
+    return false;
+  }
+  return true;
+}
+
+bool Bz2Compress(const std::string& raw, std::string* frame) {
+  if (raw.size() > std::numeric_limits<unsigned int>::max() / 2) {
+    AERROR << "Chunk of " << raw.size() << " bytes is too large for bz2.";
+    return false;
+  }
+  // bzip2 never grows input by more than 1% plus 600 bytes
+  unsigned int bound =
+      static_cast<unsigned int>(raw.size() + raw.size() / 100 + 600);
+  frame->resize(kCompressFrameHeaderSize + bound);
+  int ret = BZ2_bzBuffToBuffCompress(
+      &(*frame)[kCompressFrameHeaderSize], &bound,
+      const_cast<char*>(raw.data()), static_cast<unsigned int>(raw.size()),
+      kBz2BlockSize100k, 0, kBz2WorkFactor);
+  if (ret != BZ_OK) {
+    AERROR << "bz2 compress failed, ret: " << ret;
+    return false;
+  }
+  frame->resize(kCompressFrameHeaderSize + bound);
+  return true;
+}
+
+bool Bz2Decompress(const char* data, size_t size, std::string* raw) {
+  if (size > std::numeric_limits<unsigned int>::max() ||
+      raw->size() > std::numeric_limits<unsigned int>::max()) {
+    AERROR << "Frame of " << size << " bytes is too large for bz2.";
+    return false;
+  }
+  unsigned int dst_size = static_cast<unsigned int>(raw->size());
+  int ret = BZ2_bzBuffToBuffDecompress(&(*raw)[0], &dst_size,
+                                       const_cast<char*>(data),
+                                       static_cast<unsigned int>(size), 0, 0);
+  if (ret != BZ_OK || dst_size != raw->size()) {
+    AERROR << "bz2 decompress failed, ret: " << ret
+           << ", expect: " << raw->size() << ", actual: " << dst_size;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+bool Compress(CompressType type, const std::string& raw, std::string* frame) {
+  RETURN_VAL_IF_NULL(frame, false);
+  bool ret = false;
+  switch (type) {
+    case CompressType::COMPRESS_LZ4:
+      ret = Lz4Compress(raw, frame);
+      break;
+    case CompressType::COMPRESS_BZ2:
+      ret = Bz2Compress(raw, frame);
+      break;
+    default:
+      AERROR << "Unsupported compress type: " << type;
+      return false;
+  }
+  if (!ret) {
+    return false;
+  }
+  uint64_t raw_size = raw.size();
+  std::memcpy(&(*frame)[0], &raw_size, kCompressFrameHeaderSize);
+  return true;
+}
+
+bool Decompress(CompressType type, const char* frame, size_t size,
+                std::string* raw) {
+  RETURN_VAL_IF_NULL(frame, false);
+  RETURN_VAL_IF_NULL(raw, false);
+  uint64_t raw_size = 0;
+  if (!GetUncompressedSize(frame, size, &raw_size)) {
+    return false;
+  }
+  if (raw_size > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+    AERROR << "Invalid uncompressed size: " << raw_size;
+    return false;
+  }
+  raw->resize(raw_size);
+  if (raw_size == 0) {
+    return true;
+  }
+  const char* data = frame + kCompressFrameHeaderSize;
+  size_t data_size = size - kCompressFrameHeaderSize;
+  switch (type) {
+    case CompressType::COMPRESS_LZ4:
+      return Lz4Decompress(data, data_size, raw);
+    case CompressType::COMPRESS_BZ2:
+      return Bz2Decompress(data, data_size, raw);
+    default:
+      AERROR << "Unsupported compress type: " << type;
+      return false;
+  }
+}
+
+bool GetUncompressedSize(const char* frame, size_t size, uint64_t* raw_size) {
+  RETURN_VAL_IF_NULL(frame, false);
+  RETURN_VAL_IF_NULL(raw_size, false);
+  if (size < kCompressFrameHeaderSize) {
+    AERROR << "Compressed frame is too short: " << size;
+    return false;
+  }
+  std::memcpy(raw_size, frame, kCompressFrameHeaderSize);
+  return true;
+}
+
+bool ParseCompressType(const std::string& name, CompressType* type) {
+  RETURN_VAL_IF_NULL(type, false);
+  if (name == "none") {
+    *type = CompressType::COMPRESS_NONE;
+  } else if (name == "lz4") {
+    *type = CompressType::COMPRESS_LZ4;
+  } else if (name == "bz2") {
+    *type = CompressType::COMPRESS_BZ2;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+std::string CompressTypeName(CompressType type) {
+  switch (type) {
+    case CompressType::COMPRESS_NONE:
+      return "none";
+    case CompressType::COMPRESS_LZ4:
+      return "lz4";
+    case CompressType::COMPRESS_BZ2:
+      return "bz2";
+    default:
+      return "unknown";
+  }
+}
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
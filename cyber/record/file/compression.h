@@ -0,0 +1,55 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_RECORD_FILE_COMPRESSION_H_
+#define CYBER_RECORD_FILE_COMPRESSION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "cyber/proto/record.pb.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+/**
+ * A compressed chunk body section holds a frame instead of the serialized
+ * ChunkBody: the uncompressed size as a little endian uint64 followed by the
+ * compressed bytes. Keeping the size in front lets readers allocate once and
+ * lets `cyber_recorder info` get the ratio without decompressing.
+ */
+const size_t kCompressFrameHeaderSize = sizeof(uint64_t);
+
+bool Compress(proto::CompressType type, const std::string& raw,
+              std::string* frame);
+
+bool Decompress(proto::CompressType type, const char* frame, size_t size,
+                std::string* raw);
+
+// reads the uncompressed size stored in front of a frame
+bool GetUncompressedSize(const char* frame, size_t size, uint64_t* raw_size);
+
+// "none", "lz4" or "bz2"
+bool ParseCompressType(const std::string& name, proto::CompressType* type);
+std::string CompressTypeName(proto::CompressType type);
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_RECORD_FILE_COMPRESSION_H_
@@ -16,13 +16,115 @@
 
 #include "cyber/record/file/record_file_reader.h"
 
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "google/protobuf/wire_format_lite.h"
+
 #include "cyber/common/file.h"
+#include "cyber/record/file/compression.h"
 
 namespace apollo {
 namespace cyber {
 namespace record {
 
 using apollo::cyber::proto::SectionType;
+using google::protobuf::internal::WireFormatLite;
+
+namespace {
+
+// field numbers of ChunkBody and SingleMessage in record.proto
+const int kChunkBodyMessagesField = 1;
+const int kSingleMessageChannelNameField = 1;
+const int kSingleMessageTimeField = 2;
+const int kSingleMessageContentField = 3;
+
+bool ReadLengthDelimited(CodedInputStream* input, const void** data,
+                         uint32_t* size) {
+  if (!input->ReadVarint32(size)) {
+    return false;
+  }
+  if (*size == 0) {
+    *data = nullptr;
+    return true;
+  }
+  int avail = 0;
+  if (!input->GetDirectBufferPointer(data, &avail) ||
+      static_cast<uint32_t>(avail) < *size) {
+    return false;
+  }
+  return input->Skip(static_cast<int>(*size));
+}
+
+bool ParseSingleMessageView(CodedInputStream* input,
+                            const std::shared_ptr<const void>& holder,
+                            SingleMessageView* view) {
+  while (uint32_t tag = input->ReadTag()) {
+    int field = WireFormatLite::GetTagFieldNumber(tag);
+    auto wire_type = WireFormatLite::GetTagWireType(tag);
+    const void* data = nullptr;
+    uint32_t size = 0;
+    if (field == kSingleMessageChannelNameField &&
+        wire_type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+      if (!ReadLengthDelimited(input, &data, &size)) {
+        return false;
+      }
+      view->channel_name.assign(static_cast<const char*>(data), size);
+    } else if (field == kSingleMessageTimeField &&
+               wire_type == WireFormatLite::WIRETYPE_VARINT) {
+      if (!input->ReadVarint64(&view->time)) {
+        return false;
+      }
+    } else if (field == kSingleMessageContentField &&
+               wire_type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+      if (!ReadLengthDelimited(input, &data, &size)) {
+        return false;
+      }
+      if (size > 0) {
+        view->content.Attach(data, size, holder);
+      }
+    } else if (!WireFormatLite::SkipField(input, tag)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// walks the wire format of a ChunkBody without copying message contents
+bool ParseChunkBodyView(const char* data, int64_t size,
+                        const std::shared_ptr<const void>& holder,
+                        std::vector<SingleMessageView>* messages) {
+  CodedInputStream input(reinterpret_cast<const uint8_t*>(data),
+                         static_cast<int>(size));
+  while (uint32_t tag = input.ReadTag()) {
+    if (WireFormatLite::GetTagFieldNumber(tag) != kChunkBodyMessagesField ||
+        WireFormatLite::GetTagWireType(tag) !=
+            WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+      if (!WireFormatLite::SkipField(&input, tag)) {
+        return false;
+      }
+      continue;
+    }
+    uint32_t length = 0;
+    if (!input.ReadVarint32(&length)) {
+      return false;
+    }
+    auto limit = input.PushLimit(static_cast<int>(length));
+    SingleMessageView view;
+    if (!ParseSingleMessageView(&input, holder, &view) ||
+        !input.ConsumedEntireMessage()) {
+      return false;
+    }
+    input.PopLimit(limit);
+    messages->emplace_back(std::move(view));
+  }
+  return input.CurrentPosition() == size;
+}
+
+}  // namespace
 
 bool RecordFileReader::Open(const std::string& path) {
   std::lock_guard<std::mutex> lock(mutex_);
@@ -38,6 +140,9 @@ bool RecordFileReader::Open(const std::string& path) {
     return false;
   }
   end_of_file_ = false;
+  if (use_mmap_ && !MapFile()) {
+    AWARN << "Map file failed, read it instead, file: " << path_;
+  }
   if (!ReadHeader()) {
     AERROR << "Read header section fail, file: " << path_;
     return false;
@@ -45,7 +150,64 @@ bool RecordFileReader::Open(const std::string& path) {
   return true;
 }
 
+bool RecordFileReader::MapFile() {
+  struct stat file_stat;
+  if (fstat(fd_, &file_stat) < 0 || file_stat.st_size == 0) {
+    return false;
+  }
+  size_t length = file_stat.st_size;
+  void* addr = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd_, 0);
+  if (addr == MAP_FAILED) {
+    AERROR << "mmap failed, file: " << path_ << ", errno: " << errno;
+    return false;
+  }
+  // records are mostly replayed front to back
+  madvise(addr, length, MADV_SEQUENTIAL);
+  // views handed out keep the mapping alive after Close
+  mapping_.reset(static_cast<const void*>(addr), [length](const void* p) {
+    munmap(const_cast<void*>(p), length);
+  });
+  map_data_ = static_cast<const char*>(addr);
+  map_size_ = static_cast<int64_t>(length);
+  position_ = 0;
+  return true;
+}
+
+void RecordFileReader::WillNeed(int64_t position, int64_t size) {
+  static const int64_t kPageSize = sysconf(_SC_PAGESIZE);
+  int64_t begin = position / kPageSize * kPageSize;
+  int64_t end = std::min(position + size, map_size_);
+  if (size <= 0 || end <= begin) {
+    return;
+  }
+  madvise(const_cast<char*>(map_data_) + begin, end - begin, MADV_WILLNEED);
+}
+
+int64_t RecordFileReader::CurrentPosition() {
+  if (map_data_ != nullptr) {
+    return position_;
+  }
+  return RecordFileBase::CurrentPosition();
+}
+
+bool RecordFileReader::SetPosition(int64_t position) {
+  if (map_data_ == nullptr) {
+    return RecordFileBase::SetPosition(position);
+  }
+  if (position < 0 || position > map_size_) {
+    AERROR << "Position out of the mapped file, file: " << path_
+           << ", position: " << position << ", size: " << map_size_;
+    return false;
+  }
+  position_ = position;
+  return true;
+}
+
 void RecordFileReader::Close() {
+  mapping_.reset();
+  map_data_ = nullptr;
+  map_size_ = 0;
+  position_ = 0;
   if (fd_ >= 0) {
     close(fd_);
     fd_ = -1;
@@ -115,6 +277,23 @@ bool RecordFileReader::ReadIndex() {
 }
 
 bool RecordFileReader::ReadSection(Section* section) {
+  if (map_data_ != nullptr) {
+    if (position_ >= map_size_) {
+      end_of_file_ = true;
+      AINFO << "Reach end of file.";
+      return false;
+    }
+    if (map_size_ - position_ < static_cast<int64_t>(sizeof(struct Section))) {
+      AERROR << "Read section failed, file: " << path_
+             << ", expect count: " << sizeof(struct Section)
+             << ", actual count: " << map_size_ - position_;
+      return false;
+    }
+    memcpy(section, map_data_ + position_, sizeof(struct Section));
+    position_ += sizeof(struct Section);
+    WillNeed(position_, section->size);
+    return true;
+  }
   ssize_t count = read(fd_, section, sizeof(struct Section));
   if (count < 0) {
     AERROR << "Read fd failed, fd_: " << fd_ << ", errno: " << errno;
@@ -147,6 +326,176 @@ bool RecordFileReader::SkipSection(int64_t size) {
   return true;
 }
 
+bool RecordFileReader::ReadBytes(int64_t size, std::string* bytes) {
+  if (size < 0) {
+    AERROR << "Invalid section size: " << size;
+    return false;
+  }
+  if (map_data_ != nullptr) {
+    if (size > map_size_ - position_) {
+      end_of_file_ = true;
+      AERROR << "Reach end of file in the middle of a section"
+             << ", expect count: " << size
+             << ", actual count: " << map_size_ - position_;
+      return false;
+    }
+    bytes->assign(map_data_ + position_, size);
+    position_ += size;
+    return true;
+  }
+  bytes->resize(size);
+  int64_t offset = 0;
+  while (offset < size) {
+    ssize_t count = read(fd_, &(*bytes)[offset], size - offset);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      AERROR << "Read fd failed, fd_: " << fd_ << ", errno: " << errno;
+      return false;
+    }
+    if (count == 0) {
+      end_of_file_ = true;
+      AERROR << "Reach end of file in the middle of a section"
+             << ", expect count: " << size << ", actual count: " << offset;
+      return false;
+    }
+    offset += count;
+  }
+  return true;
+}
+
+bool RecordFileReader::ReadMappedSection(int64_t size,
+                                         google::protobuf::Message* message) {
+  if (size < 0 || size > std::numeric_limits<int>::max()) {
+    AERROR << "Invalid section size: " << size;
+    return false;
+  }
+  if (size > map_size_ - position_) {
+    end_of_file_ = true;
+    AERROR << "Section exceeds the end of file, size: " << size;
+    return false;
+  }
+  const char* data = map_data_ + position_;
+  // step over the section even if it is broken, like the read() path does
+  position_ += size;
+  if (!message->ParseFromArray(data, static_cast<int>(size))) {
+    AERROR << "Parse section message failed.";
+    return false;
+  }
+  return true;
+}
+
+bool RecordFileReader::ReadCompressedSection(
+    int64_t size, google::protobuf::Message* message) {
+  std::string frame_copy;
+  const char* frame = nullptr;
+  if (map_data_ != nullptr && size >= 0 && size <= map_size_ - position_) {
+    frame = map_data_ + position_;
+    position_ += size;
+  } else if (ReadBytes(size, &frame_copy)) {
+    frame = frame_copy.data();
+  } else {
+    return false;
+  }
+  std::string raw;
+  if (!Decompress(header_.compress(), frame, size, &raw)) {
+    AERROR << "Decompress section failed, file: " << path_;
+    return false;
+  }
+  if (!message->ParseFromString(raw)) {
+    AERROR << "Parse section message failed.";
+    return false;
+  }
+  return true;
+}
+
+bool RecordFileReader::ReadChunkBodySize(int64_t position,
+                                         uint64_t* stored_size,
+                                         uint64_t* raw_size) {
+  RETURN_VAL_IF_NULL(stored_size, false);
+  RETURN_VAL_IF_NULL(raw_size, false);
+  if (!SetPosition(position)) {
+    AERROR << "Skip bytes for reaching the chunk body section failed.";
+    return false;
+  }
+  Section section;
+  if (!ReadSection(&section)) {
+    return false;
+  }
+  if (section.type != SectionType::SECTION_CHUNK_BODY) {
+    AERROR << "Check section type failed"
+           << ", expect: " << SectionType::SECTION_CHUNK_BODY
+           << ", actual: " << section.type;
+    return false;
+  }
+  *stored_size = section.size;
+  if (header_.compress() == proto::CompressType::COMPRESS_NONE) {
+    *raw_size = section.size;
+    return true;
+  }
+  std::string frame_header;
+  if (!ReadBytes(kCompressFrameHeaderSize, &frame_header)) {
+    return false;
+  }
+  return GetUncompressedSize(frame_header.data(), frame_header.size(),
+                             raw_size);
+}
+
+bool RecordFileReader::ReadChunkBodyView(
+    int64_t size, std::vector<SingleMessageView>* messages) {
+  RETURN_VAL_IF_NULL(messages, false);
+  if (size < 0 || size > std::numeric_limits<int>::max()) {
+    AERROR << "Invalid chunk body size: " << size;
+    return false;
+  }
+  if (map_data_ != nullptr && size > map_size_ - position_) {
+    end_of_file_ = true;
+    AERROR << "Section exceeds the end of file, size: " << size;
+    return false;
+  }
+  const char* data = nullptr;
+  int64_t data_size = size;
+  std::shared_ptr<const void> holder = nullptr;
+  if (header_.compress() != proto::CompressType::COMPRESS_NONE) {
+    std::string frame_copy;
+    const char* frame = nullptr;
+    if (map_data_ != nullptr) {
+      frame = map_data_ + position_;
+      position_ += size;
+    } else if (ReadBytes(size, &frame_copy)) {
+      frame = frame_copy.data();
+    } else {
+      return false;
+    }
+    auto raw = std::make_shared<std::string>();
+    if (!Decompress(header_.compress(), frame, size, raw.get())) {
+      AERROR << "Decompress section failed, file: " << path_;
+      return false;
+    }
+    data = raw->data();
+    data_size = raw->size();
+    holder = raw;
+  } else if (map_data_ != nullptr) {
+    data = map_data_ + position_;
+    holder = mapping_;
+    position_ += size;
+  } else {
+    auto bytes = std::make_shared<std::string>();
+    if (!ReadBytes(size, bytes.get())) {
+      return false;
+    }
+    data = bytes->data();
+    holder = bytes;
+  }
+  if (data_size > std::numeric_limits<int>::max() ||
+      !ParseChunkBodyView(data, data_size, holder, messages)) {
+    AERROR << "Parse chunk body view failed, file: " << path_;
+    return false;
+  }
+  return true;
+}
+
 RecordFileReader::~RecordFileReader() {
   Close();
 }
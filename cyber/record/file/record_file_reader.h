@@ -20,8 +20,10 @@
 #include <fstream>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <limits>
 #include "google/protobuf/io/coded_stream.h"
@@ -30,6 +32,7 @@
 #include "google/protobuf/text_format.h"
 
 #include "cyber/common/log.h"
+#include "cyber/message/message_view.h"
 #include "cyber/record/file/record_file_base.h"
 #include "cyber/record/file/section.h"
 #include "cyber/time/time.h"
@@ -42,12 +45,34 @@ using google::protobuf::io::CodedInputStream;
 using google::protobuf::io::FileInputStream;
 using google::protobuf::io::ZeroCopyInputStream;
 
+/**
+ * @brief A message of a chunk body whose content is not copied out of the
+ * record. The view keeps the bytes it points to alive on its own, so it
+ * stays valid after the reader moves on or is closed.
+ */
+struct SingleMessageView {
+  std::string channel_name;
+  uint64_t time = 0;
+  message::MessageView content;
+};
+
 class RecordFileReader : public RecordFileBase {
  public:
   RecordFileReader() = default;
+  /**
+   * @brief With use_mmap the file is mapped read-only and sections are parsed
+   * straight from the page cache, so processes replaying the same record
+   * share its pages instead of each reading a private copy. Falls back to
+   * read() if the file can not be mapped. A file still being written is only
+   * seen up to the size it had when opened.
+   */
+  explicit RecordFileReader(bool use_mmap) : use_mmap_(use_mmap) {}
   virtual ~RecordFileReader();
   bool Open(const std::string& path) override;
   void Close() override;
+  int64_t CurrentPosition() override;
+  bool SetPosition(int64_t position) override;
+  bool IsMapped() const { return map_data_ != nullptr; }
   bool Reset();
   bool ReadSection(Section* section);
   bool SkipSection(int64_t size);
@@ -55,10 +80,36 @@ class RecordFileReader : public RecordFileBase {
   bool ReadSection(int64_t size, T* message);
   bool ReadIndex();
   bool EndOfFile() { return end_of_file_; }
+  /**
+   * @brief Get the stored and the uncompressed size of the chunk body section
+   * at the given position. Both are the same for an uncompressed record.
+   */
+  bool ReadChunkBodySize(int64_t position, uint64_t* stored_size,
+                         uint64_t* raw_size);
+  /**
+   * @brief Read a chunk body section as views. Contents point into the
+   * mapping of an uncompressed record, or into one shared buffer holding the
+   * decompressed or read chunk otherwise.
+   */
+  bool ReadChunkBodyView(int64_t size,
+                         std::vector<SingleMessageView>* messages);
 
  private:
+  bool MapFile();
+  void WillNeed(int64_t position, int64_t size);
+  bool ReadMappedSection(int64_t size, google::protobuf::Message* message);
   bool ReadHeader();
+  bool ReadBytes(int64_t size, std::string* bytes);
+  // chunk bodies of compressed records are decompressed transparently
+  bool ReadCompressedSection(int64_t size,
+                             google::protobuf::Message* message);
   bool end_of_file_ = false;
+
+  bool use_mmap_ = false;
+  std::shared_ptr<const void> mapping_ = nullptr;
+  const char* map_data_ = nullptr;
+  int64_t map_size_ = 0;
+  int64_t position_ = 0;
 };
 
 template <typename T>
@@ -68,6 +119,13 @@ bool RecordFileReader::ReadSection(int64_t size, T* message) {
     AERROR << "Size value greater than the range of int value.";
     return false;
   }
+  if (std::is_same<T, proto::ChunkBody>::value &&
+      header_.compress() != proto::CompressType::COMPRESS_NONE) {
+    return ReadCompressedSection(size, message);
+  }
+  if (map_data_ != nullptr) {
+    return ReadMappedSection(size, message);
+  }
   FileInputStream raw_input(fd_, static_cast<int>(size));
   CodedInputStream coded_input(&raw_input);
   CodedInputStream::Limit limit = coded_input.PushLimit(static_cast<int>(size));
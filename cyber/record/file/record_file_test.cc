@@ -17,6 +17,7 @@
 #include <unistd.h>
 #include <atomic>
 #include <string>
+#include <vector>
 
 #include "gflags/gflags.h"
 #include "gtest/gtest.h"
@@ -43,6 +44,7 @@ constexpr char kMsgType[] = "apollo.cyber.proto.Test";
 constexpr char kStr10B[] = "1234567890";
 constexpr char kTestFile1[] = "record_file_test_1.record";
 constexpr char kTestFile2[] = "record_file_test_2.record";
+constexpr char kTestFile3[] = "record_file_test_3.record";
 
 TEST(ChunkTest, TestAll) {
   Chunk ck;
@@ -308,6 +310,141 @@ TEST(RecordFileTest, TestIndex) {
   }
 }
 
+TEST(RecordFileTest, TestCompressedChunks) {
+  const int kMsgNum = 100;
+  const std::string content(1024, 'a');
+  for (auto compress_type : {proto::CompressType::COMPRESS_LZ4,
+                             proto::CompressType::COMPRESS_BZ2}) {
+    {
+      RecordFileWriter rfw;
+      ASSERT_TRUE(rfw.Open(kTestFile3));
+      // every message closes its own chunk, so chunks pile up in the pool
+      Header header = HeaderBuilder::GetHeaderWithChunkParams(0, 1);
+      header.set_compress(compress_type);
+      ASSERT_TRUE(rfw.WriteHeader(header));
+
+      Channel chan1;
+      chan1.set_name(kChan1);
+      chan1.set_message_type(kMsgType);
+      ASSERT_TRUE(rfw.WriteChannel(chan1));
+
+      for (int i = 1; i <= kMsgNum; ++i) {
+        SingleMessage msg;
+        msg.set_channel_name(kChan1);
+        msg.set_content(content);
+        msg.set_time(i);
+        ASSERT_TRUE(rfw.WriteMessage(msg));
+      }
+      rfw.Close();
+      ASSERT_TRUE(rfw.GetHeader().is_complete());
+      ASSERT_EQ(kMsgNum, rfw.GetHeader().message_number());
+    }
+
+    RecordFileReader rfr;
+    ASSERT_TRUE(rfr.Open(kTestFile3));
+    ASSERT_EQ(compress_type, rfr.GetHeader().compress());
+    Section sec;
+    int msg_num = 0;
+    while (rfr.ReadSection(&sec)) {
+      if (sec.type == SectionType::SECTION_INDEX) {
+        break;
+      }
+      if (sec.type != SectionType::SECTION_CHUNK_BODY) {
+        ASSERT_TRUE(rfr.SkipSection(sec.size));
+        continue;
+      }
+      ChunkBody ckb;
+      ASSERT_TRUE(rfr.ReadSection<ChunkBody>(sec.size, &ckb));
+      for (const auto& msg : ckb.messages()) {
+        EXPECT_EQ(content, msg.content());
+        ++msg_num;
+      }
+    }
+    EXPECT_EQ(kMsgNum, msg_num);
+
+    ASSERT_TRUE(rfr.ReadIndex());
+    uint64_t stored_size = 0;
+    uint64_t raw_size = 0;
+    for (const auto& row : rfr.GetIndex().indexes()) {
+      if (row.type() != SectionType::SECTION_CHUNK_BODY) {
+        continue;
+      }
+      uint64_t chunk_stored_size = 0;
+      uint64_t chunk_raw_size = 0;
+      ASSERT_TRUE(rfr.ReadChunkBodySize(row.position(), &chunk_stored_size,
+                                        &chunk_raw_size));
+      stored_size += chunk_stored_size;
+      raw_size += chunk_raw_size;
+    }
+    EXPECT_GT(raw_size, kMsgNum * content.size());
+    EXPECT_LT(stored_size, raw_size);
+    rfr.Close();
+    ASSERT_FALSE(remove(kTestFile3));
+  }
+}
+
+TEST(RecordFileTest, TestMmapBackend) {
+  const std::string content(1024, 'b');
+  for (auto compress_type : {proto::CompressType::COMPRESS_NONE,
+                             proto::CompressType::COMPRESS_LZ4}) {
+    {
+      RecordFileWriter rfw;
+      ASSERT_TRUE(rfw.Open(kTestFile3));
+      Header header = HeaderBuilder::GetHeaderWithChunkParams(0, 0);
+      header.set_compress(compress_type);
+      ASSERT_TRUE(rfw.WriteHeader(header));
+      Channel chan1;
+      chan1.set_name(kChan1);
+      chan1.set_message_type(kMsgType);
+      ASSERT_TRUE(rfw.WriteChannel(chan1));
+      for (int i = 1; i <= 10; ++i) {
+        SingleMessage msg;
+        msg.set_channel_name(kChan1);
+        msg.set_content(content);
+        msg.set_time(i);
+        ASSERT_TRUE(rfw.WriteMessage(msg));
+      }
+      rfw.Close();
+    }
+
+    std::vector<SingleMessageView> views;
+    {
+      RecordFileReader rfr(true);
+      ASSERT_TRUE(rfr.Open(kTestFile3));
+      ASSERT_TRUE(rfr.IsMapped());
+      ASSERT_TRUE(rfr.ReadIndex());
+      ASSERT_GT(rfr.GetIndex().indexes_size(), 0);
+      // a broken section size is rejected before it reaches the mapping
+      Channel broken;
+      EXPECT_FALSE(rfr.ReadSection<Channel>(-1, &broken));
+      Section sec;
+      while (rfr.ReadSection(&sec)) {
+        if (sec.type == SectionType::SECTION_CHANNEL) {
+          Channel chan;
+          ASSERT_TRUE(rfr.ReadSection<Channel>(sec.size, &chan));
+          EXPECT_EQ(kChan1, chan.name());
+        } else if (sec.type == SectionType::SECTION_CHUNK_BODY) {
+          ASSERT_TRUE(rfr.ReadChunkBodyView(sec.size, &views));
+        } else {
+          ASSERT_TRUE(rfr.SkipSection(sec.size));
+        }
+      }
+      EXPECT_TRUE(rfr.EndOfFile());
+    }
+    // views outlive the reader
+    ASSERT_EQ(10, views.size());
+    for (size_t i = 0; i < views.size(); ++i) {
+      EXPECT_EQ(kChan1, views[i].channel_name);
+      EXPECT_EQ(i + 1, views[i].time);
+      EXPECT_TRUE(views[i].content.IsZeroCopy());
+      std::string view_content;
+      views[i].content.SerializeToString(&view_content);
+      EXPECT_EQ(content, view_content);
+    }
+    ASSERT_FALSE(remove(kTestFile3));
+  }
+}
+
 }  // namespace record
 }  // namespace cyber
 }  // namespace apollo
@@ -18,7 +18,10 @@
 
 #include <fcntl.h>
 
+#include <algorithm>
+
 #include "cyber/common/file.h"
+#include "cyber/record/file/compression.h"
 #include "cyber/time/time.h"
 
 namespace apollo {
@@ -31,10 +34,23 @@ using apollo::cyber::proto::ChunkBody;
 using apollo::cyber::proto::ChunkBodyCache;
 using apollo::cyber::proto::ChunkHeader;
 using apollo::cyber::proto::ChunkHeaderCache;
+using apollo::cyber::proto::CompressType;
 using apollo::cyber::proto::Header;
 using apollo::cyber::proto::SectionType;
 using apollo::cyber::proto::SingleIndex;
 
+namespace {
+
+const size_t kMaxCompressingChunks = 8;
+const std::chrono::milliseconds kCompressPollInterval(20);
+
+size_t CompressThreadNum() {
+  size_t cpus = std::thread::hardware_concurrency();
+  return std::min<size_t>(std::max<size_t>(cpus / 2, 1), 4);
+}
+
+}  // namespace
+
 RecordFileWriter::RecordFileWriter() : is_writing_(false) {}
 
 RecordFileWriter::~RecordFileWriter() { Close(); }
@@ -100,6 +116,7 @@ void RecordFileWriter::Close() {
       flush_thread_->join();
       flush_thread_ = nullptr;
     }
+    compress_pool_.reset();
 
     if (!WriteIndex()) {
       AERROR << "Write index section failed, file: " << path_;
@@ -171,6 +188,34 @@ bool RecordFileWriter::WriteChannel(const Channel& channel) {
 bool RecordFileWriter::WriteChunk(const ChunkHeader& chunk_header,
                                   const ChunkBody& chunk_body) {
   std::lock_guard<std::mutex> lock(mutex_);
+  if (!WriteChunkHeader(chunk_header)) {
+    return false;
+  }
+  uint64_t pos = CurrentPosition();
+  if (!WriteSection<ChunkBody>(chunk_body)) {
+    AERROR << "Write chunk body fail";
+    return false;
+  }
+  AddChunkBodyIndex(chunk_header, pos);
+  return true;
+}
+
+bool RecordFileWriter::WriteChunk(const ChunkHeader& chunk_header,
+                                  const std::string& compressed_body) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!WriteChunkHeader(chunk_header)) {
+    return false;
+  }
+  uint64_t pos = CurrentPosition();
+  if (!WriteRawSection(SectionType::SECTION_CHUNK_BODY, compressed_body)) {
+    AERROR << "Write compressed chunk body fail";
+    return false;
+  }
+  AddChunkBodyIndex(chunk_header, pos);
+  return true;
+}
+
+bool RecordFileWriter::WriteChunkHeader(const ChunkHeader& chunk_header) {
   uint64_t pos = CurrentPosition();
   if (!WriteSection<ChunkHeader>(chunk_header)) {
     AERROR << "Write chunk header fail";
@@ -185,12 +230,11 @@ bool RecordFileWriter::WriteChunk(const ChunkHeader& chunk_header,
   chunk_header_cache->set_message_number(chunk_header.message_number());
   chunk_header_cache->set_raw_size(chunk_header.raw_size());
   single_index->set_allocated_chunk_header_cache(chunk_header_cache);
+  return true;
+}
 
-  pos = CurrentPosition();
-  if (!WriteSection<ChunkBody>(chunk_body)) {
-    AERROR << "Write chunk body fail";
-    return false;
-  }
+void RecordFileWriter::AddChunkBodyIndex(const ChunkHeader& chunk_header,
+                                         uint64_t position) {
   header_.set_chunk_number(header_.chunk_number() + 1);
   if (header_.begin_time() == 0) {
     header_.set_begin_time(chunk_header.begin_time());
@@ -198,12 +242,38 @@ bool RecordFileWriter::WriteChunk(const ChunkHeader& chunk_header,
   header_.set_end_time(chunk_header.end_time());
   header_.set_message_number(header_.message_number() +
                              chunk_header.message_number());
-  single_index = index_.add_indexes();
+  SingleIndex* single_index = index_.add_indexes();
   single_index->set_type(SectionType::SECTION_CHUNK_BODY);
-  single_index->set_position(pos);
+  single_index->set_position(position);
   ChunkBodyCache* chunk_body_cache = new ChunkBodyCache();
-  chunk_body_cache->set_message_number(chunk_body.messages_size());
+  chunk_body_cache->set_message_number(chunk_header.message_number());
   single_index->set_allocated_chunk_body_cache(chunk_body_cache);
+}
+
+bool RecordFileWriter::WriteRawSection(SectionType type,
+                                       const std::string& content) {
+  Section section;
+  /// zero out whole struct even if padded
+  memset(&section, 0, sizeof(section));
+  section = {type, static_cast<int64_t>(content.size())};
+  ssize_t count = write(fd_, &section, sizeof(section));
+  if (count != sizeof(section)) {
+    AERROR << "Write fd failed, fd: " << fd_ << ", errno: " << errno;
+    return false;
+  }
+  size_t written = 0;
+  while (written < content.size()) {
+    count = write(fd_, content.data() + written, content.size() - written);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      AERROR << "Write fd failed, fd: " << fd_ << ", errno: " << errno;
+      return false;
+    }
+    written += count;
+  }
+  header_.set_size(CurrentPosition());
   return true;
 }
 
@@ -240,20 +310,89 @@ bool RecordFileWriter::WriteMessage(const proto::SingleMessage& message) {
 void RecordFileWriter::Flush() {
   while (is_writing_) {
     std::unique_lock<std::mutex> flush_lock(flush_mutex_);
-    flush_cv_.wait(flush_lock,
-                   [this] { return !chunk_flush_->empty() || !is_writing_; });
+    auto ready = [this] { return !chunk_flush_->empty() || !is_writing_; };
+    if (compressing_chunks_.empty()) {
+      flush_cv_.wait(flush_lock, ready);
+    } else {
+      flush_cv_.wait_for(flush_lock, kCompressPollInterval, ready);
+    }
     if (!is_writing_) {
       break;
     }
     if (chunk_flush_->empty()) {
+      flush_lock.unlock();
+      WriteCompressedChunks(kMaxCompressingChunks);
       continue;
     }
-    in_writing_ = true;
-    if (!WriteChunk(chunk_flush_->header_, *(chunk_flush_->body_.get()))) {
-      AERROR << "Write chunk fail.";
+    auto compress_type = GetCompressType();
+    if (compress_type == CompressType::COMPRESS_NONE) {
+      in_writing_ = true;
+      if (!WriteChunk(chunk_flush_->header_, *(chunk_flush_->body_.get()))) {
+        AERROR << "Write chunk fail.";
+      }
+      in_writing_ = false;
+      chunk_flush_->clear();
+      continue;
     }
-    in_writing_ = false;
+    // hand the chunk over and let the recorder swap in the next one
+    auto chunk = std::make_shared<Chunk>();
+    chunk->body_.swap(chunk_flush_->body_);
+    chunk->header_ = chunk_flush_->header_;
     chunk_flush_->clear();
+    flush_lock.unlock();
+    CompressChunk(chunk, compress_type);
+    WriteCompressedChunks(kMaxCompressingChunks);
+  }
+  WriteCompressedChunks(0);
+}
+
+CompressType RecordFileWriter::GetCompressType() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return header_.compress();
+}
+
+void RecordFileWriter::CompressChunk(std::shared_ptr<Chunk> chunk,
+                                     CompressType compress_type) {
+  if (compress_pool_ == nullptr) {
+    compress_pool_.reset(new base::ThreadPool(CompressThreadNum()));
+  }
+  auto task = [chunk, compress_type]() {
+    auto compressed = std::make_shared<CompressedChunk>();
+    compressed->header = chunk->header_;
+    std::string raw;
+    if (!chunk->body_->SerializeToString(&raw)) {
+      AERROR << "Serialize chunk body fail.";
+      return compressed;
+    }
+    compressed->ok = Compress(compress_type, raw, &compressed->frame);
+    return compressed;
+  };
+  auto future = compress_pool_->Enqueue(task);
+  if (!future.valid()) {
+    AERROR << "Compress pool is stopped, chunk dropped.";
+    return;
+  }
+  compressing_chunks_.emplace_back(std::move(future));
+}
+
+void RecordFileWriter::WriteCompressedChunks(size_t max_pending) {
+  while (!compressing_chunks_.empty()) {
+    auto& future = compressing_chunks_.front();
+    if (compressing_chunks_.size() <= max_pending &&
+        future.wait_for(std::chrono::seconds(0)) !=
+            std::future_status::ready) {
+      break;
+    }
+    auto chunk = future.get();
+    compressing_chunks_.pop_front();
+    if (!chunk->ok) {
+      AERROR << "Compress chunk fail, " << chunk->header.message_number()
+             << " messages dropped.";
+      continue;
+    }
+    if (!WriteChunk(chunk->header, chunk->frame)) {
+      AERROR << "Write compressed chunk fail.";
+    }
   }
 }
 
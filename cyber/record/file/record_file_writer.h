@@ -18,7 +18,9 @@
 #define CYBER_RECORD_FILE_RECORD_FILE_WRITER_H_
 
 #include <condition_variable>
+#include <deque>
 #include <fstream>
+#include <future>
 #include <memory>
 #include <string>
 #include <thread>
@@ -30,6 +32,7 @@
 #include "google/protobuf/message.h"
 #include "google/protobuf/text_format.h"
 
+#include "cyber/base/thread_pool.h"
 #include "cyber/common/log.h"
 #include "cyber/record/file/record_file_base.h"
 #include "cyber/record/file/section.h"
@@ -74,6 +77,15 @@ struct Chunk {
   std::unique_ptr<proto::ChunkBody> body_ = nullptr;
 };
 
+/**
+ * @class RecordFileWriter
+ * @brief Writes chunks of messages into a record file.
+ *
+ * When the header asks for compression, the flush thread only hands the
+ * chunk over to a pool which serializes and compresses it, and writes the
+ * finished chunks back in order, so a slow compressor never stalls
+ * WriteMessage.
+ */
 class RecordFileWriter : public RecordFileBase {
  public:
   RecordFileWriter();
@@ -86,12 +98,31 @@ class RecordFileWriter : public RecordFileBase {
   uint64_t GetMessageNumber(const std::string& channel_name) const;
 
  private:
+  struct CompressedChunk {
+    proto::ChunkHeader header;
+    std::string frame;
+    bool ok = false;
+  };
+  using CompressedChunkPtr = std::shared_ptr<CompressedChunk>;
+
   bool WriteChunk(const proto::ChunkHeader& chunk_header,
                   const proto::ChunkBody& chunk_body);
+  bool WriteChunk(const proto::ChunkHeader& chunk_header,
+                  const std::string& compressed_body);
+  bool WriteChunkHeader(const proto::ChunkHeader& chunk_header);
+  void AddChunkBodyIndex(const proto::ChunkHeader& chunk_header,
+                         uint64_t position);
   template <typename T>
   bool WriteSection(const T& message);
+  bool WriteRawSection(proto::SectionType type, const std::string& content);
   bool WriteIndex();
   void Flush();
+  proto::CompressType GetCompressType();
+  void CompressChunk(std::shared_ptr<Chunk> chunk,
+                     proto::CompressType compress_type);
+  // writes compressed chunks in order, blocking while more than
+  // max_pending are still in the pool
+  void WriteCompressedChunks(size_t max_pending);
   std::atomic_bool is_writing_;
   std::atomic_bool in_writing_{false};
   std::unique_ptr<Chunk> chunk_active_ = nullptr;
@@ -100,6 +131,9 @@ class RecordFileWriter : public RecordFileBase {
   std::mutex flush_mutex_;
   std::condition_variable flush_cv_;
   std::unordered_map<std::string, uint64_t> channel_message_number_map_;
+  std::unique_ptr<base::ThreadPool> compress_pool_ = nullptr;
+  // only touched by the flush thread
+  std::deque<std::future<CompressedChunkPtr>> compressing_chunks_;
 };
 
 template <typename T>
@@ -16,6 +16,7 @@
 
 #include "cyber/record/record_reader.h"
 
+#include <algorithm>
 #include <utility>
 
 namespace apollo {
@@ -23,19 +24,18 @@ namespace cyber {
 namespace record {
 
 using apollo::cyber::proto::Channel;
-using apollo::cyber::proto::ChunkBody;
 using apollo::cyber::proto::ChunkHeader;
 using apollo::cyber::proto::SectionType;
 
-RecordReader::~RecordReader() {}
+RecordReader::~RecordReader() { StopPrefetch(); }
 
-RecordReader::RecordReader(const std::string& file) {
-  file_reader_.reset(new RecordFileReader());
+RecordReader::RecordReader(const std::string& file, bool use_mmap)
+    : use_mmap_(use_mmap) {
+  file_reader_.reset(new RecordFileReader(use_mmap));
   if (!file_reader_->Open(file)) {
     AERROR << "Failed to open record file: " << file;
     return;
   }
-  chunk_.reset(new ChunkBody());
   is_valid_ = true;
   header_ = file_reader_->GetHeader();
   if (file_reader_->ReadIndex()) {
@@ -53,15 +53,181 @@ RecordReader::RecordReader(const std::string& file) {
       channel_info_.insert(
           std::make_pair(channel_cache->name(), *channel_cache));
     }
+    BuildChunkIndex();
   }
   file_reader_->Reset();
 }
 
+void RecordReader::BuildChunkIndex() {
+  chunk_indexes_.clear();
+  for (const auto& single_idx : index_.indexes()) {
+    if (single_idx.type() == SectionType::SECTION_CHUNK_HEADER &&
+        single_idx.has_chunk_header_cache()) {
+      ChunkIndex chunk_index;
+      chunk_index.begin_time = single_idx.chunk_header_cache().begin_time();
+      chunk_index.end_time = single_idx.chunk_header_cache().end_time();
+      chunk_index.header_position = single_idx.position();
+      chunk_indexes_.emplace_back(chunk_index);
+    } else if (single_idx.type() == SectionType::SECTION_CHUNK_BODY &&
+               !chunk_indexes_.empty() &&
+               chunk_indexes_.back().body_position < 0) {
+      chunk_indexes_.back().body_position = single_idx.position();
+    }
+  }
+  if (!chunk_indexes_.empty() && chunk_indexes_.back().body_position < 0) {
+    chunk_indexes_.pop_back();
+  }
+  uint64_t max_end_time = 0;
+  for (auto& chunk_index : chunk_indexes_) {
+    max_end_time = std::max(max_end_time, chunk_index.end_time);
+    chunk_index.max_end_time = max_end_time;
+  }
+}
+
 void RecordReader::Reset() {
+  StopPrefetch();
+  prefetch_chunk_num_ = next_prefetch_chunk_num_;
+  read_started_ = false;
   file_reader_->Reset();
   reach_end_ = false;
   message_index_ = 0;
-  chunk_.reset(new ChunkBody());
+  chunk_.clear();
+  seek_chunk_ = 0;
+  seek_time_ = 0;
+}
+
+bool RecordReader::Seek(uint64_t time) {
+  if (!is_valid_) {
+    return false;
+  }
+  Reset();
+  if (chunk_indexes_.empty()) {
+    return true;
+  }
+  auto it = std::lower_bound(
+      chunk_indexes_.begin(), chunk_indexes_.end(), time,
+      [](const ChunkIndex& chunk_index, uint64_t t) {
+        return chunk_index.max_end_time < t;
+      });
+  seek_chunk_ = it - chunk_indexes_.begin();
+  seek_time_ = time;
+  if (it == chunk_indexes_.end()) {
+    reach_end_ = true;
+    return true;
+  }
+  if (!file_reader_->SetPosition(it->header_position)) {
+    AERROR << "Failed to seek to chunk #" << seek_chunk_
+           << ", file: " << file_reader_->GetPath();
+    return false;
+  }
+  return true;
+}
+
+void RecordReader::SetChannelFilter(const std::set<std::string>& channels) {
+  channels_ = channels;
+}
+
+void RecordReader::SetPrefetchChunkNum(uint32_t chunk_num) {
+  if (chunk_num > 0 && chunk_indexes_.empty() && is_valid_) {
+    AWARN << "No chunk index to prefetch with, file: "
+          << file_reader_->GetPath();
+  }
+  next_prefetch_chunk_num_ = chunk_num;
+  if (!read_started_) {
+    prefetch_chunk_num_ = chunk_num;
+  }
+}
+
+void RecordReader::StartPrefetch(size_t first_chunk, uint64_t end_time) {
+  prefetch_running_ = true;
+  prefetch_done_ = false;
+  prefetch_end_time_ = end_time;
+  prefetch_next_chunk_ = chunk_indexes_.size();
+  prefetch_thread_ = std::thread(&RecordReader::Prefetch, this, first_chunk,
+                                 seek_time_, end_time);
+}
+
+void RecordReader::StopPrefetch() {
+  {
+    // under the mutex, or the prefetch may miss the wakeup while it waits
+    // for room in a full queue
+    std::lock_guard<std::mutex> lock(prefetch_mutex_);
+    prefetch_running_ = false;
+  }
+  prefetch_cv_.notify_all();
+  if (prefetch_thread_.joinable()) {
+    prefetch_thread_.join();
+  }
+  prefetched_chunks_.clear();
+  prefetch_done_ = false;
+}
+
+void RecordReader::Prefetch(size_t first_chunk, uint64_t begin_time,
+                            uint64_t end_time) {
+  // a reader of its own, so the prefetch never moves the caller's position
+  RecordFileReader file_reader(use_mmap_);
+  bool ok = file_reader.Open(file_reader_->GetPath());
+  size_t next_chunk = chunk_indexes_.size();
+  for (size_t i = first_chunk; ok && i < chunk_indexes_.size(); ++i) {
+    const auto& chunk_index = chunk_indexes_[i];
+    if (chunk_index.begin_time > end_time) {
+      next_chunk = i;
+      break;
+    }
+    if (chunk_index.end_time < begin_time) {
+      continue;
+    }
+    std::vector<SingleMessageView> chunk;
+    Section section;
+    if (!file_reader.SetPosition(chunk_index.body_position) ||
+        !file_reader.ReadSection(&section) ||
+        section.type != SectionType::SECTION_CHUNK_BODY ||
+        !file_reader.ReadChunkBodyView(section.size, &chunk)) {
+      AERROR << "Failed to prefetch chunk #" << i
+             << ", file: " << file_reader.GetPath();
+      break;
+    }
+    std::unique_lock<std::mutex> lock(prefetch_mutex_);
+    prefetch_cv_.wait(lock, [this] {
+      return prefetched_chunks_.size() < prefetch_chunk_num_ ||
+             !prefetch_running_;
+    });
+    if (!prefetch_running_) {
+      break;
+    }
+    prefetched_chunks_.emplace_back(std::move(chunk));
+    prefetch_cv_.notify_all();
+  }
+  std::lock_guard<std::mutex> lock(prefetch_mutex_);
+  prefetch_next_chunk_ = next_chunk;
+  prefetch_done_ = true;
+  prefetch_cv_.notify_all();
+}
+
+bool RecordReader::PopPrefetchedChunk(uint64_t end_time) {
+  if (!prefetch_thread_.joinable()) {
+    StartPrefetch(seek_chunk_, end_time);
+  }
+  std::unique_lock<std::mutex> lock(prefetch_mutex_);
+  prefetch_cv_.wait(lock, [this] {
+    return !prefetched_chunks_.empty() || prefetch_done_;
+  });
+  if (prefetched_chunks_.empty()) {
+    size_t next_chunk = prefetch_next_chunk_;
+    if (end_time > prefetch_end_time_ && next_chunk < chunk_indexes_.size()) {
+      // stopped at an earlier end time, go on from where it stopped
+      lock.unlock();
+      StopPrefetch();
+      StartPrefetch(next_chunk, end_time);
+      return PopPrefetchedChunk(end_time);
+    }
+    reach_end_ = true;
+    return false;
+  }
+  chunk_ = std::move(prefetched_chunks_.front());
+  prefetched_chunks_.pop_front();
+  prefetch_cv_.notify_all();
+  return true;
 }
 
 std::set<std::string> RecordReader::GetChannelList() const {
@@ -74,42 +240,84 @@ std::set<std::string> RecordReader::GetChannelList() const {
 
 bool RecordReader::ReadMessage(RecordMessage* message, uint64_t begin_time,
                                uint64_t end_time) {
-  if (!is_valid_) {
+  return ReadMessage(message, begin_time, end_time, channels_);
+}
+
+bool RecordReader::ReadMessage(RecordMessage* message, uint64_t begin_time,
+                               uint64_t end_time,
+                               const std::set<std::string>& channels) {
+  auto next_message = NextMessage(begin_time, end_time, channels);
+  if (next_message == nullptr) {
     return false;
   }
+  message->channel_name = next_message->channel_name;
+  const auto& content = next_message->content;
+  message->content.assign(reinterpret_cast<const char*>(content.data()),
+                          content.size());
+  message->time = next_message->time;
+  return true;
+}
 
-  if (begin_time > header_.end_time() || end_time < header_.begin_time()) {
+bool RecordReader::ReadMessageView(SingleMessageView* message,
+                                   uint64_t begin_time, uint64_t end_time) {
+  return ReadMessageView(message, begin_time, end_time, channels_);
+}
+
+bool RecordReader::ReadMessageView(SingleMessageView* message,
+                                   uint64_t begin_time, uint64_t end_time,
+                                   const std::set<std::string>& channels) {
+  auto next_message = NextMessage(begin_time, end_time, channels);
+  if (next_message == nullptr) {
     return false;
   }
+  // every message of the chunk is read once, take it over
+  *message = std::move(*next_message);
+  return true;
+}
 
-  while (message_index_ < chunk_->messages_size()) {
-    const auto& next_message = chunk_->messages(message_index_);
-    uint64_t time = next_message.time();
-    if (time > end_time) {
-      return false;
-    }
-    ++message_index_;
-    if (time < begin_time) {
-      continue;
-    }
+SingleMessageView* RecordReader::NextMessage(
+    uint64_t begin_time, uint64_t end_time,
+    const std::set<std::string>& channels) {
+  if (!is_valid_) {
+    return nullptr;
+  }
 
-    message->channel_name = next_message.channel_name();
-    message->content = next_message.content();
-    message->time = time;
-    return true;
+  if (begin_time > header_.end_time() || end_time < header_.begin_time()) {
+    return nullptr;
   }
 
-  ADEBUG << "Read next chunk.";
-  if (ReadNextChunk(begin_time, end_time)) {
+  while (true) {
+    while (message_index_ < chunk_.size()) {
+      auto& next_message = chunk_[message_index_];
+      if (next_message.time > end_time) {
+        return nullptr;
+      }
+      ++message_index_;
+      if (next_message.time < begin_time) {
+        continue;
+      }
+      if (!channels.empty() &&
+          channels.count(next_message.channel_name) == 0) {
+        continue;
+      }
+      return &next_message;
+    }
+
+    ADEBUG << "Read next chunk.";
+    if (!ReadNextChunk(begin_time, end_time)) {
+      ADEBUG << "No chunk to read.";
+      return nullptr;
+    }
     ADEBUG << "Read chunk successfully.";
     message_index_ = 0;
-    return ReadMessage(message, begin_time, end_time);
   }
-  ADEBUG << "No chunk to read.";
-  return false;
 }
 
 bool RecordReader::ReadNextChunk(uint64_t begin_time, uint64_t end_time) {
+  read_started_ = true;
+  if (prefetch_chunk_num_ > 0 && !chunk_indexes_.empty()) {
+    return !reach_end_ && PopPrefetchedChunk(end_time);
+  }
   bool skip_next_chunk_body = false;
   while (!reach_end_) {
     Section section;
@@ -154,8 +362,8 @@ bool RecordReader::ReadNextChunk(uint64_t begin_time, uint64_t end_time) {
           break;
         }
 
-        chunk_.reset(new ChunkBody());
-        if (!file_reader_->ReadSection<ChunkBody>(section.size, chunk_.get())) {
+        chunk_.clear();
+        if (!file_reader_->ReadChunkBodyView(section.size, &chunk_)) {
           AERROR << "Failed to read chunk body section.";
           return false;
         }
@@ -17,11 +17,17 @@
 #ifndef CYBER_RECORD_RECORD_READER_H_
 #define CYBER_RECORD_RECORD_READER_H_
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "cyber/proto/record.pb.h"
 
@@ -45,8 +51,9 @@ class RecordReader : public RecordBase {
    * @brief The constructor with record file path as parameter.
    *
    * @param file
+   * @param use_mmap read the file through a read-only mapping
    */
-  explicit RecordReader(const std::string& file);
+  explicit RecordReader(const std::string& file, bool use_mmap = false);
 
   /**
    * @brief The destructor.
@@ -72,11 +79,86 @@ class RecordReader : public RecordBase {
   bool ReadMessage(RecordMessage* message, uint64_t begin_time = 0,
                    uint64_t end_time = std::numeric_limits<uint64_t>::max());
 
+  /**
+   * @brief Read one message of the given channels, empty for all, in place
+   * of the filter set by SetChannelFilter.
+   *
+   * @param message
+   * @param begin_time
+   * @param end_time
+   * @param channels
+   *
+   * @return True for success, false for not.
+   */
+  bool ReadMessage(RecordMessage* message, uint64_t begin_time,
+                   uint64_t end_time, const std::set<std::string>& channels);
+
+  /**
+   * @brief Read one message without copying its content. The view points
+   * into the mapping or into the buffer of its chunk and keeps it alive, so
+   * it stays valid after the reader moves on.
+   *
+   * @param message
+   * @param begin_time
+   * @param end_time
+   *
+   * @return True for success, false for not.
+   */
+  bool ReadMessageView(
+      SingleMessageView* message, uint64_t begin_time = 0,
+      uint64_t end_time = std::numeric_limits<uint64_t>::max());
+
+  /**
+   * @brief Read one message of the given channels, empty for all, without
+   * copying its content.
+   *
+   * @param message
+   * @param begin_time
+   * @param end_time
+   * @param channels
+   *
+   * @return True for success, false for not.
+   */
+  bool ReadMessageView(SingleMessageView* message, uint64_t begin_time,
+                       uint64_t end_time,
+                       const std::set<std::string>& channels);
+
   /**
    * @brief Reset the message index of record reader.
    */
   void Reset();
 
+  /**
+   * @brief Jump to the first chunk that may hold messages at or after the
+   * given time, found by a binary search over the chunk index.
+   *
+   * Records without an index fall back to Reset, after which ReadMessage
+   * skips earlier chunk bodies one by one.
+   *
+   * @param time
+   *
+   * @return True for success, false for not.
+   */
+  bool Seek(uint64_t time);
+
+  /**
+   * @brief Only return messages of the given channels, empty for all.
+   * Messages of other channels are dropped before their content is copied.
+   *
+   * @param channels
+   */
+  void SetChannelFilter(const std::set<std::string>& channels);
+
+  /**
+   * @brief Read and decode up to chunk_num chunks ahead of ReadMessage on a
+   * background thread, 0 to read on the caller thread. Needs the chunk index
+   * of a complete record. Once reading started, it takes effect from the
+   * next Seek or Reset, so the read in progress keeps its position.
+   *
+   * @param chunk_num
+   */
+  void SetPrefetchChunkNum(uint32_t chunk_num);
+
   /**
    * @brief Get message number by channel name.
    *
@@ -114,15 +196,54 @@ class RecordReader : public RecordBase {
   std::set<std::string> GetChannelList() const override;
 
  private:
+  struct ChunkIndex {
+    uint64_t begin_time = 0;
+    uint64_t end_time = 0;
+    // largest end time of this chunk and all chunks before it, which keeps
+    // the chunk list sorted for the seek even if chunks overlap in time
+    uint64_t max_end_time = 0;
+    int64_t header_position = -1;
+    int64_t body_position = -1;
+  };
+
+  void BuildChunkIndex();
+  SingleMessageView* NextMessage(uint64_t begin_time, uint64_t end_time,
+                                 const std::set<std::string>& channels);
   bool ReadNextChunk(uint64_t begin_time, uint64_t end_time);
+  bool PopPrefetchedChunk(uint64_t end_time);
+  void StartPrefetch(size_t first_chunk, uint64_t end_time);
+  void StopPrefetch();
+  void Prefetch(size_t first_chunk, uint64_t begin_time, uint64_t end_time);
 
   bool is_valid_ = false;
+  bool use_mmap_ = false;
   bool reach_end_ = false;
-  std::unique_ptr<proto::ChunkBody> chunk_ = nullptr;
+  // messages of the current chunk, parsed as views
+  std::vector<SingleMessageView> chunk_;
   proto::Index index_;
-  int message_index_ = 0;
+  size_t message_index_ = 0;
   ChannelInfoMap channel_info_;
   FileReaderPtr file_reader_;
+  std::set<std::string> channels_;
+
+  std::vector<ChunkIndex> chunk_indexes_;
+  // first chunk and time to read from after the last Seek or Reset
+  size_t seek_chunk_ = 0;
+  uint64_t seek_time_ = 0;
+
+  uint32_t prefetch_chunk_num_ = 0;
+  uint32_t next_prefetch_chunk_num_ = 0;
+  // a chunk was read since the last Seek or Reset
+  bool read_started_ = false;
+  std::thread prefetch_thread_;
+  std::atomic<bool> prefetch_running_ = {false};
+  std::mutex prefetch_mutex_;
+  std::condition_variable prefetch_cv_;
+  std::deque<std::vector<SingleMessageView>> prefetched_chunks_;
+  bool prefetch_done_ = false;
+  // the prefetch stops before the first chunk beginning after its end time
+  uint64_t prefetch_end_time_ = 0;
+  size_t prefetch_next_chunk_ = 0;
 };
 
 }  // namespace record
@@ -16,7 +16,9 @@
 
 #include "cyber/record/record_reader.h"
 
+#include <chrono>
 #include <string>
+#include <thread>
 
 #include "gtest/gtest.h"
 
@@ -29,6 +31,7 @@ namespace record {
 using apollo::cyber::message::RawMessage;
 
 constexpr char kChannelName1[] = "/test/channel1";
+constexpr char kChannelName2[] = "/test/channel2";
 constexpr char kMessageType1[] = "apollo.cyber.proto.Test";
 constexpr char kProtoDesc[] = "1234567890";
 constexpr char kStr10B[] = "1234567890";
@@ -122,6 +125,99 @@ TEST(RecordTest, TestReaderOrder) {
   ASSERT_FALSE(remove(kTestFile));
 }
 
+TEST(RecordTest, TestSeekAndPrefetch) {
+  const uint32_t msg_num = 200;
+  const uint64_t step_time = 100;
+  // a new chunk about every 10 messages
+  RecordWriter writer(HeaderBuilder::GetHeaderWithChunkParams(900, 0));
+  writer.SetSizeOfFileSegmentation(0);
+  writer.SetIntervalOfFileSegmentation(0);
+  writer.Open(kTestFile);
+  writer.WriteChannel(kChannelName1, kMessageType1, kProtoDesc);
+  writer.WriteChannel(kChannelName2, kMessageType1, kProtoDesc);
+  for (uint32_t i = 1; i <= msg_num; ++i) {
+    auto msg = std::make_shared<RawMessage>(std::to_string(i));
+    writer.WriteMessage(i % 2 ? kChannelName1 : kChannelName2, msg,
+                        i * step_time);
+    // give the flush thread time to write every chunk on its own
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+  writer.Close();
+
+  for (uint32_t prefetch_chunk_num : {0, 4}) {
+    RecordReader reader(kTestFile);
+    ASSERT_GT(reader.GetHeader().chunk_number(), 10);
+    reader.SetPrefetchChunkNum(prefetch_chunk_num);
+    RecordMessage message;
+
+    ASSERT_TRUE(reader.Seek(151 * step_time));
+    uint32_t count = 0;
+    while (reader.ReadMessage(&message, 151 * step_time)) {
+      EXPECT_GE(message.time, 151 * step_time);
+      ++count;
+    }
+    EXPECT_EQ(msg_num - 150, count);
+
+    reader.SetChannelFilter({kChannelName1});
+    ASSERT_TRUE(reader.Seek(0));
+    count = 0;
+    while (reader.ReadMessage(&message)) {
+      EXPECT_EQ(kChannelName1, message.channel_name);
+      ++count;
+    }
+    EXPECT_EQ(msg_num / 2, count);
+
+    ASSERT_TRUE(reader.Seek((msg_num + 1) * step_time));
+    EXPECT_FALSE(reader.ReadMessage(&message));
+
+    // a bounded read stops at its end time, a wider one goes on from there
+    reader.SetChannelFilter({});
+    ASSERT_TRUE(reader.Seek(0));
+    count = 0;
+    while (reader.ReadMessage(&message, 0, 50 * step_time)) {
+      EXPECT_LE(message.time, 50 * step_time);
+      ++count;
+    }
+    EXPECT_EQ(50, count);
+    while (reader.ReadMessage(&message)) {
+      ++count;
+    }
+    EXPECT_EQ(msg_num, count);
+
+    // switching the prefetch in the middle of a read keeps its position
+    ASSERT_TRUE(reader.Seek(0));
+    count = 0;
+    while (count < 50 && reader.ReadMessage(&message)) {
+      ++count;
+    }
+    reader.SetPrefetchChunkNum(prefetch_chunk_num > 0 ? 0 : 4);
+    while (reader.ReadMessage(&message)) {
+      ++count;
+    }
+    EXPECT_EQ(msg_num, count);
+    reader.SetPrefetchChunkNum(prefetch_chunk_num);
+
+    // a view keeps its chunk alive after the reader moved on
+    ASSERT_TRUE(reader.Seek(0));
+    SingleMessageView view;
+    ASSERT_TRUE(reader.ReadMessageView(&view));
+    ASSERT_TRUE(reader.Seek(100 * step_time));
+    ASSERT_TRUE(reader.ReadMessage(&message));
+    EXPECT_EQ(step_time, view.time);
+    std::string view_content;
+    view.content.SerializeToString(&view_content);
+    EXPECT_EQ("1", view_content);
+
+    // seeking away while the prefetch queue is full
+    for (int i = 0; i < 20; ++i) {
+      ASSERT_TRUE(reader.Seek(0));
+      ASSERT_TRUE(reader.ReadMessage(&message));
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  ASSERT_FALSE(remove(kTestFile));
+}
+
 }  // namespace record
 }  // namespace cyber
 }  // namespace apollo
@@ -64,8 +64,14 @@ bool RecordViewer::Update(RecordMessage* message) {
       break;
     }
     auto& msg = msg_buffer_.begin()->second;
-    if (channels_.empty() || channels_.count(msg->channel_name) == 1) {
-      *message = *msg;
+    if (channels_.empty() || channels_.count(msg.channel_name) == 1) {
+      // the buffered view is dropped right below, take its name over and
+      // copy the content out of the chunk
+      message->channel_name = std::move(msg.channel_name);
+      message->content.assign(
+          reinterpret_cast<const char*>(msg.content.data()),
+          msg.content.size());
+      message->time = msg.time;
       find = true;
     }
     msg_buffer_.erase(msg_buffer_.begin());
@@ -82,6 +88,12 @@ RecordViewer::Iterator RecordViewer::curr_itr() { return itr_; }
 
 void RecordViewer::set_curr_itr(const Iterator& curr_itr) { itr_ = curr_itr; }
 
+void RecordViewer::set_prefetch_chunk_num(uint32_t chunk_num) {
+  for (auto& reader : readers_) {
+    reader->SetPrefetchChunkNum(chunk_num);
+  }
+}
+
 void RecordViewer::Init() {
   // Init the channel list
   for (auto& reader : readers_) {
@@ -105,10 +117,22 @@ void RecordViewer::Init() {
 }
 
 void RecordViewer::Reset() {
-  for (auto& reader : readers_) {
-    reader->Reset();
+  for (size_t i = 0; i < readers_.size(); ++i) {
+    auto& reader = readers_[i];
+    reader->Seek(begin_time_);
+    // a record without any of the wanted channels is never read, the
+    // channel list comes from the index so a record without one is read
+    readers_finished_[i] = false;
+    if (!channels_.empty()) {
+      auto all_channel = reader->GetChannelList();
+      readers_finished_[i] =
+          !all_channel.empty() &&
+          std::none_of(all_channel.begin(), all_channel.end(),
+                       [this](const std::string& channel) {
+                         return channels_.count(channel) == 1;
+                       });
+    }
   }
-  std::fill(readers_finished_.begin(), readers_finished_.end(), false);
   curr_begin_time_ = begin_time_;
   msg_buffer_.clear();
 }
@@ -163,12 +187,13 @@ bool RecordViewer::FillBuffer() {
       }
       auto& reader = readers_[i];
       while (true) {
-        auto record_msg = std::make_shared<RecordMessage>();
-        if (!reader->ReadMessage(record_msg.get(), this_begin_time,
-                                 this_end_time)) {
+        SingleMessageView record_msg;
+        if (!reader->ReadMessageView(&record_msg, this_begin_time,
+                                     this_end_time, channels_)) {
           break;
         }
-        msg_buffer_.emplace(std::make_pair(record_msg->time, record_msg));
+        uint64_t time = record_msg.time;
+        msg_buffer_.emplace(time, std::move(record_msg));
       }
     }
 
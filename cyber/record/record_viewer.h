@@ -92,6 +92,15 @@ class RecordViewer {
    */
   std::set<std::string> GetChannelList() const { return channel_list_; }
 
+  /**
+   * @brief Let every reader read and decode up to chunk_num chunks ahead of
+   * the iterator on a thread of its own, 0 to read on the caller thread.
+   * Readers already read from switch at the next begin(), which seeks them.
+   *
+   * @param chunk_num
+   */
+  void set_prefetch_chunk_num(uint32_t chunk_num);
+
   /**
    * @brief The iterator.
    */
@@ -204,7 +213,8 @@ class RecordViewer {
   std::vector<bool> readers_finished_;
 
   uint64_t curr_begin_time_ = 0;
-  std::multimap<uint64_t, std::shared_ptr<RecordMessage>> msg_buffer_;
+  // views into the chunks, a content is only copied when it is handed out
+  std::multimap<uint64_t, SingleMessageView> msg_buffer_;
 
   const uint64_t kStepTimeNanoSec = 1000000000UL;  // 1 second
   const std::size_t kBufferMinSize = 128;
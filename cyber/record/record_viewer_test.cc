@@ -191,6 +191,8 @@ TEST(RecordTest, filter_test) {
   // filter with not exist channel
   RecordViewer viewer_6(reader, 0, end_time, {"null"});
   EXPECT_EQ(CheckCount(viewer_6), 0);
+  // which leaves the other viewers of the reader alone
+  EXPECT_EQ(CheckCount(viewer_0), msg_num);
 
   // filter with exist channel
   RecordViewer viewer_7(reader, 0, end_time, {kChannelName1});
@@ -224,6 +226,30 @@ TEST(RecordTest, mult_iterator_test) {
   ASSERT_FALSE(remove(kTestFile));
 }
 
+TEST(RecordTest, prefetch_test) {
+  uint64_t msg_num = 200;
+  uint64_t begin_time = 100000000;
+  uint64_t step_time = 100000000;  // 100ms
+  uint64_t end_time = begin_time + step_time * (msg_num - 1);
+  ConstructRecord(msg_num, begin_time, step_time);
+
+  auto reader = std::make_shared<RecordReader>(kTestFile);
+  RecordViewer viewer(reader, begin_time + 50 * step_time, end_time);
+  viewer.set_prefetch_chunk_num(2);
+
+  uint64_t i = 50;
+  for (auto& msg : viewer) {
+    EXPECT_EQ(kChannelName1, msg.channel_name);
+    EXPECT_EQ(begin_time + step_time * i, msg.time);
+    EXPECT_EQ(std::to_string(i), msg.content);
+    i++;
+  }
+  EXPECT_EQ(msg_num, i);
+  // a second pass seeks back and restarts the prefetch
+  EXPECT_EQ(CheckCount(viewer), msg_num - 50);
+  ASSERT_FALSE(remove(kTestFile));
+}
+
 }  // namespace record
 }  // namespace cyber
 }  // namespace apollo
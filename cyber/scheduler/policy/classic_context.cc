@@ -33,6 +33,60 @@ alignas(CACHELINE_SIZE) GRP_WQ_CV ClassicContext::cv_wq_;
 alignas(CACHELINE_SIZE) RQ_LOCK_GROUP ClassicContext::rq_locks_;
 alignas(CACHELINE_SIZE) CR_GROUP ClassicContext::cr_group_;
 alignas(CACHELINE_SIZE) NOTIFY_GRP ClassicContext::notify_grp_;
+alignas(CACHELINE_SIZE) READY_GRP ClassicContext::ready_grp_;
+
+namespace {
+
+bool PushReady(ReadyQueue* rq, const std::shared_ptr<CRoutine>& cr) {
+  auto prio = cr->priority();
+  if (!rq->queues[prio].Enqueue(cr)) {
+    // the group scan still finds it, just not on the fast path
+    ADEBUG << "ready queue of prio " << prio << " is full.";
+    cr->ClearQueued();
+    return false;
+  }
+  rq->bitmap.fetch_or(1u << prio, std::memory_order_release);
+  return true;
+}
+
+std::shared_ptr<CRoutine> PopReady(ReadyQueue* rq, uint32_t prio) {
+  const uint32_t bit = 1u << prio;
+  if (!(rq->bitmap.load(std::memory_order_acquire) & bit)) {
+    return nullptr;
+  }
+
+  auto& queue = rq->queues[prio];
+  std::shared_ptr<CRoutine> cr = nullptr;
+  while (true) {
+    while (queue.Dequeue(&cr)) {
+      // cleared first, so a notify from now on queues it again
+      cr->ClearQueued();
+      // a removed croutine is dropped here, its queued entries are the only
+      // references left in the ready queues
+      if (cr->IsStopped()) {
+        continue;
+      }
+      // a croutine running elsewhere is picked up by the group scan once
+      // it is released
+      if (!cr->Acquire()) {
+        continue;
+      }
+      if (cr->UpdateState() == RoutineState::READY) {
+        return cr;
+      }
+      cr->Release();
+    }
+    rq->bitmap.fetch_and(~bit, std::memory_order_acq_rel);
+    // recheck, a producer may have pushed before the bit was cleared
+    if (queue.Empty()) {
+      return nullptr;
+    }
+    rq->bitmap.fetch_or(bit, std::memory_order_acq_rel);
+  }
+  return nullptr;
+}
+
+}  // namespace
 
 ClassicContext::ClassicContext() { InitGroup(DEFAULT_GROUP_NAME); }
 
@@ -40,6 +94,14 @@ ClassicContext::ClassicContext(const std::string& group_name) {
   InitGroup(group_name);
 }
 
+ClassicContext::ClassicContext(const std::string& group_name,
+                               bool lock_free_rq) {
+  InitGroup(group_name);
+  if (lock_free_rq) {
+    InitReadyQueue(group_name);
+  }
+}
+
 void ClassicContext::InitGroup(const std::string& group_name) {
   multi_pri_rq_ = &cr_group_[group_name];
   lq_ = &rq_locks_[group_name];
@@ -49,11 +111,42 @@ void ClassicContext::InitGroup(const std::string& group_name) {
   current_grp = group_name;
 }
 
+void ClassicContext::InitReadyQueue(const std::string& group_name) {
+  auto rq = std::make_shared<ReadyQueue>();
+  for (auto& queue : rq->queues) {
+    queue.Init(READY_QUEUE_SIZE);
+  }
+
+  auto grp = &ready_grp_[group_name];
+  uint32_t index = grp->reserved.fetch_add(1);
+  if (index >= MAX_READY_GROUP_PROC) {
+    AWARN << "group " << group_name << " has more than "
+          << MAX_READY_GROUP_PROC << " processors, the rest scan only.";
+    return;
+  }
+  grp->rqs[index] = rq;
+  // publish slots in order so readers never see an empty one
+  while (grp->size.load(std::memory_order_acquire) != index) {
+    cpu_relax();
+  }
+  grp->size.store(index + 1, std::memory_order_release);
+
+  ready_grp_ptr_ = grp;
+  ready_index_ = index;
+}
+
 std::shared_ptr<CRoutine> ClassicContext::NextRoutine() {
   if (cyber_unlikely(stop_.load())) {
     return nullptr;
   }
 
+  if (ready_grp_ptr_ != nullptr) {
+    auto cr = NextReadyRoutine();
+    if (cr != nullptr) {
+      return cr;
+    }
+  }
+
   for (int i = MAX_PRIO - 1; i >= 0; --i) {
     ReadLockGuard<AtomicRWLock> lk(lq_->at(i));
     for (auto& cr : multi_pri_rq_->at(i)) {
@@ -72,6 +165,28 @@ std::shared_ptr<CRoutine> ClassicContext::NextRoutine() {
   return nullptr;
 }
 
+std::shared_ptr<CRoutine> ClassicContext::NextReadyRoutine() {
+  uint32_t size = ready_grp_ptr_->size.load(std::memory_order_acquire);
+  uint32_t ready = 0;
+  for (uint32_t i = 0; i < size; ++i) {
+    ready |= ready_grp_ptr_->rqs[i]->bitmap.load(std::memory_order_relaxed);
+  }
+
+  while (ready != 0) {
+    uint32_t prio = 31 - __builtin_clz(ready);
+    ready &= ~(1u << prio);
+    // own queue first, then steal from the other processors of the group
+    for (uint32_t i = 0; i < size; ++i) {
+      auto rq = ready_grp_ptr_->rqs[(ready_index_ + i) % size].get();
+      auto cr = PopReady(rq, prio);
+      if (cr != nullptr) {
+        return cr;
+      }
+    }
+  }
+  return nullptr;
+}
+
 void ClassicContext::Wait() {
   std::unique_lock<std::mutex> lk(mtx_wrapper_->Mutex());
   cw_->Cv().wait_for(lk, std::chrono::milliseconds(1000),
@@ -96,6 +211,36 @@ void ClassicContext::Notify(const std::string& group_name) {
   cv_wq_[group_name].Cv().notify_one();
 }
 
+bool ClassicContext::AddCRoutine(const std::shared_ptr<CRoutine>& cr) {
+  {
+    WriteLockGuard<AtomicRWLock> lk(
+        ClassicContext::rq_locks_[cr->group_name()].at(cr->priority()));
+    ClassicContext::cr_group_[cr->group_name()]
+        .at(cr->priority())
+        .emplace_back(cr);
+  }
+  Ready(cr);
+  return true;
+}
+
+void ClassicContext::Ready(const std::shared_ptr<CRoutine>& cr) {
+  auto it = ready_grp_.find(cr->group_name());
+  if (it == ready_grp_.end()) {
+    return;
+  }
+  auto& grp = it->second;
+  uint32_t size = grp.size.load(std::memory_order_acquire);
+  if (size == 0 || cr->IsStopped()) {
+    return;
+  }
+  // queued already, the pending entry covers this notify
+  if (!cr->SetQueued()) {
+    return;
+  }
+  // keep a croutine on the same processor while it is not stolen
+  PushReady(grp.rqs[cr->id() % size].get(), cr);
+}
+
 bool ClassicContext::RemoveCRoutine(const std::shared_ptr<CRoutine>& cr) {
   auto grp = cr->group_name();
   auto prio = cr->priority();
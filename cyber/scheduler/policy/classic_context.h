@@ -18,6 +18,7 @@
 #define CYBER_SCHEDULER_POLICY_CLASSIC_CONTEXT_H_
 
 #include <array>
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -26,6 +27,7 @@
 #include <vector>
 
 #include "cyber/base/atomic_rw_lock.h"
+#include "cyber/base/mpmc_queue.h"
 #include "cyber/croutine/croutine.h"
 #include "cyber/scheduler/common/cv_wrapper.h"
 #include "cyber/scheduler/common/mutex_wrapper.h"
@@ -36,6 +38,8 @@ namespace cyber {
 namespace scheduler {
 
 static constexpr uint32_t MAX_PRIO = 20;
+static constexpr uint32_t MAX_READY_GROUP_PROC = 128;
+static constexpr uint64_t READY_QUEUE_SIZE = 256;
 
 #define DEFAULT_GROUP_NAME "default_grp"
 
@@ -49,26 +53,51 @@ using GRP_WQ_MUTEX = std::unordered_map<std::string, MutexWrapper>;
 using GRP_WQ_CV = std::unordered_map<std::string, CvWrapper>;
 using NOTIFY_GRP = std::unordered_map<std::string, int>;
 
+// Croutines that were notified and may be ready, one lock-free queue per
+// priority and processor. The bitmap has bit i set while queue i may be
+// non-empty, so idle processors skip empty priorities without scanning.
+struct ReadyQueue {
+  std::array<base::MpmcQueue<std::shared_ptr<CRoutine>>, MAX_PRIO> queues;
+  alignas(CACHELINE_SIZE) std::atomic<uint32_t> bitmap = {0};
+};
+
+// Ready queues of all processors in a group, which steal from each other.
+struct ReadyQueueGroup {
+  std::array<std::shared_ptr<ReadyQueue>, MAX_READY_GROUP_PROC> rqs;
+  std::atomic<uint32_t> reserved = {0};
+  std::atomic<uint32_t> size = {0};
+};
+using READY_GRP = std::unordered_map<std::string, ReadyQueueGroup>;
+
 class ClassicContext : public ProcessorContext {
  public:
   ClassicContext();
   explicit ClassicContext(const std::string &group_name);
+  // lock_free_rq picks ready croutines from lock-free per-priority queues
+  // with work stealing, and only scans the group when they are empty
+  ClassicContext(const std::string &group_name, bool lock_free_rq);
 
   std::shared_ptr<CRoutine> NextRoutine() override;
   void Wait() override;
   void Shutdown() override;
 
   static void Notify(const std::string &group_name);
+  static bool AddCRoutine(const std::shared_ptr<CRoutine> &cr);
   static bool RemoveCRoutine(const std::shared_ptr<CRoutine> &cr);
+  // hand a notified croutine to the ready queues of its group, if any
+  static void Ready(const std::shared_ptr<CRoutine> &cr);
 
   alignas(CACHELINE_SIZE) static CR_GROUP cr_group_;
   alignas(CACHELINE_SIZE) static RQ_LOCK_GROUP rq_locks_;
   alignas(CACHELINE_SIZE) static GRP_WQ_CV cv_wq_;
   alignas(CACHELINE_SIZE) static GRP_WQ_MUTEX mtx_wq_;
   alignas(CACHELINE_SIZE) static NOTIFY_GRP notify_grp_;
+  alignas(CACHELINE_SIZE) static READY_GRP ready_grp_;
 
  private:
   void InitGroup(const std::string &group_name);
+  void InitReadyQueue(const std::string &group_name);
+  std::shared_ptr<CRoutine> NextReadyRoutine();
 
   std::chrono::steady_clock::time_point wake_time_;
   bool need_sleep_ = false;
@@ -78,6 +107,9 @@ class ClassicContext : public ProcessorContext {
   MutexWrapper *mtx_wrapper_ = nullptr;
   CvWrapper *cw_ = nullptr;
 
+  ReadyQueueGroup *ready_grp_ptr_ = nullptr;
+  uint32_t ready_index_ = 0;
+
   std::string current_grp;
 };
 
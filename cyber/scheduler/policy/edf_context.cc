@@ -0,0 +1,222 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/policy/edf_context.h"
+
+#include <chrono>
+#include <limits>
+#include <thread>
+
+#include "cyber/common/log.h"
+#include "cyber/common/types.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using apollo::cyber::croutine::RoutineState;
+
+uint64_t EdfRunQueue::NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void EdfRunQueue::AddCRoutine(const std::shared_ptr<CRoutine>& cr,
+                              uint64_t relative_deadline_ns) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Entry& entry = entries_[cr->id()];
+  entry.cr = cr;
+  entry.has_deadline = relative_deadline_ns > 0;
+  entry.relative_deadline_ns =
+      entry.has_deadline ? relative_deadline_ns : kDefaultDeadlineNs;
+  // a new croutine has to run once to reach its first wait
+  entry.queued_deadline_ns = NowNs() + entry.relative_deadline_ns;
+  ready_.emplace(entry.queued_deadline_ns, cr->id());
+}
+
+bool EdfRunQueue::RemoveCRoutine(uint64_t crid) {
+  std::shared_ptr<CRoutine> cr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(crid);
+    if (it == entries_.end()) {
+      return false;
+    }
+    cr = it->second.cr;
+    entries_.erase(it);
+  }
+  // ready_ entries of removed croutines are dropped by Pop
+  cr->Stop();
+  while (!cr->Acquire()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    AINFO_EVERY(1000) << "waiting for task " << cr->name() << " completion";
+  }
+  cr->Release();
+  return true;
+}
+
+bool EdfRunQueue::Ready(uint64_t crid, uint64_t arrival_ns) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(crid);
+    if (it == entries_.end()) {
+      return false;
+    }
+    Entry& entry = it->second;
+    if (entry.queued_deadline_ns == 0) {
+      entry.queued_deadline_ns = arrival_ns + entry.relative_deadline_ns;
+      ready_.emplace(entry.queued_deadline_ns, crid);
+    }
+  }
+  Notify();
+  return true;
+}
+
+std::shared_ptr<CRoutine> EdfRunQueue::Pop(uint64_t* deadline_ns) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto it = ready_.begin(); it != ready_.end();) {
+    auto entry_it = entries_.find(it->second);
+    if (entry_it == entries_.end() ||
+        entry_it->second.queued_deadline_ns != it->first) {
+      it = ready_.erase(it);
+      continue;
+    }
+    Entry& entry = entry_it->second;
+    // running on another processor, it stays due
+    if (!entry.cr->Acquire()) {
+      ++it;
+      continue;
+    }
+    auto state = entry.cr->UpdateState();
+    if (state == RoutineState::READY) {
+      *deadline_ns = it->first;
+      entry.queued_deadline_ns = 0;
+      ready_.erase(it);
+      return entry.cr;
+    }
+    entry.cr->Release();
+    if (state == RoutineState::SLEEP || state == RoutineState::IO_WAIT) {
+      ++it;
+      continue;
+    }
+    // nothing new arrived for it after all
+    entry.queued_deadline_ns = 0;
+    it = ready_.erase(it);
+  }
+
+  // croutines that became ready without a notify, e.g. after Sleep()
+  for (auto& ele : entries_) {
+    Entry& entry = ele.second;
+    if (entry.queued_deadline_ns != 0 || !entry.cr->Acquire()) {
+      continue;
+    }
+    if (entry.cr->UpdateState() == RoutineState::READY) {
+      *deadline_ns = NowNs() + entry.relative_deadline_ns;
+      return entry.cr;
+    }
+    entry.cr->Release();
+  }
+  return nullptr;
+}
+
+void EdfRunQueue::Finish(uint64_t crid, uint64_t deadline_ns,
+                         uint64_t finish_ns) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(crid);
+  if (it == entries_.end()) {
+    return;
+  }
+  Entry& entry = it->second;
+  ++entry.stats.runs;
+  if (entry.has_deadline && finish_ns > deadline_ns) {
+    ++entry.stats.misses;
+    entry.stats.last_lateness_ns = finish_ns - deadline_ns;
+    AWARN_EVERY(100) << "task " << entry.cr->name() << " missed its deadline"
+                     << " by " << entry.stats.last_lateness_ns / 1000
+                     << "us, misses: " << entry.stats.misses;
+  }
+  // it yielded to let others run and wants the processor back
+  if (entry.queued_deadline_ns == 0 &&
+      entry.cr->state() == RoutineState::READY) {
+    entry.queued_deadline_ns = finish_ns + entry.relative_deadline_ns;
+    ready_.emplace(entry.queued_deadline_ns, crid);
+  }
+}
+
+bool EdfRunQueue::GetStats(uint64_t crid, Stats* stats) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(crid);
+  if (it == entries_.end()) {
+    return false;
+  }
+  *stats = it->second.stats;
+  return true;
+}
+
+void EdfRunQueue::Notify() {
+  mtx_wq_.lock();
+  notify_++;
+  mtx_wq_.unlock();
+  cv_wq_.notify_one();
+}
+
+void EdfRunQueue::Wait() {
+  std::unique_lock<std::mutex> lk(mtx_wq_);
+  cv_wq_.wait_for(lk, std::chrono::milliseconds(1000),
+                  [&]() { return notify_ > 0; });
+  if (notify_ > 0 && !stop_) {
+    notify_--;
+  }
+}
+
+void EdfRunQueue::Shutdown() {
+  mtx_wq_.lock();
+  stop_ = true;
+  notify_ = std::numeric_limits<unsigned char>::max();
+  mtx_wq_.unlock();
+  cv_wq_.notify_all();
+}
+
+std::shared_ptr<CRoutine> EdfContext::NextRoutine() {
+  if (running_crid_ != 0) {
+    run_queue_->Finish(running_crid_, running_deadline_ns_,
+                       EdfRunQueue::NowNs());
+    running_crid_ = 0;
+  }
+  if (cyber_unlikely(stop_.load())) {
+    return nullptr;
+  }
+
+  uint64_t deadline_ns = 0;
+  auto cr = run_queue_->Pop(&deadline_ns);
+  if (cr != nullptr) {
+    running_crid_ = cr->id();
+    running_deadline_ns_ = deadline_ns;
+  }
+  return cr;
+}
+
+void EdfContext::Wait() { run_queue_->Wait(); }
+
+void EdfContext::Shutdown() {
+  stop_.store(true);
+  run_queue_->Shutdown();
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,118 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_SCHEDULER_POLICY_EDF_CONTEXT_H_
+#define CYBER_SCHEDULER_POLICY_EDF_CONTEXT_H_
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "cyber/croutine/croutine.h"
+#include "cyber/scheduler/processor_context.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using croutine::CRoutine;
+
+/**
+ * Run queue shared by all processors of SchedulerEdf. A croutine becomes
+ * due when data arrives for it, and its absolute deadline is the arrival
+ * time plus its relative deadline. Processors always take the earliest
+ * absolute deadline; croutines without a deadline of their own get
+ * kDefaultDeadlineNs so they run when nothing more urgent is ready.
+ */
+class EdfRunQueue {
+ public:
+  static const uint64_t kDefaultDeadlineNs = 1000000000ULL;
+
+  struct Stats {
+    uint64_t runs = 0;
+    uint64_t misses = 0;
+    // how late the latest miss finished
+    uint64_t last_lateness_ns = 0;
+  };
+
+  void AddCRoutine(const std::shared_ptr<CRoutine>& cr,
+                   uint64_t relative_deadline_ns);
+  bool RemoveCRoutine(uint64_t crid);
+
+  // data arrived for crid; keeps the earliest deadline when it is
+  // notified again before it ran
+  bool Ready(uint64_t crid, uint64_t arrival_ns);
+
+  // the earliest-deadline croutine that is ready, acquired for running
+  std::shared_ptr<CRoutine> Pop(uint64_t* deadline_ns);
+
+  // called once the croutine returned to its processor
+  void Finish(uint64_t crid, uint64_t deadline_ns, uint64_t finish_ns);
+
+  bool GetStats(uint64_t crid, Stats* stats);
+
+  void Notify();
+  void Wait();
+  void Shutdown();
+
+  // deadlines follow the steady clock, not the cyber clock of sim mode
+  static uint64_t NowNs();
+
+ private:
+  struct Entry {
+    std::shared_ptr<CRoutine> cr;
+    uint64_t relative_deadline_ns = 0;
+    // absolute deadline while queued, 0 otherwise
+    uint64_t queued_deadline_ns = 0;
+    bool has_deadline = false;
+    Stats stats;
+  };
+
+  std::mutex mutex_;
+  std::unordered_map<uint64_t, Entry> entries_;
+  // key: absolute deadline, value: crid
+  std::multimap<uint64_t, uint64_t> ready_;
+
+  std::mutex mtx_wq_;
+  std::condition_variable cv_wq_;
+  int notify_ = 0;
+  bool stop_ = false;
+};
+
+class EdfContext : public ProcessorContext {
+ public:
+  explicit EdfContext(const std::shared_ptr<EdfRunQueue>& run_queue)
+      : run_queue_(run_queue) {}
+
+  std::shared_ptr<CRoutine> NextRoutine() override;
+  void Wait() override;
+  void Shutdown() override;
+
+ private:
+  std::shared_ptr<EdfRunQueue> run_queue_;
+  // croutine handed out by the last NextRoutine, finished by now
+  uint64_t running_crid_ = 0;
+  uint64_t running_deadline_ns_ = 0;
+};
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_SCHEDULER_POLICY_EDF_CONTEXT_H_
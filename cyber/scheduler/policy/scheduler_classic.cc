@@ -38,7 +38,8 @@ using apollo::cyber::common::PathExists;
 using apollo::cyber::common::WorkRoot;
 using apollo::cyber::croutine::RoutineState;
 
-SchedulerClassic::SchedulerClassic() {
+SchedulerClassic::SchedulerClassic(bool lock_free_rq)
+    : lock_free_rq_(lock_free_rq) {
   std::string conf("conf/");
   conf.append(GlobalData::Instance()->ProcessGroup()).append(".conf");
   auto cfg_file = GetAbsolutePath(WorkRoot(), conf);
@@ -96,7 +97,7 @@ void SchedulerClassic::CreateProcessor() {
     ParseCpuset(group.cpuset(), &cpuset);
 
     for (uint32_t i = 0; i < proc_num; i++) {
-      auto ctx = std::make_shared<ClassicContext>(group_name);
+      auto ctx = std::make_shared<ClassicContext>(group_name, lock_free_rq_);
       pctxs_.emplace_back(ctx);
 
       auto proc = std::make_shared<Processor>();
@@ -148,13 +149,7 @@ bool SchedulerClassic::DispatchTask(const std::shared_ptr<CRoutine>& cr) {
   }
 
   // Enqueue task.
-  {
-    WriteLockGuard<AtomicRWLock> lk(
-        ClassicContext::rq_locks_[cr->group_name()].at(cr->priority()));
-    ClassicContext::cr_group_[cr->group_name()]
-        .at(cr->priority())
-        .emplace_back(cr);
-  }
+  ClassicContext::AddCRoutine(cr);
 
   ClassicContext::Notify(cr->group_name());
   return true;
@@ -174,6 +169,9 @@ bool SchedulerClassic::NotifyProcessor(uint64_t crid) {
         cr->SetUpdateFlag();
       }
 
+      if (lock_free_rq_) {
+        ClassicContext::Ready(cr);
+      }
       ClassicContext::Notify(cr->group_name());
       return true;
     }
@@ -42,7 +42,8 @@ class SchedulerClassic : public Scheduler {
 
  private:
   friend Scheduler* Instance();
-  SchedulerClassic();
+  // lock_free_rq: see ClassicContext, picked by the "classic_lockfree" policy
+  explicit SchedulerClassic(bool lock_free_rq = false);
 
   void CreateProcessor();
   bool NotifyProcessor(uint64_t crid) override;
@@ -50,6 +51,7 @@ class SchedulerClassic : public Scheduler {
   std::unordered_map<std::string, ClassicTask> cr_confs_;
 
   ClassicConf classic_conf_;
+  bool lock_free_rq_ = false;
 };
 
 }  // namespace scheduler
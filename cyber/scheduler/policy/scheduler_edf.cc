@@ -0,0 +1,203 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/policy/scheduler_edf.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cyber/common/environment.h"
+#include "cyber/common/file.h"
+#include "cyber/scheduler/processor.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using apollo::cyber::base::AtomicRWLock;
+using apollo::cyber::base::ReadLockGuard;
+using apollo::cyber::base::WriteLockGuard;
+using apollo::cyber::common::GetAbsolutePath;
+using apollo::cyber::common::GetProtoFromFile;
+using apollo::cyber::common::GlobalData;
+using apollo::cyber::common::PathExists;
+using apollo::cyber::common::WorkRoot;
+using apollo::cyber::croutine::RoutineState;
+
+SchedulerEdf::SchedulerEdf() : run_queue_(new EdfRunQueue()) {
+  std::string conf("conf/");
+  conf.append(GlobalData::Instance()->ProcessGroup()).append(".conf");
+  auto cfg_file = GetAbsolutePath(WorkRoot(), conf);
+
+  apollo::cyber::proto::CyberConfig cfg;
+  if (PathExists(cfg_file) && GetProtoFromFile(cfg_file, &cfg)) {
+    for (auto& thr : cfg.scheduler_conf().threads()) {
+      inner_thr_confs_[thr.name()] = thr;
+    }
+
+    if (cfg.scheduler_conf().has_process_level_cpuset()) {
+      process_level_cpuset_ = cfg.scheduler_conf().process_level_cpuset();
+      ProcessLevelResourceControl();
+    }
+
+    // deadlines replace per task priorities, so one group is enough
+    if (cfg.scheduler_conf().classic_conf().groups_size() > 0) {
+      sched_group_ = cfg.scheduler_conf().classic_conf().groups(0);
+    }
+  }
+
+  proc_num_ = sched_group_.processor_num();
+  if (proc_num_ == 0) {
+    auto& global_conf = GlobalData::Instance()->Config();
+    if (global_conf.has_scheduler_conf() &&
+        global_conf.scheduler_conf().has_default_proc_num()) {
+      proc_num_ = global_conf.scheduler_conf().default_proc_num();
+    } else {
+      proc_num_ = 2;
+    }
+  }
+  task_pool_size_ = proc_num_;
+
+  CreateProcessor();
+}
+
+void SchedulerEdf::CreateProcessor() {
+  std::vector<int> cpuset;
+  ParseCpuset(sched_group_.cpuset(), &cpuset);
+
+  for (uint32_t i = 0; i < proc_num_; i++) {
+    auto ctx = std::make_shared<EdfContext>(run_queue_);
+    pctxs_.emplace_back(ctx);
+
+    auto proc = std::make_shared<Processor>();
+    proc->BindContext(ctx);
+    SetSchedAffinity(proc->Thread(), cpuset, sched_group_.affinity(), i);
+    SetSchedPolicy(proc->Thread(), sched_group_.processor_policy(),
+                   sched_group_.processor_prio(), proc->Tid());
+    processors_.emplace_back(proc);
+  }
+}
+
+void SchedulerEdf::SetTaskDeadline(const std::string& name,
+                                   uint64_t deadline_us) {
+  std::lock_guard<std::mutex> lock(deadlines_mutex_);
+  deadlines_[name] = deadline_us * 1000;
+}
+
+uint64_t SchedulerEdf::DeadlineMisses(const std::string& name) {
+  EdfRunQueue::Stats stats;
+  if (!run_queue_->GetStats(GlobalData::GenerateHashId(name), &stats)) {
+    return 0;
+  }
+  return stats.misses;
+}
+
+bool SchedulerEdf::DispatchTask(const std::shared_ptr<CRoutine>& cr) {
+  // we use multi-key mutex to prevent race condition
+  // when del && add cr with same crid
+  MutexWrapper* wrapper = nullptr;
+  if (!id_map_mutex_.Get(cr->id(), &wrapper)) {
+    {
+      std::lock_guard<std::mutex> wl_lg(cr_wl_mtx_);
+      if (!id_map_mutex_.Get(cr->id(), &wrapper)) {
+        wrapper = new MutexWrapper();
+        id_map_mutex_.Set(cr->id(), wrapper);
+      }
+    }
+  }
+  std::lock_guard<std::mutex> lg(wrapper->Mutex());
+
+  {
+    WriteLockGuard<AtomicRWLock> lk(id_cr_lock_);
+    if (id_cr_.find(cr->id()) != id_cr_.end()) {
+      return false;
+    }
+    id_cr_[cr->id()] = cr;
+  }
+
+  uint64_t deadline_ns = 0;
+  {
+    std::lock_guard<std::mutex> lock(deadlines_mutex_);
+    auto it = deadlines_.find(cr->name());
+    if (it != deadlines_.end()) {
+      deadline_ns = it->second;
+    }
+  }
+  run_queue_->AddCRoutine(cr, deadline_ns);
+  run_queue_->Notify();
+  return true;
+}
+
+bool SchedulerEdf::RemoveTask(const std::string& name) {
+  if (cyber_unlikely(stop_)) {
+    return true;
+  }
+
+  auto crid = GlobalData::GenerateHashId(name);
+  return RemoveCRoutine(crid);
+}
+
+bool SchedulerEdf::RemoveCRoutine(uint64_t crid) {
+  // we use multi-key mutex to prevent race condition
+  // when del && add cr with same crid
+  MutexWrapper* wrapper = nullptr;
+  if (!id_map_mutex_.Get(crid, &wrapper)) {
+    {
+      std::lock_guard<std::mutex> wl_lg(cr_wl_mtx_);
+      if (!id_map_mutex_.Get(crid, &wrapper)) {
+        wrapper = new MutexWrapper();
+        id_map_mutex_.Set(crid, wrapper);
+      }
+    }
+  }
+  std::lock_guard<std::mutex> lg(wrapper->Mutex());
+
+  {
+    WriteLockGuard<AtomicRWLock> lk(id_cr_lock_);
+    if (id_cr_.find(crid) == id_cr_.end()) {
+      return false;
+    }
+    id_cr_.erase(crid);
+  }
+  return run_queue_->RemoveCRoutine(crid);
+}
+
+bool SchedulerEdf::NotifyProcessor(uint64_t crid) {
+  if (cyber_unlikely(stop_)) {
+    return true;
+  }
+
+  // the arrival time is taken before any lock, it starts the deadline
+  uint64_t arrival_ns = EdfRunQueue::NowNs();
+  {
+    ReadLockGuard<AtomicRWLock> lk(id_cr_lock_);
+    auto it = id_cr_.find(crid);
+    if (it == id_cr_.end()) {
+      return false;
+    }
+    auto& cr = it->second;
+    if (cr->state() == RoutineState::DATA_WAIT ||
+        cr->state() == RoutineState::IO_WAIT) {
+      cr->SetUpdateFlag();
+    }
+  }
+  return run_queue_->Ready(crid, arrival_ns);
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
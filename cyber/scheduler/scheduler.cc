@@ -33,6 +33,7 @@ namespace cyber {
 namespace scheduler {
 
 using apollo::cyber::common::GlobalData;
+using apollo::cyber::croutine::StackPool;
 
 bool Scheduler::CreateTask(const RoutineFactory& factory,
                            const std::string& name) {
@@ -49,7 +50,16 @@ bool Scheduler::CreateTask(std::function<void()>&& func,
 
   auto task_id = GlobalData::RegisterTaskName(name);
 
-  auto cr = std::make_shared<CRoutine>(func);
+  size_t stack_size = croutine::STACK_SIZE;
+  {
+    std::lock_guard<std::mutex> lg(stack_sizes_mtx_);
+    auto it = stack_sizes_.find(name);
+    if (it != stack_sizes_.end()) {
+      stack_size = it->second;
+    }
+  }
+
+  auto cr = std::make_shared<CRoutine>(func, stack_size);
   cr->set_id(task_id);
   cr->set_name(name);
   AINFO << "create croutine: " << name;
@@ -99,6 +109,11 @@ void Scheduler::SetInnerThreadAttr(const std::string& name, std::thread* thr) {
   }
 }
 
+void Scheduler::SetTaskStackSize(const std::string& name, size_t stack_size) {
+  std::lock_guard<std::mutex> lg(stack_sizes_mtx_);
+  stack_sizes_[name] = stack_size;
+}
+
 void Scheduler::CheckSchedStatus() {
   std::string snap_info;
   auto now = Time::Now().ToNanosecond();
@@ -122,6 +137,8 @@ void Scheduler::CheckSchedStatus() {
   snap_info.clear();
 }
 
+void Scheduler::CheckStackUsage() { StackPool::Instance()->LogUsage(); }
+
 void Scheduler::Shutdown() {
   if (cyber_unlikely(stop_.exchange(true))) {
     return;
@@ -142,6 +159,8 @@ void Scheduler::Shutdown() {
   for (auto& id : cr_list) {
     RemoveCRoutine(id);
   }
+  // peak usage of every croutine, to size their stacks from
+  CheckStackUsage();
 
   for (auto& processor : processors_) {
     processor->Stop();
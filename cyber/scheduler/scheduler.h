@@ -77,7 +77,16 @@ class Scheduler {
   virtual bool NotifyProcessor(uint64_t crid) = 0;
   virtual bool RemoveCRoutine(uint64_t crid) = 0;
 
+  // relative deadline of a task in microseconds, only deadline aware
+  // policies make use of it
+  virtual void SetTaskDeadline(const std::string& name,
+                               uint64_t deadline_us) {}
+
+  // stack size of the croutine the task gets once created, in bytes
+  void SetTaskStackSize(const std::string& name, size_t stack_size);
+
   void CheckSchedStatus();
+  void CheckStackUsage();
 
   void SetInnerThreadConfs(
       const std::unordered_map<std::string, InnerThread>& confs) {
@@ -97,6 +106,9 @@ class Scheduler {
 
   std::unordered_map<std::string, InnerThread> inner_thr_confs_;
 
+  std::mutex stack_sizes_mtx_;
+  std::unordered_map<std::string, size_t> stack_sizes_;
+
   std::string process_level_cpuset_;
   uint32_t proc_num_ = 0;
   uint32_t task_pool_size_ = 0;
@@ -0,0 +1,187 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cyber/croutine/croutine.h"
+#include "cyber/cyber.h"
+#include "cyber/scheduler/policy/classic_context.h"
+#include "cyber/scheduler/processor.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using apollo::cyber::croutine::CRoutine;
+
+namespace {
+
+const uint32_t kCRoutineNum = 256;
+const uint32_t kRoundNum = 50;
+
+uint64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+struct DispatchLatency {
+  uint64_t p50 = 0;
+  uint64_t p99 = 0;
+  uint64_t max = 0;
+  uint64_t samples = 0;
+};
+
+// Wake every croutine of a group at once, as a lidar frame does to the
+// components behind it, and measure notify-to-resume latency.
+DispatchLatency RunDispatch(uint32_t proc_num, bool lock_free_rq) {
+  std::string group_name = std::string("bench_") +
+                           (lock_free_rq ? "lockfree_" : "locked_") +
+                           std::to_string(proc_num);
+
+  std::vector<std::shared_ptr<Processor>> processors;
+  std::vector<std::shared_ptr<ClassicContext>> ctxs;
+  for (uint32_t i = 0; i < proc_num; ++i) {
+    auto ctx = std::make_shared<ClassicContext>(group_name, lock_free_rq);
+    auto proc = std::make_shared<Processor>();
+    proc->BindContext(ctx);
+    ctxs.emplace_back(ctx);
+    processors.emplace_back(proc);
+  }
+
+  std::atomic<bool> stop = {false};
+  std::atomic<uint32_t> started = {0};
+  std::atomic<uint64_t> resumed = {0};
+  std::vector<std::atomic<uint64_t>> notify_ts(kCRoutineNum);
+  std::vector<uint64_t> latencies(kCRoutineNum * kRoundNum, 0);
+
+  std::vector<std::shared_ptr<CRoutine>> crs;
+  for (uint32_t i = 0; i < kCRoutineNum; ++i) {
+    auto cr = std::make_shared<CRoutine>([&, i]() {
+      started++;
+      uint32_t round = 0;
+      while (true) {
+        CRoutine::GetCurrentRoutine()->HangUp();
+        if (stop.load()) {
+          break;
+        }
+        if (round < kRoundNum) {
+          latencies[round * kCRoutineNum + i] = NowNs() - notify_ts[i].load();
+          ++round;
+        }
+        resumed++;
+      }
+    });
+    cr->set_id(GlobalData::RegisterTaskName(group_name + std::to_string(i)));
+    cr->set_name(group_name + std::to_string(i));
+    cr->set_group_name(group_name);
+    cr->set_priority(i % MAX_PRIO);
+    ClassicContext::AddCRoutine(cr);
+    ClassicContext::Notify(group_name);
+    crs.emplace_back(cr);
+  }
+  while (started.load() < kCRoutineNum) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  auto wake = [&](const std::shared_ptr<CRoutine>& cr, uint32_t i) {
+    notify_ts[i].store(NowNs());
+    cr->SetUpdateFlag();
+    if (lock_free_rq) {
+      ClassicContext::Ready(cr);
+    }
+    ClassicContext::Notify(group_name);
+  };
+
+  for (uint32_t round = 0; round < kRoundNum; ++round) {
+    // croutines still hanging up from the last round are not ready yet
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    for (uint32_t i = 0; i < kCRoutineNum; ++i) {
+      wake(crs[i], i);
+    }
+    uint64_t expected = static_cast<uint64_t>(round + 1) * kCRoutineNum;
+    auto deadline = NowNs() + 5000000000ULL;
+    while (resumed.load() < expected && NowNs() < deadline) {
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+  }
+
+  stop.store(true);
+  for (uint32_t i = 0; i < kCRoutineNum; ++i) {
+    wake(crs[i], i);
+  }
+  for (auto& cr : crs) {
+    ClassicContext::RemoveCRoutine(cr);
+  }
+  for (auto& proc : processors) {
+    proc->Stop();
+  }
+
+  DispatchLatency result;
+  std::vector<uint64_t> samples;
+  for (auto latency : latencies) {
+    if (latency > 0) {
+      samples.emplace_back(latency);
+    }
+  }
+  if (samples.empty()) {
+    return result;
+  }
+  std::sort(samples.begin(), samples.end());
+  result.samples = samples.size();
+  result.p50 = samples[samples.size() / 2];
+  result.p99 = samples[samples.size() * 99 / 100];
+  result.max = samples.back();
+  return result;
+}
+
+}  // namespace
+
+TEST(SchedulerClassicBenchmarkTest, dispatch_latency) {
+  for (uint32_t proc_num : {1, 8, 32}) {
+    for (bool lock_free_rq : {false, true}) {
+      auto result = RunDispatch(proc_num, lock_free_rq);
+      std::cout << "processors: " << proc_num
+                << " run queue: " << (lock_free_rq ? "lockfree" : "locked")
+                << " samples: " << result.samples
+                << " p50(us): " << result.p50 / 1000
+                << " p99(us): " << result.p99 / 1000
+                << " max(us): " << result.max / 1000 << std::endl;
+      EXPECT_EQ(result.samples, kCRoutineNum * kRoundNum);
+    }
+  }
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  apollo::cyber::Init(argv[0]);
+  auto res = RUN_ALL_TESTS();
+  apollo::cyber::Clear();
+  return res;
+}
@@ -103,6 +103,38 @@ TEST(SchedulerClassicTest, sched_classic) {
   sched3->Shutdown();
 }
 
+TEST(SchedulerClassicTest, ready_queue) {
+  const std::string group_name = "ready_queue_grp";
+  auto ctx = std::make_shared<ClassicContext>(group_name, true);
+  auto cr = std::make_shared<CRoutine>(func);
+  cr->set_id(GlobalData::RegisterTaskName("ready_queue_cr"));
+  cr->set_name("ready_queue_cr");
+  cr->set_group_name(group_name);
+  cr->set_priority(1);
+  auto& queue = ClassicContext::ready_grp_[group_name].rqs[0]->queues[1];
+
+  // queued once however often it is notified before a processor pops it
+  EXPECT_TRUE(ClassicContext::AddCRoutine(cr));
+  FOR_EACH(i, 0, 10) { ClassicContext::Ready(cr); }
+  EXPECT_EQ(queue.Size(), 1);
+
+  // popped, so the next notify queues it again
+  EXPECT_EQ(ctx->NextRoutine(), cr);
+  cr->Release();
+  EXPECT_EQ(queue.Size(), 0);
+  ClassicContext::Ready(cr);
+  EXPECT_EQ(queue.Size(), 1);
+
+  // a removed croutine is not queued again, and its stale entry is dropped
+  // instead of run
+  EXPECT_TRUE(ClassicContext::RemoveCRoutine(cr));
+  ClassicContext::Ready(cr);
+  EXPECT_EQ(queue.Size(), 1);
+  EXPECT_EQ(ctx->NextRoutine(), nullptr);
+  EXPECT_EQ(queue.Size(), 0);
+  EXPECT_EQ(cr.use_count(), 1);
+}
+
 }  // namespace scheduler
 }  // namespace cyber
 }  // namespace apollo
@@ -0,0 +1,179 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cyber/common/global_data.h"
+#include "cyber/scheduler/policy/edf_context.h"
+#include "cyber/scheduler/processor.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using apollo::cyber::common::GlobalData;
+using apollo::cyber::croutine::RoutineState;
+
+namespace {
+
+std::shared_ptr<CRoutine> MakeCRoutine(const std::string& name,
+                                       const std::function<void()>& func) {
+  auto cr = std::make_shared<CRoutine>(func);
+  cr->set_id(GlobalData::RegisterTaskName(name));
+  cr->set_name(name);
+  return cr;
+}
+
+void WaitFor(const std::function<bool()>& cond) {
+  for (int i = 0; i < 5000 && !cond(); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+}  // namespace
+
+TEST(SchedulerEdfTest, earliest_deadline_first) {
+  auto run_queue = std::make_shared<EdfRunQueue>();
+  auto ctx = std::make_shared<EdfContext>(run_queue);
+  auto proc = std::make_shared<Processor>();
+  proc->BindContext(ctx);
+
+  std::mutex order_mutex;
+  std::vector<std::string> order;
+  std::atomic<uint32_t> started = {0};
+  std::vector<std::shared_ptr<CRoutine>> crs;
+  // name and relative deadline in us
+  std::vector<std::pair<std::string, uint64_t>> tasks = {
+      {"edf_100ms", 100000}, {"edf_10ms", 10000}, {"edf_50ms", 50000}};
+  for (auto& task : tasks) {
+    auto name = task.first;
+    auto cr = MakeCRoutine(name, [&, name]() {
+      started++;
+      while (true) {
+        CRoutine::GetCurrentRoutine()->HangUp();
+        std::lock_guard<std::mutex> lock(order_mutex);
+        order.emplace_back(name);
+      }
+    });
+    run_queue->AddCRoutine(cr, task.second * 1000);
+    crs.emplace_back(cr);
+  }
+  run_queue->Notify();
+  WaitFor([&]() { return started.load() == tasks.size(); });
+  ASSERT_EQ(tasks.size(), started.load());
+
+  // keep the only processor busy while all three become due together
+  std::atomic<bool> blocking = {false};
+  std::atomic<bool> release = {false};
+  auto blocker = MakeCRoutine("edf_blocker", [&]() {
+    while (true) {
+      CRoutine::GetCurrentRoutine()->HangUp();
+      blocking.store(true);
+      while (!release.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
+  });
+  run_queue->AddCRoutine(blocker, 0);
+  run_queue->Notify();
+  WaitFor([&]() { return blocker->state() == RoutineState::DATA_WAIT; });
+  blocker->SetUpdateFlag();
+  run_queue->Ready(blocker->id(), EdfRunQueue::NowNs());
+  WaitFor([&]() { return blocking.load(); });
+
+  uint64_t arrival = EdfRunQueue::NowNs();
+  for (auto& cr : crs) {
+    cr->SetUpdateFlag();
+    EXPECT_TRUE(run_queue->Ready(cr->id(), arrival));
+  }
+  release.store(true);
+  WaitFor([&]() {
+    std::lock_guard<std::mutex> lock(order_mutex);
+    return order.size() == tasks.size();
+  });
+
+  {
+    std::lock_guard<std::mutex> lock(order_mutex);
+    ASSERT_EQ(tasks.size(), order.size());
+    EXPECT_EQ("edf_10ms", order[0]);
+    EXPECT_EQ("edf_50ms", order[1]);
+    EXPECT_EQ("edf_100ms", order[2]);
+  }
+
+  EXPECT_TRUE(run_queue->RemoveCRoutine(blocker->id()));
+  EXPECT_FALSE(run_queue->RemoveCRoutine(blocker->id()));
+  for (auto& cr : crs) {
+    EXPECT_TRUE(run_queue->RemoveCRoutine(cr->id()));
+  }
+  proc->Stop();
+}
+
+TEST(SchedulerEdfTest, deadline_miss) {
+  auto run_queue = std::make_shared<EdfRunQueue>();
+  auto ctx = std::make_shared<EdfContext>(run_queue);
+  auto proc = std::make_shared<Processor>();
+  proc->BindContext(ctx);
+
+  std::atomic<uint32_t> runs = {0};
+  auto cr = MakeCRoutine("edf_miss", [&]() {
+    while (true) {
+      CRoutine::GetCurrentRoutine()->HangUp();
+      // takes longer than its 1ms deadline
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      runs++;
+    }
+  });
+  run_queue->AddCRoutine(cr, 1000000);
+  run_queue->Notify();
+  WaitFor([&]() { return cr->state() == RoutineState::DATA_WAIT; });
+
+  for (uint32_t i = 1; i <= 3; ++i) {
+    cr->SetUpdateFlag();
+    run_queue->Ready(cr->id(), EdfRunQueue::NowNs());
+    WaitFor([&]() {
+      return runs.load() == i && cr->state() == RoutineState::DATA_WAIT;
+    });
+  }
+  EXPECT_EQ(3, runs.load());
+
+  // Finish of the last run is seen by the next NextRoutine
+  run_queue->Notify();
+  WaitFor([&]() {
+    EdfRunQueue::Stats stats;
+    return run_queue->GetStats(cr->id(), &stats) && stats.misses == 3;
+  });
+  EdfRunQueue::Stats stats;
+  EXPECT_TRUE(run_queue->GetStats(cr->id(), &stats));
+  EXPECT_EQ(3, stats.misses);
+  EXPECT_GE(stats.runs, 4);
+  EXPECT_GT(stats.last_lateness_ns, 0);
+
+  EXPECT_TRUE(run_queue->RemoveCRoutine(cr->id()));
+  proc->Stop();
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
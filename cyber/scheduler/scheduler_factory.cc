@@ -29,6 +29,7 @@
 #include "cyber/common/util.h"
 #include "cyber/scheduler/policy/scheduler_choreography.h"
 #include "cyber/scheduler/policy/scheduler_classic.h"
+#include "cyber/scheduler/policy/scheduler_edf.h"
 #include "cyber/scheduler/scheduler.h"
 
 namespace apollo {
@@ -65,8 +66,12 @@ Scheduler* Instance() {
       }
       if (!policy.compare("classic")) {
         obj = new SchedulerClassic();
+      } else if (!policy.compare("classic_lockfree")) {
+        obj = new SchedulerClassic(true);
       } else if (!policy.compare("choreography")) {
         obj = new SchedulerChoreography();
+      } else if (!policy.compare("edf")) {
+        obj = new SchedulerEdf();
       } else {
         AWARN << "Invalid scheduler policy: " << policy;
         obj = new SchedulerClassic();
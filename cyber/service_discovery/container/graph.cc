@@ -95,6 +95,7 @@ Graph::Graph() {}
 Graph::~Graph() {
   edges_.clear();
   list_.clear();
+  reachable_.clear();
 }
 
 void Graph::Insert(const Edge& e) {
@@ -150,10 +151,11 @@ FlowDirection Graph::GetDirectionOf(const Vertice& lhs, const Vertice& rhs) {
   if (list_.count(lhs.GetKey()) == 0 || list_.count(rhs.GetKey()) == 0) {
     return UNREACHABLE;
   }
-  if (LevelTraverse(lhs, rhs)) {
+  std::lock_guard<std::mutex> cache_lock(cache_mutex_);
+  if (GetReachable(lhs.GetKey()).count(rhs.GetKey()) > 0) {
     return UPSTREAM;
   }
-  if (LevelTraverse(rhs, lhs)) {
+  if (GetReachable(rhs.GetKey()).count(lhs.GetKey()) > 0) {
     return DOWNSTREAM;
   }
   return UNREACHABLE;
@@ -208,7 +210,26 @@ void Graph::InsertCompleteEdge(const Edge& e) {
   if (list_.find(dst_v_k) == list_.end()) {
     list_[dst_v_k] = VerticeSet();
   }
-  list_[src_v_k][e.GetKey()] = e.dst();
+  auto& dst_v_set = list_[src_v_k];
+  if (dst_v_set.find(e.GetKey()) != dst_v_set.end()) {
+    return;
+  }
+  dst_v_set[e.GetKey()] = e.dst();
+
+  // whatever reached src now also reaches all that dst reaches
+  ReachableSet from_dst;
+  bool from_dst_ready = false;
+  for (auto& item : reachable_) {
+    auto& reachable = item.second;
+    if (reachable.count(src_v_k) == 0 || reachable.count(dst_v_k) > 0) {
+      continue;
+    }
+    if (!from_dst_ready) {
+      LevelTraverse(dst_v_k, &from_dst);
+      from_dst_ready = true;
+    }
+    reachable.insert(from_dst.begin(), from_dst.end());
+  }
 }
 
 void Graph::DeleteOutgoingEdge(const Edge& e) {
@@ -253,29 +274,49 @@ void Graph::DeleteIncomingEdge(const Edge& e) {
 
 void Graph::DeleteCompleteEdge(const Edge& e) {
   auto& src_v_k = e.src().GetKey();
-  list_[src_v_k].erase(e.GetKey());
+  if (list_[src_v_k].erase(e.GetKey()) == 0) {
+    return;
+  }
+
+  // only what reached src may have lost vertices, traverse those again
+  // when they are inquired next time
+  for (auto it = reachable_.begin(); it != reachable_.end();) {
+    if (it->second.count(src_v_k) > 0) {
+      it = reachable_.erase(it);
+    } else {
+      ++it;
+    }
+  }
 }
 
-bool Graph::LevelTraverse(const Vertice& start, const Vertice& end) {
-  std::unordered_map<std::string, bool> visited;
-  visited[end.GetKey()] = false;
-  std::queue<Vertice> unvisited;
+void Graph::LevelTraverse(const std::string& start,
+                          ReachableSet* reachable) {
+  std::queue<std::string> unvisited;
   unvisited.emplace(start);
+  reachable->emplace(start);
   while (!unvisited.empty()) {
     auto curr = unvisited.front();
     unvisited.pop();
-    if (visited[curr.GetKey()]) {
+    auto search = list_.find(curr);
+    if (search == list_.end()) {
       continue;
     }
-    visited[curr.GetKey()] = true;
-    if (curr == end) {
-      break;
-    }
-    for (auto& item : list_[curr.GetKey()]) {
-      unvisited.push(item.second);
+    for (auto& item : search->second) {
+      if (reachable->emplace(item.second.GetKey()).second) {
+        unvisited.push(item.second.GetKey());
+      }
     }
   }
-  return visited[end.GetKey()];
+}
+
+const Graph::ReachableSet& Graph::GetReachable(const std::string& start) {
+  auto search = reachable_.find(start);
+  if (search != reachable_.end()) {
+    return search->second;
+  }
+  auto& reachable = reachable_[start];
+  LevelTraverse(start, &reachable);
+  return reachable;
 }
 
 }  // namespace service_discovery
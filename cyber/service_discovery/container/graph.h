@@ -18,8 +18,10 @@
 #define CYBER_SERVICE_DISCOVERY_CONTAINER_GRAPH_H_
 
 #include <cstdint>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "cyber/base/atomic_rw_lock.h"
 
@@ -112,6 +114,7 @@ class Graph {
     VerticeSet dst;
   };
   using EdgeInfo = std::unordered_map<std::string, RelatedVertices>;
+  using ReachableSet = std::unordered_set<std::string>;
 
   void InsertOutgoingEdge(const Edge& e);
   void InsertIncomingEdge(const Edge& e);
@@ -119,11 +122,19 @@ class Graph {
   void DeleteOutgoingEdge(const Edge& e);
   void DeleteIncomingEdge(const Edge& e);
   void DeleteCompleteEdge(const Edge& e);
-  bool LevelTraverse(const Vertice& start, const Vertice& end);
+  void LevelTraverse(const std::string& start, ReachableSet* reachable);
+  const ReachableSet& GetReachable(const std::string& start);
 
   EdgeInfo edges_;
   AdjacencyList list_;
   base::AtomicRWLock rw_lock_;
+
+  // vertices reachable from the key, itself included. Filled on demand by
+  // GetDirectionOf and kept up to date as complete edges come and go,
+  // instead of traversing the graph for every inquiry. Readers share
+  // rw_lock_, so they fill it under cache_mutex_
+  std::unordered_map<std::string, ReachableSet> reachable_;
+  std::mutex cache_mutex_;
 };
 
 }  // namespace service_discovery
@@ -205,6 +205,47 @@ TEST(GraphTest, graph) {
   g.Delete(qa);
 }
 
+TEST(GraphTest, incremental_reachability) {
+  Graph g;
+  Vertice a("a");
+  Vertice b("b");
+  Vertice c("c");
+  Vertice d("d");
+
+  // a -> b, c -> d
+  g.Insert(Edge(a, Vertice(), "ab"));
+  g.Insert(Edge(Vertice(), b, "ab"));
+  g.Insert(Edge(c, d, "cd"));
+  EXPECT_EQ(g.GetDirectionOf(a, b), UPSTREAM);
+  EXPECT_EQ(g.GetDirectionOf(a, d), UNREACHABLE);
+  EXPECT_EQ(g.GetDirectionOf(d, a), UNREACHABLE);
+
+  // the cached reachability of a grows with the new edge b -> c
+  Edge bc(b, c, "bc");
+  g.Insert(bc);
+  EXPECT_EQ(g.GetDirectionOf(a, d), UPSTREAM);
+  EXPECT_EQ(g.GetDirectionOf(d, a), DOWNSTREAM);
+  EXPECT_EQ(g.GetDirectionOf(b, d), UPSTREAM);
+
+  // a second channel between the same nodes
+  Edge bc2(b, c, "bc2");
+  g.Insert(bc2);
+  g.Delete(bc);
+  EXPECT_EQ(g.GetDirectionOf(a, d), UPSTREAM);
+  g.Delete(bc2);
+  EXPECT_EQ(g.GetDirectionOf(a, d), UNREACHABLE);
+  EXPECT_EQ(g.GetDirectionOf(a, b), UPSTREAM);
+  EXPECT_EQ(g.GetDirectionOf(c, d), UPSTREAM);
+
+  // a cycle
+  Edge da(d, a, "da");
+  g.Insert(da);
+  EXPECT_EQ(g.GetDirectionOf(c, b), UPSTREAM);
+  EXPECT_EQ(g.GetDirectionOf(b, c), DOWNSTREAM);
+  g.Delete(da);
+  EXPECT_EQ(g.GetDirectionOf(c, b), UNREACHABLE);
+}
+
 }  // namespace service_discovery
 }  // namespace cyber
 }  // namespace apollo
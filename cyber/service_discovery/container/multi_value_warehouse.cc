@@ -17,6 +17,7 @@
 #include "cyber/service_discovery/container/multi_value_warehouse.h"
 
 #include <algorithm>
+#include <string>
 #include <utility>
 
 #include "cyber/common/log.h"
@@ -40,12 +41,14 @@ bool MultiValueWarehouse::Add(uint64_t key, const RolePtr& role,
   }
   std::pair<uint64_t, RolePtr> role_pair(key, role);
   roles_.insert(role_pair);
+  AddToIndex(key, role);
   return true;
 }
 
 void MultiValueWarehouse::Clear() {
   WriteLockGuard<AtomicRWLock> lock(rw_lock_);
   roles_.clear();
+  process_roles_.clear();
 }
 
 std::size_t MultiValueWarehouse::Size() {
@@ -55,6 +58,10 @@ std::size_t MultiValueWarehouse::Size() {
 
 void MultiValueWarehouse::Remove(uint64_t key) {
   WriteLockGuard<AtomicRWLock> lock(rw_lock_);
+  auto range = roles_.equal_range(key);
+  for (auto it = range.first; it != range.second; ++it) {
+    RemoveFromIndex(key, it->second);
+  }
   roles_.erase(key);
 }
 
@@ -63,6 +70,7 @@ void MultiValueWarehouse::Remove(uint64_t key, const RolePtr& role) {
   auto range = roles_.equal_range(key);
   for (auto it = range.first; it != range.second;) {
     if (it->second->Match(role->attributes())) {
+      RemoveFromIndex(key, it->second);
       it = roles_.erase(it);
     } else {
       ++it;
@@ -72,12 +80,20 @@ void MultiValueWarehouse::Remove(uint64_t key, const RolePtr& role) {
 
 void MultiValueWarehouse::Remove(const RoleAttributes& target_attr) {
   WriteLockGuard<AtomicRWLock> lock(rw_lock_);
-  for (auto it = roles_.begin(); it != roles_.end();) {
-    auto curr_role = it->second;
-    if (curr_role->Match(target_attr)) {
-      it = roles_.erase(it);
-    } else {
-      ++it;
+  std::vector<std::pair<uint64_t, RolePtr>> matched;
+  for (auto& item : GetCandidates(target_attr)) {
+    if (item.second->Match(target_attr)) {
+      matched.emplace_back(item);
+    }
+  }
+  for (auto& item : matched) {
+    RemoveFromIndex(item.first, item.second);
+    auto range = roles_.equal_range(item.first);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == item.second) {
+        roles_.erase(it);
+        break;
+      }
     }
   }
 }
@@ -146,7 +162,7 @@ bool MultiValueWarehouse::Search(const RoleAttributes& target_attr,
                                  RolePtr* first_matched_role) {
   RETURN_VAL_IF_NULL(first_matched_role, false);
   ReadLockGuard<AtomicRWLock> lock(rw_lock_);
-  for (auto& item : roles_) {
+  for (auto& item : GetCandidates(target_attr)) {
     if (item.second->Match(target_attr)) {
       *first_matched_role = item.second;
       return true;
@@ -171,7 +187,7 @@ bool MultiValueWarehouse::Search(const RoleAttributes& target_attr,
   RETURN_VAL_IF_NULL(matched_roles, false);
   bool find = false;
   ReadLockGuard<AtomicRWLock> lock(rw_lock_);
-  for (auto& item : roles_) {
+  for (auto& item : GetCandidates(target_attr)) {
     if (item.second->Match(target_attr)) {
       matched_roles->emplace_back(item.second);
       find = true;
@@ -186,7 +202,7 @@ bool MultiValueWarehouse::Search(
   RETURN_VAL_IF_NULL(matched_roles_attr, false);
   bool find = false;
   ReadLockGuard<AtomicRWLock> lock(rw_lock_);
-  for (auto& item : roles_) {
+  for (auto& item : GetCandidates(target_attr)) {
     if (item.second->Match(target_attr)) {
       matched_roles_attr->emplace_back(item.second->attributes());
       find = true;
@@ -211,6 +227,49 @@ void MultiValueWarehouse::GetAllRoles(std::vector<RoleAttributes>* roles_attr) {
   }
 }
 
+void MultiValueWarehouse::AddToIndex(uint64_t key, const RolePtr& role) {
+  std::string process_key;
+  if (GetProcessKey(role->attributes(), &process_key)) {
+    process_roles_[process_key].emplace(key, role);
+  }
+}
+
+void MultiValueWarehouse::RemoveFromIndex(uint64_t key, const RolePtr& role) {
+  std::string process_key;
+  if (!GetProcessKey(role->attributes(), &process_key)) {
+    return;
+  }
+  auto search = process_roles_.find(process_key);
+  if (search == process_roles_.end()) {
+    return;
+  }
+  auto& roles = search->second;
+  auto range = roles.equal_range(key);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second == role) {
+      roles.erase(it);
+      break;
+    }
+  }
+  if (roles.empty()) {
+    process_roles_.erase(search);
+  }
+}
+
+const MultiValueWarehouse::RoleMap& MultiValueWarehouse::GetCandidates(
+    const RoleAttributes& target_attr) {
+  static const RoleMap empty;
+  std::string process_key;
+  if (!GetProcessKey(target_attr, &process_key)) {
+    return roles_;
+  }
+  auto search = process_roles_.find(process_key);
+  if (search == process_roles_.end()) {
+    return empty;
+  }
+  return search->second;
+}
+
 }  // namespace service_discovery
 }  // namespace cyber
 }  // namespace apollo
@@ -18,6 +18,7 @@
 #define CYBER_SERVICE_DISCOVERY_CONTAINER_MULTI_VALUE_WAREHOUSE_H_
 
 #include <cstdint>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -67,7 +68,14 @@ class MultiValueWarehouse : public WarehouseBase {
   void GetAllRoles(std::vector<proto::RoleAttributes>* roles_attr) override;
 
  private:
+  // callers hold rw_lock_
+  void AddToIndex(uint64_t key, const RolePtr& role);
+  void RemoveFromIndex(uint64_t key, const RolePtr& role);
+  const RoleMap& GetCandidates(const proto::RoleAttributes& target_attr);
+
   RoleMap roles_;
+  // key: host_name+process_id
+  std::unordered_map<std::string, RoleMap> process_roles_;
   base::AtomicRWLock rw_lock_;
 };
 
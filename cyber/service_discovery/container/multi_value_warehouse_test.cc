@@ -18,6 +18,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 #include "gtest/gtest.h"
 
 namespace apollo {
@@ -232,6 +233,56 @@ TEST(MultiValueWarehouseTest, test1) {
   }
 }
 
+TEST(MultiValueWarehouseTest, process_index) {
+  MultiValueWarehouse wh;
+  std::vector<RolePtr> roles;
+  for (int i = 0; i < 5; ++i) {
+    RoleAttributes attr;
+    attr.set_host_name("caros");
+    attr.set_process_id(i < 3 ? 1 : 2);
+    attr.set_node_id(i);
+    roles.emplace_back(std::make_shared<RoleBase>(attr, 54321));
+    EXPECT_TRUE(wh.Add(i, roles.back()));
+  }
+
+  // a role added again under the same key
+  wh.Add(2, roles[2]);
+  EXPECT_EQ(wh.Size(), 6);
+
+  RoleAttributes target;
+  target.set_host_name("caros");
+  target.set_process_id(1);
+  std::vector<RolePtr> matched;
+  EXPECT_TRUE(wh.Search(target, &matched));
+  EXPECT_EQ(matched.size(), 4);
+
+  target.set_node_id(4);
+  EXPECT_FALSE(wh.Search(target));
+  target.set_process_id(2);
+  EXPECT_TRUE(wh.Search(target));
+  target.clear_node_id();
+
+  wh.Remove(0);
+  wh.Remove(1, roles[1]);
+  target.set_process_id(1);
+  matched.clear();
+  EXPECT_TRUE(wh.Search(target, &matched));
+  EXPECT_EQ(matched.size(), 2);
+  EXPECT_EQ(matched[0]->attributes().node_id(), 2);
+
+  wh.Remove(target);
+  EXPECT_FALSE(wh.Search(target));
+  EXPECT_EQ(wh.Size(), 2);
+  target.set_process_id(2);
+  EXPECT_TRUE(wh.Search(target));
+  target.set_process_id(3);
+  EXPECT_FALSE(wh.Search(target));
+
+  wh.Clear();
+  target.set_process_id(2);
+  EXPECT_FALSE(wh.Search(target));
+}
+
 }  // namespace service_discovery
 }  // namespace cyber
 }  // namespace apollo
@@ -16,6 +16,8 @@
 
 #include "cyber/service_discovery/container/single_value_warehouse.h"
 
+#include <string>
+
 #include "cyber/common/log.h"
 
 namespace apollo {
@@ -35,13 +37,19 @@ bool SingleValueWarehouse::Add(uint64_t key, const RolePtr& role,
       return false;
     }
   }
+  auto search = roles_.find(key);
+  if (search != roles_.end()) {
+    RemoveFromIndex(key, search->second);
+  }
   roles_[key] = role;
+  AddToIndex(key, role);
   return true;
 }
 
 void SingleValueWarehouse::Clear() {
   WriteLockGuard<AtomicRWLock> lock(rw_lock_);
   roles_.clear();
+  process_roles_.clear();
 }
 
 std::size_t SingleValueWarehouse::Size() {
@@ -51,7 +59,12 @@ std::size_t SingleValueWarehouse::Size() {
 
 void SingleValueWarehouse::Remove(uint64_t key) {
   WriteLockGuard<AtomicRWLock> lock(rw_lock_);
-  roles_.erase(key);
+  auto search = roles_.find(key);
+  if (search == roles_.end()) {
+    return;
+  }
+  RemoveFromIndex(key, search->second);
+  roles_.erase(search);
 }
 
 void SingleValueWarehouse::Remove(uint64_t key, const RolePtr& role) {
@@ -63,19 +76,23 @@ void SingleValueWarehouse::Remove(uint64_t key, const RolePtr& role) {
   if (!search->second->Match(role->attributes())) {
     return;
   }
+  RemoveFromIndex(key, search->second);
   roles_.erase(search);
 }
 
 void SingleValueWarehouse::Remove(const RoleAttributes& target_attr) {
   WriteLockGuard<AtomicRWLock> lock(rw_lock_);
-  for (auto it = roles_.begin(); it != roles_.end();) {
-    auto curr_role = it->second;
-    if (curr_role->Match(target_attr)) {
-      it = roles_.erase(it);
-    } else {
-      ++it;
+  std::vector<uint64_t> keys;
+  for (auto& item : GetCandidates(target_attr)) {
+    if (item.second->Match(target_attr)) {
+      keys.emplace_back(item.first);
     }
   }
+  for (auto key : keys) {
+    auto search = roles_.find(key);
+    RemoveFromIndex(key, search->second);
+    roles_.erase(search);
+  }
 }
 
 bool SingleValueWarehouse::Search(uint64_t key) {
@@ -136,7 +153,7 @@ bool SingleValueWarehouse::Search(const RoleAttributes& target_attr,
                                   RolePtr* first_matched_role) {
   RETURN_VAL_IF_NULL(first_matched_role, false);
   ReadLockGuard<AtomicRWLock> lock(rw_lock_);
-  for (auto& item : roles_) {
+  for (auto& item : GetCandidates(target_attr)) {
     if (item.second->Match(target_attr)) {
       *first_matched_role = item.second;
       return true;
@@ -161,7 +178,7 @@ bool SingleValueWarehouse::Search(const RoleAttributes& target_attr,
   RETURN_VAL_IF_NULL(matched_roles, false);
   bool find = false;
   ReadLockGuard<AtomicRWLock> lock(rw_lock_);
-  for (auto& item : roles_) {
+  for (auto& item : GetCandidates(target_attr)) {
     if (item.second->Match(target_attr)) {
       matched_roles->emplace_back(item.second);
       find = true;
@@ -176,7 +193,7 @@ bool SingleValueWarehouse::Search(
   RETURN_VAL_IF_NULL(matched_roles_attr, false);
   bool find = false;
   ReadLockGuard<AtomicRWLock> lock(rw_lock_);
-  for (auto& item : roles_) {
+  for (auto& item : GetCandidates(target_attr)) {
     if (item.second->Match(target_attr)) {
       matched_roles_attr->emplace_back(item.second->attributes());
       find = true;
@@ -202,6 +219,43 @@ void SingleValueWarehouse::GetAllRoles(
   }
 }
 
+void SingleValueWarehouse::AddToIndex(uint64_t key, const RolePtr& role) {
+  std::string process_key;
+  if (GetProcessKey(role->attributes(), &process_key)) {
+    process_roles_[process_key][key] = role;
+  }
+}
+
+void SingleValueWarehouse::RemoveFromIndex(uint64_t key,
+                                           const RolePtr& role) {
+  std::string process_key;
+  if (!GetProcessKey(role->attributes(), &process_key)) {
+    return;
+  }
+  auto search = process_roles_.find(process_key);
+  if (search == process_roles_.end()) {
+    return;
+  }
+  search->second.erase(key);
+  if (search->second.empty()) {
+    process_roles_.erase(search);
+  }
+}
+
+const SingleValueWarehouse::RoleMap& SingleValueWarehouse::GetCandidates(
+    const RoleAttributes& target_attr) {
+  static const RoleMap empty;
+  std::string process_key;
+  if (!GetProcessKey(target_attr, &process_key)) {
+    return roles_;
+  }
+  auto search = process_roles_.find(process_key);
+  if (search == process_roles_.end()) {
+    return empty;
+  }
+  return search->second;
+}
+
 }  // namespace service_discovery
 }  // namespace cyber
 }  // namespace apollo
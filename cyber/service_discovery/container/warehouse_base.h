@@ -18,6 +18,7 @@
 #define CYBER_SERVICE_DISCOVERY_CONTAINER_WAREHOUSE_BASE_H_
 
 #include <cstdint>
+#include <string>
 #include <vector>
 
 #include "cyber/service_discovery/role/role.h"
@@ -61,6 +62,24 @@ class WarehouseBase {
 
   virtual void GetAllRoles(std::vector<RolePtr>* roles) = 0;
   virtual void GetAllRoles(std::vector<proto::RoleAttributes>* roles_attr) = 0;
+
+ protected:
+  /**
+   * @brief roles are indexed by the process they belong to, so that looking
+   * up or removing the roles of one process does not scan the whole
+   * warehouse. The key has the format of participant names,
+   * host_name+process_id
+   *
+   * @return false if `attr` does not name a process
+   */
+  static bool GetProcessKey(const proto::RoleAttributes& attr,
+                            std::string* key) {
+    if (!attr.has_host_name() || !attr.has_process_id()) {
+      return false;
+    }
+    *key = attr.host_name() + '+' + std::to_string(attr.process_id());
+    return true;
+  }
 };
 
 }  // namespace service_discovery
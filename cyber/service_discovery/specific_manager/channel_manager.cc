@@ -23,6 +23,7 @@
 #include "cyber/common/global_data.h"
 #include "cyber/common/log.h"
 #include "cyber/message/message_traits.h"
+#include "cyber/message/message_view.h"
 #include "cyber/message/py_message.h"
 #include "cyber/message/raw_message.h"
 #include "cyber/state.h"
@@ -38,6 +39,7 @@ ChannelManager::ChannelManager() {
   change_type_ = ChangeType::CHANGE_CHANNEL;
   channel_name_ = "channel_change_broadcast";
   exempted_msg_types_.emplace(message::MessageType<message::RawMessage>());
+  exempted_msg_types_.emplace(message::MessageType<message::MessageView>());
   exempted_msg_types_.emplace(message::MessageType<message::PyMessageWrap>());
 }
 
@@ -241,6 +243,7 @@ void ChannelManager::Dispose(const ChangeMsg& msg) {
 void ChannelManager::OnTopoModuleLeave(const std::string& host_name,
                                        int process_id) {
   RETURN_IF(!is_discovery_started_.load());
+  IgnoreEarlierSnapshots(host_name, process_id);
 
   RoleAttributes attr;
   attr.set_host_name(host_name);
@@ -252,22 +255,58 @@ void ChannelManager::OnTopoModuleLeave(const std::string& host_name,
   std::vector<RolePtr> readers_to_remove;
   channel_readers_.Search(attr, &readers_to_remove);
 
+  // the warehouses are indexed by process, remove its roles at once
+  // instead of one by one
+  node_writers_.Remove(attr);
+  channel_writers_.Remove(attr);
+  node_readers_.Remove(attr);
+  channel_readers_.Remove(attr);
+
+  Edge e;
+  for (auto& writer : writers_to_remove) {
+    e.set_src(Vertice(writer->attributes().node_name()));
+    e.set_dst(Vertice());
+    e.set_value(writer->attributes().channel_name());
+    node_graph_.Delete(e);
+  }
+  for (auto& reader : readers_to_remove) {
+    e.set_src(Vertice());
+    e.set_dst(Vertice(reader->attributes().node_name()));
+    e.set_value(reader->attributes().channel_name());
+    node_graph_.Delete(e);
+  }
+
   ChangeMsg msg;
   for (auto& writer : writers_to_remove) {
     Convert(writer->attributes(), RoleType::ROLE_WRITER, OperateType::OPT_LEAVE,
             &msg);
-    DisposeLeave(msg);
     Notify(msg);
   }
 
   for (auto& reader : readers_to_remove) {
     Convert(reader->attributes(), RoleType::ROLE_READER, OperateType::OPT_LEAVE,
             &msg);
-    DisposeLeave(msg);
     Notify(msg);
   }
 }
 
+void ChannelManager::GetRolesOfProcess(const std::string& host_name,
+                                       int process_id,
+                                       std::vector<ChangeMsg>* msgs) {
+  RETURN_IF_NULL(msgs);
+  RoleAttributes attr;
+  attr.set_host_name(host_name);
+  attr.set_process_id(process_id);
+
+  std::vector<RolePtr> writers;
+  channel_writers_.Search(attr, &writers);
+  AppendJoinMsgs(writers, RoleType::ROLE_WRITER, msgs);
+
+  std::vector<RolePtr> readers;
+  channel_readers_.Search(attr, &readers);
+  AppendJoinMsgs(readers, RoleType::ROLE_READER, msgs);
+}
+
 void ChannelManager::DisposeJoin(const ChangeMsg& msg) {
   ScanMessageType(msg);
 
@@ -195,6 +195,8 @@ class ChannelManager : public Manager {
   bool Check(const RoleAttributes& attr) override;
   void Dispose(const ChangeMsg& msg) override;
   void OnTopoModuleLeave(const std::string& host_name, int process_id) override;
+  void GetRolesOfProcess(const std::string& host_name, int process_id,
+                         std::vector<ChangeMsg>* msgs) override;
 
   void DisposeJoin(const ChangeMsg& msg);
   void DisposeLeave(const ChangeMsg& msg);
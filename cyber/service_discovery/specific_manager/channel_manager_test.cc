@@ -430,6 +430,70 @@ TEST_F(ChannelManagerTest, is_message_type_matching) {
       channel_manager_.IsMessageTypeMatching(raw_msg_type_1, py_msg_type));
 }
 
+TEST_F(ChannelManagerTest, snapshot) {
+  std::string data;
+  EXPECT_TRUE(channel_manager_.GetSnapshot(&data));
+  std::vector<ChangeMsg> msgs;
+  EXPECT_TRUE(Manager::ParseSnapshot(data, &msgs));
+  EXPECT_EQ(msgs.size(), 2 * channel_num_ + 1);
+  EXPECT_EQ(msgs[0].role_type(), RoleType::ROLE_PARTICIPANT);
+  // our own snapshot is not applied
+  EXPECT_FALSE(channel_manager_.ApplySnapshot(data));
+  EXPECT_FALSE(channel_manager_.ApplySnapshot("wasd"));
+
+  // a snapshot of another process with a writer of channel_0
+  ChangeMsg header;
+  header.set_timestamp(1000);
+  header.set_change_type(ChangeType::CHANGE_CHANNEL);
+  header.set_operate_type(OperateType::OPT_JOIN);
+  header.set_role_type(RoleType::ROLE_PARTICIPANT);
+  header.mutable_role_attr()->set_host_name("snapshot_host");
+  header.mutable_role_attr()->set_process_id(4321);
+
+  ChangeMsg writer(header);
+  writer.set_role_type(RoleType::ROLE_WRITER);
+  auto role_attr = writer.mutable_role_attr();
+  role_attr->set_node_name("snapshot_node");
+  role_attr->set_node_id(common::GlobalData::RegisterNode("snapshot_node"));
+  role_attr->set_channel_name("channel_0");
+  role_attr->set_channel_id(
+      common::GlobalData::Instance()->RegisterChannel("channel_0"));
+  role_attr->set_id(transport::Identity().HashValue());
+
+  msgs = {header, writer};
+  EXPECT_TRUE(Manager::SerializeSnapshot(msgs, &data));
+  EXPECT_TRUE(channel_manager_.ApplySnapshot(data));
+  std::vector<RoleAttributes> writers;
+  channel_manager_.GetWritersOfChannel("channel_0", &writers);
+  EXPECT_EQ(writers.size(), 2);
+  EXPECT_EQ(channel_manager_.GetFlowDirection("snapshot_node", "node_0"),
+            UPSTREAM);
+
+  // the same or an older snapshot is ignored
+  EXPECT_FALSE(channel_manager_.ApplySnapshot(data));
+
+  // the writer is gone and a reader of channel_1 showed up
+  ChangeMsg reader(writer);
+  reader.set_role_type(RoleType::ROLE_READER);
+  reader.mutable_role_attr()->set_channel_name("channel_1");
+  reader.mutable_role_attr()->set_channel_id(
+      common::GlobalData::Instance()->RegisterChannel("channel_1"));
+  header.set_timestamp(2000);
+  msgs = {header, reader};
+  EXPECT_TRUE(Manager::SerializeSnapshot(msgs, &data));
+  EXPECT_TRUE(channel_manager_.ApplySnapshot(data));
+  writers.clear();
+  channel_manager_.GetWritersOfChannel("channel_0", &writers);
+  EXPECT_EQ(writers.size(), 1);
+  std::vector<RoleAttributes> readers;
+  channel_manager_.GetReadersOfChannel("channel_1", &readers);
+  EXPECT_EQ(readers.size(), 2);
+  EXPECT_EQ(channel_manager_.GetFlowDirection("snapshot_node", "node_0"),
+            UNREACHABLE);
+  EXPECT_EQ(channel_manager_.GetFlowDirection("node_1", "snapshot_node"),
+            UPSTREAM);
+}
+
 }  // namespace service_discovery
 }  // namespace cyber
 }  // namespace apollo
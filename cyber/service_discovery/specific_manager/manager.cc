@@ -16,6 +16,13 @@
 
 #include "cyber/service_discovery/specific_manager/manager.h"
 
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+#include "google/protobuf/util/delimited_message_util.h"
+
 #include "cyber/common/global_data.h"
 #include "cyber/common/log.h"
 #include "cyber/message/message_traits.h"
@@ -32,6 +39,19 @@ namespace service_discovery {
 using transport::AttributesFiller;
 using transport::QosProfileConf;
 
+namespace {
+
+std::string ProcessKey(const RoleAttributes& attr) {
+  return attr.host_name() + '+' + std::to_string(attr.process_id());
+}
+
+// the same role serializes to the same bytes on every process
+std::string RoleKey(const ChangeMsg& msg) {
+  return std::to_string(msg.role_type()) + msg.role_attr().SerializeAsString();
+}
+
+}  // namespace
+
 Manager::Manager()
     : is_shutdown_(false),
       is_discovery_started_(false),
@@ -40,7 +60,11 @@ Manager::Manager()
       channel_name_(""),
       publisher_(nullptr),
       subscriber_(nullptr),
-      listener_(nullptr) {
+      listener_(nullptr),
+      snapshot_dirty_(false),
+      snapshot_publisher_(nullptr),
+      snapshot_subscriber_(nullptr),
+      snapshot_listener_(nullptr) {
   host_name_ = common::GlobalData::Instance()->HostName();
   process_id_ = common::GlobalData::Instance()->ProcessId();
 }
@@ -59,6 +83,14 @@ bool Manager::StartDiscovery(RtpsParticipant* participant) {
     StopDiscovery();
     return false;
   }
+  if (!CreateSnapshotPublisher(participant) ||
+      !CreateSnapshotSubscriber(participant)) {
+    AERROR << "create snapshot publisher or subscriber failed.";
+    StopDiscovery();
+    return false;
+  }
+  // announce ourselves even without any role
+  snapshot_dirty_.store(true);
   return true;
 }
 
@@ -73,6 +105,10 @@ void Manager::StopDiscovery() {
       eprosima::fastrtps::Domain::removePublisher(publisher_);
       publisher_ = nullptr;
     }
+    if (snapshot_publisher_ != nullptr) {
+      eprosima::fastrtps::Domain::removePublisher(snapshot_publisher_);
+      snapshot_publisher_ = nullptr;
+    }
   }
 
   if (subscriber_ != nullptr) {
@@ -84,6 +120,16 @@ void Manager::StopDiscovery() {
     delete listener_;
     listener_ = nullptr;
   }
+
+  if (snapshot_subscriber_ != nullptr) {
+    eprosima::fastrtps::Domain::removeSubscriber(snapshot_subscriber_);
+    snapshot_subscriber_ = nullptr;
+  }
+
+  if (snapshot_listener_ != nullptr) {
+    delete snapshot_listener_;
+    snapshot_listener_ = nullptr;
+  }
 }
 
 void Manager::Shutdown() {
@@ -104,8 +150,12 @@ bool Manager::Join(const RoleAttributes& attr, RoleType role,
   RETURN_VAL_IF(!((1 << role) & allowed_role_), false);
   RETURN_VAL_IF(!Check(attr), false);
   ChangeMsg msg;
-  Convert(attr, role, OperateType::OPT_JOIN, &msg);
-  Dispose(msg);
+  {
+    std::lock_guard<std::recursive_mutex> lg(stamp_mutex_);
+    Convert(attr, role, OperateType::OPT_JOIN, &msg);
+    Dispose(msg);
+  }
+  snapshot_dirty_.store(true);
   if (need_publish) {
     return Publish(msg);
   }
@@ -120,8 +170,12 @@ bool Manager::Leave(const RoleAttributes& attr, RoleType role) {
   RETURN_VAL_IF(!((1 << role) & allowed_role_), false);
   RETURN_VAL_IF(!Check(attr), false);
   ChangeMsg msg;
-  Convert(attr, role, OperateType::OPT_LEAVE, &msg);
-  Dispose(msg);
+  {
+    std::lock_guard<std::recursive_mutex> lg(stamp_mutex_);
+    Convert(attr, role, OperateType::OPT_LEAVE, &msg);
+    Dispose(msg);
+  }
+  snapshot_dirty_.store(true);
   if (NeedPublish(msg)) {
     return Publish(msg);
   }
@@ -137,6 +191,144 @@ void Manager::RemoveChangeListener(const ChangeConnection& conn) {
   local_conn.Disconnect();
 }
 
+bool Manager::PublishSnapshot() {
+  if (!is_discovery_started_.load()) {
+    ADEBUG << "discovery is not started.";
+    return false;
+  }
+  if (!snapshot_dirty_.exchange(false)) {
+    return true;
+  }
+
+  apollo::cyber::transport::UnderlayMessage m;
+  bool result = GetSnapshot(&m.data());
+  if (result) {
+    std::lock_guard<std::mutex> lg(lock_);
+    if (snapshot_publisher_ != nullptr) {
+      result = snapshot_publisher_->write(reinterpret_cast<void*>(&m));
+    }
+  }
+  if (!result) {
+    AWARN << "publish snapshot on " << channel_name_ << " failed.";
+    snapshot_dirty_.store(true);
+  }
+  return result;
+}
+
+bool Manager::GetSnapshot(std::string* data) {
+  RETURN_VAL_IF_NULL(data, false);
+  std::vector<ChangeMsg> msgs(1);
+  RoleAttributes attr;
+  attr.set_host_name(host_name_);
+  attr.set_process_id(process_id_);
+  {
+    // local changes are stamped and disposed under the same lock, so the
+    // roles read here hold every change stamped before the snapshot and
+    // none stamped after it
+    std::lock_guard<std::recursive_mutex> lg(stamp_mutex_);
+    Convert(attr, RoleType::ROLE_PARTICIPANT, OperateType::OPT_JOIN,
+            &msgs[0]);
+    GetRolesOfProcess(host_name_, process_id_, &msgs);
+  }
+  return SerializeSnapshot(msgs, data);
+}
+
+bool Manager::ApplySnapshot(const std::string& data) {
+  std::vector<ChangeMsg> msgs;
+  RETURN_VAL_IF(!ParseSnapshot(data, &msgs), false);
+  const ChangeMsg& header = msgs.front();
+  RETURN_VAL_IF(header.role_type() != RoleType::ROLE_PARTICIPANT, false);
+  RETURN_VAL_IF(header.change_type() != change_type_, false);
+  if (IsFromSameProcess(header)) {
+    return false;
+  }
+
+  auto& host_name = header.role_attr().host_name();
+  int process_id = header.role_attr().process_id();
+  std::lock_guard<std::mutex> lg(remote_mutex_);
+  auto key = ProcessKey(header.role_attr());
+  auto& last_timestamp = last_timestamps_[key];
+  last_timestamp = std::max<uint64_t>(last_timestamp, header.timestamp());
+  auto& timestamp = snapshot_timestamps_[key];
+  if (header.timestamp() <= timestamp) {
+    ADEBUG << "ignore outdated snapshot of " << host_name << "+"
+           << process_id;
+    return false;
+  }
+  timestamp = header.timestamp();
+
+  std::vector<ChangeMsg> existing_msgs;
+  GetRolesOfProcess(host_name, process_id, &existing_msgs);
+  std::unordered_map<std::string, const ChangeMsg*> leaving;
+  for (auto& msg : existing_msgs) {
+    leaving[RoleKey(msg)] = &msg;
+  }
+
+  std::vector<const ChangeMsg*> joining;
+  for (std::size_t i = 1; i < msgs.size(); ++i) {
+    auto& msg = msgs[i];
+    if (leaving.erase(RoleKey(msg)) > 0) {
+      continue;
+    }
+    if (msg.operate_type() != OperateType::OPT_JOIN ||
+        msg.change_type() != change_type_ ||
+        msg.role_attr().host_name() != host_name ||
+        msg.role_attr().process_id() != process_id ||
+        !Check(msg.role_attr())) {
+      continue;
+    }
+    joining.emplace_back(&msg);
+  }
+
+  for (auto& item : leaving) {
+    ChangeMsg msg(*item.second);
+    msg.set_timestamp(header.timestamp());
+    msg.set_operate_type(OperateType::OPT_LEAVE);
+    Dispose(msg);
+  }
+  for (auto msg : joining) {
+    Dispose(*msg);
+  }
+  ADEBUG << "applied snapshot of " << host_name << "+" << process_id
+         << ", join: " << joining.size() << ", leave: " << leaving.size();
+  return true;
+}
+
+bool Manager::SerializeSnapshot(const std::vector<ChangeMsg>& msgs,
+                                std::string* data) {
+  RETURN_VAL_IF_NULL(data, false);
+  RETURN_VAL_IF(msgs.empty(), false);
+  data->clear();
+  google::protobuf::io::StringOutputStream output(data);
+  for (auto& msg : msgs) {
+    if (!google::protobuf::util::SerializeDelimitedToZeroCopyStream(
+            msg, &output)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Manager::ParseSnapshot(const std::string& data,
+                            std::vector<ChangeMsg>* msgs) {
+  RETURN_VAL_IF_NULL(msgs, false);
+  google::protobuf::io::ArrayInputStream input(data.data(),
+                                               static_cast<int>(data.size()));
+  while (true) {
+    ChangeMsg msg;
+    bool clean_eof = false;
+    if (!google::protobuf::util::ParseDelimitedFromZeroCopyStream(
+            &msg, &input, &clean_eof)) {
+      if (clean_eof) {
+        break;
+      }
+      return false;
+    }
+    msgs->emplace_back(std::move(msg));
+  }
+  return !msgs->empty();
+}
+
 bool Manager::CreatePublisher(RtpsParticipant* participant) {
   RtpsPublisherAttr pub_attr;
   RETURN_VAL_IF(
@@ -162,6 +354,31 @@ bool Manager::CreateSubscriber(RtpsParticipant* participant) {
   return subscriber_ != nullptr;
 }
 
+bool Manager::CreateSnapshotPublisher(RtpsParticipant* participant) {
+  RtpsPublisherAttr pub_attr;
+  RETURN_VAL_IF(!AttributesFiller::FillInPubAttr(
+                    channel_name_ + "_snapshot",
+                    QosProfileConf::QOS_PROFILE_TOPO_SNAPSHOT, &pub_attr),
+                false);
+  snapshot_publisher_ =
+      eprosima::fastrtps::Domain::createPublisher(participant, pub_attr);
+  return snapshot_publisher_ != nullptr;
+}
+
+bool Manager::CreateSnapshotSubscriber(RtpsParticipant* participant) {
+  RtpsSubscriberAttr sub_attr;
+  RETURN_VAL_IF(!AttributesFiller::FillInSubAttr(
+                    channel_name_ + "_snapshot",
+                    QosProfileConf::QOS_PROFILE_TOPO_SNAPSHOT, &sub_attr),
+                false);
+  snapshot_listener_ = new SubscriberListener(
+      [this](const std::string& data) { OnRemoteSnapshot(data); });
+
+  snapshot_subscriber_ = eprosima::fastrtps::Domain::createSubscriber(
+      participant, sub_attr, snapshot_listener_);
+  return snapshot_subscriber_ != nullptr;
+}
+
 bool Manager::NeedPublish(const ChangeMsg& msg) const {
   (void)msg;
   return true;
@@ -183,6 +400,35 @@ void Manager::Convert(const RoleAttributes& attr, RoleType role,
   }
 }
 
+void Manager::AppendJoinMsgs(const std::vector<RolePtr>& roles, RoleType role,
+                             std::vector<ChangeMsg>* msgs) {
+  for (auto& item : roles) {
+    ChangeMsg msg;
+    msg.set_timestamp(item->timestamp_ns());
+    msg.set_change_type(change_type_);
+    msg.set_operate_type(OperateType::OPT_JOIN);
+    msg.set_role_type(role);
+    msg.mutable_role_attr()->CopyFrom(item->attributes());
+    msgs->emplace_back(std::move(msg));
+  }
+}
+
+void Manager::IgnoreEarlierSnapshots(const std::string& host_name,
+                                     int process_id) {
+  RoleAttributes attr;
+  attr.set_host_name(host_name);
+  attr.set_process_id(process_id);
+  std::lock_guard<std::mutex> lg(remote_mutex_);
+  // the clock of that process, not ours, stamped its snapshots
+  auto key = ProcessKey(attr);
+  auto search = last_timestamps_.find(key);
+  if (search == last_timestamps_.end()) {
+    return;
+  }
+  auto& timestamp = snapshot_timestamps_[key];
+  timestamp = std::max(timestamp, search->second);
+}
+
 void Manager::Notify(const ChangeMsg& msg) { signal_(msg); }
 
 void Manager::OnRemoteChange(const std::string& msg_str) {
@@ -197,9 +443,28 @@ void Manager::OnRemoteChange(const std::string& msg_str) {
     return;
   }
   RETURN_IF(!Check(msg.role_attr()));
+
+  std::lock_guard<std::mutex> lg(remote_mutex_);
+  auto key = ProcessKey(msg.role_attr());
+  auto& last_timestamp = last_timestamps_[key];
+  last_timestamp = std::max<uint64_t>(last_timestamp, msg.timestamp());
+  auto search = snapshot_timestamps_.find(key);
+  if (search != snapshot_timestamps_.end() &&
+      msg.timestamp() <= search->second) {
+    ADEBUG << "ignore change covered by a snapshot.";
+    return;
+  }
   Dispose(msg);
 }
 
+void Manager::OnRemoteSnapshot(const std::string& data) {
+  if (is_shutdown_.load()) {
+    ADEBUG << "the manager has been shut down.";
+    return;
+  }
+  ApplySnapshot(data);
+}
+
 bool Manager::Publish(const ChangeMsg& msg) {
   if (!is_discovery_started_.load()) {
     ADEBUG << "discovery is not started.";
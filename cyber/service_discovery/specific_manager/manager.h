@@ -18,9 +18,12 @@
 #define CYBER_SERVICE_DISCOVERY_SPECIFIC_MANAGER_MANAGER_H_
 
 #include <atomic>
+#include <cstdint>
 #include <functional>
 #include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "fastrtps/Domain.h"
 #include "fastrtps/attributes/PublisherAttributes.h"
@@ -32,6 +35,7 @@
 #include "cyber/base/signal.h"
 #include "cyber/proto/topology_change.pb.h"
 #include "cyber/service_discovery/communication/subscriber_listener.h"
+#include "cyber/service_discovery/role/role.h"
 
 namespace apollo {
 namespace cyber {
@@ -135,20 +139,73 @@ class Manager {
   virtual void OnTopoModuleLeave(const std::string& host_name,
                                  int process_id) = 0;
 
+  /**
+   * @brief Publish a snapshot of the roles of this process, if they changed
+   * since the last one. Joins and leaves within one call are batched into a
+   * single snapshot, and the latest snapshot of every process is kept for
+   * managers that join the topology later, instead of replaying every change
+   *
+   * @return true if there was nothing to publish or it was published
+   * @return false if publishing failed
+   */
+  bool PublishSnapshot();
+
+  /**
+   * @brief Get the snapshot of the roles of this process
+   *
+   * @param data the serialized snapshot
+   * @return true if serialized successfully
+   */
+  bool GetSnapshot(std::string* data);
+
+  /**
+   * @brief Bring the roles of another process in line with its snapshot.
+   * Roles missing in the snapshot leave and roles missing here join, the
+   * others are left untouched. Snapshots and changes older than the latest
+   * applied snapshot of that process are ignored
+   *
+   * @param data the serialized snapshot
+   * @return true if the snapshot was applied
+   */
+  bool ApplySnapshot(const std::string& data);
+
+  /**
+   * @brief a snapshot is a participant message naming the process and the
+   * time it was taken, followed by a join message per role, each of them
+   * length delimited
+   */
+  static bool SerializeSnapshot(const std::vector<ChangeMsg>& msgs,
+                                std::string* data);
+  static bool ParseSnapshot(const std::string& data,
+                            std::vector<ChangeMsg>* msgs);
+
  protected:
   bool CreatePublisher(RtpsParticipant* participant);
   bool CreateSubscriber(RtpsParticipant* participant);
+  bool CreateSnapshotPublisher(RtpsParticipant* participant);
+  bool CreateSnapshotSubscriber(RtpsParticipant* participant);
 
   virtual bool Check(const RoleAttributes& attr) = 0;
   virtual void Dispose(const ChangeMsg& msg) = 0;
   virtual bool NeedPublish(const ChangeMsg& msg) const;
+  /**
+   * @brief append a join message for every role of the process
+   */
+  virtual void GetRolesOfProcess(const std::string& host_name, int process_id,
+                                 std::vector<ChangeMsg>* msgs) = 0;
 
   void Convert(const RoleAttributes& attr, RoleType role, OperateType opt,
                ChangeMsg* msg);
 
+  void AppendJoinMsgs(const std::vector<RolePtr>& roles, RoleType role,
+                      std::vector<ChangeMsg>* msgs);
+  // once a process left, snapshots it published before are stale
+  void IgnoreEarlierSnapshots(const std::string& host_name, int process_id);
+
   void Notify(const ChangeMsg& msg);
   bool Publish(const ChangeMsg& msg);
   void OnRemoteChange(const std::string& msg_str);
+  void OnRemoteSnapshot(const std::string& data);
   bool IsFromSameProcess(const ChangeMsg& msg);
 
   std::atomic<bool> is_shutdown_;
@@ -163,6 +220,22 @@ class Manager {
   eprosima::fastrtps::Subscriber* subscriber_;
   SubscriberListener* listener_;
 
+  std::atomic<bool> snapshot_dirty_;
+  eprosima::fastrtps::Publisher* snapshot_publisher_;
+  eprosima::fastrtps::Subscriber* snapshot_subscriber_;
+  SubscriberListener* snapshot_listener_;
+  // held while a local change is stamped and disposed, and while a snapshot
+  // is stamped and its roles are read. Recursive since the listeners notified
+  // on dispose may join roles themselves
+  std::recursive_mutex stamp_mutex_;
+  // serializes the remote changes and snapshots applied
+  std::mutex remote_mutex_;
+  // key: host_name+process_id, value: time of its latest applied snapshot
+  std::unordered_map<std::string, uint64_t> snapshot_timestamps_;
+  // key: host_name+process_id, value: latest time stamped by that process
+  // on a change or snapshot received from it
+  std::unordered_map<std::string, uint64_t> last_timestamps_;
+
   ChangeSignal signal_;
 };
 
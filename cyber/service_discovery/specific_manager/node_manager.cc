@@ -60,6 +60,7 @@ void NodeManager::Dispose(const ChangeMsg& msg) {
 void NodeManager::OnTopoModuleLeave(const std::string& host_name,
                                     int process_id) {
   RETURN_IF(!is_discovery_started_.load());
+  IgnoreEarlierSnapshots(host_name, process_id);
 
   RoleAttributes attr;
   attr.set_host_name(host_name);
@@ -78,6 +79,18 @@ void NodeManager::OnTopoModuleLeave(const std::string& host_name,
   }
 }
 
+void NodeManager::GetRolesOfProcess(const std::string& host_name,
+                                    int process_id,
+                                    std::vector<ChangeMsg>* msgs) {
+  RETURN_IF_NULL(msgs);
+  RoleAttributes attr;
+  attr.set_host_name(host_name);
+  attr.set_process_id(process_id);
+  std::vector<RolePtr> nodes;
+  nodes_.Search(attr, &nodes);
+  AppendJoinMsgs(nodes, RoleType::ROLE_NODE, msgs);
+}
+
 void NodeManager::DisposeJoin(const ChangeMsg& msg) {
   auto node = std::make_shared<RoleNode>(msg.role_attr(), msg.timestamp());
   uint64_t key = node->attributes().node_id();
@@ -68,6 +68,7 @@ void ServiceManager::Dispose(const ChangeMsg& msg) {
 void ServiceManager::OnTopoModuleLeave(const std::string& host_name,
                                        int process_id) {
   RETURN_IF(!is_discovery_started_.load());
+  IgnoreEarlierSnapshots(host_name, process_id);
 
   RoleAttributes attr;
   attr.set_host_name(host_name);
@@ -99,6 +100,23 @@ void ServiceManager::OnTopoModuleLeave(const std::string& host_name,
   }
 }
 
+void ServiceManager::GetRolesOfProcess(const std::string& host_name,
+                                       int process_id,
+                                       std::vector<ChangeMsg>* msgs) {
+  RETURN_IF_NULL(msgs);
+  RoleAttributes attr;
+  attr.set_host_name(host_name);
+  attr.set_process_id(process_id);
+
+  std::vector<RolePtr> servers;
+  servers_.Search(attr, &servers);
+  AppendJoinMsgs(servers, RoleType::ROLE_SERVER, msgs);
+
+  std::vector<RolePtr> clients;
+  clients_.Search(attr, &clients);
+  AppendJoinMsgs(clients, RoleType::ROLE_CLIENT, msgs);
+}
+
 void ServiceManager::DisposeJoin(const ChangeMsg& msg) {
   if (msg.role_type() == RoleType::ROLE_SERVER) {
     auto role = std::make_shared<RoleServer>(msg.role_attr());
@@ -82,6 +82,8 @@ class ServiceManager : public Manager {
   bool Check(const RoleAttributes& attr) override;
   void Dispose(const ChangeMsg& msg) override;
   void OnTopoModuleLeave(const std::string& host_name, int process_id) override;
+  void GetRolesOfProcess(const std::string& host_name, int process_id,
+                         std::vector<ChangeMsg>* msgs) override;
 
   void DisposeJoin(const ChangeMsg& msg);
   void DisposeLeave(const ChangeMsg& msg);
@@ -16,6 +16,8 @@
 
 #include "cyber/service_discovery/topology_manager.h"
 
+#include <chrono>
+
 #include "cyber/common/global_data.h"
 #include "cyber/common/log.h"
 #include "cyber/time/time.h"
@@ -24,6 +26,10 @@ namespace apollo {
 namespace cyber {
 namespace service_discovery {
 
+namespace {
+constexpr int kSnapshotIntervalMs = 50;
+}  // namespace
+
 TopologyManager::TopologyManager()
     : init_(false),
       node_manager_(nullptr),
@@ -43,6 +49,14 @@ void TopologyManager::Shutdown() {
     return;
   }
 
+  {
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    snapshot_cv_.notify_all();
+  }
+  if (snapshot_thread_.joinable()) {
+    snapshot_thread_.join();
+  }
+
   node_manager_->Shutdown();
   channel_manager_->Shutdown();
   service_manager_->Shutdown();
@@ -89,6 +103,7 @@ bool TopologyManager::Init() {
     return false;
   }
 
+  snapshot_thread_ = std::thread(&TopologyManager::PublishSnapshots, this);
   return true;
 }
 
@@ -115,6 +130,17 @@ bool TopologyManager::CreateParticipant() {
   return true;
 }
 
+void TopologyManager::PublishSnapshots() {
+  std::unique_lock<std::mutex> lock(snapshot_mutex_);
+  while (!snapshot_cv_.wait_for(
+      lock, std::chrono::milliseconds(kSnapshotIntervalMs),
+      [this] { return !init_.load(); })) {
+    node_manager_->PublishSnapshot();
+    channel_manager_->PublishSnapshot();
+    service_manager_->PublishSnapshot();
+  }
+}
+
 void TopologyManager::OnParticipantChange(const PartInfo& info) {
   ChangeMsg msg;
   if (!Convert(info, &msg)) {
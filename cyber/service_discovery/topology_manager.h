@@ -18,11 +18,13 @@
 #define CYBER_SERVICE_DISCOVERY_TOPOLOGY_MANAGER_H_
 
 #include <atomic>
+#include <condition_variable>
 #include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 
 #include "cyber/base/signal.h"
 #include "cyber/common/macros.h"
@@ -114,6 +116,7 @@ class TopologyManager {
   bool InitServiceManager();
 
   bool CreateParticipant();
+  void PublishSnapshots();
   void OnParticipantChange(const PartInfo& info);
   bool Convert(const PartInfo& info, ChangeMsg* change_msg);
   bool ParseParticipantName(const std::string& participant_name,
@@ -130,6 +133,12 @@ class TopologyManager {
                                          ///< connect to `ChangeFunc`s
   PartNameContainer participant_names_;  /// other participant in the topology
 
+  /// publishes the snapshots of the managers, batching the roles that
+  /// joined or left within an interval
+  std::thread snapshot_thread_;
+  std::mutex snapshot_mutex_;
+  std::condition_variable snapshot_cv_;
+
   DECLARE_SINGLETON(TopologyManager)
 };
 
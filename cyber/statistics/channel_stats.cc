@@ -0,0 +1,415 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/statistics/channel_stats.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+
+#include "cyber/common/global_data.h"
+#include "cyber/common/log.h"
+#include "cyber/time/time.h"
+
+namespace apollo {
+namespace cyber {
+namespace statistics {
+
+namespace {
+
+const char kNamePrefix[] = "cyber_stats.";
+const uint32_t kMagic = 0x43535431;  // "CST1"
+
+struct Header {
+  uint32_t magic;
+  uint32_t record_num;
+  uint64_t reserved;
+};
+
+int BucketOf(uint64_t value_us) {
+  int bucket = 0;
+  for (; value_us > 0; value_us >>= 1) {
+    ++bucket;
+  }
+  return std::min(bucket,
+                  static_cast<int>(ChannelStatsRecord::kLatencyBucketNum) - 1);
+}
+
+}  // namespace
+
+const uint32_t ChannelStats::kMaxChannelNum = 512;
+
+void ChannelStatsSnapshot::Merge(const ChannelStatsRecord& record) {
+  ++process_num;
+  published += record.published.load();
+  shm_write_failures += record.shm_write_failures.load();
+  shm_laps += record.shm_laps.load();
+  shm_contended_blocks += record.shm_contended_blocks.load();
+  delivered += record.delivered.load();
+  latency_sum_us += record.latency_sum_us.load();
+  latency_max_us = std::max(latency_max_us, record.latency_max_us.load());
+  for (uint32_t i = 0; i < ChannelStatsRecord::kLatencyBucketNum; ++i) {
+    latency_buckets[i] += record.latency_buckets[i].load();
+  }
+  cache_overwrites += record.cache_overwrites.load();
+  queue_depth_max = std::max(queue_depth_max, record.queue_depth_max.load());
+  shm_read_failures += record.shm_read_failures.load();
+  wakeups += record.wakeups.load();
+  wakeup_lag_sum_us += record.wakeup_lag_sum_us.load();
+  wakeup_lag_max_us =
+      std::max(wakeup_lag_max_us, record.wakeup_lag_max_us.load());
+}
+
+uint64_t ChannelStatsSnapshot::LatencyPercentileUs(double percentile) const {
+  uint64_t total = 0;
+  for (auto count : latency_buckets) {
+    total += count;
+  }
+  if (total == 0) {
+    return 0;
+  }
+  uint64_t count = 0;
+  for (uint32_t i = 0; i < latency_buckets.size(); ++i) {
+    count += latency_buckets[i];
+    if (static_cast<double>(count) >= percentile * static_cast<double>(total)) {
+      return 1ULL << i;
+    }
+  }
+  return 1ULL << (latency_buckets.size() - 1);
+}
+
+ChannelStats::ChannelStats() {}
+
+ChannelStats::~ChannelStats() {
+  if (records_ != nullptr) {
+    munmap(reinterpret_cast<char*>(records_) - sizeof(Header), mapped_size_);
+    shm_unlink(GetName(getpid()).c_str());
+    records_ = nullptr;
+  }
+}
+
+void ChannelStats::Shutdown() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (records_ != nullptr) {
+    shm_unlink(GetName(getpid()).c_str());
+  }
+}
+
+std::string ChannelStats::GetName(int pid) {
+  return kNamePrefix + std::to_string(pid);
+}
+
+void ChannelStats::OnPublish(uint64_t channel_id) {
+  auto entry = GetEntry(channel_id);
+  entry->record->published.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ChannelStats::OnShmWriteFailure(uint64_t channel_id) {
+  auto entry = GetEntry(channel_id);
+  entry->record->shm_write_failures.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ChannelStats::OnShmLap(uint64_t channel_id) {
+  auto entry = GetEntry(channel_id);
+  entry->record->shm_laps.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ChannelStats::OnShmContention(uint64_t channel_id) {
+  auto entry = GetEntry(channel_id);
+  entry->record->shm_contended_blocks.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ChannelStats::OnDispatch(uint64_t channel_id, const void* msg,
+                              uint64_t send_time_ns, uint64_t trace_id) {
+  auto entry = GetEntry(channel_id);
+  auto& slot = entry->send_times[(reinterpret_cast<uintptr_t>(msg) >> 4) %
+                                 kSendTimeSlotNum];
+  slot.msg.store(nullptr, std::memory_order_relaxed);
+  slot.send_time_ns.store(send_time_ns, std::memory_order_relaxed);
+  slot.trace_id.store(trace_id, std::memory_order_relaxed);
+  slot.msg.store(msg, std::memory_order_release);
+}
+
+bool ChannelStats::LoadSlot(Entry* entry, const void* msg,
+                            uint64_t* send_time_ns, uint64_t* trace_id) {
+  auto& slot = entry->send_times[(reinterpret_cast<uintptr_t>(msg) >> 4) %
+                                 kSendTimeSlotNum];
+  if (slot.msg.load(std::memory_order_acquire) != msg) {
+    return false;
+  }
+  *send_time_ns = slot.send_time_ns.load(std::memory_order_relaxed);
+  *trace_id = slot.trace_id.load(std::memory_order_relaxed);
+  // the slot was taken by another message meanwhile
+  return slot.msg.load(std::memory_order_acquire) == msg;
+}
+
+void ChannelStats::OnCallback(uint64_t channel_id, const void* msg) {
+  auto entry = GetEntry(channel_id);
+  uint64_t send_time_ns = 0;
+  uint64_t trace_id = 0;
+  if (!LoadSlot(entry, msg, &send_time_ns, &trace_id)) {
+    return;
+  }
+  uint64_t now_ns = Time::Now().ToNanosecond();
+  uint64_t latency_us =
+      now_ns > send_time_ns ? (now_ns - send_time_ns) / 1000 : 0;
+
+  auto record = entry->record;
+  record->delivered.fetch_add(1, std::memory_order_relaxed);
+  record->latency_sum_us.fetch_add(latency_us, std::memory_order_relaxed);
+  UpdateMax(&record->latency_max_us, latency_us);
+  record->latency_buckets[BucketOf(latency_us)].fetch_add(
+      1, std::memory_order_relaxed);
+  if (entry->latency != nullptr) {
+    *(entry->latency) << latency_us;
+  }
+}
+
+uint64_t ChannelStats::TraceId(uint64_t channel_id, const void* msg) {
+  uint64_t send_time_ns = 0;
+  uint64_t trace_id = 0;
+  if (!LoadSlot(GetEntry(channel_id), msg, &send_time_ns, &trace_id)) {
+    return 0;
+  }
+  return trace_id;
+}
+
+void ChannelStats::OnCacheFill(uint64_t channel_id, bool overwritten,
+                               uint64_t depth) {
+  auto entry = GetEntry(channel_id);
+  if (overwritten) {
+    entry->record->cache_overwrites.fetch_add(1, std::memory_order_relaxed);
+  }
+  UpdateMax(&entry->record->queue_depth_max, depth);
+}
+
+void ChannelStats::OnShmRead(uint64_t channel_id, uint64_t send_time_ns) {
+  auto entry = GetEntry(channel_id);
+  uint64_t now_ns = Time::Now().ToNanosecond();
+  uint64_t lag_us = now_ns > send_time_ns ? (now_ns - send_time_ns) / 1000 : 0;
+  auto record = entry->record;
+  record->wakeups.fetch_add(1, std::memory_order_relaxed);
+  record->wakeup_lag_sum_us.fetch_add(lag_us, std::memory_order_relaxed);
+  UpdateMax(&record->wakeup_lag_max_us, lag_us);
+}
+
+void ChannelStats::OnShmReadFailure(uint64_t channel_id) {
+  auto entry = GetEntry(channel_id);
+  entry->record->shm_read_failures.fetch_add(1, std::memory_order_relaxed);
+}
+
+ChannelStats::Entry* ChannelStats::GetEntry(uint64_t channel_id) {
+  Entry* entry = nullptr;
+  if (entries_.Get(channel_id, &entry)) {
+    return entry;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (entries_.Get(channel_id, &entry)) {
+    return entry;
+  }
+  std::string channel_name = common::GlobalData::GetChannelById(channel_id);
+  if (channel_name.empty()) {
+    channel_name = std::to_string(channel_id);
+  }
+  std::unique_ptr<Entry> new_entry(new Entry());
+  if (OpenShm()) {
+    for (uint32_t i = 0; i < record_num_; ++i) {
+      if (records_[i].channel_id.load(std::memory_order_relaxed) == 0) {
+        new_entry->record = &records_[i];
+        break;
+      }
+    }
+  }
+  if (new_entry->record == nullptr) {
+    new_entry->local_record.reset(new ChannelStatsRecord());
+    new_entry->record = new_entry->local_record.get();
+  }
+  std::strncpy(new_entry->record->channel_name, channel_name.c_str(),
+               ChannelStatsRecord::kNameSize - 1);
+  // readers of the object see the record once its name is there
+  new_entry->record->channel_id.store(channel_id, std::memory_order_release);
+  Expose(new_entry.get(), channel_name);
+
+  entry = new_entry.get();
+  owned_entries_.emplace_back(std::move(new_entry));
+  entries_.Set(channel_id, entry);
+  return entry;
+}
+
+bool ChannelStats::OpenShm() {
+  if (shm_opened_) {
+    return records_ != nullptr;
+  }
+  shm_opened_ = true;
+
+  // a stale object of an earlier process with the same pid
+  std::string name = GetName(getpid());
+  shm_unlink(name.c_str());
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+  if (fd < 0) {
+    AWARN << "create channel stats " << name << " failed: " << strerror(errno);
+    return false;
+  }
+  std::size_t size =
+      sizeof(Header) + sizeof(ChannelStatsRecord) * kMaxChannelNum;
+  if (ftruncate(fd, size) < 0) {
+    AWARN << "truncate channel stats " << name
+          << " failed: " << strerror(errno);
+    close(fd);
+    shm_unlink(name.c_str());
+    return false;
+  }
+  void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    AWARN << "map channel stats " << name << " failed: " << strerror(errno);
+    shm_unlink(name.c_str());
+    return false;
+  }
+
+  auto header = reinterpret_cast<Header*>(addr);
+  header->record_num = kMaxChannelNum;
+  header->magic = kMagic;
+  records_ = reinterpret_cast<ChannelStatsRecord*>(header + 1);
+  record_num_ = kMaxChannelNum;
+  mapped_size_ = size;
+  return true;
+}
+
+void ChannelStats::Expose(Entry* entry, const std::string& channel_name) {
+  auto record = entry->record;
+  std::pair<const char*, std::atomic<uint64_t>*> counters[] = {
+      {"published", &record->published},
+      {"shm-write-failures", &record->shm_write_failures},
+      {"shm-laps", &record->shm_laps},
+      {"shm-contended-blocks", &record->shm_contended_blocks},
+      {"delivered", &record->delivered},
+      {"cache-overwrites", &record->cache_overwrites},
+      {"queue-depth-max", &record->queue_depth_max},
+      {"shm-read-failures", &record->shm_read_failures},
+      {"wakeup-lag-max-us", &record->wakeup_lag_max_us},
+  };
+  for (auto& counter : counters) {
+    entry->vars.emplace_back(new ::bvar::PassiveStatus<uint64_t>(
+        channel_name + "-stats-" + counter.first, &ChannelStats::LoadCounter,
+        counter.second));
+  }
+  entry->latency.reset(
+      new ::bvar::LatencyRecorder(channel_name, "publish-callback"));
+}
+
+void ChannelStats::UpdateMax(std::atomic<uint64_t>* max, uint64_t value) {
+  uint64_t current = max->load(std::memory_order_relaxed);
+  while (value > current &&
+         !max->compare_exchange_weak(current, value,
+                                     std::memory_order_relaxed)) {
+  }
+}
+
+uint64_t ChannelStats::LoadCounter(void* counter) {
+  return static_cast<std::atomic<uint64_t>*>(counter)->load();
+}
+
+bool ChannelStats::ReadAll(std::vector<ChannelStatsSnapshot>* snapshots) {
+  RETURN_VAL_IF_NULL(snapshots, false);
+  snapshots->clear();
+  DIR* dir = opendir("/dev/shm");
+  if (dir == nullptr) {
+    AERROR << "open /dev/shm failed: " << strerror(errno);
+    return false;
+  }
+
+  std::map<uint64_t, ChannelStatsSnapshot> channels;
+  const std::size_t prefix_len = std::strlen(kNamePrefix);
+  while (auto item = readdir(dir)) {
+    if (std::strncmp(item->d_name, kNamePrefix, prefix_len) != 0) {
+      continue;
+    }
+    int pid = std::atoi(item->d_name + prefix_len);
+    if (pid <= 0) {
+      continue;
+    }
+    if (kill(pid, 0) < 0 && errno == ESRCH) {
+      shm_unlink(item->d_name);
+      continue;
+    }
+
+    int fd = shm_open(item->d_name, O_RDONLY, 0644);
+    if (fd < 0) {
+      continue;
+    }
+    struct stat file_attr;
+    if (fstat(fd, &file_attr) < 0 ||
+        static_cast<std::size_t>(file_attr.st_size) < sizeof(Header)) {
+      close(fd);
+      continue;
+    }
+    std::size_t size = file_attr.st_size;
+    void* addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+      continue;
+    }
+
+    auto header = reinterpret_cast<const Header*>(addr);
+    auto records = reinterpret_cast<const ChannelStatsRecord*>(header + 1);
+    if (header->magic == kMagic &&
+        sizeof(Header) + sizeof(ChannelStatsRecord) * header->record_num <=
+            size) {
+      for (uint32_t i = 0; i < header->record_num; ++i) {
+        uint64_t channel_id =
+            records[i].channel_id.load(std::memory_order_acquire);
+        if (channel_id == 0) {
+          continue;
+        }
+        auto& snapshot = channels[channel_id];
+        if (snapshot.channel_name.empty()) {
+          snapshot.channel_id = channel_id;
+          snapshot.channel_name.assign(
+              records[i].channel_name,
+              strnlen(records[i].channel_name, ChannelStatsRecord::kNameSize));
+        }
+        snapshot.Merge(records[i]);
+      }
+    }
+    munmap(addr, size);
+  }
+  closedir(dir);
+
+  for (auto& item : channels) {
+    snapshots->emplace_back(std::move(item.second));
+  }
+  std::sort(snapshots->begin(), snapshots->end(),
+            [](const ChannelStatsSnapshot& lhs,
+               const ChannelStatsSnapshot& rhs) {
+              return lhs.channel_name < rhs.channel_name;
+            });
+  return true;
+}
+
+}  // namespace statistics
+}  // namespace cyber
+}  // namespace apollo
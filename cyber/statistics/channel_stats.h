@@ -0,0 +1,182 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_STATISTICS_CHANNEL_STATS_H_
+#define CYBER_STATISTICS_CHANNEL_STATS_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "cyber/base/atomic_hash_map.h"
+#include "cyber/common/macros.h"
+#include "third_party/var/bvar/bvar.h"
+
+namespace apollo {
+namespace cyber {
+namespace statistics {
+
+/**
+ * @brief Transport counters of one channel in one process. Records live in
+ * a shared memory object of the process, so cyber_channel_stats reads them
+ * while the process runs.
+ */
+struct ChannelStatsRecord {
+  static const uint32_t kNameSize = 128;
+  // latency_buckets[i] counts the samples below 2^i us
+  static const uint32_t kLatencyBucketNum = 24;
+
+  // 0 while the record is free, set once the name is written
+  std::atomic<uint64_t> channel_id;
+  char channel_name[kNameSize];
+
+  // writer side
+  std::atomic<uint64_t> published;
+  std::atomic<uint64_t> shm_write_failures;
+  std::atomic<uint64_t> shm_laps;
+  std::atomic<uint64_t> shm_contended_blocks;
+
+  // reader side, publish to fetch latency
+  std::atomic<uint64_t> delivered;
+  std::atomic<uint64_t> latency_sum_us;
+  std::atomic<uint64_t> latency_max_us;
+  std::atomic<uint64_t> latency_buckets[kLatencyBucketNum];
+
+  // reader side, messages the reader queues dropped to make room
+  std::atomic<uint64_t> cache_overwrites;
+  std::atomic<uint64_t> queue_depth_max;
+
+  // reader side, blocks overwritten before the dispatcher read them and the
+  // time from publish until the dispatcher woke up for a block
+  std::atomic<uint64_t> shm_read_failures;
+  std::atomic<uint64_t> wakeups;
+  std::atomic<uint64_t> wakeup_lag_sum_us;
+  std::atomic<uint64_t> wakeup_lag_max_us;
+};
+
+/**
+ * @brief A copy of the records of a channel, summed over processes.
+ */
+struct ChannelStatsSnapshot {
+  uint64_t channel_id = 0;
+  std::string channel_name;
+  uint32_t process_num = 0;
+  uint64_t published = 0;
+  uint64_t shm_write_failures = 0;
+  uint64_t shm_laps = 0;
+  uint64_t shm_contended_blocks = 0;
+  uint64_t delivered = 0;
+  uint64_t latency_sum_us = 0;
+  uint64_t latency_max_us = 0;
+  std::array<uint64_t, ChannelStatsRecord::kLatencyBucketNum> latency_buckets{};
+  uint64_t cache_overwrites = 0;
+  uint64_t queue_depth_max = 0;
+  uint64_t shm_read_failures = 0;
+  uint64_t wakeups = 0;
+  uint64_t wakeup_lag_sum_us = 0;
+  uint64_t wakeup_lag_max_us = 0;
+
+  void Merge(const ChannelStatsRecord& record);
+  // upper bound of the bucket holding the percentile, 0 without samples
+  uint64_t LatencyPercentileUs(double percentile) const;
+};
+
+class ChannelStats {
+ public:
+  virtual ~ChannelStats();
+
+  // writer side
+  void OnPublish(uint64_t channel_id);
+  void OnShmWriteFailure(uint64_t channel_id);
+  void OnShmLap(uint64_t channel_id);
+  void OnShmContention(uint64_t channel_id);
+
+  /**
+   * @brief Reader side, a message is handed to the reader queues of the
+   * process. OnCallback on the same message samples the latency from its
+   * publish until a reader callback or a component fetches it, TraceId
+   * returns its trace id, 0 once the slot went to a newer message.
+   */
+  void OnDispatch(uint64_t channel_id, const void* msg, uint64_t send_time_ns,
+                  uint64_t trace_id = 0);
+  void OnCallback(uint64_t channel_id, const void* msg);
+  uint64_t TraceId(uint64_t channel_id, const void* msg);
+  void OnCacheFill(uint64_t channel_id, bool overwritten, uint64_t depth);
+  void OnShmRead(uint64_t channel_id, uint64_t send_time_ns);
+  void OnShmReadFailure(uint64_t channel_id);
+
+  /**
+   * @brief The channels of all processes on this host, processes that exited
+   * are skipped and their objects removed.
+   */
+  static bool ReadAll(std::vector<ChannelStatsSnapshot>* snapshots);
+
+  // removes the object of this process, the records stay mapped for late
+  // updates until the process exits
+  void Shutdown();
+
+  static std::string GetName(int pid);
+
+ private:
+  static const uint32_t kMaxChannelNum;
+  static const uint32_t kSendTimeSlotNum = 64;
+
+  struct SendTimeSlot {
+    std::atomic<const void*> msg = {nullptr};
+    std::atomic<uint64_t> send_time_ns = {0};
+    std::atomic<uint64_t> trace_id = {0};
+  };
+
+  // per channel state of this process, never freed while it runs
+  struct Entry {
+    ChannelStatsRecord* record = nullptr;
+    // the record when the shared memory object is full or failed
+    std::unique_ptr<ChannelStatsRecord> local_record;
+    // send times and trace ids of the latest dispatched messages, by message
+    // address
+    std::array<SendTimeSlot, kSendTimeSlotNum> send_times;
+    std::vector<std::unique_ptr<::bvar::PassiveStatus<uint64_t>>> vars;
+    std::unique_ptr<::bvar::LatencyRecorder> latency;
+  };
+
+  Entry* GetEntry(uint64_t channel_id);
+  static bool LoadSlot(Entry* entry, const void* msg, uint64_t* send_time_ns,
+                       uint64_t* trace_id);
+  bool OpenShm();
+  void Expose(Entry* entry, const std::string& channel_name);
+  static void UpdateMax(std::atomic<uint64_t>* max, uint64_t value);
+  static uint64_t LoadCounter(void* counter);
+
+  std::mutex mutex_;
+  base::AtomicHashMap<uint64_t, Entry*, 1024> entries_;
+  std::vector<std::unique_ptr<Entry>> owned_entries_;
+  bool shm_opened_ = false;
+  ChannelStatsRecord* records_ = nullptr;
+  uint32_t record_num_ = 0;
+  std::size_t mapped_size_ = 0;
+
+  DECLARE_SINGLETON(ChannelStats)
+};
+
+}  // namespace statistics
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_STATISTICS_CHANNEL_STATS_H_
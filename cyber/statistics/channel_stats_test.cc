@@ -0,0 +1,97 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/statistics/channel_stats.h"
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cyber/time/time.h"
+
+namespace apollo {
+namespace cyber {
+namespace statistics {
+
+const ChannelStatsSnapshot* Find(
+    const std::vector<ChannelStatsSnapshot>& snapshots, uint64_t channel_id) {
+  for (auto& snapshot : snapshots) {
+    if (snapshot.channel_id == channel_id) {
+      return &snapshot;
+    }
+  }
+  return nullptr;
+}
+
+TEST(ChannelStatsTest, read_all) {
+  auto stats = ChannelStats::Instance();
+  const uint64_t channel_id = 0x5a5a0001;
+
+  stats->OnPublish(channel_id);
+  stats->OnPublish(channel_id);
+  stats->OnShmLap(channel_id);
+  stats->OnShmContention(channel_id);
+  stats->OnShmWriteFailure(channel_id);
+  stats->OnShmReadFailure(channel_id);
+  stats->OnCacheFill(channel_id, false, 3);
+  stats->OnCacheFill(channel_id, true, 2);
+
+  auto msg = std::make_shared<int>(1);
+  uint64_t send_time_ns = Time::Now().ToNanosecond() - 5000000;
+  stats->OnDispatch(channel_id, msg.get(), send_time_ns, 42);
+  stats->OnShmRead(channel_id, send_time_ns);
+  stats->OnCallback(channel_id, msg.get());
+  EXPECT_EQ(42, stats->TraceId(channel_id, msg.get()));
+  // never dispatched, no latency to sample
+  auto other_msg = std::make_shared<int>(2);
+  stats->OnCallback(channel_id, other_msg.get());
+  EXPECT_EQ(0, stats->TraceId(channel_id, other_msg.get()));
+
+  std::vector<ChannelStatsSnapshot> snapshots;
+  ASSERT_TRUE(ChannelStats::ReadAll(&snapshots));
+  auto snapshot = Find(snapshots, channel_id);
+  ASSERT_NE(snapshot, nullptr);
+  EXPECT_EQ(snapshot->channel_name, std::to_string(channel_id));
+  EXPECT_EQ(snapshot->process_num, 1);
+  EXPECT_EQ(snapshot->published, 2);
+  EXPECT_EQ(snapshot->shm_laps, 1);
+  EXPECT_EQ(snapshot->shm_contended_blocks, 1);
+  EXPECT_EQ(snapshot->shm_write_failures, 1);
+  EXPECT_EQ(snapshot->shm_read_failures, 1);
+  EXPECT_EQ(snapshot->cache_overwrites, 1);
+  EXPECT_EQ(snapshot->queue_depth_max, 3);
+  EXPECT_EQ(snapshot->wakeups, 1);
+  EXPECT_GE(snapshot->wakeup_lag_max_us, 5000);
+  EXPECT_EQ(snapshot->delivered, 1);
+  EXPECT_GE(snapshot->latency_max_us, 5000);
+  EXPECT_GE(snapshot->LatencyPercentileUs(0.5), 5000);
+}
+
+TEST(ChannelStatsTest, percentile) {
+  ChannelStatsSnapshot snapshot;
+  EXPECT_EQ(snapshot.LatencyPercentileUs(0.99), 0);
+  // 90 samples below 8 us, 10 below 1024 us
+  snapshot.latency_buckets[3] = 90;
+  snapshot.latency_buckets[10] = 10;
+  EXPECT_EQ(snapshot.LatencyPercentileUs(0.5), 8);
+  EXPECT_EQ(snapshot.LatencyPercentileUs(0.9), 8);
+  EXPECT_EQ(snapshot.LatencyPercentileUs(0.99), 1024);
+}
+
+}  // namespace statistics
+}  // namespace cyber
+}  // namespace apollo
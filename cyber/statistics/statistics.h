@@ -73,6 +73,15 @@ class Statistics {
     return std::make_shared<::bvar::Adder<SampleT>>(expose_name);
   }
 
+  template <typename SampleT>
+  std::shared_ptr<::bvar::Status<SampleT>> CreateStatus(
+                        const proto::RoleAttributes& role_attr,
+                        const std::string& suffix) {
+    std::string expose_name = role_attr.node_name() + "-" +
+      role_attr.channel_name() + "-" + suffix;
+    return std::make_shared<::bvar::Status<SampleT>>(expose_name, 0);
+  }
+
   template <typename SampleT>
   bool SamplingProcLatency(
         const proto::RoleAttributes& role_attr, SampleT sample) {
@@ -17,9 +17,13 @@
 #ifndef CYBER_TASK_TASK_H_
 #define CYBER_TASK_TASK_H_
 
+#include <cstddef>
 #include <future>
 #include <utility>
 
+#include "cyber/base/work_stealing_executor.h"
+#include "cyber/common/global_data.h"
+#include "cyber/croutine/croutine.h"
 #include "cyber/task/task_manager.h"
 
 namespace apollo {
@@ -38,6 +42,31 @@ static auto Async(F&& f, Args&&... args)
                    std::bind(std::forward<F>(f), std::forward<Args>(args)...));
 }
 
+using base::TaskGroup;
+
+/**
+ * @brief The executor for ParallelFor, ParallelReduce and TaskGroup. It is
+ * separate from the one Async runs on, which also carries long running
+ * loops, and it lives until process exit.
+ */
+static inline base::WorkStealingExecutor* ParallelExecutor() {
+  return base::WorkStealingExecutor::Default();
+}
+
+template <typename F>
+static void ParallelFor(std::size_t begin, std::size_t end, const F& func,
+                        std::size_t grain = 0) {
+  ParallelExecutor()->ParallelFor(begin, end, func, grain);
+}
+
+template <typename T, typename Map, typename Reduce>
+static T ParallelReduce(std::size_t begin, std::size_t end, const T& identity,
+                        const Map& map, const Reduce& reduce,
+                        std::size_t grain = 0) {
+  return ParallelExecutor()->ParallelReduce(begin, end, identity, map, reduce,
+                                            grain);
+}
+
 static inline void Yield() {
   if (croutine::CRoutine::GetCurrentRoutine()) {
     croutine::CRoutine::Yield();
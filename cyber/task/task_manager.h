@@ -25,8 +25,10 @@
 #include <utility>
 #include <vector>
 
-#include "cyber/base/bounded_queue.h"
-#include "cyber/scheduler/scheduler_factory.h"
+#include "cyber/base/atomic_rw_lock.h"
+#include "cyber/base/rw_lock_guard.h"
+#include "cyber/base/work_stealing_executor.h"
+#include "cyber/common/macros.h"
 
 namespace apollo {
 namespace cyber {
@@ -41,24 +43,22 @@ class TaskManager {
   auto Enqueue(F&& func, Args&&... args)
       -> std::future<typename std::result_of<F(Args...)>::type> {
     using return_type = typename std::result_of<F(Args...)>::type;
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
-        std::bind(std::forward<F>(func), std::forward<Args>(args)...));
-    if (!stop_.load()) {
-      task_queue_->Enqueue([task]() { (*task)(); });
-      for (auto& task : tasks_) {
-        scheduler::Instance()->NotifyTask(task);
-      }
+    base::ReadLockGuard<base::AtomicRWLock> lock(executor_lock_);
+    if (stop_.load() || executor_ == nullptr) {
+      // never runs, the future reports a broken promise
+      std::packaged_task<return_type()> task(
+          std::bind(std::forward<F>(func), std::forward<Args>(args)...));
+      return task.get_future();
     }
-    std::future<return_type> res(task->get_future());
-    return res;
+    return executor_->Submit(std::forward<F>(func),
+                             std::forward<Args>(args)...);
   }
 
  private:
   uint32_t num_threads_ = 0;
-  uint32_t task_queue_size_ = 1000;
   std::atomic<bool> stop_ = {false};
-  std::vector<uint64_t> tasks_;
-  std::shared_ptr<base::BoundedQueue<std::function<void()>>> task_queue_;
+  base::AtomicRWLock executor_lock_;
+  std::unique_ptr<base::WorkStealingExecutor> executor_;
   DECLARE_SINGLETON(TaskManager);
 };
 
@@ -0,0 +1,251 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/timer/precise_timing_wheel.h"
+
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "cyber/common/log.h"
+#include "cyber/scheduler/scheduler_factory.h"
+#include "cyber/time/time.h"
+
+namespace apollo {
+namespace cyber {
+
+PreciseTimingWheel::PreciseTimingWheel() {
+  const char* env = std::getenv("CYBER_TIMER_RESOLUTION_US");
+  if (env != nullptr) {
+    uint64_t resolution_us = std::strtoull(env, nullptr, 10);
+    if (resolution_us < PRECISE_TIMER_MIN_RESOLUTION_US) {
+      AWARN << "timer resolution " << resolution_us << "us is below "
+            << PRECISE_TIMER_MIN_RESOLUTION_US << "us, use the minimum";
+      resolution_us = PRECISE_TIMER_MIN_RESOLUTION_US;
+    }
+    resolution_ns_ = resolution_us * 1000;
+  }
+}
+
+PreciseTimingWheel::~PreciseTimingWheel() { Shutdown(); }
+
+void PreciseTimingWheel::Start() {
+  std::lock_guard<std::mutex> lock(running_mutex_);
+  if (running_) {
+    return;
+  }
+
+  timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+  if (timer_fd_ < 0) {
+    AERROR << "timerfd_create failed: " << std::strerror(errno);
+    return;
+  }
+  start_ns_ = Time::MonoTime().ToNanosecond();
+  uint64_t first_ns = start_ns_ + resolution_ns_;
+  struct itimerspec spec;
+  spec.it_value.tv_sec = first_ns / 1000000000;
+  spec.it_value.tv_nsec = first_ns % 1000000000;
+  spec.it_interval.tv_sec = resolution_ns_ / 1000000000;
+  spec.it_interval.tv_nsec = resolution_ns_ % 1000000000;
+  if (timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr) != 0) {
+    AERROR << "timerfd_settime failed: " << std::strerror(errno);
+    close(timer_fd_);
+    timer_fd_ = -1;
+    return;
+  }
+
+  current_tick_ = 0;
+  running_ = true;
+  tick_thread_ = std::thread([this]() { this->TickFunc(); });
+  scheduler::Instance()->SetInnerThreadAttr("timer", &tick_thread_);
+  AINFO << "precise timing wheel start, resolution: " << resolution_ns_ / 1000
+        << "us";
+}
+
+void PreciseTimingWheel::Shutdown() {
+  std::lock_guard<std::mutex> lock(running_mutex_);
+  if (!running_) {
+    return;
+  }
+  // the tick thread wakes up within one resolution
+  running_ = false;
+  if (tick_thread_.joinable()) {
+    tick_thread_.join();
+  }
+  close(timer_fd_);
+  timer_fd_ = -1;
+
+  Release(pending_.exchange(nullptr));
+  for (auto& level : slots_) {
+    for (auto& slot : level) {
+      Release(slot);
+      slot = nullptr;
+    }
+  }
+}
+
+void PreciseTimingWheel::AddTask(
+    const std::shared_ptr<PreciseTimerTask>& task) {
+  if (!running_) {
+    Start();
+  }
+  task->self = task;
+  auto head = pending_.load(std::memory_order_relaxed);
+  do {
+    task->next = head;
+  } while (!pending_.compare_exchange_weak(head, task.get(),
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed));
+}
+
+void PreciseTimingWheel::TickFunc() {
+  while (running_) {
+    uint64_t expirations = 0;
+    auto ret = read(timer_fd_, &expirations, sizeof(expirations));
+    if (ret != sizeof(expirations)) {
+      if (errno != EINTR) {
+        AERROR << "read timerfd failed: " << std::strerror(errno);
+      }
+      continue;
+    }
+    // catch up on the ticks we slept through, one by one
+    if (expirations > 1) {
+      overrun_count_.fetch_add(expirations - 1);
+    }
+    for (uint64_t i = 0; i < expirations; ++i) {
+      ++current_tick_;
+      Tick();
+      tick_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+}
+
+void PreciseTimingWheel::Tick() {
+  // from the top, so tasks moving down can land in a slot cascaded next
+  for (int level = kLevelNum - 1; level > 0; --level) {
+    uint64_t span_mask = (uint64_t(1) << (kSlotBits * level)) - 1;
+    if ((current_tick_ & span_mask) == 0) {
+      Cascade(level);
+    }
+  }
+  DrainPending();
+
+  auto& slot = slots_[0][current_tick_ & kSlotMask];
+  auto task = slot;
+  slot = nullptr;
+  const uint64_t tick_ns = start_ns_ + current_tick_ * resolution_ns_;
+  while (task != nullptr) {
+    auto next = task->next;
+    if (task->cancelled.load(std::memory_order_relaxed)) {
+      task->next = nullptr;
+      Release(task);
+    } else if (task->expire_tick > current_tick_) {
+      Place(task);
+    } else {
+      task->notify();
+      if (task->period_ns == 0) {
+        task->next = nullptr;
+        Release(task);
+      } else {
+        // fixed rate, periods missed while the thread was late are skipped
+        do {
+          task->expire_ns += task->period_ns;
+        } while (task->expire_ns <= tick_ns);
+        Place(task);
+      }
+    }
+    task = next;
+  }
+}
+
+void PreciseTimingWheel::DrainPending() {
+  auto task = pending_.exchange(nullptr, std::memory_order_acquire);
+  while (task != nullptr) {
+    auto next = task->next;
+    if (task->cancelled.load(std::memory_order_relaxed)) {
+      task->next = nullptr;
+      Release(task);
+    } else {
+      Place(task);
+    }
+    task = next;
+  }
+}
+
+void PreciseTimingWheel::Cascade(int level) {
+  auto& slot =
+      slots_[level][(current_tick_ >> (kSlotBits * level)) & kSlotMask];
+  auto task = slot;
+  slot = nullptr;
+  while (task != nullptr) {
+    auto next = task->next;
+    if (task->cancelled.load(std::memory_order_relaxed)) {
+      task->next = nullptr;
+      Release(task);
+    } else {
+      Place(task);
+    }
+    task = next;
+  }
+}
+
+void PreciseTimingWheel::Place(PreciseTimerTask* task) {
+  if (task->expire_ns <= start_ns_) {
+    task->expire_tick = 0;
+  } else {
+    task->expire_tick =
+        (task->expire_ns - start_ns_ + resolution_ns_ - 1) / resolution_ns_;
+  }
+
+  uint64_t tick = task->expire_tick;
+  int level = 0;
+  if (tick <= current_tick_) {
+    // already due, fire in the current tick
+    tick = current_tick_;
+  } else {
+    uint64_t delta = tick - current_tick_;
+    while (level < kLevelNum - 1 &&
+           delta >= (uint64_t(1) << (kSlotBits * (level + 1)))) {
+      ++level;
+    }
+    // beyond the top level, park at its far end and place again later
+    uint64_t max_delta = (uint64_t(1) << (kSlotBits * kLevelNum)) - 1;
+    if (delta > max_delta) {
+      tick = current_tick_ + max_delta;
+    }
+  }
+
+  auto& slot = slots_[level][(tick >> (kSlotBits * level)) & kSlotMask];
+  task->next = slot;
+  slot = task;
+}
+
+void PreciseTimingWheel::Release(PreciseTimerTask* list) {
+  while (list != nullptr) {
+    auto next = list->next;
+    list->next = nullptr;
+    // may be the last reference
+    auto self = std::move(list->self);
+    list = next;
+  }
+}
+
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,113 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TIMER_PRECISE_TIMING_WHEEL_H_
+#define CYBER_TIMER_PRECISE_TIMING_WHEEL_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "cyber/common/macros.h"
+
+namespace apollo {
+namespace cyber {
+
+static const uint64_t PRECISE_TIMER_MIN_RESOLUTION_US = 100;
+static const uint64_t PRECISE_TIMER_DEFAULT_RESOLUTION_US = 1000;
+
+struct PreciseTimerTask {
+  explicit PreciseTimerTask(uint64_t timer_id) : timer_id_(timer_id) {}
+
+  uint64_t timer_id_ = 0;
+  // runs on the tick thread, must only hand the work over
+  std::function<void()> notify;
+  // CLOCK_MONOTONIC, advanced by period_ns on every fire so that late ticks
+  // do not accumulate into drift
+  uint64_t expire_ns = 0;
+  // 0 for oneshot
+  uint64_t period_ns = 0;
+  std::atomic<bool> cancelled = {false};
+
+  // owned by the wheel while the task is queued
+  uint64_t expire_tick = 0;
+  PreciseTimerTask* next = nullptr;
+  std::shared_ptr<PreciseTimerTask> self;
+};
+
+/**
+ * Four level hierarchical timing wheel of 256 slots per level, driven by a
+ * periodic timerfd. The resolution comes from CYBER_TIMER_RESOLUTION_US,
+ * 1ms by default and 100us at best; levels span 256, 256^2, ... ticks.
+ *
+ * AddTask is a single CAS onto a lock-free pending stack, the tick thread
+ * moves pending tasks into their slot, so slots are only ever touched by one
+ * thread. Expired tasks call their notify and nothing else: the callback
+ * itself runs wherever notify sends it, never on the tick thread.
+ */
+class PreciseTimingWheel {
+ public:
+  ~PreciseTimingWheel();
+
+  void Start();
+  void Shutdown();
+
+  void AddTask(const std::shared_ptr<PreciseTimerTask>& task);
+
+  uint64_t ResolutionNs() const { return resolution_ns_; }
+  uint64_t TickCount() const { return tick_count_.load(); }
+  // ticks that were processed later than one resolution after they were due
+  uint64_t OverrunCount() const { return overrun_count_.load(); }
+
+ private:
+  static const int kLevelNum = 4;
+  static const int kSlotBits = 8;
+  static const uint64_t kSlotNum = 1 << kSlotBits;
+  static const uint64_t kSlotMask = kSlotNum - 1;
+
+  void TickFunc();
+  void Tick();
+  void DrainPending();
+  void Cascade(int level);
+  void Place(PreciseTimerTask* task);
+  void Release(PreciseTimerTask* list);
+
+  uint64_t resolution_ns_ = PRECISE_TIMER_DEFAULT_RESOLUTION_US * 1000;
+  // CLOCK_MONOTONIC time of tick 0
+  uint64_t start_ns_ = 0;
+  // the tick being processed, only the tick thread moves it
+  uint64_t current_tick_ = 0;
+  std::atomic<uint64_t> tick_count_ = {0};
+  std::atomic<uint64_t> overrun_count_ = {0};
+
+  std::atomic<PreciseTimerTask*> pending_ = {nullptr};
+  PreciseTimerTask* slots_[kLevelNum][kSlotNum] = {};
+
+  int timer_fd_ = -1;
+  std::atomic<bool> running_ = {false};
+  std::mutex running_mutex_;
+  std::thread tick_thread_;
+
+  DECLARE_SINGLETON(PreciseTimingWheel)
+};
+
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TIMER_PRECISE_TIMING_WHEEL_H_
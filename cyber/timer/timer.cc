@@ -17,8 +17,12 @@
 #include "cyber/timer/timer.h"
 
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
 
 #include "cyber/common/global_data.h"
+#include "cyber/croutine/croutine.h"
+#include "cyber/scheduler/scheduler_factory.h"
 
 namespace apollo {
 namespace cyber {
@@ -126,13 +130,72 @@ bool Timer::InitTimerTask() {
   return true;
 }
 
+bool Timer::UsePreciseWheel() const {
+  if (timer_opt_.period_us > 0) {
+    return true;
+  }
+  const char* backend = std::getenv("CYBER_TIMER_BACKEND");
+  return backend != nullptr && std::strcmp(backend, "precise") == 0;
+}
+
+bool Timer::StartPrecise() {
+  uint64_t period_ns = timer_opt_.period_us > 0
+                           ? timer_opt_.period_us * 1000
+                           : static_cast<uint64_t>(timer_opt_.period) * 1000000;
+  if (period_ns == 0) {
+    AERROR << "Max interval must great than 0";
+    return false;
+  }
+  auto wheel = PreciseTimingWheel::Instance();
+  if (period_ns < wheel->ResolutionNs()) {
+    AWARN << "timer [" << timer_id_ << "] period " << period_ns / 1000
+          << "us is shorter than the timer resolution "
+          << wheel->ResolutionNs() / 1000 << "us";
+  }
+
+  auto task = std::make_shared<PreciseTimerTask>(timer_id_);
+  task_name_ = "timer_" + std::to_string(timer_id_);
+  auto func = [callback = timer_opt_.callback, task]() {
+    for (;;) {
+      croutine::CRoutine::Yield(croutine::RoutineState::DATA_WAIT);
+      if (task->cancelled.load()) {
+        return;
+      }
+      callback();
+    }
+  };
+  if (!scheduler::Instance()->CreateTask(std::move(func), task_name_)) {
+    AERROR << "create croutine for timer [" << timer_id_ << "] failed";
+    return false;
+  }
+
+  auto crid = common::GlobalData::GenerateHashId(task_name_);
+  task->notify = [crid]() { scheduler::Instance()->NotifyTask(crid); };
+  task->period_ns = timer_opt_.oneshot ? 0 : period_ns;
+  task->expire_ns = Time::MonoTime().ToNanosecond() + period_ns;
+  precise_task_ = task;
+  wheel->AddTask(task);
+  return true;
+}
+
+void Timer::StopPrecise() {
+  precise_task_->cancelled = true;
+  // waits for a callback in flight
+  scheduler::Instance()->RemoveTask(task_name_);
+  precise_task_.reset();
+}
+
 void Timer::Start() {
   if (!common::GlobalData::Instance()->IsRealityMode()) {
     return;
   }
 
   if (!started_.exchange(true)) {
-    if (InitTimerTask()) {
+    if (UsePreciseWheel()) {
+      if (StartPrecise()) {
+        AINFO << "start precise timer [" << timer_id_ << "]";
+      }
+    } else if (InitTimerTask()) {
       timing_wheel_->AddTask(task_);
       AINFO << "start timer [" << task_->timer_id_ << "]";
     }
@@ -140,7 +203,14 @@ void Timer::Start() {
 }
 
 void Timer::Stop() {
-  if (started_.exchange(false) && task_) {
+  if (!started_.exchange(false)) {
+    return;
+  }
+  if (precise_task_) {
+    AINFO << "stop precise timer, the timer_id: " << timer_id_;
+    StopPrecise();
+  }
+  if (task_) {
     AINFO << "stop timer, the timer_id: " << timer_id_;
     // using a shared pointer to hold task_->mutex before task_ reset
     auto tmp_task = task_;
@@ -152,7 +222,7 @@ void Timer::Stop() {
 }
 
 Timer::~Timer() {
-  if (task_) {
+  if (task_ || precise_task_) {
     Stop();
   }
 }
@@ -19,7 +19,9 @@
 
 #include <atomic>
 #include <memory>
+#include <string>
 
+#include "cyber/timer/precise_timing_wheel.h"
 #include "cyber/timer/timing_wheel.h"
 
 namespace apollo {
@@ -61,12 +63,22 @@ struct TimerOption {
    * False: perform the callback every timed period
    */
   bool oneshot;
+
+  /**
+   * @brief The period of the timer, unit is us. Takes precedence over period
+   * when not 0 and runs the timer on the precise timing wheel.
+   * min: the precise timer resolution, CYBER_TIMER_RESOLUTION_US
+   */
+  uint64_t period_us = 0;
 };
 
 /**
  * @class Timer
  * @brief Used to perform oneshot or periodic timing tasks
  *
+ * Timers with period_us, or all timers when CYBER_TIMER_BACKEND=precise, run
+ * on the PreciseTimingWheel. Each of them owns a croutine the wheel wakes up
+ * through the scheduler; the callback must not Stop its own timer.
  */
 class Timer {
  public:
@@ -111,10 +123,16 @@ class Timer {
 
  private:
   bool InitTimerTask();
+  bool UsePreciseWheel() const;
+  bool StartPrecise();
+  void StopPrecise();
+
   uint64_t timer_id_;
   TimerOption timer_opt_;
   TimingWheel* timing_wheel_ = nullptr;
   std::shared_ptr<TimerTask> task_;
+  std::shared_ptr<PreciseTimerTask> precise_task_;
+  std::string task_name_;
   std::atomic<bool> started_ = {false};
 };
 
@@ -18,8 +18,16 @@
 
 #include "cyber/timer/timer.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -34,6 +42,57 @@ namespace timer {
 using cyber::Timer;
 using cyber::TimerOption;
 
+namespace {
+
+struct Jitter {
+  size_t samples = 0;
+  double mean_us = 0;
+  double p99_us = 0;
+  double max_us = 0;
+};
+
+// period error of the callbacks fired by opt over the duration
+Jitter MeasureJitter(TimerOption opt, uint64_t period_ns,
+                     std::chrono::milliseconds duration) {
+  std::mutex mutex;
+  std::vector<uint64_t> stamps;
+  stamps.reserve(2 * duration.count() * 1000000 / period_ns + 16);
+  opt.callback = [&mutex, &stamps] {
+    std::lock_guard<std::mutex> lg(mutex);
+    stamps.emplace_back(Time::MonoTime().ToNanosecond());
+  };
+  Timer timer(opt);
+  timer.Start();
+  std::this_thread::sleep_for(duration);
+  timer.Stop();
+
+  std::vector<double> errors;
+  for (size_t i = 1; i < stamps.size(); ++i) {
+    double interval = static_cast<double>(stamps[i] - stamps[i - 1]);
+    errors.emplace_back(std::abs(interval - period_ns) / 1000.0);
+  }
+  Jitter jitter;
+  jitter.samples = errors.size();
+  if (errors.empty()) {
+    return jitter;
+  }
+  std::sort(errors.begin(), errors.end());
+  for (auto error : errors) {
+    jitter.mean_us += error / errors.size();
+  }
+  jitter.p99_us = errors[errors.size() * 99 / 100];
+  jitter.max_us = errors.back();
+  return jitter;
+}
+
+void PrintJitter(const std::string& name, const Jitter& jitter) {
+  std::cout << name << ": " << jitter.samples << " periods, mean "
+            << jitter.mean_us << "us, p99 " << jitter.p99_us << "us, max "
+            << jitter.max_us << "us" << std::endl;
+}
+
+}  // namespace
+
 TEST(TimerTest, one_shot) {
   int count = 0;
   Timer timer(
@@ -97,12 +156,62 @@ TEST(TimerTest, sim_mode) {
   }
 }
 
+TEST(TimerTest, precise_one_shot) {
+  std::atomic<int> count = {0};
+  TimerOption opt(0, [&count] { count++; }, true);
+  opt.period_us = 50000;
+  Timer timer(opt);
+  timer.Start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(40));
+  EXPECT_EQ(0, count.load());
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  EXPECT_EQ(1, count.load());
+  timer.Stop();
+}
+
+TEST(TimerTest, precise_start_stop) {
+  std::atomic<int> count = {0};
+  TimerOption opt(0, [&count] { count++; }, false);
+  opt.period_us = 500;
+  Timer timer(opt);
+  for (int i = 0; i < 20; i++) {
+    timer.Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    timer.Stop();
+  }
+  // no callback after Stop
+  auto stopped = count.load();
+  EXPECT_GT(stopped, 0);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(stopped, count.load());
+}
+
+// 100Hz, the usual control loop rate, on both backends
+TEST(TimerTest, jitter_benchmark) {
+  const uint64_t period_ns = 10000000;
+  const auto duration = std::chrono::seconds(2);
+
+  TimerOption wheel_opt(10, nullptr, false);
+  auto wheel = MeasureJitter(wheel_opt, period_ns, duration);
+  PrintJitter("timing wheel", wheel);
+
+  TimerOption precise_opt(0, nullptr, false);
+  precise_opt.period_us = period_ns / 1000;
+  auto precise = MeasureJitter(precise_opt, period_ns, duration);
+  PrintJitter("precise timing wheel", precise);
+
+  EXPECT_GT(wheel.samples, 100);
+  EXPECT_GT(precise.samples, 100);
+}
+
 }  // namespace timer
 }  // namespace cyber
 }  // namespace apollo
 
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
+  // the finest resolution the precise timing wheel supports
+  setenv("CYBER_TIMER_RESOLUTION_US", "100", 0);
   apollo::cyber::Init(argv[0]);
   return RUN_ALL_TESTS();
 }
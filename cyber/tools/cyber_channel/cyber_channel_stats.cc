@@ -0,0 +1,83 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "cyber/statistics/channel_stats.h"
+
+using apollo::cyber::statistics::ChannelStats;
+using apollo::cyber::statistics::ChannelStatsSnapshot;
+
+void DisplayUsage(const std::string& binary) {
+  std::cout << "usage: " << binary << " [channel ...]\n"
+            << "Show the transport statistics of the channels of all cyber "
+               "processes on this host.\n"
+            << std::endl;
+}
+
+uint64_t Average(uint64_t sum, uint64_t num) { return num > 0 ? sum / num : 0; }
+
+int main(int argc, char** argv) {
+  std::set<std::string> channels;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg(argv[i]);
+    if (arg == "-h" || arg == "--help") {
+      DisplayUsage(argv[0]);
+      return 0;
+    }
+    channels.insert(arg);
+  }
+
+  std::vector<ChannelStatsSnapshot> snapshots;
+  if (!ChannelStats::ReadAll(&snapshots)) {
+    return -1;
+  }
+
+  std::cout << std::left << std::setw(40) << "channel" << std::right
+            << std::setw(6) << "procs" << std::setw(12) << "published"
+            << std::setw(12) << "delivered" << std::setw(10) << "p50(us)"
+            << std::setw(10) << "p99(us)" << std::setw(10) << "max(us)"
+            << std::setw(11) << "overwrite" << std::setw(8) << "queue"
+            << std::setw(10) << "shm_laps" << std::setw(10) << "contended"
+            << std::setw(10) << "w_fail" << std::setw(10) << "r_fail"
+            << std::setw(12) << "wakeup(us)" << std::setw(12) << "wake_max"
+            << std::endl;
+  for (auto& snapshot : snapshots) {
+    if (!channels.empty() && channels.count(snapshot.channel_name) == 0) {
+      continue;
+    }
+    std::cout << std::left << std::setw(40) << snapshot.channel_name
+              << std::right << std::setw(6) << snapshot.process_num
+              << std::setw(12) << snapshot.published << std::setw(12)
+              << snapshot.delivered << std::setw(10)
+              << snapshot.LatencyPercentileUs(0.5) << std::setw(10)
+              << snapshot.LatencyPercentileUs(0.99) << std::setw(10)
+              << snapshot.latency_max_us << std::setw(11)
+              << snapshot.cache_overwrites << std::setw(8)
+              << snapshot.queue_depth_max << std::setw(10)
+              << snapshot.shm_laps << std::setw(10)
+              << snapshot.shm_contended_blocks << std::setw(10)
+              << snapshot.shm_write_failures << std::setw(10)
+              << snapshot.shm_read_failures << std::setw(12)
+              << Average(snapshot.wakeup_lag_sum_us, snapshot.wakeups)
+              << std::setw(12) << snapshot.wakeup_lag_max_us << std::endl;
+  }
+  return 0;
+}
@@ -16,6 +16,7 @@
 
 #include "cyber/tools/cyber_recorder/info.h"
 
+#include "cyber/record/file/compression.h"
 #include "cyber/record/record_message.h"
 
 namespace apollo {
@@ -95,9 +96,40 @@ bool Info::Display(const std::string& file) {
     return false;
   }
 
+  proto::Index idx = file_reader.GetIndex();
+
+  // compress type and ratio of chunk bodies
+  std::cout << std::setw(w) << "compress: "
+            << CompressTypeName(hdr.compress());
+  if (hdr.compress() != proto::CompressType::COMPRESS_NONE) {
+    uint64_t stored_size = 0;
+    uint64_t raw_size = 0;
+    for (int i = 0; i < idx.indexes_size(); ++i) {
+      if (idx.indexes(i).type() != proto::SectionType::SECTION_CHUNK_BODY) {
+        continue;
+      }
+      uint64_t chunk_stored_size = 0;
+      uint64_t chunk_raw_size = 0;
+      if (!file_reader.ReadChunkBodySize(idx.indexes(i).position(),
+                                         &chunk_stored_size,
+                                         &chunk_raw_size)) {
+        AERROR << "read chunk body size fail. file: " << file;
+        return false;
+      }
+      stored_size += chunk_stored_size;
+      raw_size += chunk_raw_size;
+    }
+    if (stored_size > 0) {
+      std::cout << " (ratio "
+                << static_cast<double>(raw_size) /
+                       static_cast<double>(stored_size)
+                << ", " << raw_size << " -> " << stored_size << " Bytes)";
+    }
+  }
+  std::cout << std::endl;
+
   // channel info
   std::cout << std::setw(w) << "channel_info: " << std::endl;
-  proto::Index idx = file_reader.GetIndex();
   for (int i = 0; i < idx.indexes_size(); ++i) {
     ChannelCache* cache = idx.mutable_indexes(i)->mutable_channel_cache();
     if (idx.mutable_indexes(i)->type() == proto::SectionType::SECTION_CHANNEL) {
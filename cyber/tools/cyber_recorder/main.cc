@@ -25,6 +25,7 @@
 #include "cyber/common/file.h"
 #include "cyber/common/time_conversion.h"
 #include "cyber/init.h"
+#include "cyber/record/file/compression.h"
 #include "cyber/tools/cyber_recorder/info.h"
 #include "cyber/tools/cyber_recorder/player/player.h"
 #include "cyber/tools/cyber_recorder/recorder.h"
@@ -38,6 +39,7 @@
 using apollo::cyber::common::GetFileName;
 using apollo::cyber::common::StringToUnixSeconds;
 using apollo::cyber::common::UnixSecondsToString;
+using apollo::cyber::record::ParseCompressType;
 using apollo::cyber::record::HeaderBuilder;
 using apollo::cyber::record::Info;
 using apollo::cyber::record::Player;
@@ -47,8 +49,8 @@ using apollo::cyber::record::Recoverer;
 using apollo::cyber::record::Spliter;
 
 const char INFO_OPTIONS[] = "h";
-const char RECORD_OPTIONS[] = "o:ac:k:i:m:hCH";
-const char PLAY_OPTIONS[] = "f:ac:k:lr:b:e:s:d:p:h";
+const char RECORD_OPTIONS[] = "o:ac:k:i:m:z:hCH";
+const char PLAY_OPTIONS[] = "f:ac:k:lr:xb:e:s:d:p:P:h";
 const char SPLIT_OPTIONS[] = "f:o:c:k:b:e:h";
 const char RECOVER_OPTIONS[] = "f:o:h";
 
@@ -122,6 +124,10 @@ void DisplayUsage(const std::string& binary, const std::string& command,
         std::cout << "\t-r, --rate <1.0>\t\t\tmultiply the " << command
                   << " rate by FACTOR" << std::endl;
         break;
+      case 'x':
+        std::cout << "\t-x, --max-throughput			" << command
+                  << " as fast as possible, ignoring the rate" << std::endl;
+        break;
       case 'b':
         std::cout << "\t-b, --begin 2018-07-01-00:00:00\t" << command
                   << " the record begin at" << std::endl;
@@ -142,6 +148,10 @@ void DisplayUsage(const std::string& binary, const std::string& command,
         std::cout << "\t-p, --preload <seconds>\t\t\t" << command
                   << " after trying to preload n second(s)" << std::endl;
         break;
+      case 'P':
+        std::cout << "\t-P, --prefetch <chunks>			decode n chunk(s) of "
+                  << "each file ahead on worker threads" << std::endl;
+        break;
       case 'i':
         std::cout << "\t-i, --segment-interval <seconds>\t" << command
                   << " segmented every n second(s)" << std::endl;
@@ -150,6 +160,10 @@ void DisplayUsage(const std::string& binary, const std::string& command,
         std::cout << "\t-m, --segment-size <MB>\t\t\t" << command
                   << " segmented every n megabyte(s)" << std::endl;
         break;
+      case 'z':
+        std::cout << "\t-z, --compress <none|lz4|bz2>\t\t" << command
+                  << " with compressed chunks" << std::endl;
+        break;
       case 'h':
         std::cout << "\t-h, --help\t\t\t\tshow help message" << std::endl;
         break;
@@ -182,7 +196,7 @@ int main(int argc, char** argv) {
   }
 
   int long_index = 0;
-  const std::string short_opts = "f:c:k:o:alr:b:e:s:d:p:i:m:hCH";
+  const std::string short_opts = "f:c:k:o:alr:xb:e:s:d:p:P:i:m:z:hCH";
   static const struct option long_opts[] = {
       {"files", required_argument, nullptr, 'f'},
       {"white-channel", required_argument, nullptr, 'c'},
@@ -191,13 +205,16 @@ int main(int argc, char** argv) {
       {"all", no_argument, nullptr, 'a'},
       {"loop", no_argument, nullptr, 'l'},
       {"rate", required_argument, nullptr, 'r'},
+      {"max-throughput", no_argument, nullptr, 'x'},
       {"begin", required_argument, nullptr, 'b'},
       {"end", required_argument, nullptr, 'e'},
       {"start", required_argument, nullptr, 's'},
       {"delay", required_argument, nullptr, 'd'},
       {"preload", required_argument, nullptr, 'p'},
+      {"prefetch", required_argument, nullptr, 'P'},
       {"segment-interval", required_argument, nullptr, 'i'},
       {"segment-size", required_argument, nullptr, 'm'},
+      {"compress", required_argument, nullptr, 'z'},
       {"help", no_argument, nullptr, 'h'},
       {"cpu-profile", no_argument, nullptr, 'C'},
       {"heap-profule", no_argument, nullptr, 'H'}};
@@ -211,11 +228,13 @@ int main(int argc, char** argv) {
   bool opt_all = false;
   bool opt_loop = false;
   float opt_rate = 1.0f;
+  bool opt_max_throughput = false;
   uint64_t opt_begin = 0;
   uint64_t opt_end = std::numeric_limits<uint64_t>::max();
   double opt_start = 0;
   uint64_t opt_delay = 0;
   uint32_t opt_preload = 3;
+  uint32_t opt_prefetch = 0;
   auto opt_header = HeaderBuilder::GetHeader();
 
   do {
@@ -283,6 +302,9 @@ int main(int argc, char** argv) {
           return -1;
         }
         break;
+      case 'x':
+        opt_max_throughput = true;
+        break;
       case 'b':
         opt_begin =
             StringToUnixSeconds(std::string(optarg)) * 1000 * 1000 * 1000ULL;
@@ -330,6 +352,25 @@ int main(int argc, char** argv) {
           return -1;
         }
         break;
+      case 'P':
+        try {
+          int prefetch = std::stoi(optarg);
+          if (prefetch < 0) {
+            std::cout << "Argument is less than zero: -P/--prefetch "
+                      << std::string(optarg) << std::endl;
+            return -1;
+          }
+          opt_prefetch = prefetch;
+        } catch (std::invalid_argument& ia) {
+          std::cout << "Invalid argument: -P/--prefetch "
+                    << std::string(optarg) << std::endl;
+          return -1;
+        } catch (const std::out_of_range& e) {
+          std::cout << "Argument is out of range: -P/--prefetch "
+                    << std::string(optarg) << std::endl;
+          return -1;
+        }
+        break;
       case 'i':
         try {
           int interval_s = std::stoi(optarg);
@@ -368,6 +409,16 @@ int main(int argc, char** argv) {
           return -1;
         }
         break;
+      case 'z': {
+        apollo::cyber::proto::CompressType compress_type;
+        if (!ParseCompressType(std::string(optarg), &compress_type)) {
+          std::cout << "Invalid argument: -z/--compress "
+                    << std::string(optarg) << std::endl;
+          return -1;
+        }
+        opt_header.set_compress(compress_type);
+        break;
+      }
       case 'h':
         DisplayUsage(binary, command);
         return 0;
@@ -415,11 +466,13 @@ int main(int argc, char** argv) {
     play_param.is_play_all_channels = opt_all || opt_white_channels.empty();
     play_param.is_loop_playback = opt_loop;
     play_param.play_rate = opt_rate;
+    play_param.is_max_throughput = opt_max_throughput;
     play_param.begin_time_ns = opt_begin;
     play_param.end_time_ns = opt_end;
     play_param.start_time_s = opt_start;
     play_param.delay_time_s = opt_delay;
     play_param.preload_time_s = opt_preload;
+    play_param.prefetch_chunk_num = opt_prefetch;
     play_param.files_to_play.insert(opt_file_vec.begin(), opt_file_vec.end());
     play_param.black_channels.insert(opt_black_channels.begin(),
                                      opt_black_channels.end());
@@ -30,12 +30,16 @@ struct PlayParam {
   bool is_play_all_channels = false;
   bool is_loop_playback = false;
   double play_rate = 1.0;
+  // publish as fast as the readers take it, ignoring the record timing
+  bool is_max_throughput = false;
   uint64_t begin_time_ns = 0;
   uint64_t base_begin_time_ns = 0;
   uint64_t end_time_ns = std::numeric_limits<uint64_t>::max();
   double start_time_s = 0;
   uint64_t delay_time_s = 0;
   uint32_t preload_time_s = 3;
+  // chunks each record file decodes ahead on a thread of its own, 0 for none
+  uint32_t prefetch_chunk_num = 0;
   std::set<std::string> files_to_play;
   std::set<std::string> channels_to_play;
   std::set<std::string> black_channels;
@@ -41,6 +41,9 @@ class PlayTask {
 
   uint64_t msg_real_time_ns() const { return msg_real_time_ns_; }
   uint64_t msg_play_time_ns() const { return msg_play_time_ns_; }
+  size_t msg_size() const {
+    return msg_ == nullptr ? 0 : msg_->message.size();
+  }
   static uint64_t played_msg_num() { return played_msg_num_.load(); }
 
  private:
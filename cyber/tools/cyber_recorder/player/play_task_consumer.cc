@@ -16,8 +16,9 @@
 
 #include "cyber/tools/cyber_recorder/player/play_task_consumer.h"
 
+#include <algorithm>
+
 #include "cyber/common/log.h"
-#include "cyber/time/time.h"
 
 namespace apollo {
 namespace cyber {
@@ -26,10 +27,12 @@ namespace record {
 const uint64_t PlayTaskConsumer::kPauseSleepNanoSec = 100000000UL;
 const uint64_t PlayTaskConsumer::kWaitProduceSleepNanoSec = 5000000UL;
 const uint64_t PlayTaskConsumer::MIN_SLEEP_DURATION_NS = 200000000UL;
+const uint64_t PlayTaskConsumer::kSpinWaitNanoSec = 200000UL;
 
 PlayTaskConsumer::PlayTaskConsumer(const TaskBufferPtr& task_buffer,
-                                   double play_rate)
+                                   double play_rate, bool is_max_throughput)
     : play_rate_(play_rate),
+      is_max_throughput_(is_max_throughput),
       consume_th_(nullptr),
       task_buffer_(task_buffer),
       is_stopped_(true),
@@ -37,12 +40,17 @@ PlayTaskConsumer::PlayTaskConsumer(const TaskBufferPtr& task_buffer,
       is_playonce_(false),
       base_msg_play_time_ns_(0),
       base_msg_real_time_ns_(0),
-      last_played_msg_real_time_ns_(0) {
+      last_played_msg_real_time_ns_(0),
+      played_msg_num_(0),
+      played_bytes_(0),
+      late_sum_ns_(0),
+      late_max_ns_(0) {
   if (play_rate_ <= 0) {
     AERROR << "invalid play rate: " << play_rate_
            << " , we will use default value(1.0).";
     play_rate_ = 1.0;
   }
+  late_buckets_.fill(0);
 }
 
 PlayTaskConsumer::~PlayTaskConsumer() { Stop(); }
@@ -52,6 +60,11 @@ void PlayTaskConsumer::Start(uint64_t begin_time_ns) {
     return;
   }
   begin_time_ns_ = begin_time_ns;
+  played_msg_num_ = 0;
+  played_bytes_ = 0;
+  late_sum_ns_ = 0;
+  late_max_ns_ = 0;
+  late_buckets_.fill(0);
   consume_th_.reset(new std::thread(&PlayTaskConsumer::ThreadFunc, this));
 }
 
@@ -69,9 +82,74 @@ void PlayTaskConsumer::Stop() {
   last_played_msg_real_time_ns_ = 0;
 }
 
+void PlayTaskConsumer::PrintTimingStats(std::ostream* os) const {
+  if (os == nullptr || played_msg_num_ == 0) {
+    return;
+  }
+  double duration_s =
+      std::chrono::duration<double>(last_play_time_ - first_play_time_)
+          .count();
+  double played_mb = static_cast<double>(played_bytes_) / 1e6;
+  *os << "played " << played_msg_num_ << " messages, " << played_mb
+      << " MB in " << duration_s << " s";
+  if (duration_s > 0) {
+    *os << " (" << static_cast<double>(played_msg_num_) / duration_s
+        << " msg/s, " << played_mb / duration_s << " MB/s)";
+  }
+  *os << std::endl;
+  if (is_max_throughput_) {
+    return;
+  }
+  *os << "timing error: mean "
+      << static_cast<double>(late_sum_ns_) /
+             static_cast<double>(played_msg_num_) / 1e3
+      << " us, p50 < " << LatePercentileUs(0.5) << " us, p99 < "
+      << LatePercentileUs(0.99) << " us, max "
+      << static_cast<double>(late_max_ns_) / 1e3 << " us" << std::endl;
+}
+
+void PlayTaskConsumer::WaitUntil(const Clock::time_point& time_point) {
+  // a sleep wakes up late by the timer slack and more under load, so sleep
+  // until shortly before the time point and spin the rest
+  auto sleep_until = time_point - std::chrono::nanoseconds(kSpinWaitNanoSec);
+  auto now = Clock::now();
+  while (now < sleep_until && !is_stopped_.load()) {
+    std::this_thread::sleep_until(std::min(
+        sleep_until, now + std::chrono::nanoseconds(MIN_SLEEP_DURATION_NS)));
+    now = Clock::now();
+  }
+  while (Clock::now() < time_point && !is_stopped_.load()) {
+    std::this_thread::yield();
+  }
+}
+
+void PlayTaskConsumer::UpdateTimingStats(uint64_t late_ns, size_t msg_size) {
+  ++played_msg_num_;
+  played_bytes_ += msg_size;
+  late_sum_ns_ += late_ns;
+  late_max_ns_ = std::max(late_max_ns_, late_ns);
+  int bucket = 0;
+  for (uint64_t late_us = late_ns / 1000; late_us > 0; late_us >>= 1) {
+    ++bucket;
+  }
+  ++late_buckets_[std::min(bucket, kLateBucketNum - 1)];
+}
+
+uint64_t PlayTaskConsumer::LatePercentileUs(double percentile) const {
+  uint64_t count = 0;
+  for (int i = 0; i < kLateBucketNum; ++i) {
+    count += late_buckets_[i];
+    if (static_cast<double>(count) >=
+        percentile * static_cast<double>(played_msg_num_)) {
+      return 1ULL << i;
+    }
+  }
+  return 1ULL << (kLateBucketNum - 1);
+}
+
 void PlayTaskConsumer::ThreadFunc() {
-  uint64_t base_real_time_ns = 0;
-  uint64_t accumulated_pause_time_ns = 0;
+  Clock::time_point base_real_time;
+  Clock::duration accumulated_pause_time(0);
 
   while (!is_stopped_.load()) {
     auto task = task_buffer_->Front();
@@ -86,7 +164,7 @@ void PlayTaskConsumer::ThreadFunc() {
     if (base_msg_play_time_ns_ == 0) {
       base_msg_play_time_ns_ = task->msg_play_time_ns();
       base_msg_real_time_ns_ = task->msg_real_time_ns();
-      if (base_msg_play_time_ns_ > begin_time_ns_) {
+      if (!is_max_throughput_ && base_msg_play_time_ns_ > begin_time_ns_) {
         sleep_ns = static_cast<uint64_t>(
             static_cast<double>(base_msg_play_time_ns_ - begin_time_ns_) /
             play_rate_);
@@ -102,32 +180,52 @@ void PlayTaskConsumer::ThreadFunc() {
 
         std::this_thread::sleep_for(std::chrono::nanoseconds(sleep_ns));
       }
-      base_real_time_ns = Time::Now().ToNanosecond();
-      ADEBUG << "base_msg_play_time_ns: " << base_msg_play_time_ns_
-             << "base_real_time_ns: " << base_real_time_ns;
+      base_real_time = Clock::now();
+      first_play_time_ = base_real_time;
+      ADEBUG << "base_msg_play_time_ns: " << base_msg_play_time_ns_;
     }
 
-    uint64_t task_interval_ns = static_cast<uint64_t>(
-        static_cast<double>(task->msg_play_time_ns() - base_msg_play_time_ns_) /
-        play_rate_);
-    uint64_t real_time_interval_ns = Time::Now().ToNanosecond() -
-                                     base_real_time_ns -
-                                     accumulated_pause_time_ns;
-    if (task_interval_ns > real_time_interval_ns) {
-      sleep_ns = task_interval_ns - real_time_interval_ns;
-      std::this_thread::sleep_for(std::chrono::nanoseconds(sleep_ns));
+    // the schedule of every message is derived from the first one, so
+    // errors of single waits never add up
+    auto play_time = Clock::now();
+    if (!is_max_throughput_) {
+      uint64_t task_interval_ns = 0;
+      if (task->msg_play_time_ns() > base_msg_play_time_ns_) {
+        task_interval_ns = static_cast<uint64_t>(
+            static_cast<double>(task->msg_play_time_ns() -
+                                base_msg_play_time_ns_) /
+            play_rate_);
+      }
+      play_time = base_real_time + accumulated_pause_time +
+                  std::chrono::nanoseconds(task_interval_ns);
+      WaitUntil(play_time);
+      if (is_stopped_.load()) {
+        break;
+      }
     }
 
+    auto now = Clock::now();
+    UpdateTimingStats(
+        now > play_time ? std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              now - play_time)
+                              .count()
+                        : 0,
+        task->msg_size());
     task->Play();
+    last_play_time_ = Clock::now();
     is_playonce_.store(false);
 
     last_played_msg_real_time_ns_ = task->msg_real_time_ns();
-    while (is_paused_.load() && !is_stopped_.load()) {
-      if (is_playonce_.load()) {
-        break;
+    if (is_paused_.load() && !is_stopped_.load()) {
+      auto pause_begin = Clock::now();
+      while (is_paused_.load() && !is_stopped_.load()) {
+        if (is_playonce_.load()) {
+          break;
+        }
+        std::this_thread::sleep_for(
+            std::chrono::nanoseconds(kPauseSleepNanoSec));
       }
-      std::this_thread::sleep_for(std::chrono::nanoseconds(kPauseSleepNanoSec));
-      accumulated_pause_time_ns += kPauseSleepNanoSec;
+      accumulated_pause_time += Clock::now() - pause_begin;
     }
     task_buffer_->PopFront();
   }
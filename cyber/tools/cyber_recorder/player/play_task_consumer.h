@@ -17,9 +17,12 @@
 #ifndef CYBER_TOOLS_CYBER_RECORDER_PLAYER_PLAY_TASK_CONSUMER_H_
 #define CYBER_TOOLS_CYBER_RECORDER_PLAYER_PLAY_TASK_CONSUMER_H_
 
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <memory>
+#include <ostream>
 #include <thread>
 
 #include "cyber/tools/cyber_recorder/player/play_task_buffer.h"
@@ -34,7 +37,8 @@ class PlayTaskConsumer {
   using TaskBufferPtr = std::shared_ptr<PlayTaskBuffer>;
 
   explicit PlayTaskConsumer(const TaskBufferPtr& task_buffer,
-                            double play_rate = 1.0);
+                            double play_rate = 1.0,
+                            bool is_max_throughput = false);
   virtual ~PlayTaskConsumer();
 
   void Start(uint64_t begin_time_ns);
@@ -49,10 +53,22 @@ class PlayTaskConsumer {
     return last_played_msg_real_time_ns_;
   }
 
+  /**
+   * @brief Print how late messages were published against their schedule
+   * and the throughput of the last play, call it once the consumer stopped.
+   */
+  void PrintTimingStats(std::ostream* os) const;
+
  private:
+  using Clock = std::chrono::steady_clock;
+
   void ThreadFunc();
+  void WaitUntil(const Clock::time_point& time_point);
+  void UpdateTimingStats(uint64_t late_ns, size_t msg_size);
+  uint64_t LatePercentileUs(double percentile) const;
 
   double play_rate_;
+  bool is_max_throughput_;
   ThreadPtr consume_th_;
   TaskBufferPtr task_buffer_;
   std::atomic<bool> is_stopped_;
@@ -62,9 +78,21 @@ class PlayTaskConsumer {
   uint64_t base_msg_play_time_ns_;
   uint64_t base_msg_real_time_ns_;
   uint64_t last_played_msg_real_time_ns_;
+
+  // late_buckets_[i] counts the messages late by less than 2^i us
+  static const int kLateBucketNum = 24;
+  uint64_t played_msg_num_;
+  uint64_t played_bytes_;
+  uint64_t late_sum_ns_;
+  uint64_t late_max_ns_;
+  std::array<uint64_t, kLateBucketNum> late_buckets_;
+  Clock::time_point first_play_time_;
+  Clock::time_point last_play_time_;
+
   static const uint64_t kPauseSleepNanoSec;
   static const uint64_t kWaitProduceSleepNanoSec;
   static const uint64_t MIN_SLEEP_DURATION_NS;
+  static const uint64_t kSpinWaitNanoSec;
 };
 
 }  // namespace record
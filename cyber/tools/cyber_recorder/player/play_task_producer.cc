@@ -112,7 +112,10 @@ bool PlayTaskProducer::ReadRecordInfo() {
 
   // loop each file
   for (auto& file : play_param_.files_to_play) {
-    auto record_reader = std::make_shared<RecordReader>(file);
+    // chunks are parsed straight out of the page cache, the viewer copies
+    // a content out of the mapping only when it hands the message out and
+    // PushPlayTask takes that copy over
+    auto record_reader = std::make_shared<RecordReader>(file, true);
     if (!record_reader->IsValid()) {
       continue;
     }
@@ -224,10 +227,7 @@ void PlayTaskProducer::Reset(const double& progress_s) {
   play_param_.begin_time_ns = play_param_.base_begin_time_ns + progress_s * 1e9;
   play_param_.start_time_s = progress_s;
   record_viewer_ptr_ = nullptr;
-  record_viewer_ptr_ = std::make_shared<RecordViewer>(
-      record_readers_, play_param_.begin_time_ns, play_param_.end_time_ns,
-      play_param_.channels_to_play);
-  record_viewer_ptr_->set_curr_itr(record_viewer_ptr_->begin());
+  CreateRecordViewer();
 }
 
 bool PlayTaskProducer::CreatePlayTaskWriter(const std::string& channel_name,
@@ -274,16 +274,39 @@ bool PlayTaskProducer::CreateWriters() {
                               "apollo.cyber.proto.RecordInfo");
 }
 
+void PlayTaskProducer::CreateRecordViewer() {
+  record_viewer_ptr_ = std::make_shared<RecordViewer>(
+      record_readers_, play_param_.begin_time_ns, play_param_.end_time_ns,
+      play_param_.channels_to_play);
+  // chunks of every file are read and decoded on worker threads, so the
+  // producer only merges them by time
+  record_viewer_ptr_->set_prefetch_chunk_num(play_param_.prefetch_chunk_num);
+  record_viewer_ptr_->set_curr_itr(record_viewer_ptr_->begin());
+}
+
+void PlayTaskProducer::PushPlayTask(RecordMessage* msg,
+                                    uint64_t plus_time_ns) {
+  auto search = writers_.find(msg->channel_name);
+  if (search == writers_.end()) {
+    return;
+  }
+
+  // the serialized content is sent as it is, take it over instead of copying
+  // it, the iterator reads the next message into it anyway
+  auto raw_msg = std::make_shared<message::RawMessage>();
+  raw_msg->message.swap(msg->content);
+  auto task = std::make_shared<PlayTask>(raw_msg, search->second, msg->time,
+                                         msg->time + plus_time_ns);
+  task_buffer_->Push(task);
+}
+
 void PlayTaskProducer::FillPlayTaskBuffer() {
   task_buffer_->Clear();
   // use fixed preload buffer size
   uint32_t preload_size = kMinTaskBufferSize * 2;
 
   if (!record_viewer_ptr_) {
-    record_viewer_ptr_ = std::make_shared<RecordViewer>(
-        record_readers_, play_param_.begin_time_ns, play_param_.end_time_ns,
-        play_param_.channels_to_play);
-    record_viewer_ptr_->set_curr_itr(record_viewer_ptr_->begin());
+    CreateRecordViewer();
   }
 
   auto itr = record_viewer_ptr_->curr_itr();
@@ -294,15 +317,7 @@ void PlayTaskProducer::FillPlayTaskBuffer() {
       break;
     }
 
-    auto search = writers_.find(itr->channel_name);
-    if (search == writers_.end()) {
-      continue;
-    }
-
-    auto raw_msg = std::make_shared<message::RawMessage>(itr->content);
-    auto task = std::make_shared<PlayTask>(raw_msg, search->second, itr->time,
-                                           itr->time);
-    task_buffer_->Push(task);
+    PushPlayTask(&(*itr), 0);
   }
 }
 
@@ -325,10 +340,7 @@ void PlayTaskProducer::ThreadFuncUnderPreloadMode() {
     return;
   }
   if (!record_viewer_ptr_) {
-    record_viewer_ptr_ = std::make_shared<RecordViewer>(
-        record_readers_, play_param_.begin_time_ns, play_param_.end_time_ns,
-        play_param_.channels_to_play);
-    record_viewer_ptr_->set_curr_itr(record_viewer_ptr_->begin());
+    CreateRecordViewer();
   }
 
   while (!is_stopped_.load()) {
@@ -345,15 +357,7 @@ void PlayTaskProducer::ThreadFuncUnderPreloadMode() {
           break;
         }
 
-        auto search = writers_.find(itr->channel_name);
-        if (search == writers_.end()) {
-          continue;
-        }
-
-        auto raw_msg = std::make_shared<message::RawMessage>(itr->content);
-        auto task = std::make_shared<PlayTask>(raw_msg, search->second,
-                                               itr->time, itr->time);
-        task_buffer_->Push(task);
+        PushPlayTask(&(*itr), 0);
       }
     }
     // not support loop
@@ -378,10 +382,7 @@ void PlayTaskProducer::ThreadFunc() {
     preload_size = kMinTaskBufferSize;
   }
 
-  record_viewer_ptr_ = std::make_shared<RecordViewer>(
-      record_readers_, play_param_.begin_time_ns, play_param_.end_time_ns,
-      play_param_.channels_to_play);
-  record_viewer_ptr_->set_curr_itr(record_viewer_ptr_->begin());
+  CreateRecordViewer();
 
   uint32_t loop_num = 0;
   while (!is_stopped_.load()) {
@@ -399,15 +400,7 @@ void PlayTaskProducer::ThreadFunc() {
           break;
         }
 
-        auto search = writers_.find(itr->channel_name);
-        if (search == writers_.end()) {
-          continue;
-        }
-
-        auto raw_msg = std::make_shared<message::RawMessage>(itr->content);
-        auto task = std::make_shared<PlayTask>(
-            raw_msg, search->second, itr->time, itr->time + plus_time_ns);
-        task_buffer_->Push(task);
+        PushPlayTask(&(*itr), plus_time_ns);
       }
     }
 
@@ -86,6 +86,8 @@ class PlayTaskProducer {
   bool CreateWriters();
   bool CreatePlayTaskWriter(const std::string& channel_name,
                             const std::string& msg_type);
+  void CreateRecordViewer();
+  void PushPlayTask(RecordMessage* msg, uint64_t plus_time_ns);
   void ThreadFunc();
   void ThreadFuncUnderPreloadMode();
 
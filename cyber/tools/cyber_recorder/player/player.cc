@@ -34,7 +34,8 @@ Player::Player(const PlayParam& play_param, const NodePtr& node,
       producer_(nullptr),
       task_buffer_(nullptr) {
   task_buffer_ = std::make_shared<PlayTaskBuffer>();
-  consumer_.reset(new PlayTaskConsumer(task_buffer_, play_param.play_rate));
+  consumer_.reset(new PlayTaskConsumer(task_buffer_, play_param.play_rate,
+                                       play_param.is_max_throughput));
   producer_.reset(new PlayTaskProducer(task_buffer_, play_param, node,
                                        preload_fill_buffer_mode));
 }
@@ -252,7 +253,9 @@ bool Player::Start() {
         std::chrono::milliseconds(kSleepIntervalMiliSec));
   }
 
+  consumer_->Stop();
   std::cout << "\nplay finished." << std::endl;
+  consumer_->PrintTimingStats(&std::cout);
   std::cout.flags(before);
   return true;
 }
@@ -25,9 +25,11 @@
 
 #include "cyber/common/log.h"
 #include "cyber/common/macros.h"
+#include "cyber/message/arena_pool.h"
 #include "cyber/message/message_traits.h"
 #include "cyber/time/time.h"
 #include "cyber/transport/dispatcher/dispatcher.h"
+#include "cyber/transport/message/content_filter_registry.h"
 #include "cyber/transport/rtps/attributes_filler.h"
 #include "cyber/transport/rtps/participant.h"
 #include "cyber/transport/rtps/sub_listener.h"
@@ -86,8 +88,15 @@ void RtpsDispatcher::AddListener(const RoleAttributes& self_attr,
   auto listener_adapter = [listener, self_attr](
                               const std::shared_ptr<std::string>& msg_str,
                               const MessageInfo& msg_info) {
-    auto msg = std::make_shared<MessageT>();
+    bool need_message = false;
+    auto filters = ContentFilterRegistry::Instance();
+    RETURN_IF(!filters->AcceptInfo(self_attr.id(), msg_info, &need_message));
+    auto msg = message::ArenaPoolManager::Instance()->CreateMessage<MessageT>(
+        self_attr.channel_id());
     RETURN_IF(!message::ParseFromString(*msg_str, msg.get()));
+    RETURN_IF(need_message &&
+              !filters->AcceptMessage(self_attr.id(), msg_info,
+                                      AsProtobufMessage(*msg)));
     uint64_t recv_time = Time::Now().ToMicrosecond();
     uint64_t send_time = msg_info.send_time();
     if (send_time > recv_time) {
@@ -113,8 +122,15 @@ void RtpsDispatcher::AddListener(const RoleAttributes& self_attr,
   auto listener_adapter = [listener, self_attr](
                               const std::shared_ptr<std::string>& msg_str,
                               const MessageInfo& msg_info) {
-    auto msg = std::make_shared<MessageT>();
+    bool need_message = false;
+    auto filters = ContentFilterRegistry::Instance();
+    RETURN_IF(!filters->AcceptInfo(self_attr.id(), msg_info, &need_message));
+    auto msg = message::ArenaPoolManager::Instance()->CreateMessage<MessageT>(
+        self_attr.channel_id());
     RETURN_IF(!message::ParseFromString(*msg_str, msg.get()));
+    RETURN_IF(need_message &&
+              !filters->AcceptMessage(self_attr.id(), msg_info,
+                                      AsProtobufMessage(*msg)));
     uint64_t recv_time = Time::Now().ToMicrosecond();
     uint64_t send_time = msg_info.send_time();
     if (send_time > recv_time) {
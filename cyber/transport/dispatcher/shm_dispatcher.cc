@@ -15,9 +15,16 @@
  *****************************************************************************/
 
 #include "cyber/transport/dispatcher/shm_dispatcher.h"
+
+#include <signal.h>
+
+#include <cerrno>
+#include <vector>
+
 #include "cyber/common/global_data.h"
 #include "cyber/common/util.h"
 #include "cyber/scheduler/scheduler_factory.h"
+#include "cyber/statistics/channel_stats.h"
 #include "cyber/transport/shm/readable_info.h"
 
 namespace apollo {
@@ -51,7 +58,7 @@ void ShmDispatcher::AddSegment(const RoleAttributes& self_attr) {
   if (segments_.count(channel_id) > 0) {
     return;
   }
-  auto segment = SegmentFactory::CreateSegment(channel_id);
+  auto segment = std::make_shared<SegmentAllocator>(channel_id);
   segments_[channel_id] = segment;
   previous_indexes_[channel_id] = UINT32_MAX;
 }
@@ -60,30 +67,130 @@ void ShmDispatcher::ReadMessage(uint64_t channel_id, uint32_t block_index) {
   ADEBUG << "Reading sharedmem message: "
          << GlobalData::GetChannelById(channel_id)
          << " from block: " << block_index;
-  auto rb = std::make_shared<ReadableBlock>();
-  rb->index = block_index;
-  if (!segments_[channel_id]->AcquireBlockToRead(rb.get())) {
+  auto segment = segments_[channel_id];
+  ReadableBlock block;
+  block.index = block_index;
+  if (!segment->AcquireBlockToRead(&block)) {
+    statistics::ChannelStats::Instance()->OnShmReadFailure(channel_id);
     AWARN << "fail to acquire block, channel: "
           << GlobalData::GetChannelById(channel_id)
           << " index: " << block_index;
     return;
   }
+  // The block is handed back when the last reference is dropped, which is
+  // right after OnMessage unless a reader keeps a MessageView of it.
+  ReadableBlockPtr rb(new ReadableBlock(block),
+                      [segment](ReadableBlock* readable_block) {
+                        segment->ReleaseReadBlock(*readable_block);
+                        delete readable_block;
+                      });
 
   MessageInfo msg_info;
   const char* msg_info_addr =
       reinterpret_cast<char*>(rb->buf) + rb->block->msg_size();
 
   if (msg_info.DeserializeFrom(msg_info_addr, rb->block->msg_info_size())) {
+    statistics::ChannelStats::Instance()->OnShmRead(channel_id,
+                                                    msg_info.send_time());
     OnMessage(channel_id, rb, msg_info);
   } else {
     AERROR << "error msg info of channel:"
            << GlobalData::GetChannelById(channel_id);
   }
-  segments_[channel_id]->ReleaseReadBlock(*rb);
 }
 
-void ShmDispatcher::OnMessage(uint64_t channel_id,
-                              const std::shared_ptr<ReadableBlock>& rb,
+SegmentAllocatorPtr ShmDispatcher::GetSegment(uint64_t channel_id) {
+  ReadLockGuard<AtomicRWLock> lock(segments_lock_);
+  auto itr = segments_.find(channel_id);
+  if (itr == segments_.end()) {
+    return nullptr;
+  }
+  return itr->second;
+}
+
+bool ShmDispatcher::ReadHistoryBlocks(uint64_t channel_id, uint64_t writer_id,
+                                      const BlockListener& listener) {
+  auto segment = GetSegment(channel_id);
+  if (segment == nullptr) {
+    AWARN << "no segment of channel: "
+          << GlobalData::GetChannelById(channel_id);
+    return false;
+  }
+
+  HistoryIndex history(channel_id, writer_id);
+  if (!history.Open()) {
+    return false;
+  }
+  std::vector<HistoryIndex::Entry> entries;
+  history.GetEntries(&entries);
+  ADEBUG << "Reading " << entries.size() << " history messages of channel: "
+         << GlobalData::GetChannelById(channel_id);
+
+  for (auto& entry : entries) {
+    ReadableBlock block;
+    block.index = entry.block_index;
+    if (!segment->AcquireBlockToRead(&block)) {
+      continue;
+    }
+    ReadableBlockPtr rb(new ReadableBlock(block),
+                        [segment](ReadableBlock* readable_block) {
+                          segment->ReleaseReadBlock(*readable_block);
+                          delete readable_block;
+                        });
+    // the writer let go of the block before the read lock was taken, it may
+    // hold a newer message already
+    if (!history.IsCurrent(entry)) {
+      continue;
+    }
+
+    MessageInfo msg_info;
+    const char* msg_info_addr =
+        reinterpret_cast<char*>(rb->buf) + rb->block->msg_size();
+    if (!msg_info.DeserializeFrom(msg_info_addr,
+                                  rb->block->msg_info_size())) {
+      AERROR << "error msg info of channel:"
+             << GlobalData::GetChannelById(channel_id);
+      continue;
+    }
+    listener(rb, msg_info);
+  }
+  return true;
+}
+
+void ShmDispatcher::ReleaseHistory(const RoleAttributes& self_attr,
+                                   const RoleAttributes& opposite_attr) {
+  if (kill(opposite_attr.process_id(), 0) == 0 || errno != ESRCH) {
+    return;
+  }
+  uint64_t channel_id = self_attr.channel_id();
+  auto segment = GetSegment(channel_id);
+  if (segment == nullptr) {
+    return;
+  }
+  HistoryIndex history(channel_id, opposite_attr.id());
+  if (!history.Open()) {
+    return;
+  }
+
+  std::vector<HistoryIndex::Entry> entries;
+  history.GetEntries(&entries);
+  ReadableBlock block;
+  uint32_t released = 0;
+  for (auto& entry : entries) {
+    // every reader of the channel sees the writer leave, one of them unlocks
+    if (history.Claim(entry)) {
+      block.index = entry.block_index;
+      segment->ReleasePinnedBlock(block);
+      ++released;
+    }
+  }
+  history.Remove();
+  AINFO << "released " << released << " history blocks of a writer of "
+        << "process " << opposite_attr.process_id() << " that is gone, "
+        << "channel: " << GlobalData::GetChannelById(channel_id);
+}
+
+void ShmDispatcher::OnMessage(uint64_t channel_id, const ReadableBlockPtr& rb,
                               const MessageInfo& msg_info) {
   if (is_shutdown_.load()) {
     return;
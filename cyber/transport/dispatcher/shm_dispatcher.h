@@ -18,6 +18,7 @@
 #define CYBER_TRANSPORT_DISPATCHER_SHM_DISPATCHER_H_
 
 #include <cstring>
+#include <functional>
 #include <memory>
 #include <string>
 #include <thread>
@@ -29,10 +30,13 @@
 #include "cyber/common/macros.h"
 #include "cyber/statistics/statistics.h"
 #include "cyber/time/time.h"
+#include "cyber/message/arena_pool.h"
 #include "cyber/message/message_traits.h"
 #include "cyber/transport/dispatcher/dispatcher.h"
+#include "cyber/transport/message/content_filter_registry.h"
+#include "cyber/transport/shm/history_index.h"
 #include "cyber/transport/shm/notifier_factory.h"
-#include "cyber/transport/shm/segment_factory.h"
+#include "cyber/transport/shm/segment_allocator.h"
 
 namespace apollo {
 namespace cyber {
@@ -40,14 +44,36 @@ namespace transport {
 
 class ShmDispatcher;
 using ShmDispatcherPtr = ShmDispatcher*;
+using ReadableBlockPtr = std::shared_ptr<ReadableBlock>;
 using apollo::cyber::base::AtomicRWLock;
 using apollo::cyber::base::ReadLockGuard;
 using apollo::cyber::base::WriteLockGuard;
 
+template <typename MessageT>
+bool ParseFromBlock(const ReadableBlockPtr& rb, MessageT* msg) {
+  return message::ParseFromArray(
+      rb->buf, static_cast<int>(rb->block->msg_size()), msg);
+}
+
+// MessageView readers share the block instead of parsing it, the read lock is
+// released once the last view referencing it goes away. Once views hold as
+// many blocks as the segment allows, the bytes are copied instead.
+inline bool ParseFromBlock(const ReadableBlockPtr& rb,
+                           message::MessageView* msg) {
+  if (rb->segment == nullptr || !rb->segment->TryPinBlock()) {
+    return msg->ParseFromArray(rb->buf,
+                               static_cast<int>(rb->block->msg_size()));
+  }
+  std::shared_ptr<const void> holder(
+      rb->buf, [rb](const void*) { rb->segment->UnpinBlock(); });
+  msg->Attach(rb->buf, rb->block->msg_size(), holder);
+  return true;
+}
+
 class ShmDispatcher : public Dispatcher {
  public:
   // key: channel_id
-  using SegmentContainer = std::unordered_map<uint64_t, SegmentPtr>;
+  using SegmentContainer = std::unordered_map<uint64_t, SegmentAllocatorPtr>;
 
   virtual ~ShmDispatcher();
 
@@ -62,10 +88,34 @@ class ShmDispatcher : public Dispatcher {
                    const RoleAttributes& opposite_attr,
                    const MessageListener<MessageT>& listener);
 
+  /**
+   * @brief Hands the messages a transient local writer on this host still
+   * keeps in shared memory to the listener, oldest first.
+   * @return false if the writer keeps no such history.
+   */
+  template <typename MessageT>
+  bool ReadHistory(const RoleAttributes& self_attr,
+                   const RoleAttributes& opposite_attr,
+                   const MessageListener<MessageT>& listener);
+
+  /**
+   * @brief Unlocks the blocks a transient local writer on this host kept for
+   * its history, if its process is gone without doing so. A writer that
+   * left normally released them itself.
+   */
+  void ReleaseHistory(const RoleAttributes& self_attr,
+                      const RoleAttributes& opposite_attr);
+
  private:
+  using BlockListener =
+      std::function<void(const ReadableBlockPtr&, const MessageInfo&)>;
+
   void AddSegment(const RoleAttributes& self_attr);
+  SegmentAllocatorPtr GetSegment(uint64_t channel_id);
+  bool ReadHistoryBlocks(uint64_t channel_id, uint64_t writer_id,
+                         const BlockListener& listener);
   void ReadMessage(uint64_t channel_id, uint32_t block_index);
-  void OnMessage(uint64_t channel_id, const std::shared_ptr<ReadableBlock>& rb,
+  void OnMessage(uint64_t channel_id, const ReadableBlockPtr& rb,
                  const MessageInfo& msg_info);
   void ThreadFunc();
   bool Init();
@@ -87,9 +137,15 @@ void ShmDispatcher::AddListener(const RoleAttributes& self_attr,
   auto listener_adapter = [listener, self_attr](
                                      const std::shared_ptr<ReadableBlock>& rb,
                                      const MessageInfo& msg_info) {
-    auto msg = std::make_shared<MessageT>();
-    RETURN_IF(!message::ParseFromArray(
-        rb->buf, static_cast<int>(rb->block->msg_size()), msg.get()));
+    bool need_message = false;
+    auto filters = ContentFilterRegistry::Instance();
+    RETURN_IF(!filters->AcceptInfo(self_attr.id(), msg_info, &need_message));
+    auto msg = message::ArenaPoolManager::Instance()->CreateMessage<MessageT>(
+        self_attr.channel_id());
+    RETURN_IF(!ParseFromBlock(rb, msg.get()));
+    RETURN_IF(need_message &&
+              !filters->AcceptMessage(self_attr.id(), msg_info,
+                                      AsProtobufMessage(*msg)));
 
     auto send_time = msg_info.send_time();
     auto msg_seq_num = msg_info.msg_seq_num();
@@ -125,9 +181,15 @@ void ShmDispatcher::AddListener(const RoleAttributes& self_attr,
   auto listener_adapter = [listener, self_attr](
                                      const std::shared_ptr<ReadableBlock>& rb,
                                      const MessageInfo& msg_info) {
-    auto msg = std::make_shared<MessageT>();
-    RETURN_IF(!message::ParseFromArray(
-        rb->buf, static_cast<int>(rb->block->msg_size()), msg.get()));
+    bool need_message = false;
+    auto filters = ContentFilterRegistry::Instance();
+    RETURN_IF(!filters->AcceptInfo(self_attr.id(), msg_info, &need_message));
+    auto msg = message::ArenaPoolManager::Instance()->CreateMessage<MessageT>(
+        self_attr.channel_id());
+    RETURN_IF(!ParseFromBlock(rb, msg.get()));
+    RETURN_IF(need_message &&
+              !filters->AcceptMessage(self_attr.id(), msg_info,
+                                      AsProtobufMessage(*msg)));
 
     auto send_time = msg_info.send_time();
     auto msg_seq_num = msg_info.msg_seq_num();
@@ -156,6 +218,21 @@ void ShmDispatcher::AddListener(const RoleAttributes& self_attr,
   AddSegment(self_attr);
 }
 
+template <typename MessageT>
+bool ShmDispatcher::ReadHistory(const RoleAttributes& self_attr,
+                                const RoleAttributes& opposite_attr,
+                                const MessageListener<MessageT>& listener) {
+  auto block_listener = [&listener, &self_attr](const ReadableBlockPtr& rb,
+                                                const MessageInfo& msg_info) {
+    auto msg = message::ArenaPoolManager::Instance()->CreateMessage<MessageT>(
+        self_attr.channel_id());
+    RETURN_IF(!ParseFromBlock(rb, msg.get()));
+    listener(msg, msg_info);
+  };
+  return ReadHistoryBlocks(self_attr.channel_id(), opposite_attr.id(),
+                           block_listener);
+}
+
 }  // namespace transport
 }  // namespace cyber
 }  // namespace apollo
@@ -23,6 +23,7 @@
 #include "cyber/common/global_data.h"
 #include "cyber/common/util.h"
 #include "cyber/init.h"
+#include "cyber/message/message_view.h"
 #include "cyber/proto/unit_test.pb.h"
 #include "cyber/transport/receiver/shm_receiver.h"
 #include "cyber/transport/transmitter/shm_transmitter.h"
@@ -149,6 +150,62 @@ TEST_F(ShmTransceiverTest, enable_and_disable) {
   EXPECT_EQ(msgs.size(), 0);
 }
 
+TEST_F(ShmTransceiverTest, loan_and_view) {
+  struct FixedLayout {
+    uint64_t timestamp;
+    double value;
+  };
+
+  std::vector<message::MessageView> views;
+  RoleAttributes attr;
+  attr.set_channel_name(channel_name_);
+  attr.set_channel_id(common::Hash(channel_name_));
+  auto receiver = std::make_shared<ShmReceiver<message::MessageView>>(
+      attr, [&views](const std::shared_ptr<message::MessageView>& msg,
+                     const MessageInfo& msg_info, const RoleAttributes& attr) {
+        (void)msg_info;
+        (void)attr;
+        views.emplace_back(*msg);
+      });
+  receiver->Enable();
+
+  LoanedMessage loaned_msg;
+  EXPECT_TRUE(transmitter_a_->Loan(sizeof(FixedLayout), &loaned_msg));
+  EXPECT_TRUE(loaned_msg.IsValid());
+  EXPECT_EQ(loaned_msg.capacity(), sizeof(FixedLayout));
+  auto fixed = loaned_msg.As<FixedLayout>();
+  ASSERT_NE(fixed, nullptr);
+  fixed->timestamp = 123;
+  fixed->value = 4.5;
+
+  EXPECT_TRUE(transmitter_a_->Transmit(&loaned_msg));
+  EXPECT_FALSE(loaned_msg.IsValid());
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  ASSERT_EQ(views.size(), 1);
+  EXPECT_TRUE(views[0].IsZeroCopy());
+  auto received = views[0].As<FixedLayout>();
+  ASSERT_NE(received, nullptr);
+  EXPECT_EQ(received->timestamp, 123);
+  EXPECT_DOUBLE_EQ(received->value, 4.5);
+
+  // an unpublished loan hands the block back silently
+  {
+    LoanedMessage dropped;
+    EXPECT_TRUE(transmitter_a_->Loan(16, &dropped));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(views.size(), 1);
+
+  LoanedMessage too_small;
+  EXPECT_TRUE(transmitter_a_->Loan(4, &too_small));
+  EXPECT_EQ(too_small.As<FixedLayout>(), nullptr);
+  too_small.Release();
+  EXPECT_FALSE(too_small.IsValid());
+
+  views.clear();
+  receiver->Disable();
+}
+
 }  // namespace transport
 }  // namespace cyber
 }  // namespace apollo
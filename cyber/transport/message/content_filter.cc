@@ -0,0 +1,190 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/message/content_filter.h"
+
+#include <cstdlib>
+#include <sstream>
+
+#include "google/protobuf/descriptor.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+using google::protobuf::FieldDescriptor;
+using google::protobuf::Message;
+using google::protobuf::Reflection;
+
+void ContentFilter::set_max_rate(double hz) {
+  max_rate_ = hz > 0.0 ? hz : 0.0;
+  period_ns_ = max_rate_ > 0.0 ? static_cast<uint64_t>(1e9 / max_rate_) : 0;
+  last_periods_.clear();
+}
+
+void ContentFilter::set_field_equals(const std::string& path,
+                                     const std::string& value) {
+  field_path_ = path;
+  field_value_ = value;
+}
+
+bool ContentFilter::Accept(const MessageInfo& msg_info, const Message* msg) {
+  if (every_nth_ > 1 &&
+      (msg_info.seq_num() + every_nth_ - 1) % every_nth_ != 0) {
+    return false;
+  }
+  if (msg != nullptr && needs_message() && !MatchField(*msg)) {
+    return false;
+  }
+  if (period_ns_ > 0) {
+    uint64_t period = msg_info.send_time() / period_ns_;
+    auto itr = last_periods_.find(msg_info.sender_id().HashValue());
+    if (itr != last_periods_.end() && itr->second == period) {
+      return false;
+    }
+    last_periods_[msg_info.sender_id().HashValue()] = period;
+  }
+  return true;
+}
+
+bool ContentFilter::operator==(const ContentFilter& other) const {
+  return period_ns_ == other.period_ns_ && every_nth_ == other.every_nth_ &&
+         field_path_ == other.field_path_ &&
+         field_value_ == other.field_value_;
+}
+
+std::string ContentFilter::ToString() const {
+  std::ostringstream oss;
+  oss.precision(17);
+  if (max_rate_ > 0.0) {
+    oss << "rate=" << max_rate_ << ";";
+  }
+  if (every_nth_ > 1) {
+    oss << "nth=" << every_nth_ << ";";
+  }
+  if (!field_path_.empty()) {
+    // the value goes last, it may hold any character
+    oss << "field=" << field_path_ << ";value=" << field_value_;
+  }
+  return oss.str();
+}
+
+bool ContentFilter::FromString(const std::string& spec,
+                               ContentFilter* filter) {
+  if (filter == nullptr) {
+    return false;
+  }
+  ContentFilter result;
+  std::string field;
+  std::size_t pos = 0;
+  while (pos < spec.size()) {
+    std::size_t eq = spec.find('=', pos);
+    if (eq == std::string::npos) {
+      return false;
+    }
+    std::string key = spec.substr(pos, eq - pos);
+    if (key == "value") {
+      result.set_field_equals(field, spec.substr(eq + 1));
+      break;
+    }
+    std::size_t end = spec.find(';', eq);
+    if (end == std::string::npos) {
+      end = spec.size();
+    }
+    std::string value = spec.substr(eq + 1, end - eq - 1);
+    char* value_end = nullptr;
+    if (key == "rate") {
+      result.set_max_rate(std::strtod(value.c_str(), &value_end));
+    } else if (key == "nth") {
+      result.set_every_nth(static_cast<uint32_t>(
+          std::strtoul(value.c_str(), &value_end, 10)));
+    } else if (key == "field") {
+      field = value;
+    } else {
+      return false;
+    }
+    if (key != "field" && (value.empty() || *value_end != '\0')) {
+      return false;
+    }
+    pos = end + 1;
+  }
+  if (!field.empty() && result.field_path_.empty()) {
+    return false;
+  }
+  *filter = result;
+  return true;
+}
+
+bool ContentFilter::MatchField(const Message& msg) const {
+  const Message* current = &msg;
+  const FieldDescriptor* field = nullptr;
+  std::size_t pos = 0;
+  while (true) {
+    std::size_t dot = field_path_.find('.', pos);
+    std::string name = field_path_.substr(
+        pos, dot == std::string::npos ? std::string::npos : dot - pos);
+    field = current->GetDescriptor()->FindFieldByName(name);
+    if (field == nullptr || field->is_repeated()) {
+      return false;
+    }
+    if (dot == std::string::npos) {
+      break;
+    }
+    if (field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE) {
+      return false;
+    }
+    current = &current->GetReflection()->GetMessage(*current, field);
+    pos = dot + 1;
+  }
+
+  const Reflection* reflection = current->GetReflection();
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_STRING:
+      return reflection->GetString(*current, field) == field_value_;
+    case FieldDescriptor::CPPTYPE_INT32:
+      return std::to_string(reflection->GetInt32(*current, field)) ==
+             field_value_;
+    case FieldDescriptor::CPPTYPE_INT64:
+      return std::to_string(reflection->GetInt64(*current, field)) ==
+             field_value_;
+    case FieldDescriptor::CPPTYPE_UINT32:
+      return std::to_string(reflection->GetUInt32(*current, field)) ==
+             field_value_;
+    case FieldDescriptor::CPPTYPE_UINT64:
+      return std::to_string(reflection->GetUInt64(*current, field)) ==
+             field_value_;
+    case FieldDescriptor::CPPTYPE_BOOL:
+      return (reflection->GetBool(*current, field) ? "true" : "false") ==
+             field_value_;
+    case FieldDescriptor::CPPTYPE_ENUM: {
+      auto value = reflection->GetEnum(*current, field);
+      return value->name() == field_value_ ||
+             std::to_string(value->number()) == field_value_;
+    }
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      return reflection->GetDouble(*current, field) ==
+             std::strtod(field_value_.c_str(), nullptr);
+    case FieldDescriptor::CPPTYPE_FLOAT:
+      return reflection->GetFloat(*current, field) ==
+             std::strtof(field_value_.c_str(), nullptr);
+    default:
+      return false;
+  }
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,113 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_MESSAGE_CONTENT_FILTER_H_
+#define CYBER_TRANSPORT_MESSAGE_CONTENT_FILTER_H_
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+#include "google/protobuf/message.h"
+
+#include "cyber/transport/message/message_info.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+/**
+ * @class ContentFilter
+ * @brief What a reader wants of a channel: at most so many messages per
+ * second, every nth message, and only messages with a field of a given value.
+ * The conditions are combined, a filter without any accepts everything.
+ *
+ * Writers evaluate the filters of their readers and skip a transport when
+ * none of its readers wants the message, dispatchers evaluate them again
+ * before parsing, for messages sent on behalf of other readers. Rate and
+ * every nth are decided on the MessageInfo of each writer alone, so both
+ * sides pick the same messages.
+ */
+class ContentFilter {
+ public:
+  ContentFilter() = default;
+
+  // at most hz messages per second of each writer, 0 for no limit
+  void set_max_rate(double hz);
+  // every nth message of each writer, 0 or 1 for all of them
+  void set_every_nth(uint32_t n) { every_nth_ = n; }
+  // messages whose field at path, e.g. "header.module_name", prints as value
+  void set_field_equals(const std::string& path, const std::string& value);
+
+  double max_rate() const { return max_rate_; }
+  uint32_t every_nth() const { return every_nth_; }
+  const std::string& field_path() const { return field_path_; }
+  const std::string& field_value() const { return field_value_; }
+
+  bool empty() const {
+    return period_ns_ == 0 && every_nth_ <= 1 && field_path_.empty();
+  }
+  // the field condition can only be checked on the parsed message
+  bool needs_message() const { return !field_path_.empty(); }
+
+  /**
+   * @brief Checks a message and counts it against the rate when accepted.
+   * @param msg nullptr if the message is not a protobuf one, the field
+   * condition is not checked then.
+   */
+  bool Accept(const MessageInfo& msg_info,
+              const google::protobuf::Message* msg);
+
+  bool operator==(const ContentFilter& other) const;
+
+  // "rate=1;nth=10;field=header.module_name;value=planning", parts optional
+  std::string ToString() const;
+  static bool FromString(const std::string& spec, ContentFilter* filter);
+
+ private:
+  bool MatchField(const google::protobuf::Message& msg) const;
+
+  double max_rate_ = 0.0;
+  uint64_t period_ns_ = 0;
+  uint32_t every_nth_ = 0;
+  std::string field_path_;
+  std::string field_value_;
+
+  // key: sender hash, value: rate period of its last accepted message
+  std::unordered_map<uint64_t, uint64_t> last_periods_;
+};
+
+template <typename T>
+typename std::enable_if<std::is_base_of<google::protobuf::Message, T>::value,
+                        const google::protobuf::Message*>::type
+AsProtobufMessage(const T& msg) {
+  return &msg;
+}
+
+template <typename T>
+typename std::enable_if<!std::is_base_of<google::protobuf::Message, T>::value,
+                        const google::protobuf::Message*>::type
+AsProtobufMessage(const T& msg) {
+  (void)msg;
+  return nullptr;
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_MESSAGE_CONTENT_FILTER_H_
@@ -0,0 +1,253 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/message/content_filter_registry.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+ContentFilterRegistry::ContentFilterRegistry() {}
+
+ContentFilterRegistry::~ContentFilterRegistry() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& item : entries_) {
+    if (item.second.filtered()) {
+      shm_unlink(GetName(item.second.channel_id, item.first).c_str());
+    }
+  }
+  entries_.clear();
+}
+
+void ContentFilterRegistry::Add(uint64_t channel_id, uint64_t receiver_id,
+                                const ContentFilter& filter) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& entry = entries_[receiver_id];
+  bool was_filtered = entry.filtered();
+  entry.channel_id = channel_id;
+  if (filter.empty()) {
+    ++entry.unfiltered;
+  } else {
+    entry.filters.emplace_back(filter);
+  }
+  if (entry.filtered() && !was_filtered) {
+    ++filtered_num_;
+  } else if (!entry.filtered() && was_filtered) {
+    --filtered_num_;
+  }
+  Publish(receiver_id, entry);
+}
+
+void ContentFilterRegistry::Remove(uint64_t channel_id, uint64_t receiver_id,
+                                   const ContentFilter& filter) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto itr = entries_.find(receiver_id);
+  if (itr == entries_.end()) {
+    return;
+  }
+  auto& entry = itr->second;
+  bool was_filtered = entry.filtered();
+  if (filter.empty()) {
+    if (entry.unfiltered > 0) {
+      --entry.unfiltered;
+    }
+  } else {
+    auto pos = std::find(entry.filters.begin(), entry.filters.end(), filter);
+    if (pos != entry.filters.end()) {
+      entry.filters.erase(pos);
+    }
+  }
+  if (entry.filtered() && !was_filtered) {
+    ++filtered_num_;
+  } else if (!entry.filtered() && was_filtered) {
+    --filtered_num_;
+  }
+  if (entry.unfiltered == 0 && entry.filters.empty()) {
+    shm_unlink(GetName(channel_id, receiver_id).c_str());
+    entries_.erase(itr);
+    return;
+  }
+  Publish(receiver_id, entry);
+}
+
+bool ContentFilterRegistry::AcceptInfo(uint64_t receiver_id,
+                                       const MessageInfo& msg_info,
+                                       bool* need_message) {
+  *need_message = false;
+  if (filtered_num_.load() == 0) {
+    return true;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto itr = entries_.find(receiver_id);
+  if (itr == entries_.end() || !itr->second.filtered()) {
+    return true;
+  }
+
+  bool accepted = false;
+  for (auto& filter : itr->second.filters) {
+    if (filter.needs_message()) {
+      *need_message = true;
+    } else if (filter.Accept(msg_info, nullptr)) {
+      // no early return, every filter counts the message against its rate
+      accepted = true;
+    }
+  }
+  if (accepted) {
+    *need_message = false;
+  }
+  return accepted || *need_message;
+}
+
+bool ContentFilterRegistry::AcceptMessage(
+    uint64_t receiver_id, const MessageInfo& msg_info,
+    const google::protobuf::Message* msg) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto itr = entries_.find(receiver_id);
+  if (itr == entries_.end() || !itr->second.filtered()) {
+    return true;
+  }
+
+  bool accepted = false;
+  for (auto& filter : itr->second.filters) {
+    if (filter.needs_message() && filter.Accept(msg_info, msg)) {
+      accepted = true;
+    }
+  }
+  return accepted;
+}
+
+bool ContentFilterRegistry::Get(uint64_t channel_id, uint64_t receiver_id,
+                                std::vector<ContentFilter>* filters) {
+  RETURN_VAL_IF_NULL(filters, false);
+  filters->clear();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto itr = entries_.find(receiver_id);
+    if (itr != entries_.end()) {
+      if (!itr->second.filtered()) {
+        return false;
+      }
+      *filters = itr->second.filters;
+      return true;
+    }
+  }
+
+  int fd = shm_open(GetName(channel_id, receiver_id).c_str(), O_RDONLY, 0644);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat file_attr;
+  std::string data;
+  if (fstat(fd, &file_attr) == 0 && file_attr.st_size > 0) {
+    data.resize(file_attr.st_size);
+    ssize_t nbytes = pread(fd, &data[0], data.size(), 0);
+    data.resize(nbytes > 0 ? nbytes : 0);
+  }
+  close(fd);
+
+  // a receiver updating its filters right now passes everything this time
+  if (!Decode(data, filters)) {
+    filters->clear();
+    return false;
+  }
+  return !filters->empty();
+}
+
+std::string ContentFilterRegistry::GetName(uint64_t channel_id,
+                                           uint64_t receiver_id) {
+  return std::to_string(channel_id) + ".filter." +
+         std::to_string(receiver_id);
+}
+
+void ContentFilterRegistry::Publish(uint64_t receiver_id, const Entry& entry) {
+  std::string name = GetName(entry.channel_id, receiver_id);
+  if (!entry.filtered()) {
+    shm_unlink(name.c_str());
+    return;
+  }
+
+  std::string data = Encode(entry.filters);
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    AERROR << "publish content filter " << name
+           << " failed: " << strerror(errno);
+    return;
+  }
+  ssize_t nbytes = write(fd, data.data(), data.size());
+  if (nbytes != static_cast<ssize_t>(data.size())) {
+    AERROR << "write content filter " << name
+           << " failed: " << strerror(errno);
+    close(fd);
+    shm_unlink(name.c_str());
+    return;
+  }
+  close(fd);
+}
+
+std::string ContentFilterRegistry::Encode(
+    const std::vector<ContentFilter>& filters) {
+  // the count comes first, a half written object never decodes
+  std::string data = std::to_string(filters.size()) + ";";
+  for (auto& filter : filters) {
+    std::string spec = filter.ToString();
+    data += std::to_string(spec.size()) + ":" + spec;
+  }
+  return data;
+}
+
+bool ContentFilterRegistry::Decode(const std::string& data,
+                                   std::vector<ContentFilter>* filters) {
+  std::size_t pos = data.find(';');
+  if (pos == std::string::npos) {
+    return false;
+  }
+  std::size_t count = std::strtoul(data.c_str(), nullptr, 10);
+  ++pos;
+  while (pos < data.size()) {
+    std::size_t colon = data.find(':', pos);
+    if (colon == std::string::npos) {
+      return false;
+    }
+    char* end = nullptr;
+    std::size_t len = std::strtoul(data.c_str() + pos, &end, 10);
+    if (end != data.c_str() + colon || colon + 1 + len > data.size()) {
+      return false;
+    }
+    ContentFilter filter;
+    if (!ContentFilter::FromString(data.substr(colon + 1, len), &filter)) {
+      return false;
+    }
+    filters->emplace_back(filter);
+    pos = colon + 1 + len;
+  }
+  return filters->size() == count;
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
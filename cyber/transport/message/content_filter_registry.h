@@ -0,0 +1,101 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_MESSAGE_CONTENT_FILTER_REGISTRY_H_
+#define CYBER_TRANSPORT_MESSAGE_CONTENT_FILTER_REGISTRY_H_
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cyber/common/macros.h"
+#include "cyber/transport/message/content_filter.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+/**
+ * @class ContentFilterRegistry
+ * @brief The content filters of the readers in this process, by receiver.
+ *
+ * Readers of a channel share the receiver of their process, so a receiver
+ * passes a message when any of its readers' filters does, and not at all
+ * once one of them reads unfiltered. The filters of every receiver are also
+ * published in a small shared memory object, where writers on the same host
+ * look them up when the reader joins.
+ */
+class ContentFilterRegistry {
+ public:
+  virtual ~ContentFilterRegistry();
+
+  // reader side, an empty filter makes the receiver pass everything
+  void Add(uint64_t channel_id, uint64_t receiver_id,
+           const ContentFilter& filter);
+  void Remove(uint64_t channel_id, uint64_t receiver_id,
+              const ContentFilter& filter);
+
+  /**
+   * @brief Reader side, checks a message before it is parsed.
+   * @return false if no filter of the receiver wants it. need_message is
+   * set when the decision waits for AcceptMessage on the parsed message.
+   */
+  bool AcceptInfo(uint64_t receiver_id, const MessageInfo& msg_info,
+                  bool* need_message);
+  bool AcceptMessage(uint64_t receiver_id, const MessageInfo& msg_info,
+                     const google::protobuf::Message* msg);
+
+  /**
+   * @brief Writer side, the filters of a receiver in this or another process
+   * of this host.
+   * @return false if the receiver passes everything or is unknown.
+   */
+  bool Get(uint64_t channel_id, uint64_t receiver_id,
+           std::vector<ContentFilter>* filters);
+
+  static std::string GetName(uint64_t channel_id, uint64_t receiver_id);
+
+ private:
+  struct Entry {
+    uint64_t channel_id = 0;
+    uint32_t unfiltered = 0;
+    std::vector<ContentFilter> filters;
+
+    bool filtered() const { return unfiltered == 0 && !filters.empty(); }
+  };
+
+  void Publish(uint64_t receiver_id, const Entry& entry);
+  static std::string Encode(const std::vector<ContentFilter>& filters);
+  static bool Decode(const std::string& data,
+                     std::vector<ContentFilter>* filters);
+
+  std::mutex mutex_;
+  // key: receiver id
+  std::unordered_map<uint64_t, Entry> entries_;
+  // receivers with filters, the common case of none skips the lock
+  std::atomic<uint32_t> filtered_num_ = {0};
+
+  DECLARE_SINGLETON(ContentFilterRegistry)
+};
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_MESSAGE_CONTENT_FILTER_REGISTRY_H_
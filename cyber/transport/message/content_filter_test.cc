@@ -0,0 +1,167 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/message/content_filter.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cyber/proto/unit_test.pb.h"
+#include "cyber/transport/common/identity.h"
+#include "cyber/transport/message/content_filter_registry.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+MessageInfo MakeInfo(const Identity& sender, uint64_t seq_num,
+                     uint64_t send_time_ms) {
+  MessageInfo msg_info(sender, seq_num);
+  msg_info.set_send_time(send_time_ms * 1000000);
+  return msg_info;
+}
+
+TEST(ContentFilterTest, every_nth) {
+  Identity sender;
+  ContentFilter filter;
+  EXPECT_TRUE(filter.empty());
+  filter.set_every_nth(3);
+  EXPECT_FALSE(filter.empty());
+
+  std::vector<uint64_t> accepted;
+  for (uint64_t seq = 1; seq <= 10; ++seq) {
+    if (filter.Accept(MakeInfo(sender, seq, seq), nullptr)) {
+      accepted.push_back(seq);
+    }
+  }
+  EXPECT_EQ(accepted, std::vector<uint64_t>({1, 4, 7, 10}));
+}
+
+TEST(ContentFilterTest, max_rate) {
+  Identity sender, other_sender;
+  ContentFilter filter;
+  filter.set_max_rate(10.0);
+  EXPECT_TRUE(filter.Accept(MakeInfo(sender, 1, 1000), nullptr));
+  EXPECT_FALSE(filter.Accept(MakeInfo(sender, 2, 1050), nullptr));
+  // each writer has a rate of its own
+  EXPECT_TRUE(filter.Accept(MakeInfo(other_sender, 1, 1060), nullptr));
+  EXPECT_TRUE(filter.Accept(MakeInfo(sender, 3, 1100), nullptr));
+  EXPECT_FALSE(filter.Accept(MakeInfo(sender, 4, 1199), nullptr));
+  EXPECT_TRUE(filter.Accept(MakeInfo(sender, 5, 1250), nullptr));
+}
+
+TEST(ContentFilterTest, field_equals) {
+  Identity sender;
+  ContentFilter filter;
+  filter.set_field_equals("class_name", "ContentFilterTest");
+  EXPECT_TRUE(filter.needs_message());
+
+  proto::UnitTest msg;
+  msg.set_class_name("ContentFilterTest");
+  EXPECT_TRUE(filter.Accept(MakeInfo(sender, 1, 1), &msg));
+  msg.set_class_name("Other");
+  EXPECT_FALSE(filter.Accept(MakeInfo(sender, 2, 2), &msg));
+  // not a protobuf message, the field can't be checked
+  EXPECT_TRUE(filter.Accept(MakeInfo(sender, 3, 3), nullptr));
+
+  filter.set_field_equals("class_name.size", "1");
+  EXPECT_FALSE(filter.Accept(MakeInfo(sender, 4, 4), &msg));
+  filter.set_field_equals("no_such_field", "1");
+  EXPECT_FALSE(filter.Accept(MakeInfo(sender, 5, 5), &msg));
+}
+
+TEST(ContentFilterTest, string) {
+  ContentFilter filter;
+  filter.set_max_rate(2.5);
+  filter.set_every_nth(4);
+  filter.set_field_equals("header.module_name", "a;b=c");
+  EXPECT_EQ(filter.ToString(),
+            "rate=2.5;nth=4;field=header.module_name;value=a;b=c");
+
+  ContentFilter parsed;
+  EXPECT_TRUE(ContentFilter::FromString(filter.ToString(), &parsed));
+  EXPECT_EQ(parsed, filter);
+  EXPECT_DOUBLE_EQ(parsed.max_rate(), 2.5);
+  EXPECT_EQ(parsed.field_value(), "a;b=c");
+
+  EXPECT_TRUE(ContentFilter::FromString("", &parsed));
+  EXPECT_TRUE(parsed.empty());
+  EXPECT_FALSE(ContentFilter::FromString("rate=fast", &parsed));
+  EXPECT_FALSE(ContentFilter::FromString("speed=1", &parsed));
+  EXPECT_FALSE(ContentFilter::FromString("field=header.seq", &parsed));
+  EXPECT_FALSE(ContentFilter::FromString("nth", &parsed));
+}
+
+TEST(ContentFilterRegistryTest, receivers) {
+  auto registry = ContentFilterRegistry::Instance();
+  const uint64_t channel_id = 1234;
+  const uint64_t receiver_id = 5678;
+  Identity sender;
+  bool need_message = false;
+
+  ContentFilter every_other;
+  every_other.set_every_nth(2);
+  ContentFilter by_name;
+  by_name.set_field_equals("case_name", "receivers");
+
+  std::vector<ContentFilter> filters;
+  EXPECT_FALSE(registry->Get(channel_id, receiver_id, &filters));
+
+  registry->Add(channel_id, receiver_id, every_other);
+  EXPECT_TRUE(registry->Get(channel_id, receiver_id, &filters));
+  ASSERT_EQ(filters.size(), 1);
+  EXPECT_EQ(filters[0], every_other);
+  EXPECT_TRUE(registry->AcceptInfo(receiver_id, MakeInfo(sender, 1, 1),
+                                   &need_message));
+  EXPECT_FALSE(need_message);
+  EXPECT_FALSE(registry->AcceptInfo(receiver_id, MakeInfo(sender, 2, 2),
+                                    &need_message));
+
+  // a second reader of the receiver, the message decides
+  registry->Add(channel_id, receiver_id, by_name);
+  EXPECT_TRUE(registry->AcceptInfo(receiver_id, MakeInfo(sender, 4, 4),
+                                   &need_message));
+  EXPECT_TRUE(need_message);
+  proto::UnitTest msg;
+  msg.set_case_name("other");
+  EXPECT_FALSE(
+      registry->AcceptMessage(receiver_id, MakeInfo(sender, 4, 4), &msg));
+  msg.set_case_name("receivers");
+  EXPECT_TRUE(
+      registry->AcceptMessage(receiver_id, MakeInfo(sender, 6, 6), &msg));
+
+  // an unfiltered reader makes the receiver take everything
+  registry->Add(channel_id, receiver_id, ContentFilter());
+  EXPECT_FALSE(registry->Get(channel_id, receiver_id, &filters));
+  EXPECT_TRUE(registry->AcceptInfo(receiver_id, MakeInfo(sender, 8, 8),
+                                   &need_message));
+  EXPECT_FALSE(need_message);
+
+  registry->Remove(channel_id, receiver_id, ContentFilter());
+  registry->Remove(channel_id, receiver_id, by_name);
+  EXPECT_TRUE(registry->Get(channel_id, receiver_id, &filters));
+  EXPECT_EQ(filters.size(), 1);
+  registry->Remove(channel_id, receiver_id, every_other);
+  EXPECT_FALSE(registry->Get(channel_id, receiver_id, &filters));
+  EXPECT_TRUE(registry->AcceptInfo(receiver_id, MakeInfo(sender, 10, 10),
+                                   &need_message));
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
@@ -26,7 +26,7 @@ namespace transport {
 
 const std::size_t MessageInfo::kSize = 2 * ID_SIZE + sizeof(uint64_t) + \
                                         sizeof(uint64_t) + sizeof(int32_t) + \
-                                        sizeof(uint64_t);
+                                        sizeof(uint64_t) + sizeof(uint64_t);
 
 MessageInfo::MessageInfo() : sender_id_(false), spare_id_(false) {}
 
@@ -41,7 +41,8 @@ MessageInfo::MessageInfo(const MessageInfo& another)
     : sender_id_(another.sender_id_),
       channel_id_(another.channel_id_),
       seq_num_(another.seq_num_),
-      spare_id_(another.spare_id_) {}
+      spare_id_(another.spare_id_),
+      trace_id_(another.trace_id_) {}
 
 MessageInfo::~MessageInfo() {}
 
@@ -51,6 +52,7 @@ MessageInfo& MessageInfo::operator=(const MessageInfo& another) {
     channel_id_ = another.channel_id_;
     seq_num_ = another.seq_num_;
     spare_id_ = another.spare_id_;
+    trace_id_ = another.trace_id_;
   }
   return *this;
 }
@@ -78,6 +80,8 @@ bool MessageInfo::SerializeTo(std::string* dst) const {
     &msg_seq_num_), sizeof(msg_seq_num_));
   dst->append(reinterpret_cast<const char*>(
     &send_time_), sizeof(send_time_));
+  dst->append(reinterpret_cast<const char*>(
+    &trace_id_), sizeof(trace_id_));
   return true;
 }
 
@@ -102,6 +106,9 @@ bool MessageInfo::SerializeTo(char* dst, std::size_t len) const {
   ptr += sizeof(msg_seq_num_);
   std::memcpy(ptr,
     reinterpret_cast<const char*>(&send_time_), sizeof(send_time_));
+  ptr += sizeof(send_time_);
+  std::memcpy(ptr,
+    reinterpret_cast<const char*>(&trace_id_), sizeof(trace_id_));
   return true;
 }
 
@@ -132,6 +139,9 @@ bool MessageInfo::DeserializeFrom(const char* src, std::size_t len) {
   ptr += sizeof(msg_seq_num_);
   std::memcpy(
     reinterpret_cast<char*>(&send_time_), ptr, sizeof(send_time_));
+  ptr += sizeof(send_time_);
+  std::memcpy(
+    reinterpret_cast<char*>(&trace_id_), ptr, sizeof(trace_id_));
   return true;
 }
 
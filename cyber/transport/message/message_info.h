@@ -66,6 +66,19 @@ class MessageInfo {
   uint64_t send_time() const { return send_time_; }
   void set_send_time(uint64_t send_time) { send_time_ = send_time; }
 
+  // trace id of the message the publishing routine processed, 0 if none
+  uint64_t trace_id() const { return trace_id_; }
+  void set_trace_id(uint64_t trace_id) { trace_id_ = trace_id; }
+
+  /**
+   * @brief Links the profiler spans of one sensor frame through every hop of
+   * the pipeline: the trace id carried on, else one made of the sender and
+   * seq, unique across channels and processes.
+   */
+  uint64_t TraceId() const {
+    return trace_id_ != 0 ? trace_id_ : sender_id_.HashValue() ^ seq_num_;
+  }
+
  private:
   Identity sender_id_;
   uint64_t channel_id_ = 0;
@@ -73,6 +86,7 @@ class MessageInfo {
   Identity spare_id_;
   int32_t msg_seq_num_;
   uint64_t send_time_;
+  uint64_t trace_id_ = 0;
 };
 
 }  // namespace transport
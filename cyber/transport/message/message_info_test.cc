@@ -70,6 +70,31 @@ TEST(MessageInfoTest, test) {
   EXPECT_EQ(msgInfo3, msgInfo4);
 }
 
+TEST(MessageInfoTest, trace_id) {
+  Identity id, id2;
+  MessageInfo first(id, 1);
+  MessageInfo other_sender(id2, 1);
+  // without an upstream trace id, the sender keeps equal seqs apart
+  EXPECT_EQ(0, first.trace_id());
+  EXPECT_NE(0, first.TraceId());
+  EXPECT_NE(first.TraceId(), other_sender.TraceId());
+
+  MessageInfo next_hop(id2, 5);
+  next_hop.set_send_time(0);
+  next_hop.set_msg_seq_num(0);
+  next_hop.set_trace_id(first.TraceId());
+  EXPECT_EQ(first.TraceId(), next_hop.TraceId());
+
+  std::string str;
+  EXPECT_TRUE(next_hop.SerializeTo(&str));
+  EXPECT_EQ(MessageInfo::kSize, str.size());
+  MessageInfo received;
+  EXPECT_TRUE(received.DeserializeFrom(str));
+  EXPECT_EQ(first.TraceId(), received.TraceId());
+  MessageInfo copied(received);
+  EXPECT_EQ(first.TraceId(), copied.trace_id());
+}
+
 }  // namespace transport
 }  // namespace cyber
 }  // namespace apollo
@@ -77,9 +77,17 @@ const QosProfile QosProfileConf::QOS_PROFILE_TF_STATIC = CreateQosProfile(
     QosReliabilityPolicy::RELIABILITY_RELIABLE,
     QosDurabilityPolicy::DURABILITY_TRANSIENT_LOCAL);
 
+// late joiners learn the topology from the snapshots below, the changes are
+// not replayed to them
 const QosProfile QosProfileConf::QOS_PROFILE_TOPO_CHANGE = CreateQosProfile(
     QosHistoryPolicy::HISTORY_KEEP_ALL, 10, QOS_MPS_SYSTEM_DEFAULT,
     QosReliabilityPolicy::RELIABILITY_RELIABLE,
+    QosDurabilityPolicy::DURABILITY_VOLATILE);
+
+// only the latest snapshot of the roles of a process matters
+const QosProfile QosProfileConf::QOS_PROFILE_TOPO_SNAPSHOT = CreateQosProfile(
+    QosHistoryPolicy::HISTORY_KEEP_LAST, 1, QOS_MPS_SYSTEM_DEFAULT,
+    QosReliabilityPolicy::RELIABILITY_RELIABLE,
     QosDurabilityPolicy::DURABILITY_TRANSIENT_LOCAL);
 
 }  // namespace transport
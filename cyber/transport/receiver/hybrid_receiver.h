@@ -252,6 +252,16 @@ void HybridReceiver<M>::ReceiveHistoryMsg(const RoleAttributes& opposite_attr) {
   }
 
   auto attr = opposite_attr;
+  // a writer on this host keeps the history in shared memory, read it there
+  // instead of waiting for a replay
+  if (mapping_table_[GetRelation(opposite_attr)] == OptionalMode::SHM) {
+    auto receiver = std::dynamic_pointer_cast<ShmReceiver<M>>(
+        receivers_[OptionalMode::SHM]);
+    if (receiver != nullptr) {
+      cyber::Async(&ShmReceiver<M>::ReadHistory, receiver, attr);
+      return;
+    }
+  }
   cyber::Async(&HybridReceiver<M>::ThreadFunc, this, attr);
 }
 
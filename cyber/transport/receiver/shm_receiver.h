@@ -17,7 +17,11 @@
 #ifndef CYBER_TRANSPORT_RECEIVER_SHM_RECEIVER_H_
 #define CYBER_TRANSPORT_RECEIVER_SHM_RECEIVER_H_
 
+#include <atomic>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include "cyber/common/log.h"
 #include "cyber/transport/dispatcher/shm_dispatcher.h"
@@ -40,8 +44,32 @@ class ShmReceiver : public Receiver<M> {
   void Enable(const RoleAttributes& opposite_attr) override;
   void Disable(const RoleAttributes& opposite_attr) override;
 
+  /**
+   * @brief Delivers what a transient local writer keeps in shared memory.
+   * Enable(opposite_attr) must come first: its live messages are delivered
+   * from then on, and history read after the first of them is dropped
+   * instead of being delivered out of order.
+   */
+  bool ReadHistory(const RoleAttributes& opposite_attr);
+
  private:
+  // a transient local writer whose history is not read yet
+  struct PendingHistory {
+    std::mutex mutex;
+    std::atomic<bool> pending = {true};
+    bool live_delivered = false;
+  };
+  using PendingHistoryPtr = std::shared_ptr<PendingHistory>;
+
+  void OnLiveMessage(const PendingHistoryPtr& history,
+                     const std::shared_ptr<M>& msg,
+                     const MessageInfo& msg_info);
+  PendingHistoryPtr TakePendingHistory(uint64_t writer_id);
+
   ShmDispatcherPtr dispatcher_;
+  std::mutex history_mutex_;
+  // key: writer id
+  std::unordered_map<uint64_t, PendingHistoryPtr> pending_histories_;
 };
 
 template <typename M>
@@ -81,15 +109,83 @@ void ShmReceiver<M>::Disable() {
 
 template <typename M>
 void ShmReceiver<M>::Enable(const RoleAttributes& opposite_attr) {
+  if (opposite_attr.qos_profile().durability() !=
+      proto::QosDurabilityPolicy::DURABILITY_TRANSIENT_LOCAL) {
+    dispatcher_->AddListener<M>(
+        this->attr_, opposite_attr,
+        std::bind(&ShmReceiver<M>::OnNewMessage, this, std::placeholders::_1,
+                  std::placeholders::_2));
+    return;
+  }
+
+  auto history = std::make_shared<PendingHistory>();
+  {
+    std::lock_guard<std::mutex> lock(history_mutex_);
+    pending_histories_[opposite_attr.id()] = history;
+  }
   dispatcher_->AddListener<M>(
       this->attr_, opposite_attr,
-      std::bind(&ShmReceiver<M>::OnNewMessage, this, std::placeholders::_1,
-                std::placeholders::_2));
+      std::bind(&ShmReceiver<M>::OnLiveMessage, this, history,
+                std::placeholders::_1, std::placeholders::_2));
 }
 
 template <typename M>
 void ShmReceiver<M>::Disable(const RoleAttributes& opposite_attr) {
   dispatcher_->RemoveListener<M>(this->attr_, opposite_attr);
+  if (opposite_attr.qos_profile().durability() ==
+      proto::QosDurabilityPolicy::DURABILITY_TRANSIENT_LOCAL) {
+    TakePendingHistory(opposite_attr.id());
+    // the blocks would stay locked for good if the writer crashed
+    dispatcher_->ReleaseHistory(this->attr_, opposite_attr);
+  }
+}
+
+template <typename M>
+bool ShmReceiver<M>::ReadHistory(const RoleAttributes& opposite_attr) {
+  auto history = TakePendingHistory(opposite_attr.id());
+  if (history == nullptr) {
+    return false;
+  }
+  auto listener = [this, &history](const std::shared_ptr<M>& msg,
+                                   const MessageInfo& msg_info) {
+    std::lock_guard<std::mutex> lock(history->mutex);
+    if (!history->live_delivered) {
+      this->OnNewMessage(msg, msg_info);
+    }
+  };
+  bool result = dispatcher_->ReadHistory<M>(this->attr_, opposite_attr,
+                                            listener);
+  {
+    std::lock_guard<std::mutex> lock(history->mutex);
+    history->pending.store(false);
+  }
+  return result;
+}
+
+template <typename M>
+void ShmReceiver<M>::OnLiveMessage(const PendingHistoryPtr& history,
+                                   const std::shared_ptr<M>& msg,
+                                   const MessageInfo& msg_info) {
+  if (history->pending.load()) {
+    std::lock_guard<std::mutex> lock(history->mutex);
+    history->live_delivered = true;
+    this->OnNewMessage(msg, msg_info);
+    return;
+  }
+  this->OnNewMessage(msg, msg_info);
+}
+
+template <typename M>
+typename ShmReceiver<M>::PendingHistoryPtr ShmReceiver<M>::TakePendingHistory(
+    uint64_t writer_id) {
+  std::lock_guard<std::mutex> lock(history_mutex_);
+  auto itr = pending_histories_.find(writer_id);
+  if (itr == pending_histories_.end()) {
+    return nullptr;
+  }
+  auto history = itr->second;
+  pending_histories_.erase(itr);
+  return history;
 }
 
 }  // namespace transport
@@ -0,0 +1,91 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_SHM_FUTEX_NOTIFIER_H_
+#define CYBER_TRANSPORT_SHM_FUTEX_NOTIFIER_H_
+
+#include <sys/types.h>
+#include <atomic>
+#include <cstdint>
+
+#include "cyber/common/macros.h"
+#include "cyber/transport/shm/notifier_base.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+/**
+ * Same ring of ReadableInfo as ConditionNotifier, but a listener that has
+ * caught up sleeps on a futex word in the segment instead of polling.
+ * Writers only enter the kernel while some listener sleeps, and a woken
+ * listener drains the whole ring before it sleeps again, so a burst of
+ * writes costs one wakeup per listener rather than one per message.
+ */
+class FutexNotifier : public NotifierBase {
+  static const uint32_t kBufLength = 4096;
+
+  struct Slot {
+    std::atomic<uint64_t> seq = {0};
+    uint64_t host_id = 0;
+    uint64_t channel_id = 0;
+    uint32_t block_index = 0;
+  };
+
+  struct Indicator {
+    std::atomic<uint64_t> next_seq = {0};
+    // bumped before every wake, listeners wait while it is unchanged
+    std::atomic<uint32_t> futex = {0};
+    std::atomic<uint32_t> waiters = {0};
+    Slot slots[kBufLength];
+  };
+
+ public:
+  virtual ~FutexNotifier();
+
+  void Shutdown() override;
+  bool Notify(const ReadableInfo& info) override;
+  bool Listen(int timeout_ms, ReadableInfo* info) override;
+
+  static const char* Type() { return "futex"; }
+
+  uint64_t wake_count() const { return wake_count_.load(); }
+
+ private:
+  bool Init();
+  bool OpenOrCreate();
+  bool OpenOnly();
+  bool Remove();
+  void Reset();
+  bool TryRead(ReadableInfo* info);
+  void Wake();
+
+  key_t key_ = 0;
+  void* managed_shm_ = nullptr;
+  size_t shm_size_ = 0;
+  Indicator* indicator_ = nullptr;
+  uint64_t next_seq_ = 0;
+  std::atomic<uint64_t> wake_count_ = {0};
+  std::atomic<bool> is_shutdown_ = {false};
+
+  DECLARE_SINGLETON(FutexNotifier)
+};
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_SHM_FUTEX_NOTIFIER_H_
@@ -0,0 +1,92 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/shm/futex_notifier.h"
+
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+TEST(FutexNotifierTest, constructor) {
+  auto notifier = FutexNotifier::Instance();
+  EXPECT_NE(notifier, nullptr);
+}
+
+TEST(FutexNotifierTest, notify_listen) {
+  auto notifier = FutexNotifier::Instance();
+  ReadableInfo readable_info;
+  while (notifier->Listen(100, &readable_info)) {
+  }
+  EXPECT_FALSE(notifier->Listen(100, &readable_info));
+  EXPECT_TRUE(notifier->Notify(ReadableInfo(1, 2, 3)));
+  EXPECT_TRUE(notifier->Listen(100, &readable_info));
+  EXPECT_EQ(1, readable_info.host_id());
+  EXPECT_EQ(2, readable_info.block_index());
+  EXPECT_EQ(3, readable_info.channel_id());
+  EXPECT_FALSE(notifier->Listen(100, &readable_info));
+  EXPECT_TRUE(notifier->Notify(readable_info));
+  EXPECT_TRUE(notifier->Notify(readable_info));
+  EXPECT_TRUE(notifier->Listen(100, &readable_info));
+  EXPECT_TRUE(notifier->Listen(100, &readable_info));
+  EXPECT_FALSE(notifier->Listen(0, &readable_info));
+}
+
+TEST(FutexNotifierTest, wakeup_and_batching) {
+  auto notifier = FutexNotifier::Instance();
+  ReadableInfo readable_info;
+  while (notifier->Listen(0, &readable_info)) {
+  }
+
+  // a sleeping listener is woken well before its timeout
+  std::thread writer([notifier]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    notifier->Notify(ReadableInfo(0, 0, 0));
+  });
+  auto begin = std::chrono::steady_clock::now();
+  EXPECT_TRUE(notifier->Listen(5000, &readable_info));
+  EXPECT_LT(std::chrono::steady_clock::now() - begin,
+            std::chrono::milliseconds(1000));
+  writer.join();
+
+  // nobody sleeps while a burst is written, so nobody is woken
+  uint64_t wakes = notifier->wake_count();
+  for (uint32_t i = 0; i < 100; ++i) {
+    EXPECT_TRUE(notifier->Notify(ReadableInfo(0, i, 0)));
+  }
+  EXPECT_EQ(wakes, notifier->wake_count());
+  for (uint32_t i = 0; i < 100; ++i) {
+    EXPECT_TRUE(notifier->Listen(0, &readable_info));
+    EXPECT_EQ(i, readable_info.block_index());
+  }
+  EXPECT_FALSE(notifier->Listen(0, &readable_info));
+}
+
+TEST(FutexNotifierTest, shutdown) {
+  auto notifier = FutexNotifier::Instance();
+  notifier->Shutdown();
+  ReadableInfo readable_info;
+  EXPECT_FALSE(notifier->Notify(readable_info));
+  EXPECT_FALSE(notifier->Listen(100, &readable_info));
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
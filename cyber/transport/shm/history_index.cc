@@ -0,0 +1,229 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/shm/history_index.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+HistoryIndex::HistoryIndex(uint64_t channel_id, uint64_t writer_id)
+    : shm_name_(GetName(channel_id, writer_id)) {}
+
+HistoryIndex::~HistoryIndex() {
+  Unmap();
+  if (owner_) {
+    shm_unlink(shm_name_.c_str());
+  }
+}
+
+bool HistoryIndex::Create(uint32_t depth) {
+  if (managed_shm_ != nullptr) {
+    return true;
+  }
+  if (depth == 0) {
+    AERROR << "history depth must be positive.";
+    return false;
+  }
+
+  int fd = shm_open(shm_name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+  if (fd < 0 && errno == EEXIST) {
+    // left behind by a writer that crashed, writer ids are never reused
+    ADEBUG << "remove stale history " << shm_name_;
+    shm_unlink(shm_name_.c_str());
+    fd = shm_open(shm_name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+  }
+  if (fd < 0) {
+    AERROR << "create history " << shm_name_
+           << " failed, error: " << strerror(errno);
+    return false;
+  }
+  owner_ = true;
+
+  std::size_t size = depth * sizeof(Slot);
+  if (ftruncate(fd, size) < 0) {
+    AERROR << "ftruncate failed: " << strerror(errno);
+    close(fd);
+    return false;
+  }
+  if (!Map(fd, size)) {
+    return false;
+  }
+
+  slots_ = new (managed_shm_) Slot[depth];
+  return true;
+}
+
+bool HistoryIndex::Open() {
+  if (managed_shm_ != nullptr) {
+    return true;
+  }
+
+  int fd = shm_open(shm_name_.c_str(), O_RDWR, 0644);
+  if (fd < 0) {
+    ADEBUG << "no history " << shm_name_ << ": " << strerror(errno);
+    return false;
+  }
+  struct stat file_attr;
+  if (fstat(fd, &file_attr) < 0) {
+    AERROR << "fstat failed: " << strerror(errno);
+    close(fd);
+    return false;
+  }
+  // not sized by the writer yet
+  if (static_cast<std::size_t>(file_attr.st_size) < sizeof(Slot)) {
+    close(fd);
+    return false;
+  }
+  if (!Map(fd, file_attr.st_size)) {
+    return false;
+  }
+
+  slots_ = reinterpret_cast<Slot*>(managed_shm_);
+  return true;
+}
+
+bool HistoryIndex::Add(uint32_t block_index, uint32_t* evicted_block_index) {
+  if (slots_ == nullptr) {
+    return false;
+  }
+
+  bool evicted = false;
+  if (size() == depth()) {
+    evicted = Evict(evicted_block_index);
+  }
+  uint64_t seq = next_seq_++;
+  Slot& slot = slots_[(seq - 1) % depth()];
+  slot.block_index.store(block_index);
+  slot.seq.store(seq);
+  return evicted;
+}
+
+bool HistoryIndex::Evict(uint32_t* evicted_block_index) {
+  if (slots_ == nullptr || size() == 0) {
+    return false;
+  }
+
+  uint64_t seq = oldest_seq_++;
+  Slot& slot = slots_[(seq - 1) % depth()];
+  // readers that locked the block before this see the entry is gone
+  if (slot.seq.exchange(0) != seq) {
+    return false;
+  }
+  if (evicted_block_index != nullptr) {
+    *evicted_block_index = slot.block_index.load();
+  }
+  return true;
+}
+
+void HistoryIndex::GetEntries(std::vector<Entry>* entries) const {
+  if (entries == nullptr) {
+    return;
+  }
+  entries->clear();
+  if (slots_ == nullptr) {
+    return;
+  }
+
+  for (uint32_t i = 0; i < depth(); ++i) {
+    Entry entry;
+    entry.seq = slots_[i].seq.load();
+    if (entry.seq == 0) {
+      continue;
+    }
+    entry.block_index = slots_[i].block_index.load();
+    // the writer replaced the slot while it was being read
+    if (slots_[i].seq.load() != entry.seq) {
+      continue;
+    }
+    entries->emplace_back(entry);
+  }
+  std::sort(entries->begin(), entries->end(),
+            [](const Entry& lhs, const Entry& rhs) {
+              return lhs.seq < rhs.seq;
+            });
+}
+
+bool HistoryIndex::IsCurrent(const Entry& entry) const {
+  if (slots_ == nullptr || entry.seq == 0) {
+    return false;
+  }
+  return slots_[(entry.seq - 1) % depth()].seq.load() == entry.seq;
+}
+
+bool HistoryIndex::Claim(const Entry& entry) {
+  if (slots_ == nullptr || entry.seq == 0) {
+    return false;
+  }
+  uint64_t seq = entry.seq;
+  Slot& slot = slots_[(seq - 1) % depth()];
+  return slot.seq.compare_exchange_strong(seq, 0);
+}
+
+void HistoryIndex::Remove() {
+  Unmap();
+  shm_unlink(shm_name_.c_str());
+}
+
+uint32_t HistoryIndex::depth() const {
+  if (slots_ == nullptr) {
+    return 0;
+  }
+  return static_cast<uint32_t>(shm_size_ / sizeof(Slot));
+}
+
+std::string HistoryIndex::GetName(uint64_t channel_id, uint64_t writer_id) {
+  return std::to_string(channel_id) + ".history." + std::to_string(writer_id);
+}
+
+bool HistoryIndex::Map(int fd, std::size_t size) {
+  managed_shm_ =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (managed_shm_ == MAP_FAILED) {
+    AERROR << "attach history " << shm_name_
+           << " failed: " << strerror(errno);
+    managed_shm_ = nullptr;
+    return false;
+  }
+  shm_size_ = size;
+  return true;
+}
+
+void HistoryIndex::Unmap() {
+  if (managed_shm_ != nullptr) {
+    munmap(managed_shm_, shm_size_);
+    managed_shm_ = nullptr;
+  }
+  slots_ = nullptr;
+  shm_size_ = 0;
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
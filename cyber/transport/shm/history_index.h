@@ -0,0 +1,121 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_SHM_HISTORY_INDEX_H_
+#define CYBER_TRANSPORT_SHM_HISTORY_INDEX_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+class HistoryIndex;
+using HistoryIndexPtr = std::shared_ptr<HistoryIndex>;
+
+/**
+ * @class HistoryIndex
+ * @brief Block indexes of the last messages a transient local writer put into
+ * the segment of its channel, so readers on the same host that join later
+ * read them straight from shared memory.
+ *
+ * The writer keeps a read lock on every block in the index, the segment skips
+ * such blocks instead of overwriting them, and drops it once the block falls
+ * out. Every entry carries a sequence that is never reused: a reader locks the
+ * block of an entry and then checks the entry is unchanged, so a block
+ * recycled in between is never delivered.
+ */
+class HistoryIndex {
+ public:
+  struct Entry {
+    uint64_t seq = 0;
+    uint32_t block_index = 0;
+  };
+
+  HistoryIndex(uint64_t channel_id, uint64_t writer_id);
+  virtual ~HistoryIndex();
+
+  // writer side, the shared memory is removed when this object is destroyed
+  bool Create(uint32_t depth);
+  // reader side
+  bool Open();
+
+  /**
+   * @brief Writer side, appends a block whose read lock the writer holds.
+   * @return true if the oldest entry was pushed out, its block is returned
+   * in evicted_block_index and may be unlocked.
+   */
+  bool Add(uint32_t block_index, uint32_t* evicted_block_index);
+  /**
+   * @brief Writer side, pushes out the oldest entry ahead of time.
+   * @return true if its block is returned in evicted_block_index and may be
+   * unlocked, false if the index is empty or a reader claimed the entry.
+   */
+  bool Evict(uint32_t* evicted_block_index);
+  // writer side, entries in the index
+  uint32_t size() const {
+    return static_cast<uint32_t>(next_seq_ - oldest_seq_);
+  }
+
+  // entries currently in the index, oldest first
+  void GetEntries(std::vector<Entry>* entries) const;
+  // whether the entry still holds its block, check after locking the block
+  bool IsCurrent(const Entry& entry) const;
+  /**
+   * @brief Reader side, takes the entry over from a writer that is gone.
+   * @return true for exactly one caller, which unlocks the block.
+   */
+  bool Claim(const Entry& entry);
+  // reader side, removes the shared memory of a writer that is gone
+  void Remove();
+
+  // derived from the size of the object, readers may map it before the
+  // writer touched it
+  uint32_t depth() const;
+
+  static std::string GetName(uint64_t channel_id, uint64_t writer_id);
+
+ private:
+  struct Slot {
+    // 0 while the slot is empty or being replaced
+    std::atomic<uint64_t> seq = {0};
+    std::atomic<uint32_t> block_index = {0};
+  };
+
+  bool Map(int fd, std::size_t size);
+  void Unmap();
+
+  std::string shm_name_;
+  bool owner_ = false;
+  void* managed_shm_ = nullptr;
+  std::size_t shm_size_ = 0;
+  Slot* slots_ = nullptr;
+
+  // writer only, the entries in the index are [oldest_seq_, next_seq_)
+  uint64_t oldest_seq_ = 1;
+  uint64_t next_seq_ = 1;
+};
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_SHM_HISTORY_INDEX_H_
@@ -0,0 +1,135 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/shm/history_index.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cyber/common/util.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+TEST(HistoryIndexTest, add_and_evict) {
+  uint64_t channel_id = common::Hash("/history_index_test/add_and_evict");
+  HistoryIndex writer(channel_id, 1);
+  EXPECT_FALSE(writer.Create(0));
+  EXPECT_TRUE(writer.Create(3));
+  EXPECT_EQ(writer.depth(), 3);
+
+  uint32_t evicted = 0;
+  EXPECT_FALSE(writer.Add(10, &evicted));
+  EXPECT_FALSE(writer.Add(11, &evicted));
+  EXPECT_FALSE(writer.Add(12, &evicted));
+  EXPECT_EQ(writer.size(), 3);
+  EXPECT_TRUE(writer.Add(13, &evicted));
+  EXPECT_EQ(evicted, 10);
+  EXPECT_EQ(writer.size(), 3);
+
+  EXPECT_TRUE(writer.Evict(&evicted));
+  EXPECT_EQ(evicted, 11);
+  EXPECT_EQ(writer.size(), 2);
+
+  std::vector<HistoryIndex::Entry> entries;
+  writer.GetEntries(&entries);
+  ASSERT_EQ(entries.size(), 2);
+  EXPECT_EQ(entries[0].block_index, 12);
+  EXPECT_EQ(entries[1].block_index, 13);
+
+  EXPECT_TRUE(writer.Evict(&evicted));
+  EXPECT_TRUE(writer.Evict(&evicted));
+  EXPECT_EQ(evicted, 13);
+  EXPECT_FALSE(writer.Evict(&evicted));
+  writer.GetEntries(&entries);
+  EXPECT_TRUE(entries.empty());
+}
+
+TEST(HistoryIndexTest, reader) {
+  uint64_t channel_id = common::Hash("/history_index_test/reader");
+  HistoryIndex reader(channel_id, 2);
+  EXPECT_FALSE(reader.Open());
+
+  std::vector<HistoryIndex::Entry> entries;
+  {
+    HistoryIndex writer(channel_id, 2);
+    EXPECT_TRUE(writer.Create(2));
+    EXPECT_TRUE(reader.Open());
+    EXPECT_EQ(reader.depth(), 2);
+    reader.GetEntries(&entries);
+    EXPECT_TRUE(entries.empty());
+
+    writer.Add(5, nullptr);
+    writer.Add(6, nullptr);
+    writer.Add(7, nullptr);
+    reader.GetEntries(&entries);
+    ASSERT_EQ(entries.size(), 2);
+    EXPECT_EQ(entries[0].block_index, 6);
+    EXPECT_EQ(entries[1].block_index, 7);
+    EXPECT_TRUE(reader.IsCurrent(entries[0]));
+    EXPECT_TRUE(reader.IsCurrent(entries[1]));
+
+    // the slot of block 6 now holds block 8
+    writer.Add(8, nullptr);
+    EXPECT_FALSE(reader.IsCurrent(entries[0]));
+    EXPECT_TRUE(reader.IsCurrent(entries[1]));
+
+    // other writers of the channel keep a history of their own
+    HistoryIndex other(channel_id, 3);
+    EXPECT_FALSE(other.Open());
+  }
+
+  // gone with the writer
+  HistoryIndex late_reader(channel_id, 2);
+  EXPECT_FALSE(late_reader.Open());
+}
+
+TEST(HistoryIndexTest, claim) {
+  uint64_t channel_id = common::Hash("/history_index_test/claim");
+  HistoryIndex writer(channel_id, 4);
+  EXPECT_TRUE(writer.Create(3));
+  writer.Add(20, nullptr);
+  writer.Add(21, nullptr);
+
+  // two readers see the writer gone, only one of them unlocks each block
+  HistoryIndex reader(channel_id, 4);
+  HistoryIndex other_reader(channel_id, 4);
+  EXPECT_TRUE(reader.Open());
+  EXPECT_TRUE(other_reader.Open());
+  std::vector<HistoryIndex::Entry> entries;
+  reader.GetEntries(&entries);
+  ASSERT_EQ(entries.size(), 2);
+  EXPECT_TRUE(reader.Claim(entries[0]));
+  EXPECT_FALSE(other_reader.Claim(entries[0]));
+  EXPECT_FALSE(reader.IsCurrent(entries[0]));
+
+  // the writer does not unlock a claimed block a second time
+  uint32_t evicted = 0;
+  EXPECT_FALSE(writer.Evict(&evicted));
+  EXPECT_TRUE(writer.Evict(&evicted));
+  EXPECT_EQ(evicted, 21);
+  EXPECT_FALSE(reader.Claim(entries[1]));
+
+  reader.Remove();
+  HistoryIndex late_reader(channel_id, 4);
+  EXPECT_FALSE(late_reader.Open());
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
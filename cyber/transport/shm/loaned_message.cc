@@ -0,0 +1,89 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/shm/loaned_message.h"
+
+#include <utility>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+LoanedMessage::LoanedMessage()
+    : segment_(nullptr), block_(), capacity_(0), size_(0) {}
+
+LoanedMessage::LoanedMessage(const SegmentAllocatorPtr& segment,
+                             const WritableBlock& block, std::size_t capacity)
+    : segment_(segment), block_(block), capacity_(capacity), size_(capacity) {}
+
+LoanedMessage::~LoanedMessage() { Release(); }
+
+LoanedMessage::LoanedMessage(LoanedMessage&& other)
+    : segment_(std::move(other.segment_)),
+      block_(other.block_),
+      capacity_(other.capacity_),
+      size_(other.size_) {
+  other.segment_ = nullptr;
+  other.block_ = WritableBlock();
+  other.capacity_ = 0;
+  other.size_ = 0;
+}
+
+LoanedMessage& LoanedMessage::operator=(LoanedMessage&& other) {
+  if (this != &other) {
+    Release();
+    segment_ = std::move(other.segment_);
+    block_ = other.block_;
+    capacity_ = other.capacity_;
+    size_ = other.size_;
+    other.segment_ = nullptr;
+    other.block_ = WritableBlock();
+    other.capacity_ = 0;
+    other.size_ = 0;
+  }
+  return *this;
+}
+
+bool LoanedMessage::set_size(std::size_t size) {
+  if (size > capacity_) {
+    AERROR << "size[" << size << "] exceeds loaned capacity[" << capacity_
+           << "].";
+    return false;
+  }
+  size_ = size;
+  return true;
+}
+
+void LoanedMessage::Release() {
+  if (segment_ == nullptr) {
+    return;
+  }
+  segment_->ReleaseWrittenBlock(block_);
+  Detach();
+}
+
+void LoanedMessage::Detach() {
+  segment_ = nullptr;
+  block_ = WritableBlock();
+  capacity_ = 0;
+  size_ = 0;
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,105 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_SHM_LOANED_MESSAGE_H_
+#define CYBER_TRANSPORT_SHM_LOANED_MESSAGE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+#include "cyber/transport/shm/segment_allocator.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+/**
+ * @class LoanedMessage
+ * @brief A shared memory block lent to a writer, so the payload can be built
+ * in place instead of being serialized into the segment on Transmit.
+ *
+ * The block stays write-locked until the message is transmitted or the loan
+ * is destroyed, in which case the block is handed back unpublished.
+ */
+class LoanedMessage {
+  template <typename M>
+  friend class ShmTransmitter;
+
+ public:
+  LoanedMessage();
+  LoanedMessage(const SegmentAllocatorPtr& segment, const WritableBlock& block,
+                std::size_t capacity);
+  virtual ~LoanedMessage();
+
+  LoanedMessage(LoanedMessage&& other);
+  LoanedMessage& operator=(LoanedMessage&& other);
+
+  LoanedMessage(const LoanedMessage&) = delete;
+  LoanedMessage& operator=(const LoanedMessage&) = delete;
+
+  bool IsValid() const { return segment_ != nullptr; }
+
+  uint8_t* data() { return block_.buf; }
+  const uint8_t* data() const { return block_.buf; }
+  std::size_t capacity() const { return capacity_; }
+
+  std::size_t size() const { return size_; }
+  bool set_size(std::size_t size);
+
+  /**
+   * @brief Construct a fixed-layout message directly in the block and mark
+   * the loan as sizeof(T) bytes long.
+   *
+   * @return nullptr if the loan is invalid or too small
+   */
+  template <typename T>
+  T* As();
+
+  /**
+   * @brief Give the block back without publishing it.
+   */
+  void Release();
+
+  const WritableBlock& block() const { return block_; }
+  const SegmentAllocatorPtr& segment() const { return segment_; }
+
+ private:
+  // forget the block once the transmitter has published it
+  void Detach();
+
+  SegmentAllocatorPtr segment_;
+  WritableBlock block_;
+  std::size_t capacity_;
+  std::size_t size_;
+};
+
+template <typename T>
+T* LoanedMessage::As() {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "only fixed-layout messages can be built in place");
+  if (!IsValid() || !set_size(sizeof(T))) {
+    return nullptr;
+  }
+  return new (block_.buf) T();
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_SHM_LOANED_MESSAGE_H_
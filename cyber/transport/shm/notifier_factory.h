@@ -32,6 +32,7 @@ class NotifierFactory {
  private:
   static NotifierPtr CreateConditionNotifier();
   static NotifierPtr CreateMulticastNotifier();
+  static NotifierPtr CreateFutexNotifier();
 };
 
 }  // namespace transport
@@ -34,6 +34,15 @@ PosixSegment::PosixSegment(uint64_t channel_id) : Segment(channel_id) {
   shm_name_ = std::to_string(channel_id);
 }
 
+PosixSegment::PosixSegment(uint64_t channel_id, uint32_t slab_id,
+                           const ShmConf& conf)
+    : Segment(channel_id, conf) {
+  shm_name_ = std::to_string(channel_id);
+  if (slab_id != 0) {
+    shm_name_ += "." + std::to_string(slab_id);
+  }
+}
+
 PosixSegment::~PosixSegment() { Destroy(); }
 
 bool PosixSegment::OpenOrCreate() {
@@ -237,6 +246,10 @@ void PosixSegment::Reset() {
   }
 }
 
+void PosixSegment::Unmap(void* managed_shm, uint64_t size) {
+  munmap(managed_shm, size);
+}
+
 }  // namespace transport
 }  // namespace cyber
 }  // namespace apollo
@@ -28,6 +28,8 @@ namespace transport {
 class PosixSegment : public Segment {
  public:
   explicit PosixSegment(uint64_t channel_id);
+  // slab_id 0 shares its name with the plain per-channel segment
+  PosixSegment(uint64_t channel_id, uint32_t slab_id, const ShmConf& conf);
   virtual ~PosixSegment();
 
   static const char* Type() { return "posix"; }
@@ -37,6 +39,7 @@ class PosixSegment : public Segment {
   bool Remove() override;
   bool OpenOnly() override;
   bool OpenOrCreate() override;
+  void Unmap(void* managed_shm, uint64_t size) override;
 
   std::string shm_name_;
 };
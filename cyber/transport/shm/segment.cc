@@ -16,8 +16,11 @@
 
 #include "cyber/transport/shm/segment.h"
 
+#include <algorithm>
+
 #include "cyber/common/log.h"
 #include "cyber/common/util.h"
+#include "cyber/statistics/channel_stats.h"
 #include "cyber/transport/shm/shm_conf.h"
 
 namespace apollo {
@@ -34,6 +37,16 @@ Segment::Segment(uint64_t channel_id)
       block_buf_lock_(),
       block_buf_addrs_() {}
 
+Segment::Segment(uint64_t channel_id, const ShmConf& conf)
+    : init_(false),
+      conf_(conf),
+      channel_id_(channel_id),
+      state_(nullptr),
+      blocks_(nullptr),
+      managed_shm_(nullptr),
+      block_buf_lock_(),
+      block_buf_addrs_() {}
+
 bool Segment::AcquireBlockToWrite(std::size_t msg_size,
                                   WritableBlock* writable_block) {
   RETURN_VAL_IF_NULL(writable_block, false);
@@ -47,7 +60,7 @@ bool Segment::AcquireBlockToWrite(std::size_t msg_size,
     result = Remap();
   }
 
-  if (msg_size > conf_.ceiling_msg_size()) {
+  if (result && msg_size > conf_.ceiling_msg_size()) {
     AINFO << "msg_size: " << msg_size
           << " larger than current shm_buffer_size: "
           << conf_.ceiling_msg_size() << " , need recreate.";
@@ -59,19 +72,22 @@ bool Segment::AcquireBlockToWrite(std::size_t msg_size,
     return false;
   }
 
-  uint32_t index = GetNextWritableBlockIndex();
+  uint32_t index = 0;
+  if (!GetNextWritableBlockIndex(&index)) {
+    AWARN << "no block of channel[" << channel_id_
+          << "] is free to write, all are held by readers.";
+    return false;
+  }
   writable_block->index = index;
   writable_block->block = &blocks_[index];
   writable_block->buf = block_buf_addrs_[index];
+  writable_block->segment = this;
+  acquired_blocks_.fetch_add(1);
   return true;
 }
 
 void Segment::ReleaseWrittenBlock(const WritableBlock& writable_block) {
-  auto index = writable_block.index;
-  if (index >= conf_.block_num()) {
-    return;
-  }
-  blocks_[index].ReleaseWriteLock();
+  ReleaseBlock(writable_block, true);
 }
 
 bool Segment::AcquireBlockToRead(ReadableBlock* readable_block) {
@@ -87,12 +103,7 @@ bool Segment::AcquireBlockToRead(ReadableBlock* readable_block) {
     return false;
   }
 
-  bool result = true;
-  if (state_->need_remap()) {
-    result = Remap();
-  }
-
-  if (!result) {
+  if (state_->need_remap() && !Remap()) {
     AERROR << "segment update failed.";
     return false;
   }
@@ -102,18 +113,71 @@ bool Segment::AcquireBlockToRead(ReadableBlock* readable_block) {
   }
   readable_block->block = blocks_ + index;
   readable_block->buf = block_buf_addrs_[index];
+  readable_block->segment = this;
+  acquired_blocks_.fetch_add(1);
   return true;
 }
 
 void Segment::ReleaseReadBlock(const ReadableBlock& readable_block) {
-  auto index = readable_block.index;
-  if (index >= conf_.block_num()) {
+  ReleaseBlock(readable_block, false);
+}
+
+void Segment::ReleaseBlock(const WritableBlock& block, bool is_write) {
+  std::lock_guard<std::mutex> lg(mapping_lock_);
+  for (auto it = retired_mappings_.begin(); it != retired_mappings_.end();
+       ++it) {
+    if (block.block < it->blocks || block.block >= it->blocks + it->block_num) {
+      continue;
+    }
+    if (is_write) {
+      block.block->ReleaseWriteLock();
+    } else {
+      block.block->ReleaseReadLock();
+    }
+    if (--it->acquired_blocks == 0) {
+      Unmap(it->managed_shm, it->size);
+      retired_mappings_.erase(it);
+    }
+    return;
+  }
+
+  auto index = block.index;
+  if (index >= conf_.block_num() || blocks_ == nullptr) {
     return;
   }
-  blocks_[index].ReleaseReadLock();
+  if (is_write) {
+    blocks_[index].ReleaseWriteLock();
+  } else {
+    blocks_[index].ReleaseReadLock();
+  }
+  acquired_blocks_.fetch_sub(1);
+}
+
+bool Segment::TryPinBlock() {
+  if (!init_) {
+    return false;
+  }
+  return state_->TryPinBlock(std::max(conf_.block_num() / 2, 1u));
+}
+
+void Segment::UnpinBlock() {
+  if (init_) {
+    state_->UnpinBlock();
+  }
+}
+
+uint64_t Segment::mapped_size() {
+  return init_ ? conf_.managed_shm_size() : 0;
 }
 
 bool Segment::Destroy() {
+  {
+    std::lock_guard<std::mutex> lg(mapping_lock_);
+    for (auto& mapping : retired_mappings_) {
+      Unmap(mapping.managed_shm, mapping.size);
+    }
+    retired_mappings_.clear();
+  }
   if (!init_) {
     return true;
   }
@@ -135,6 +199,7 @@ bool Segment::Destroy() {
 
 bool Segment::Remap() {
   init_ = false;
+  RetireMapping();
   ADEBUG << "before reset.";
   Reset();
   ADEBUG << "after reset.";
@@ -144,21 +209,50 @@ bool Segment::Remap() {
 bool Segment::Recreate(const uint64_t& msg_size) {
   init_ = false;
   state_->set_need_remap(true);
+  RetireMapping();
   Reset();
   Remove();
   conf_.Update(msg_size);
   return OpenOrCreate();
 }
 
-uint32_t Segment::GetNextWritableBlockIndex() {
+void Segment::RetireMapping() {
+  std::lock_guard<std::mutex> lg(mapping_lock_);
+  uint32_t acquired = acquired_blocks_.exchange(0);
+  if (acquired == 0 || managed_shm_ == nullptr) {
+    return;
+  }
+  // Reset leaves a mapping alone once it is handed over here
+  RetiredMapping mapping;
+  mapping.managed_shm = managed_shm_;
+  mapping.size = conf_.managed_shm_size();
+  mapping.blocks = blocks_;
+  mapping.block_num = conf_.block_num();
+  mapping.acquired_blocks = acquired;
+  retired_mappings_.emplace_back(mapping);
+  managed_shm_ = nullptr;
+  ADEBUG << "segment of channel[" << channel_id_ << "] remapped while "
+         << acquired << " block(s) are still held.";
+}
+
+bool Segment::GetNextWritableBlockIndex(uint32_t* index) {
   const auto block_num = conf_.block_num();
-  while (1) {
+  // blocks held by readers are skipped, give up after one lap over all of
+  // them rather than wait for a reader to let go
+  for (uint32_t i = 0; i < block_num; ++i) {
     uint32_t try_idx = state_->FetchAddSeq(1) % block_num;
+    if (try_idx == block_num - 1) {
+      laps_.fetch_add(1);
+      statistics::ChannelStats::Instance()->OnShmLap(channel_id_);
+    }
     if (blocks_[try_idx].TryLockForWrite()) {
-      return try_idx;
+      *index = try_idx;
+      return true;
     }
+    contended_blocks_.fetch_add(1);
+    statistics::ChannelStats::Instance()->OnShmContention(channel_id_);
   }
-  return 0;
+  return false;
 }
 
 }  // namespace transport
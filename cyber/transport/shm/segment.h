@@ -17,10 +17,12 @@
 #ifndef CYBER_TRANSPORT_SHM_SEGMENT_H_
 #define CYBER_TRANSPORT_SHM_SEGMENT_H_
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "cyber/transport/shm/block.h"
 #include "cyber/transport/shm/shm_conf.h"
@@ -37,12 +39,15 @@ struct WritableBlock {
   uint32_t index = 0;
   Block* block = nullptr;
   uint8_t* buf = nullptr;
+  // the segment the block was acquired from
+  Segment* segment = nullptr;
 };
 using ReadableBlock = WritableBlock;
 
 class Segment {
  public:
   explicit Segment(uint64_t channel_id);
+  Segment(uint64_t channel_id, const ShmConf& conf);
   virtual ~Segment() {}
 
   bool AcquireBlockToWrite(std::size_t msg_size, WritableBlock* writable_block);
@@ -51,15 +56,37 @@ class Segment {
   bool AcquireBlockToRead(ReadableBlock* readable_block);
   void ReleaseReadBlock(const ReadableBlock& readable_block);
 
+  // A message view or a writer history keeps its block read-locked for as
+  // long as it lives. At most half of the blocks may be held that way by all
+  // processes together, counted in the shared state, so the writer always
+  // finds blocks to write to; past that the reader copies the message
+  // instead. Fails before the segment is opened.
+  bool TryPinBlock();
+  void UnpinBlock();
+
+  // bytes currently mapped, 0 before the segment is opened
+  uint64_t mapped_size();
+  // times the writer found a block still locked by a reader
+  uint64_t contended_blocks() const { return contended_blocks_.load(); }
+  // times the writer wrapped around the block ring
+  uint64_t laps() const { return laps_.load(); }
+
  protected:
   virtual bool Destroy();
   virtual void Reset() = 0;
   virtual bool Remove() = 0;
   virtual bool OpenOnly() = 0;
   virtual bool OpenOrCreate() = 0;
+  virtual void Unmap(void* managed_shm, uint64_t size) = 0;
 
   bool init_;
   ShmConf conf_;
+  // Blocks of the current mapping that are acquired but not released yet.
+  // Loaned messages and message views keep their block across calls, a remap
+  // or recreate leaves the mapping to them until they are all handed back.
+  std::atomic<uint32_t> acquired_blocks_ = {0};
+  std::atomic<uint64_t> contended_blocks_ = {0};
+  std::atomic<uint64_t> laps_ = {0};
   uint64_t channel_id_;
 
   State* state_;
@@ -69,9 +96,24 @@ class Segment {
   std::unordered_map<uint32_t, uint8_t*> block_buf_addrs_;
 
  private:
+  // A mapping replaced while some of its blocks were still acquired. It
+  // stays mapped until the last of them is released.
+  struct RetiredMapping {
+    void* managed_shm = nullptr;
+    uint64_t size = 0;
+    Block* blocks = nullptr;
+    uint32_t block_num = 0;
+    uint32_t acquired_blocks = 0;
+  };
+
   bool Remap();
   bool Recreate(const uint64_t& msg_size);
-  uint32_t GetNextWritableBlockIndex();
+  void RetireMapping();
+  void ReleaseBlock(const WritableBlock& block, bool is_write);
+  bool GetNextWritableBlockIndex(uint32_t* index);
+
+  std::mutex mapping_lock_;
+  std::vector<RetiredMapping> retired_mappings_;
 };
 
 }  // namespace transport
@@ -0,0 +1,228 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/shm/segment_allocator.h"
+
+#include "cyber/common/log.h"
+#include "cyber/common/util.h"
+#include "cyber/time/time.h"
+#include "cyber/transport/shm/segment_factory.h"
+#include "cyber/transport/shm/shm_conf.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+const uint32_t SegmentAllocator::kSlabIdShift = 24;
+const uint32_t SegmentAllocator::kLocalIndexMask = (1u << 24) - 1;
+const uint64_t SegmentAllocator::kMinLapIntervalNs = 100 * 1000 * 1000;
+
+SegmentAllocator::SegmentAllocator(uint64_t channel_id)
+    : channel_id_(channel_id),
+      slabs_(ShmConf::kSizeClassNum * ShmConf::kMaxSlabsPerClass),
+      slab_nums_(ShmConf::kSizeClassNum, 0),
+      next_slabs_(ShmConf::kSizeClassNum, 0) {}
+
+SegmentAllocator::~SegmentAllocator() {
+  std::lock_guard<std::mutex> lg(slabs_lock_);
+  slabs_.clear();
+}
+
+bool SegmentAllocator::AcquireBlockToWrite(std::size_t msg_size,
+                                           WritableBlock* writable_block) {
+  RETURN_VAL_IF_NULL(writable_block, false);
+  uint64_t max_msg_size =
+      ShmConf::GetClassCeilingSize(ShmConf::kSizeClassNum - 1);
+  if (msg_size > max_msg_size) {
+    AERROR << "msg_size[" << msg_size << "] exceeds the largest size class["
+           << max_msg_size << "].";
+    return false;
+  }
+
+  uint32_t size_class = ShmConf::GetSizeClass(msg_size);
+  uint32_t slab_id = 0;
+  auto segment = PickSlabToWrite(size_class, &slab_id);
+  bool is_new_mapping = segment->mapped_size() == 0;
+  if (!segment->AcquireBlockToWrite(msg_size, writable_block)) {
+    return false;
+  }
+  writable_block->index = EncodeIndex(slab_id, writable_block->index);
+
+  if (is_new_mapping) {
+    UpdateMappedSize();
+  }
+  MaybeGrow(size_class, slab_id);
+  return true;
+}
+
+void SegmentAllocator::ReleaseWrittenBlock(
+    const WritableBlock& writable_block) {
+  auto segment = GetSlab(GetSlabId(writable_block.index));
+  if (segment == nullptr) {
+    return;
+  }
+  WritableBlock local_block = writable_block;
+  local_block.index = GetLocalIndex(writable_block.index);
+  segment->ReleaseWrittenBlock(local_block);
+}
+
+bool SegmentAllocator::AcquireBlockToRead(ReadableBlock* readable_block) {
+  RETURN_VAL_IF_NULL(readable_block, false);
+  auto segment = GetSlab(GetSlabId(readable_block->index));
+  if (segment == nullptr) {
+    AERROR << "invalid block_index[" << readable_block->index << "].";
+    return false;
+  }
+
+  bool is_new_mapping = segment->mapped_size() == 0;
+  ReadableBlock local_block;
+  local_block.index = GetLocalIndex(readable_block->index);
+  if (!segment->AcquireBlockToRead(&local_block)) {
+    return false;
+  }
+  readable_block->block = local_block.block;
+  readable_block->buf = local_block.buf;
+  readable_block->segment = local_block.segment;
+
+  if (is_new_mapping) {
+    UpdateMappedSize();
+  }
+  return true;
+}
+
+void SegmentAllocator::ReleaseReadBlock(const ReadableBlock& readable_block) {
+  auto segment = GetSlab(GetSlabId(readable_block.index));
+  if (segment == nullptr) {
+    return;
+  }
+  ReadableBlock local_block = readable_block;
+  local_block.index = GetLocalIndex(readable_block.index);
+  segment->ReleaseReadBlock(local_block);
+}
+
+bool SegmentAllocator::AcquireBlockToPin(ReadableBlock* readable_block) {
+  if (!AcquireBlockToRead(readable_block)) {
+    return false;
+  }
+  if (!readable_block->segment->TryPinBlock()) {
+    ReleaseReadBlock(*readable_block);
+    return false;
+  }
+  return true;
+}
+
+void SegmentAllocator::ReleasePinnedBlock(const ReadableBlock& readable_block) {
+  auto segment = GetSlab(GetSlabId(readable_block.index));
+  if (segment == nullptr) {
+    return;
+  }
+  segment->UnpinBlock();
+  ReadableBlock local_block = readable_block;
+  local_block.index = GetLocalIndex(readable_block.index);
+  segment->ReleaseReadBlock(local_block);
+}
+
+uint32_t SegmentAllocator::slab_num(uint32_t size_class) {
+  std::lock_guard<std::mutex> lg(slabs_lock_);
+  if (size_class >= slab_nums_.size()) {
+    return 0;
+  }
+  return slab_nums_[size_class];
+}
+
+uint32_t SegmentAllocator::EncodeIndex(uint32_t slab_id,
+                                       uint32_t local_index) {
+  return (slab_id << kSlabIdShift) | (local_index & kLocalIndexMask);
+}
+
+SegmentPtr SegmentAllocator::GetSlab(uint32_t slab_id) {
+  std::lock_guard<std::mutex> lg(slabs_lock_);
+  if (slab_id >= slabs_.size()) {
+    return nullptr;
+  }
+  auto& slab = slabs_[slab_id];
+  if (slab.segment == nullptr) {
+    uint32_t size_class = slab_id / ShmConf::kMaxSlabsPerClass;
+    ShmConf conf(ShmConf::GetClassCeilingSize(size_class),
+                 ShmConf::GetSlabBlockNum(size_class));
+    slab.segment = SegmentFactory::CreateSegment(channel_id_, slab_id, conf);
+  }
+  return slab.segment;
+}
+
+SegmentPtr SegmentAllocator::PickSlabToWrite(uint32_t size_class,
+                                             uint32_t* slab_id) {
+  {
+    std::lock_guard<std::mutex> lg(slabs_lock_);
+    if (slab_nums_[size_class] == 0) {
+      slab_nums_[size_class] = 1;
+    }
+    uint32_t n = next_slabs_[size_class]++ % slab_nums_[size_class];
+    *slab_id = size_class * ShmConf::kMaxSlabsPerClass + n;
+  }
+  return GetSlab(*slab_id);
+}
+
+void SegmentAllocator::MaybeGrow(uint32_t size_class, uint32_t slab_id) {
+  std::lock_guard<std::mutex> lg(slabs_lock_);
+  auto& slab = slabs_[slab_id];
+  if (slab.segment == nullptr) {
+    return;
+  }
+
+  bool need_grow = false;
+  uint64_t contended_blocks = slab.segment->contended_blocks();
+  if (contended_blocks > slab.contended_blocks) {
+    slab.contended_blocks = contended_blocks;
+    need_grow = true;
+  }
+  uint64_t laps = slab.segment->laps();
+  if (laps > slab.laps) {
+    uint64_t now = Time::MonoTime().ToNanosecond();
+    if (slab.last_lap_time != 0 &&
+        now - slab.last_lap_time < kMinLapIntervalNs) {
+      need_grow = true;
+    }
+    slab.laps = laps;
+    slab.last_lap_time = now;
+  }
+
+  if (!need_grow || slab_nums_[size_class] >= ShmConf::kMaxSlabsPerClass) {
+    return;
+  }
+  ++slab_nums_[size_class];
+  AINFO << "channel[" << channel_id_ << "] size class["
+        << ShmConf::GetClassCeilingSize(size_class) << "] grows to "
+        << slab_nums_[size_class] << " slab(s).";
+}
+
+void SegmentAllocator::UpdateMappedSize() {
+  std::lock_guard<std::mutex> lg(slabs_lock_);
+  uint64_t mapped_size = 0;
+  for (auto& slab : slabs_) {
+    if (slab.segment != nullptr) {
+      mapped_size += slab.segment->mapped_size();
+    }
+  }
+  mapped_size_.store(mapped_size);
+  if (mapped_size > high_water_mark_.load()) {
+    high_water_mark_.store(mapped_size);
+  }
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,109 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_SHM_SEGMENT_ALLOCATOR_H_
+#define CYBER_TRANSPORT_SHM_SEGMENT_ALLOCATOR_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "cyber/transport/shm/segment.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+class SegmentAllocator;
+using SegmentAllocatorPtr = std::shared_ptr<SegmentAllocator>;
+
+/**
+ * @class SegmentAllocator
+ * @brief Hands out shared memory blocks of a channel from per size class
+ * slabs instead of one segment sized for the largest message seen.
+ *
+ * Every slab is a Segment of its own with a fixed ceiling and block count, so
+ * a big message only maps a slab of its class and never remaps the slabs
+ * readers already hold. A class starts with one slab and gets another one,
+ * up to ShmConf::kMaxSlabsPerClass, when the writer runs into blocks still
+ * locked by readers or laps its ring too fast. Block indexes carry the slab
+ * id in their top bits, so readers open the slabs they are told about.
+ */
+class SegmentAllocator {
+ public:
+  explicit SegmentAllocator(uint64_t channel_id);
+  virtual ~SegmentAllocator();
+
+  bool AcquireBlockToWrite(std::size_t msg_size, WritableBlock* writable_block);
+  void ReleaseWrittenBlock(const WritableBlock& writable_block);
+
+  bool AcquireBlockToRead(ReadableBlock* readable_block);
+  void ReleaseReadBlock(const ReadableBlock& readable_block);
+
+  // Reads a block and keeps it read-locked past the call, counted against
+  // the pin limit of its slab, see Segment::TryPinBlock. False if the block
+  // is not readable or the slab has no blocks left to pin.
+  bool AcquireBlockToPin(ReadableBlock* readable_block);
+  void ReleasePinnedBlock(const ReadableBlock& readable_block);
+
+  // bytes of all slabs mapped by this allocator
+  uint64_t mapped_size() const { return mapped_size_.load(); }
+  uint64_t high_water_mark() const { return high_water_mark_.load(); }
+  // slabs in use by the given size class
+  uint32_t slab_num(uint32_t size_class);
+
+  static uint32_t EncodeIndex(uint32_t slab_id, uint32_t local_index);
+  static uint32_t GetSlabId(uint32_t index) { return index >> kSlabIdShift; }
+  static uint32_t GetLocalIndex(uint32_t index) {
+    return index & kLocalIndexMask;
+  }
+
+ private:
+  static const uint32_t kSlabIdShift;
+  static const uint32_t kLocalIndexMask;
+  // a ring lapped faster than this is considered too small
+  static const uint64_t kMinLapIntervalNs;
+
+  struct Slab {
+    SegmentPtr segment = nullptr;
+    uint64_t contended_blocks = 0;
+    uint64_t laps = 0;
+    uint64_t last_lap_time = 0;
+  };
+
+  SegmentPtr GetSlab(uint32_t slab_id);
+  SegmentPtr PickSlabToWrite(uint32_t size_class, uint32_t* slab_id);
+  void MaybeGrow(uint32_t size_class, uint32_t slab_id);
+  void UpdateMappedSize();
+
+  uint64_t channel_id_;
+  std::mutex slabs_lock_;
+  // indexed by slab id, size_class * kMaxSlabsPerClass + n
+  std::vector<Slab> slabs_;
+  std::vector<uint32_t> slab_nums_;
+  std::vector<uint32_t> next_slabs_;
+  std::atomic<uint64_t> mapped_size_ = {0};
+  std::atomic<uint64_t> high_water_mark_ = {0};
+};
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_SHM_SEGMENT_ALLOCATOR_H_
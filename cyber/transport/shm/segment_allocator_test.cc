@@ -0,0 +1,227 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/shm/segment_allocator.h"
+
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cyber/common/util.h"
+#include "cyber/transport/shm/segment_factory.h"
+#include "cyber/transport/shm/shm_conf.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+TEST(ShmConfTest, size_class) {
+  EXPECT_EQ(ShmConf::GetSizeClass(0), 0);
+  EXPECT_EQ(ShmConf::GetSizeClass(ShmConf::GetClassCeilingSize(0)), 0);
+  EXPECT_EQ(ShmConf::GetSizeClass(ShmConf::GetClassCeilingSize(0) + 1), 1);
+  EXPECT_EQ(ShmConf::GetSizeClass(9 * 1024 * 1024), 4);
+  EXPECT_EQ(ShmConf::GetSizeClass(ShmConf::GetClassCeilingSize(5) * 2),
+            ShmConf::kSizeClassNum - 1);
+
+  ShmConf conf(ShmConf::GetClassCeilingSize(2), 3);
+  EXPECT_EQ(conf.block_num(), 3);
+  conf.Update(ShmConf::GetClassCeilingSize(3));
+  EXPECT_EQ(conf.block_num(), 3);
+  EXPECT_EQ(conf.ceiling_msg_size(), ShmConf::GetClassCeilingSize(3));
+}
+
+TEST(SegmentAllocatorTest, index) {
+  uint32_t index = SegmentAllocator::EncodeIndex(5, 17);
+  EXPECT_EQ(SegmentAllocator::GetSlabId(index), 5);
+  EXPECT_EQ(SegmentAllocator::GetLocalIndex(index), 17);
+  // the first slab keeps the plain block index
+  EXPECT_EQ(SegmentAllocator::EncodeIndex(0, 17), 17);
+}
+
+TEST(SegmentAllocatorTest, size_classes) {
+  uint64_t channel_id = common::Hash("/segment_allocator_test/size_classes");
+  SegmentAllocator writer(channel_id);
+  SegmentAllocator reader(channel_id);
+
+  WritableBlock small_block;
+  EXPECT_FALSE(writer.AcquireBlockToWrite(16, nullptr));
+  EXPECT_TRUE(writer.AcquireBlockToWrite(16, &small_block));
+  std::memcpy(small_block.buf, "small", 6);
+  small_block.block->set_msg_size(6);
+  writer.ReleaseWrittenBlock(small_block);
+  uint64_t small_mapped_size = writer.mapped_size();
+  EXPECT_GT(small_mapped_size, 0);
+
+  // a larger message maps a slab of its own class, the small one stays
+  WritableBlock big_block;
+  uint64_t big_size = ShmConf::GetClassCeilingSize(1) + 1;
+  EXPECT_TRUE(writer.AcquireBlockToWrite(big_size, &big_block));
+  std::memcpy(big_block.buf, "big", 4);
+  big_block.block->set_msg_size(4);
+  writer.ReleaseWrittenBlock(big_block);
+  EXPECT_NE(SegmentAllocator::GetSlabId(small_block.index),
+            SegmentAllocator::GetSlabId(big_block.index));
+  EXPECT_GT(writer.mapped_size(), small_mapped_size);
+  EXPECT_EQ(writer.high_water_mark(), writer.mapped_size());
+  EXPECT_LT(writer.mapped_size(),
+            ShmConf(ShmConf::GetClassCeilingSize(2)).managed_shm_size());
+
+  ReadableBlock rb;
+  rb.index = small_block.index;
+  EXPECT_TRUE(reader.AcquireBlockToRead(&rb));
+  EXPECT_STREQ(reinterpret_cast<char*>(rb.buf), "small");
+  reader.ReleaseReadBlock(rb);
+
+  rb.index = big_block.index;
+  EXPECT_TRUE(reader.AcquireBlockToRead(&rb));
+  EXPECT_STREQ(reinterpret_cast<char*>(rb.buf), "big");
+  reader.ReleaseReadBlock(rb);
+
+  rb.index = SegmentAllocator::EncodeIndex(200, 0);
+  EXPECT_FALSE(reader.AcquireBlockToRead(&rb));
+
+  WritableBlock too_big;
+  uint64_t too_big_size = ShmConf::GetClassCeilingSize(5) + 1;
+  EXPECT_FALSE(writer.AcquireBlockToWrite(too_big_size, &too_big));
+}
+
+TEST(SegmentAllocatorTest, grow_on_contention) {
+  uint64_t channel_id = common::Hash("/segment_allocator_test/grow");
+  SegmentAllocator writer(channel_id);
+  SegmentAllocator reader(channel_id);
+  const uint32_t block_num = ShmConf::GetSlabBlockNum(0);
+
+  WritableBlock wb;
+  EXPECT_TRUE(writer.AcquireBlockToWrite(16, &wb));
+  writer.ReleaseWrittenBlock(wb);
+  EXPECT_EQ(writer.slab_num(0), 1);
+
+  // a slow reader keeps the first block while the writer laps the ring
+  ReadableBlock rb;
+  rb.index = wb.index;
+  EXPECT_TRUE(reader.AcquireBlockToRead(&rb));
+  for (uint32_t i = 0; i < block_num; ++i) {
+    EXPECT_TRUE(writer.AcquireBlockToWrite(16, &wb));
+    writer.ReleaseWrittenBlock(wb);
+  }
+  reader.ReleaseReadBlock(rb);
+  EXPECT_GT(writer.slab_num(0), 1);
+  EXPECT_LE(writer.slab_num(0), ShmConf::kMaxSlabsPerClass);
+}
+
+TEST(SegmentAllocatorTest, pin_blocks) {
+  uint64_t channel_id = common::Hash("/segment_allocator_test/pin_blocks");
+  SegmentAllocator writer(channel_id);
+  SegmentAllocator history(channel_id);
+  SegmentAllocator reader(channel_id);
+  const uint32_t block_num = ShmConf::GetSlabBlockNum(0);
+
+  std::vector<ReadableBlock> pinned(block_num);
+  for (uint32_t i = 0; i < block_num; ++i) {
+    WritableBlock wb;
+    EXPECT_TRUE(writer.AcquireBlockToWrite(16, &wb));
+    writer.ReleaseWrittenBlock(wb);
+    pinned[i].index = wb.index;
+  }
+
+  // a writer history and the views of a reader share the limit of the slab
+  ASSERT_GE(block_num, 4);
+  const uint32_t history_num = block_num / 4;
+  const uint32_t max_pinned = block_num / 2;
+  for (uint32_t i = 0; i < history_num; ++i) {
+    EXPECT_TRUE(history.AcquireBlockToPin(&pinned[i]));
+  }
+  for (uint32_t i = history_num; i < max_pinned; ++i) {
+    EXPECT_TRUE(reader.AcquireBlockToRead(&pinned[i]));
+    EXPECT_TRUE(pinned[i].segment->TryPinBlock());
+  }
+  EXPECT_FALSE(history.AcquireBlockToPin(&pinned[max_pinned]));
+
+  history.ReleasePinnedBlock(pinned[0]);
+  EXPECT_TRUE(history.AcquireBlockToPin(&pinned[max_pinned]));
+  history.ReleasePinnedBlock(pinned[max_pinned]);
+  for (uint32_t i = 1; i < history_num; ++i) {
+    history.ReleasePinnedBlock(pinned[i]);
+  }
+  for (uint32_t i = history_num; i < max_pinned; ++i) {
+    pinned[i].segment->UnpinBlock();
+    reader.ReleaseReadBlock(pinned[i]);
+  }
+}
+
+TEST(SegmentTest, readers_hold_every_block) {
+  uint64_t channel_id = common::Hash("/segment_test/readers_hold_every_block");
+  auto writer = SegmentFactory::CreateSegment(channel_id);
+  auto reader = SegmentFactory::CreateSegment(channel_id);
+
+  WritableBlock wb;
+  EXPECT_TRUE(writer->AcquireBlockToWrite(16, &wb));
+  writer->ReleaseWrittenBlock(wb);
+  const uint32_t block_num = ShmConf().block_num();
+
+  // the writer gives up after one lap instead of waiting for the readers
+  std::vector<ReadableBlock> rbs(block_num);
+  for (uint32_t i = 0; i < block_num; ++i) {
+    rbs[i].index = i;
+    EXPECT_TRUE(reader->AcquireBlockToRead(&rbs[i]));
+    EXPECT_EQ(reader.get(), rbs[i].segment);
+  }
+  EXPECT_FALSE(writer->AcquireBlockToWrite(16, &wb));
+  reader->ReleaseReadBlock(rbs[0]);
+  EXPECT_TRUE(writer->AcquireBlockToWrite(16, &wb));
+  writer->ReleaseWrittenBlock(wb);
+  for (uint32_t i = 1; i < block_num; ++i) {
+    reader->ReleaseReadBlock(rbs[i]);
+  }
+
+  // views may pin at most half of the blocks, counted over all processes
+  for (uint32_t i = 0; i < block_num / 2; ++i) {
+    EXPECT_TRUE(reader->TryPinBlock());
+  }
+  EXPECT_FALSE(reader->TryPinBlock());
+  EXPECT_FALSE(writer->TryPinBlock());
+  reader->UnpinBlock();
+  EXPECT_TRUE(writer->TryPinBlock());
+  writer->UnpinBlock();
+  for (uint32_t i = 0; i < block_num / 2; ++i) {
+    reader->UnpinBlock();
+  }
+
+  // a block held across a remap stays readable until it is released
+  EXPECT_TRUE(writer->AcquireBlockToWrite(16, &wb));
+  std::memcpy(wb.buf, "old", 4);
+  wb.block->set_msg_size(4);
+  writer->ReleaseWrittenBlock(wb);
+  ReadableBlock held;
+  held.index = wb.index;
+  EXPECT_TRUE(reader->AcquireBlockToRead(&held));
+  WritableBlock big;
+  EXPECT_TRUE(writer->AcquireBlockToWrite(ShmConf().ceiling_msg_size() + 1,
+                                          &big));
+  writer->ReleaseWrittenBlock(big);
+  ReadableBlock fresh;
+  fresh.index = big.index;
+  EXPECT_TRUE(reader->AcquireBlockToRead(&fresh));
+  EXPECT_NE(held.block, fresh.block);
+  EXPECT_STREQ(reinterpret_cast<char*>(held.buf), "old");
+  reader->ReleaseReadBlock(held);
+  reader->ReleaseReadBlock(fresh);
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
@@ -30,7 +30,9 @@ namespace transport {
 
 using apollo::cyber::common::GlobalData;
 
-auto SegmentFactory::CreateSegment(uint64_t channel_id) -> SegmentPtr {
+namespace {
+
+std::string GetSegmentType() {
   std::string segment_type(XsiSegment::Type());
   auto& shm_conf = GlobalData::Instance()->Config();
   if (shm_conf.has_transport_conf() &&
@@ -40,14 +42,28 @@ auto SegmentFactory::CreateSegment(uint64_t channel_id) -> SegmentPtr {
   }
 
   ADEBUG << "segment type: " << segment_type;
+  return segment_type;
+}
 
-  if (segment_type == PosixSegment::Type()) {
+}  // namespace
+
+auto SegmentFactory::CreateSegment(uint64_t channel_id) -> SegmentPtr {
+  if (GetSegmentType() == PosixSegment::Type()) {
     return std::make_shared<PosixSegment>(channel_id);
   }
 
   return std::make_shared<XsiSegment>(channel_id);
 }
 
+auto SegmentFactory::CreateSegment(uint64_t channel_id, uint32_t slab_id,
+                                   const ShmConf& conf) -> SegmentPtr {
+  if (GetSegmentType() == PosixSegment::Type()) {
+    return std::make_shared<PosixSegment>(channel_id, slab_id, conf);
+  }
+
+  return std::make_shared<XsiSegment>(channel_id, slab_id, conf);
+}
+
 }  // namespace transport
 }  // namespace cyber
 }  // namespace apollo
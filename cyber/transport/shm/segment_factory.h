@@ -26,6 +26,8 @@ namespace transport {
 class SegmentFactory {
  public:
   static SegmentPtr CreateSegment(uint64_t channel_id);
+  static SegmentPtr CreateSegment(uint64_t channel_id, uint32_t slab_id,
+                                  const ShmConf& conf);
 };
 
 }  // namespace transport
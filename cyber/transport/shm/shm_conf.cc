@@ -21,16 +21,24 @@ namespace apollo {
 namespace cyber {
 namespace transport {
 
-ShmConf::ShmConf() { Update(MESSAGE_SIZE_16K); }
+ShmConf::ShmConf() : fixed_block_num_(0) { Update(MESSAGE_SIZE_16K); }
 
-ShmConf::ShmConf(const uint64_t& real_msg_size) { Update(real_msg_size); }
+ShmConf::ShmConf(const uint64_t& real_msg_size) : fixed_block_num_(0) {
+  Update(real_msg_size);
+}
+
+ShmConf::ShmConf(const uint64_t& real_msg_size, const uint32_t& block_num)
+    : fixed_block_num_(block_num) {
+  Update(real_msg_size);
+}
 
 ShmConf::~ShmConf() {}
 
 void ShmConf::Update(const uint64_t& real_msg_size) {
   ceiling_msg_size_ = GetCeilingMessageSize(real_msg_size);
   block_buf_size_ = GetBlockBufSize(ceiling_msg_size_);
-  block_num_ = GetBlockNum(ceiling_msg_size_);
+  block_num_ =
+      fixed_block_num_ > 0 ? fixed_block_num_ : GetBlockNum(ceiling_msg_size_);
   managed_shm_size_ =
       EXTRA_SIZE + STATE_SIZE + (BLOCK_SIZE + block_buf_size_) * block_num_;
 }
@@ -58,6 +66,9 @@ const uint64_t ShmConf::MESSAGE_SIZE_16M = 1024 * 1024 * 16;
 const uint32_t ShmConf::BLOCK_NUM_MORE = 8;
 const uint64_t ShmConf::MESSAGE_SIZE_MORE = 1024 * 1024 * 32;
 
+const uint32_t ShmConf::kSizeClassNum = 6;
+const uint32_t ShmConf::kMaxSlabsPerClass = 4;
+
 uint64_t ShmConf::GetCeilingMessageSize(const uint64_t& real_msg_size) {
   uint64_t ceiling_msg_size = MESSAGE_SIZE_16K;
   if (real_msg_size <= MESSAGE_SIZE_16K) {
@@ -76,6 +87,36 @@ uint64_t ShmConf::GetCeilingMessageSize(const uint64_t& real_msg_size) {
   return ceiling_msg_size;
 }
 
+uint32_t ShmConf::GetSizeClass(const uint64_t& real_msg_size) {
+  uint32_t size_class = 0;
+  while (size_class + 1 < kSizeClassNum &&
+         real_msg_size > GetClassCeilingSize(size_class)) {
+    ++size_class;
+  }
+  return size_class;
+}
+
+uint64_t ShmConf::GetClassCeilingSize(const uint32_t& size_class) {
+  static const uint64_t ceilings[] = {
+      MESSAGE_SIZE_16K, MESSAGE_SIZE_128K, MESSAGE_SIZE_1M,
+      MESSAGE_SIZE_8M,  MESSAGE_SIZE_16M,  MESSAGE_SIZE_MORE};
+  return ceilings[size_class < kSizeClassNum ? size_class : kSizeClassNum - 1];
+}
+
+uint32_t ShmConf::GetClassBlockNum(const uint32_t& size_class) {
+  static const uint32_t block_nums[] = {BLOCK_NUM_16K, BLOCK_NUM_128K,
+                                        BLOCK_NUM_1M,  BLOCK_NUM_8M,
+                                        BLOCK_NUM_16M, BLOCK_NUM_MORE};
+  return block_nums[size_class < kSizeClassNum ? size_class
+                                               : kSizeClassNum - 1];
+}
+
+uint32_t ShmConf::GetSlabBlockNum(const uint32_t& size_class) {
+  uint32_t num = GetClassBlockNum(size_class) / kMaxSlabsPerClass;
+  // a ring of one block would make the writer spin on a busy reader
+  return num < 2 ? 2 : num;
+}
+
 uint64_t ShmConf::GetBlockBufSize(const uint64_t& ceiling_msg_size) {
   return ceiling_msg_size + MESSAGE_INFO_SIZE;
 }
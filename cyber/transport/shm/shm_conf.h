@@ -28,6 +28,8 @@ class ShmConf {
  public:
   ShmConf();
   explicit ShmConf(const uint64_t& real_msg_size);
+  // block_num is kept as is across Update, used by size class slabs
+  ShmConf(const uint64_t& real_msg_size, const uint32_t& block_num);
   virtual ~ShmConf();
 
   void Update(const uint64_t& real_msg_size);
@@ -37,6 +39,17 @@ class ShmConf {
   const uint32_t& block_num() { return block_num_; }
   const uint64_t& managed_shm_size() { return managed_shm_size_; }
 
+  // Size classes, one per ceiling message size, smallest first. A channel
+  // keeps one or more slabs per class it has used, see SegmentAllocator.
+  static uint32_t GetSizeClass(const uint64_t& real_msg_size);
+  static uint64_t GetClassCeilingSize(const uint32_t& size_class);
+  // blocks a class may hold in total, and blocks in each of its slabs
+  static uint32_t GetClassBlockNum(const uint32_t& size_class);
+  static uint32_t GetSlabBlockNum(const uint32_t& size_class);
+
+  static const uint32_t kSizeClassNum;
+  static const uint32_t kMaxSlabsPerClass;
+
  private:
   uint64_t GetCeilingMessageSize(const uint64_t& real_msg_size);
   uint64_t GetBlockBufSize(const uint64_t& ceiling_msg_size);
@@ -45,6 +58,7 @@ class ShmConf {
   uint64_t ceiling_msg_size_;
   uint64_t block_buf_size_;
   uint32_t block_num_;
+  uint32_t fixed_block_num_;
   uint64_t managed_shm_size_;
 
   // Extra size, Byte
@@ -52,10 +52,31 @@ class State {
   uint64_t ceiling_msg_size() { return ceiling_msg_size_.load(); }
   uint32_t reference_counts() { return reference_count_.load(); }
 
+  // blocks pinned by the views and writer histories of all processes
+  bool TryPinBlock(uint32_t max_pinned) {
+    uint32_t pinned = pinned_blocks_.load();
+    do {
+      if (pinned >= max_pinned) {
+        return false;
+      }
+    } while (!pinned_blocks_.compare_exchange_weak(pinned, pinned + 1));
+    return true;
+  }
+
+  void UnpinBlock() {
+    uint32_t pinned = pinned_blocks_.load();
+    do {
+      if (pinned == 0) {
+        return;
+      }
+    } while (!pinned_blocks_.compare_exchange_weak(pinned, pinned - 1));
+  }
+
  private:
   std::atomic<bool> need_remap_ = {false};
   std::atomic<uint32_t> seq_ = {0};
   std::atomic<uint32_t> reference_count_ = {0};
+  std::atomic<uint32_t> pinned_blocks_ = {0};
   std::atomic<uint64_t> ceiling_msg_size_;
 };
 
@@ -20,6 +20,8 @@
 #include <sys/shm.h>
 #include <sys/types.h>
 
+#include <string>
+
 #include "cyber/common/log.h"
 #include "cyber/common/util.h"
 #include "cyber/transport/shm/segment.h"
@@ -33,6 +35,16 @@ XsiSegment::XsiSegment(uint64_t channel_id) : Segment(channel_id) {
   key_ = static_cast<key_t>(channel_id);
 }
 
+XsiSegment::XsiSegment(uint64_t channel_id, uint32_t slab_id,
+                       const ShmConf& conf)
+    : Segment(channel_id, conf) {
+  key_ = static_cast<key_t>(channel_id);
+  if (slab_id != 0) {
+    key_ = static_cast<key_t>(common::Hash(std::to_string(channel_id) + "." +
+                                           std::to_string(slab_id)));
+  }
+}
+
 XsiSegment::~XsiSegment() { Destroy(); }
 
 bool XsiSegment::OpenOrCreate() {
@@ -233,6 +245,10 @@ void XsiSegment::Reset() {
   }
 }
 
+void XsiSegment::Unmap(void* managed_shm, uint64_t /*size*/) {
+  shmdt(managed_shm);
+}
+
 }  // namespace transport
 }  // namespace cyber
 }  // namespace apollo
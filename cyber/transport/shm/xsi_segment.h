@@ -26,6 +26,8 @@ namespace transport {
 class XsiSegment : public Segment {
  public:
   explicit XsiSegment(uint64_t channel_id);
+  // slab_id 0 shares its name with the plain per-channel segment
+  XsiSegment(uint64_t channel_id, uint32_t slab_id, const ShmConf& conf);
   virtual ~XsiSegment();
 
   static const char* Type() { return "xsi"; }
@@ -35,6 +37,7 @@ class XsiSegment : public Segment {
   bool Remove() override;
   bool OpenOnly() override;
   bool OpenOrCreate() override;
+  void Unmap(void* managed_shm, uint64_t size) override;
 
   key_t key_;
 };
@@ -28,9 +28,11 @@
 #include "cyber/common/global_data.h"
 #include "cyber/common/log.h"
 #include "cyber/common/types.h"
+#include "cyber/message/arena_pool.h"
 #include "cyber/proto/role_attributes.pb.h"
 #include "cyber/proto/transport_conf.pb.h"
 #include "cyber/task/task.h"
+#include "cyber/transport/message/content_filter_registry.h"
 #include "cyber/transport/message/history.h"
 #include "cyber/transport/rtps/participant.h"
 #include "cyber/transport/transmitter/intra_transmitter.h"
@@ -59,6 +61,8 @@ class HybridTransmitter : public Transmitter<M> {
   using CommunicationModePtr = std::shared_ptr<proto::CommunicationMode>;
   using MappingTable =
       std::unordered_map<Relation, OptionalMode, std::hash<int>>;
+  // key: reader id
+  using FilterMap = std::unordered_map<uint64_t, std::vector<ContentFilter>>;
 
   HybridTransmitter(const RoleAttributes& attr,
                     const ParticipantPtr& participant);
@@ -71,6 +75,10 @@ class HybridTransmitter : public Transmitter<M> {
 
   bool Transmit(const MessagePtr& msg, const MessageInfo& msg_info) override;
 
+  bool Loan(std::size_t size, LoanedMessage* loaned_msg) override;
+  bool Transmit(LoanedMessage* loaned_msg,
+                const MessageInfo& msg_info) override;
+
  private:
   void InitMode();
   void ObtainConfig();
@@ -80,6 +88,8 @@ class HybridTransmitter : public Transmitter<M> {
   void InitReceivers();
   void ClearReceivers();
   void TransmitHistoryMsg(const RoleAttributes& opposite_attr);
+  bool KeepsShmHistory(OptionalMode mode);
+  bool IsWanted(OptionalMode mode, const M& msg, const MessageInfo& msg_info);
   void ThreadFunc(const RoleAttributes& opposite_attr,
                   const std::vector<typename History<M>::CachedMessage>& msgs);
   Relation GetRelation(const RoleAttributes& opposite_attr);
@@ -87,6 +97,7 @@ class HybridTransmitter : public Transmitter<M> {
   HistoryPtr history_;
   TransmitterMap transmitters_;
   ReceiverMap receivers_;
+  FilterMap filters_;
   std::mutex mutex_;
 
   CommunicationModePtr mode_;
@@ -141,6 +152,14 @@ void HybridTransmitter<M>::Enable(const RoleAttributes& opposite_attr) {
   uint64_t id = opposite_attr.id();
   std::lock_guard<std::mutex> lock(mutex_);
   receivers_[mapping_table_[relation]].insert(id);
+  // looked up again on every join, readers sharing a receiver add theirs
+  std::vector<ContentFilter> filters;
+  if (ContentFilterRegistry::Instance()->Get(this->attr_.channel_id(), id,
+                                             &filters)) {
+    filters_[id] = filters;
+  } else {
+    filters_.erase(id);
+  }
   transmitters_[mapping_table_[relation]]->Enable();
   TransmitHistoryMsg(opposite_attr);
 }
@@ -154,9 +173,12 @@ void HybridTransmitter<M>::Disable(const RoleAttributes& opposite_attr) {
 
   uint64_t id = opposite_attr.id();
   std::lock_guard<std::mutex> lock(mutex_);
-  receivers_[mapping_table_[relation]].erase(id);
-  if (receivers_[mapping_table_[relation]].empty()) {
-    transmitters_[mapping_table_[relation]]->Disable();
+  auto mode = mapping_table_[relation];
+  receivers_[mode].erase(id);
+  filters_.erase(id);
+  // the shared memory history outlives the readers, it is for those to come
+  if (receivers_[mode].empty() && !KeepsShmHistory(mode)) {
+    transmitters_[mode]->Disable();
   }
 }
 
@@ -166,8 +188,63 @@ bool HybridTransmitter<M>::Transmit(const MessagePtr& msg,
   std::lock_guard<std::mutex> lock(mutex_);
   history_->Add(msg, msg_info);
   for (auto& item : transmitters_) {
-    item.second->Transmit(msg, msg_info);
+    if (IsWanted(item.first, *msg, msg_info)) {
+      item.second->Transmit(msg, msg_info);
+    }
+  }
+  return true;
+}
+
+template <typename M>
+bool HybridTransmitter<M>::Loan(std::size_t size, LoanedMessage* loaned_msg) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto itr = transmitters_.find(OptionalMode::SHM);
+  if (itr == transmitters_.end()) {
+    return false;
+  }
+  return itr->second->Loan(size, loaned_msg);
+}
+
+template <typename M>
+bool HybridTransmitter<M>::Transmit(LoanedMessage* loaned_msg,
+                                    const MessageInfo& msg_info) {
+  RETURN_VAL_IF_NULL(loaned_msg, false);
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // Only shared memory readers consume the loaned block directly, history and
+  // readers on the other transports still need a message of their own.
+  bool need_copy = this->attr_.qos_profile().durability() ==
+                   QosDurabilityPolicy::DURABILITY_TRANSIENT_LOCAL;
+  for (auto& item : receivers_) {
+    if (item.first != OptionalMode::SHM && !item.second.empty()) {
+      need_copy = true;
+    }
+  }
+
+  if (need_copy && loaned_msg->IsValid()) {
+    auto msg = message::ArenaPoolManager::Instance()->CreateMessage<M>(
+        this->attr_.channel_id());
+    if (message::ParseFromArray(loaned_msg->data(),
+                                static_cast<int>(loaned_msg->size()),
+                                msg.get())) {
+      history_->Add(msg, msg_info);
+      for (auto& item : transmitters_) {
+        if (item.first != OptionalMode::SHM) {
+          item.second->Transmit(msg, msg_info);
+        }
+      }
+    } else {
+      AERROR << "parse loaned message failed, channel: "
+             << this->attr_.channel_name();
+    }
   }
+
+  auto itr = transmitters_.find(OptionalMode::SHM);
+  if (itr == transmitters_.end()) {
+    loaned_msg->Release();
+    return true;
+  }
+  itr->second->Transmit(loaned_msg, msg_info);
   return true;
 }
 
@@ -220,6 +297,10 @@ void HybridTransmitter<M>::InitTransmitters() {
         break;
       case OptionalMode::SHM:
         transmitters_[mode] = std::make_shared<ShmTransmitter<M>>(this->attr_);
+        // start the history with the first message, not the first reader
+        if (KeepsShmHistory(mode)) {
+          transmitters_[mode]->Enable();
+        }
         break;
       default:
         transmitters_[mode] =
@@ -259,6 +340,11 @@ void HybridTransmitter<M>::TransmitHistoryMsg(
     return;
   }
 
+  // readers on this host map the history from shared memory themselves
+  if (KeepsShmHistory(mapping_table_[GetRelation(opposite_attr)])) {
+    return;
+  }
+
   // get unsent messages
   std::vector<typename History<M>::CachedMessage> unsent_msgs;
   history_->GetCachedMessage(&unsent_msgs);
@@ -270,6 +356,46 @@ void HybridTransmitter<M>::TransmitHistoryMsg(
   cyber::Async(&HybridTransmitter<M>::ThreadFunc, this, attr, unsent_msgs);
 }
 
+template <typename M>
+bool HybridTransmitter<M>::KeepsShmHistory(OptionalMode mode) {
+  if (mode != OptionalMode::SHM) {
+    return false;
+  }
+  auto itr = transmitters_.find(mode);
+  if (itr == transmitters_.end()) {
+    return false;
+  }
+  auto transmitter = std::dynamic_pointer_cast<ShmTransmitter<M>>(itr->second);
+  return transmitter != nullptr && transmitter->keeps_history();
+}
+
+template <typename M>
+bool HybridTransmitter<M>::IsWanted(OptionalMode mode, const M& msg,
+                                    const MessageInfo& msg_info) {
+  if (filters_.empty() || KeepsShmHistory(mode)) {
+    return true;
+  }
+  auto& readers = receivers_[mode];
+  if (readers.empty()) {
+    return true;
+  }
+
+  bool wanted = false;
+  for (auto id : readers) {
+    auto itr = filters_.find(id);
+    if (itr == filters_.end()) {
+      return true;
+    }
+    // no early return, every filter counts the message against its rate
+    for (auto& filter : itr->second) {
+      if (filter.Accept(msg_info, AsProtobufMessage(msg))) {
+        wanted = true;
+      }
+    }
+  }
+  return wanted;
+}
+
 template <typename M>
 void HybridTransmitter<M>::ThreadFunc(
     const RoleAttributes& opposite_attr,
@@ -17,6 +17,7 @@
 #ifndef CYBER_TRANSPORT_TRANSMITTER_SHM_TRANSMITTER_H_
 #define CYBER_TRANSPORT_TRANSMITTER_SHM_TRANSMITTER_H_
 
+#include <algorithm>
 #include <cstring>
 #include <iostream>
 #include <memory>
@@ -27,15 +28,19 @@
 #include "cyber/common/util.h"
 #include "cyber/message/message_traits.h"
 #include "cyber/statistics/statistics.h"
+#include "cyber/transport/shm/history_index.h"
 #include "cyber/transport/shm/notifier_factory.h"
 #include "cyber/transport/shm/readable_info.h"
-#include "cyber/transport/shm/segment_factory.h"
+#include "cyber/transport/shm/segment_allocator.h"
+#include "cyber/transport/shm/shm_conf.h"
 #include "cyber/transport/transmitter/transmitter.h"
 
 namespace apollo {
 namespace cyber {
 namespace transport {
 
+using apollo::cyber::proto::QosDurabilityPolicy;
+
 template <typename M>
 class ShmTransmitter : public Transmitter<M> {
  public:
@@ -49,13 +54,31 @@ class ShmTransmitter : public Transmitter<M> {
 
   bool Transmit(const MessagePtr& msg, const MessageInfo& msg_info) override;
 
+  bool Loan(std::size_t size, LoanedMessage* loaned_msg) override;
+  bool Transmit(LoanedMessage* loaned_msg,
+                const MessageInfo& msg_info) override;
+
+  // whether published messages stay readable for readers joining later
+  bool keeps_history() const { return history_depth_ > 0; }
+
  private:
   bool Transmit(const M& msg, const MessageInfo& msg_info);
+  bool Publish(const WritableBlock& wb, std::size_t msg_size,
+               const MessageInfo& msg_info);
+
+  void ReportHighWaterMark();
+  void AddToHistory(uint32_t block_index);
+  void ClearHistory();
 
-  SegmentPtr segment_;
+  SegmentAllocatorPtr segment_;
   uint64_t channel_id_;
   uint64_t host_id_;
   NotifierPtr notifier_;
+  statistics::StatusVarPtr high_water_mark_;
+  // blocks of the last messages of a transient local writer, read locked by
+  // the writer until they fall out
+  HistoryIndexPtr history_;
+  uint32_t history_depth_;
 };
 
 template <typename M>
@@ -63,8 +86,16 @@ ShmTransmitter<M>::ShmTransmitter(const RoleAttributes& attr)
     : Transmitter<M>(attr),
       segment_(nullptr),
       channel_id_(attr.channel_id()),
-      notifier_(nullptr) {
+      notifier_(nullptr),
+      history_(nullptr),
+      history_depth_(0) {
   host_id_ = common::Hash(attr.host_ip());
+  if (attr.qos_profile().durability() ==
+      QosDurabilityPolicy::DURABILITY_TRANSIENT_LOCAL) {
+    history_depth_ = std::max(attr.qos_profile().depth(), 1u);
+  }
+  high_water_mark_ = statistics::Statistics::Instance()->CreateStatus<uint64_t>(
+      attr, "shm-high-water-mark");
 }
 
 template <typename M>
@@ -78,14 +109,23 @@ void ShmTransmitter<M>::Enable() {
     return;
   }
 
-  segment_ = SegmentFactory::CreateSegment(channel_id_);
+  segment_ = std::make_shared<SegmentAllocator>(channel_id_);
   notifier_ = NotifierFactory::CreateNotifier();
+  if (keeps_history()) {
+    history_ = std::make_shared<HistoryIndex>(channel_id_, this->attr_.id());
+    if (!history_->Create(history_depth_)) {
+      AERROR << "create shm history failed, channel: "
+             << this->attr_.channel_name();
+      history_ = nullptr;
+    }
+  }
   this->enabled_ = true;
 }
 
 template <typename M>
 void ShmTransmitter<M>::Disable() {
   if (this->enabled_) {
+    ClearHistory();
     segment_ = nullptr;
     notifier_ = nullptr;
     this->enabled_ = false;
@@ -108,9 +148,11 @@ bool ShmTransmitter<M>::Transmit(const M& msg, const MessageInfo& msg_info) {
   WritableBlock wb;
   std::size_t msg_size = message::ByteSize(msg);
   if (!segment_->AcquireBlockToWrite(msg_size, &wb)) {
+    statistics::ChannelStats::Instance()->OnShmWriteFailure(channel_id_);
     AERROR << "acquire block failed.";
     return false;
   }
+  ReportHighWaterMark();
 
   ADEBUG << "block index: " << wb.index;
   if (!message::SerializeToArray(msg, wb.buf, static_cast<int>(msg_size))) {
@@ -118,6 +160,53 @@ bool ShmTransmitter<M>::Transmit(const M& msg, const MessageInfo& msg_info) {
     segment_->ReleaseWrittenBlock(wb);
     return false;
   }
+
+  return Publish(wb, msg_size, msg_info);
+}
+
+template <typename M>
+bool ShmTransmitter<M>::Loan(std::size_t size, LoanedMessage* loaned_msg) {
+  RETURN_VAL_IF_NULL(loaned_msg, false);
+  if (!this->enabled_) {
+    ADEBUG << "not enable.";
+    return false;
+  }
+
+  WritableBlock wb;
+  if (!segment_->AcquireBlockToWrite(size, &wb)) {
+    statistics::ChannelStats::Instance()->OnShmWriteFailure(channel_id_);
+    AERROR << "acquire block to loan failed.";
+    return false;
+  }
+  ReportHighWaterMark();
+  *loaned_msg = LoanedMessage(segment_, wb, size);
+  return true;
+}
+
+template <typename M>
+bool ShmTransmitter<M>::Transmit(LoanedMessage* loaned_msg,
+                                 const MessageInfo& msg_info) {
+  RETURN_VAL_IF_NULL(loaned_msg, false);
+  if (!loaned_msg->IsValid()) {
+    AERROR << "loaned message is not valid.";
+    return false;
+  }
+  if (!this->enabled_ || loaned_msg->segment() != segment_) {
+    ADEBUG << "not enable or loan is from another segment.";
+    loaned_msg->Release();
+    return false;
+  }
+
+  WritableBlock wb = loaned_msg->block();
+  std::size_t msg_size = loaned_msg->size();
+  // Publish always returns the block to the segment.
+  loaned_msg->Detach();
+  return Publish(wb, msg_size, msg_info);
+}
+
+template <typename M>
+bool ShmTransmitter<M>::Publish(const WritableBlock& wb, std::size_t msg_size,
+                                const MessageInfo& msg_info) {
   wb.block->set_msg_size(msg_size);
 
   char* msg_info_addr = reinterpret_cast<char*>(wb.buf) + msg_size;
@@ -128,6 +217,9 @@ bool ShmTransmitter<M>::Transmit(const M& msg, const MessageInfo& msg_info) {
   }
   wb.block->set_msg_info_size(MessageInfo::kSize);
   segment_->ReleaseWrittenBlock(wb);
+  if (history_ != nullptr) {
+    AddToHistory(wb.index);
+  }
 
   ReadableInfo readable_info(host_id_, wb.index, channel_id_);
 
@@ -137,6 +229,59 @@ bool ShmTransmitter<M>::Transmit(const M& msg, const MessageInfo& msg_info) {
   return notifier_->Notify(readable_info);
 }
 
+template <typename M>
+void ShmTransmitter<M>::ReportHighWaterMark() {
+  uint64_t high_water_mark = segment_->high_water_mark();
+  if (high_water_mark != high_water_mark_->get_value()) {
+    high_water_mark_->set_value(high_water_mark);
+  }
+}
+
+template <typename M>
+void ShmTransmitter<M>::AddToHistory(uint32_t block_index) {
+  ReadableBlock pinned;
+  pinned.index = block_index;
+  // the pin limit of the slab is shared with the message views of all
+  // readers, the history goes without the block once it is reached
+  if (!segment_->AcquireBlockToPin(&pinned)) {
+    ADEBUG << "fail to keep block " << block_index << " in history, channel: "
+           << this->attr_.channel_name();
+    return;
+  }
+
+  uint32_t evicted = 0;
+  if (history_->Add(block_index, &evicted)) {
+    pinned.index = evicted;
+    segment_->ReleasePinnedBlock(pinned);
+  }
+  // a locked block is skipped by the writer, leave at least half of the slab
+  // free however deep the history is
+  uint32_t size_class =
+      SegmentAllocator::GetSlabId(block_index) / ShmConf::kMaxSlabsPerClass;
+  uint32_t max_pinned =
+      std::max(ShmConf::GetSlabBlockNum(size_class) / 2, 1u);
+  while (history_->size() > max_pinned) {
+    if (history_->Evict(&evicted)) {
+      pinned.index = evicted;
+      segment_->ReleasePinnedBlock(pinned);
+    }
+  }
+}
+
+template <typename M>
+void ShmTransmitter<M>::ClearHistory() {
+  if (history_ == nullptr) {
+    return;
+  }
+  ReadableBlock pinned;
+  while (history_->size() > 0) {
+    if (history_->Evict(&pinned.index)) {
+      segment_->ReleasePinnedBlock(pinned);
+    }
+  }
+  history_ = nullptr;
+}
+
 }  // namespace transport
 }  // namespace cyber
 }  // namespace apollo
@@ -22,9 +22,12 @@
 #include <string>
 
 #include "cyber/event/perf_event_cache.h"
+#include "cyber/profiler/block_manager.h"
+#include "cyber/statistics/channel_stats.h"
 #include "cyber/statistics/statistics.h"
 #include "cyber/transport/common/endpoint.h"
 #include "cyber/transport/message/message_info.h"
+#include "cyber/transport/shm/loaned_message.h"
 
 namespace apollo {
 namespace cyber {
@@ -50,6 +53,12 @@ class Transmitter : public Endpoint {
   virtual bool Transmit(const MessagePtr& msg);
   virtual bool Transmit(const MessagePtr& msg, const MessageInfo& msg_info) = 0;
 
+  // Zero-copy publishing, only transmitters backed by shared memory can lend
+  // out blocks. Others return false and the caller falls back to Transmit.
+  virtual bool Loan(std::size_t size, LoanedMessage* loaned_msg);
+  virtual bool Transmit(LoanedMessage* loaned_msg);
+  virtual bool Transmit(LoanedMessage* loaned_msg, const MessageInfo& msg_info);
+
   uint64_t NextSeqNum() { return ++seq_num_; }
 
   uint64_t seq_num() const { return seq_num_; }
@@ -78,11 +87,43 @@ bool Transmitter<M>::Transmit(const MessagePtr& msg) {
   msg_info_.set_seq_num(NextSeqNum());
   msg_info_.set_msg_seq_num(msg_counter_->get_value());
   msg_info_.set_send_time(Time::Now().ToNanosecond());
+  msg_info_.set_trace_id(profiler::BlockManager::Instance()->TraceId());
   PerfEventCache::Instance()->AddTransportEvent(
       TransPerf::TRANSMIT_BEGIN, attr_.channel_id(), msg_info_.seq_num());
+  statistics::ChannelStats::Instance()->OnPublish(attr_.channel_id());
   return Transmit(msg, msg_info_);
 }
 
+template <typename M>
+bool Transmitter<M>::Loan(std::size_t size, LoanedMessage* loaned_msg) {
+  (void)size;
+  (void)loaned_msg;
+  return false;
+}
+
+template <typename M>
+bool Transmitter<M>::Transmit(LoanedMessage* loaned_msg) {
+  (*msg_counter_) << 1;
+  msg_info_.set_seq_num(NextSeqNum());
+  msg_info_.set_msg_seq_num(msg_counter_->get_value());
+  msg_info_.set_send_time(Time::Now().ToNanosecond());
+  msg_info_.set_trace_id(profiler::BlockManager::Instance()->TraceId());
+  PerfEventCache::Instance()->AddTransportEvent(
+      TransPerf::TRANSMIT_BEGIN, attr_.channel_id(), msg_info_.seq_num());
+  statistics::ChannelStats::Instance()->OnPublish(attr_.channel_id());
+  return Transmit(loaned_msg, msg_info_);
+}
+
+template <typename M>
+bool Transmitter<M>::Transmit(LoanedMessage* loaned_msg,
+                              const MessageInfo& msg_info) {
+  (void)msg_info;
+  if (loaned_msg != nullptr) {
+    loaned_msg->Release();
+  }
+  return false;
+}
+
 template <typename M>
 void Transmitter<M>::Enable(const RoleAttributes& opposite_attr) {
   (void)opposite_attr;